@@ -23,13 +23,35 @@
 #include <core/TellusimLog.h>
 #include <core/TellusimTime.h>
 #include <core/TellusimBlob.h>
+#include <core/TellusimFile.h>
 #include <core/TellusimArray.h>
+#include <core/TellusimSource.h>
 #include <format/TellusimArchive.h>
 
+#include "main_batch.h"
+#include "main_index.h"
+#include "main_mapping.h"
+#include "main_gzip.h"
+#include "main_reader.h"
+
 /*
  */
 using namespace Tellusim;
 
+/*
+ */
+static bool check_file(const String &name, const uint8_t *data, size_t size) {
+	if(name.extension() != "txt") {
+		if(size != sizeof(uint16_t) * 1024 * 32) return false;
+		for(uint32_t k = 0; k < 1024 * 32; k++) {
+			if(data[k * 2 + 0] != (uint8_t)(k & 0xff) || data[k * 2 + 1] != (uint8_t)(k >> 8)) return false;
+		}
+	} else {
+		if(size <= name.size() || memcmp(data, name.get(), name.size())) return false;
+	}
+	return true;
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -66,6 +88,367 @@ int32_t main(int32_t argc, char **argv) {
 		}
 	}
 	
+	// parallel decompression
+	if(1) {
+		
+		const char *names[] = { "test_archive.tar.gz", "test_archive.zip" };
+		
+		for(uint32_t i = 0; i < TS_COUNTOF(names); i++) {
+			
+			TS_LOG(Message, "\n");
+			
+			ArchiveBatch batch;
+			if(!batch.open(names[i])) return 1;
+			
+			Array<uint32_t> indices;
+			for(uint32_t j = 0; j < batch.getNumFiles(); j++) {
+				indices.append(batch.getNumFiles() - j - 1);
+			}
+			
+			ThreadPool pool(4);
+			
+			// Blobs under a budget smaller than two entries
+			uint32_t counter = 0;
+			batch.setBudget(1024 * 96);
+			if(!batch.decompress(pool, indices.get(), indices.size(), [&](uint32_t j, Blob &blob) {
+				String name = batch.getFileName(indices[j]);
+				Array<uint8_t> data(blob.getSize());
+				if(j != counter++ || blob.read(data.get(), data.size()) != data.size() || !check_file(name, data.get(), data.size())) counter = Maxu32;
+			})) return 1;
+			if(counter != indices.size()) return 2;
+			
+			// caller-provided buffers
+			Array<Array<uint8_t>> data(indices.size());
+			Array<uint8_t*> buffers(indices.size());
+			for(uint32_t j = 0; j < indices.size(); j++) {
+				data[j].resize(batch.getFileSize(indices[j]));
+				buffers[j] = data[j].get();
+			}
+			counter = 0;
+			if(!batch.decompress(pool, indices.get(), indices.size(), buffers.get(), [&](uint32_t j, size_t size) {
+				if(j != counter++ || !check_file(batch.getFileName(indices[j]), buffers[j], size)) counter = Maxu32;
+			})) return 1;
+			if(counter != indices.size()) return 2;
+			
+			TS_LOGF(Message, "%s: %u files in order\n", names[i], indices.size());
+		}
+	}
+	
+	// parallel decompression benchmark
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		const char *names[] = { "test_archive.tar.gz", "test_archive.zip" };
+		
+		for(uint32_t i = 0; i < TS_COUNTOF(names); i++) {
+			
+			ArchiveBatch batch;
+			if(!batch.open(names[i])) return 1;
+			
+			// repeated binary entries
+			Array<uint32_t> indices;
+			for(uint32_t j = 0; indices.size() < 1024; j = (j + 1) % batch.getNumFiles()) {
+				if(batch.getFileName(j).extension() != "txt") indices.append(j);
+			}
+			
+			size_t size = 0;
+			Array<Array<uint8_t>> data(indices.size());
+			Array<uint8_t*> buffers(indices.size());
+			for(uint32_t j = 0; j < indices.size(); j++) {
+				data[j].resize(batch.getFileSize(indices[j]));
+				buffers[j] = data[j].get();
+				size += data[j].size();
+			}
+			
+			// sequential reading
+			{
+				Archive archive;
+				if(!archive.open(names[i])) return 1;
+				uint64_t begin = Time::current();
+				for(uint32_t j = 0; j < indices.size(); j++) {
+					Stream stream = archive.openFile(archive.getFileName(indices[j]).get());
+					if(!stream || stream.read(buffers[j], data[j].size()) != data[j].size()) return 1;
+				}
+				uint64_t time = Time::current() - begin;
+				TS_LOGF(Message, "%s: %s sequential: %s %.1f MB/s\n", names[i], String::fromBytes(size).get(), String::fromTime(time).get(), size / (float64_t)max(time, (uint64_t)1));
+			}
+			
+			// thread pool
+			uint32_t num_threads[] = { 1, 2, 4, 8, 16 };
+			for(uint32_t j = 0; j < TS_COUNTOF(num_threads); j++) {
+				if(j && num_threads[j] > Async::getNumCores()) break;
+				
+				ThreadPool pool(num_threads[j]);
+				
+				uint64_t begin = Time::current();
+				if(!batch.decompress(pool, indices.get(), indices.size(), buffers.get())) return 1;
+				uint64_t buffers_time = Time::current() - begin;
+				
+				batch.setBudget(1024 * 1024 * 8);
+				begin = Time::current();
+				if(!batch.decompress(pool, indices.get(), indices.size(), [](uint32_t, Blob&) { })) return 1;
+				uint64_t blobs_time = Time::current() - begin;
+				
+				TS_LOGF(Message, "%s: %2u threads: buffers %.1f MB/s blobs %.1f MB/s\n", names[i], num_threads[j], size / (float64_t)max(buffers_time, (uint64_t)1), size / (float64_t)max(blobs_time, (uint64_t)1));
+			}
+			
+			for(uint32_t j = 0; j < indices.size(); j++) {
+				if(!check_file(batch.getFileName(indices[j]), buffers[j], data[j].size())) return 2;
+			}
+		}
+	}
+	
+	// hashed name index
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		const char *names[] = { "test_archive.tar", "test_archive.tar.gz", "test_archive.zip" };
+		
+		for(uint32_t i = 0; i < TS_COUNTOF(names); i++) {
+			
+			String cache = String(names[i]) + ".index";
+			remove(cache.get());
+			
+			// scan the archive and save the cache
+			ArchiveIndex index;
+			if(!index.open(names[i], cache.get())) return 1;
+			if(!index.isLoaded()) return 2;
+			
+			// reopen from the cache
+			ArchiveIndex cached;
+			if(!cached.open(names[i], cache.get())) return 1;
+			if(cached.isLoaded() || cached.getNumFiles() != index.getNumFiles()) return 2;
+			
+			Archive archive;
+			if(!archive.open(names[i])) return 1;
+			for(uint32_t j = 0; j < archive.getNumFiles(); j++) {
+				String name = archive.getFileName(j);
+				uint32_t k = cached.findFile(name.get());
+				if(k == Maxu32 || cached.getFileName(k) != name || index.findFile(name.get()) != k) return 2;
+				if(cached.getFileSize(k) != archive.getFileSize(j) || cached.getFileMTime(k) != archive.getFileMTime(j)) return 2;
+			}
+			if(cached.isFile("not_found.txt") || cached.findFile("") != Maxu32) return 2;
+			
+			// open files through the cached index
+			for(uint32_t j = 0; j < cached.getNumFiles(); j++) {
+				Stream stream = cached.openFile(cached.getFileName(j).get());
+				if(!stream) return 1;
+				Array<uint8_t> data(cached.getFileSize(j));
+				if(stream.read(data.get(), data.size()) != data.size() || !check_file(cached.getFileName(j), data.get(), data.size())) return 2;
+			}
+			if(!cached.isLoaded()) return 2;
+			
+			// lookup time
+			uint32_t counter = 0;
+			uint64_t begin = Time::current();
+			for(uint32_t j = 0; j < 1024; j++) {
+				for(uint32_t k = 0; k < archive.getNumFiles(); k++) {
+					String name = archive.getFileName(k);
+					for(uint32_t l = 0; l < archive.getNumFiles(); l++) {
+						if(archive.getFileName(l) == name) { counter += l; break; }
+					}
+				}
+			}
+			uint64_t linear_time = Time::current() - begin;
+			begin = Time::current();
+			for(uint32_t j = 0; j < 1024; j++) {
+				for(uint32_t k = 0; k < cached.getNumFiles(); k++) {
+					counter -= cached.findFile(cached.getFileName(k).get());
+				}
+			}
+			uint64_t hashed_time = Time::current() - begin;
+			if(counter != 0) return 2;
+			
+			TS_LOGF(Message, "%s: %u files linear %s hashed %s\n", names[i], cached.getNumFiles(), String::fromTime(linear_time).get(), String::fromTime(hashed_time).get());
+		}
+	}
+	
+	// memory-mapped entries
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		const char *names[] = { "test_archive.tar", "test_archive.tar.gz", "test_archive.zip" };
+		
+		for(uint32_t i = 0; i < TS_COUNTOF(names); i++) {
+			
+			ArchiveMapping mapping;
+			if(!mapping.open(names[i])) return 1;
+			
+			// mapped data and streams
+			size_t size = 0;
+			for(uint32_t j = 0; j < mapping.getNumFiles(); j++) {
+				const String &name = mapping.getFileName(j);
+				Array<uint8_t> data(mapping.getFileSize(j));
+				Stream stream = mapping.copyFile(name.get());
+				if(!stream || stream.read(data.get(), data.size()) != data.size() || !check_file(name, data.get(), data.size())) return 2;
+				if(mapping.isMapped(j)) {
+					if(!check_file(name, mapping.getFileData(j), mapping.getFileSize(j))) return 2;
+					size += mapping.getFileSize(j);
+				} else if(mapping.getFileData(j) != nullptr) {
+					return 2;
+				}
+			}
+			
+			// mapped data checksum time
+			uint32_t checksum = 0;
+			uint64_t begin = Time::current();
+			for(uint32_t j = 0; j < mapping.getNumFiles(); j++) {
+				const uint8_t *data = mapping.getFileData(j);
+				if(data == nullptr) continue;
+				for(size_t k = 0; k < mapping.getFileSize(j); k++) checksum += data[k];
+			}
+			uint64_t time = Time::current() - begin;
+			
+			TS_LOGF(Message, "%s: %u of %u files mapped %s %s (%08x)\n", names[i], mapping.getNumMappedFiles(), mapping.getNumFiles(), String::fromBytes(size).get(), String::fromTime(time).get(), checksum);
+		}
+		
+		// corrupted central directory leaves no partial mapping
+		{
+			Array<uint8_t> data;
+			{
+				Source source;
+				if(!source.open("test_archive.zip")) return 1;
+				data.resize((uint32_t)source.getSize());
+				if(source.read(data.get(), data.size()) != data.size()) return 1;
+			}
+			uint32_t num_headers = 0;
+			for(uint32_t i = 0; i + 4 <= data.size(); i++) {
+				if(memcmp(data.get() + i, "PK\x01\x02", 4) || num_headers++ != 1) continue;
+				memcpy(data.get() + i, "PK\x00\x00", 4);
+				break;
+			}
+			{
+				File file;
+				if(!file.open("test_archive_corrupted.zip", "wb") || file.write(data.get(), data.size()) != data.size()) return 1;
+			}
+			ArchiveMapping mapping;
+			if(mapping.open("test_archive_corrupted.zip")) {
+				if(mapping.getNumMappedFiles()) return 2;
+				for(uint32_t i = 0; i < mapping.getNumFiles(); i++) {
+					if(mapping.isMapped(i) || mapping.getFileData(i)) return 2;
+				}
+			}
+			remove("test_archive_corrupted.zip");
+		}
+	}
+	
+	// gzip seek index
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		const char *name = "test_archive.tar.gz";
+		
+		// build the index and save the caches
+		remove("test_archive.tar.gz.index");
+		remove("test_archive.tar.gz.seek");
+		GzipArchive archive;
+		if(!archive.open(name, "test_archive.tar.gz.index", "test_archive.tar.gz.seek", 1024 * 64)) return 1;
+		
+		// reopen from the caches
+		GzipArchive cached;
+		if(!cached.open(name, "test_archive.tar.gz.index", "test_archive.tar.gz.seek")) return 1;
+		if(cached.getNumCheckpoints() != archive.getNumCheckpoints()) return 2;
+		
+		// random access in the reverse order
+		for(uint32_t i = cached.getNumFiles(); i > 0; i--) {
+			const String &file_name = cached.getFileName(i - 1);
+			if(!cached.isIndexed(i - 1)) return 2;
+			Array<uint8_t> data(cached.getFileSize(i - 1));
+			Stream stream = cached.openFile(file_name.get());
+			if(!stream || stream.read(data.get(), data.size()) != data.size() || !check_file(file_name, data.get(), data.size())) return 2;
+		}
+		
+		// last file time
+		uint32_t index = cached.getNumFiles() - 1;
+		String file_name = cached.getFileName(index);
+		Array<uint8_t> data(cached.getFileSize(index));
+		{
+			Archive archive;
+			if(!archive.open(name)) return 1;
+			uint64_t begin = Time::current();
+			for(uint32_t i = 0; i < 64; i++) {
+				Stream stream = archive.openFile(file_name.get());
+				if(!stream || stream.read(data.get(), data.size()) != data.size()) return 1;
+			}
+			uint64_t archive_time = Time::current() - begin;
+			begin = Time::current();
+			for(uint32_t i = 0; i < 64; i++) {
+				if(!cached.readFile(index, data.get())) return 1;
+			}
+			uint64_t seek_time = Time::current() - begin;
+			if(!check_file(file_name, data.get(), data.size())) return 2;
+			TS_LOGF(Message, "%s: %u checkpoints %s: archive %s seek %s\n", name, cached.getNumCheckpoints(), file_name.get(), String::fromTime(archive_time / 64).get(), String::fromTime(seek_time / 64).get());
+		}
+		
+		// checkpoint outside of the archive rebuilds the index
+		{
+			Array<uint8_t> data;
+			{
+				Source source;
+				if(!source.open("test_archive.tar.gz.seek")) return 1;
+				data.resize((uint32_t)source.getSize());
+				if(source.read(data.get(), data.size()) != data.size()) return 1;
+			}
+			// the first checkpoint has no window
+			uint32_t offset = 28 + cached.getNumFiles() * 8 + 4 + 28;
+			if(cached.getNumCheckpoints() < 2 || offset + 8 > data.size()) return 2;
+			memset(data.get() + offset, 0xff, 8);
+			{
+				File file;
+				if(!file.open("test_archive.tar.gz.seek", "wb") || file.write(data.get(), data.size()) != data.size()) return 1;
+			}
+			GzipArchive rebuilt;
+			if(!rebuilt.open(name, "test_archive.tar.gz.index", "test_archive.tar.gz.seek", 1024 * 64)) return 1;
+			if(rebuilt.getNumCheckpoints() != archive.getNumCheckpoints()) return 2;
+			for(uint32_t i = 0; i < rebuilt.getNumFiles(); i++) {
+				Array<uint8_t> data(rebuilt.getFileSize(i));
+				if(!rebuilt.readFile(i, data.get()) || !check_file(rebuilt.getFileName(i), data.get(), data.size())) return 2;
+			}
+		}
+	}
+	
+	// cached entry locations
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		const char *names[] = { "test_archive.tar", "test_archive.tar.gz", "test_archive.zip" };
+		
+		for(uint32_t i = 0; i < TS_COUNTOF(names); i++) {
+			
+			String cache = String(names[i]) + ".index";
+			String location_cache = String(names[i]) + ".location";
+			remove(cache.get());
+			remove(location_cache.get());
+			
+			// scan the archive and save the caches
+			{
+				ArchiveReader reader;
+				if(!reader.open(names[i], cache.get(), location_cache.get())) return 1;
+			}
+			
+			// all files are read from the cached locations without opening the archive
+			uint64_t begin = Time::current();
+			ArchiveReader reader;
+			if(!reader.open(names[i], cache.get(), location_cache.get())) return 1;
+			for(uint32_t j = 0; j < reader.getNumFiles(); j++) {
+				const String &name = reader.getFileName(j);
+				if(!reader.isIndexed(j)) return 2;
+				Array<uint8_t> data(reader.getFileSize(j));
+				Stream stream = reader.openFile(name.get());
+				if(!stream || stream.read(data.get(), data.size()) != data.size() || !check_file(name, data.get(), data.size())) return 2;
+			}
+			if(reader.isLoaded()) return 2;
+			uint64_t time = Time::current() - begin;
+			
+			TS_LOGF(Message, "%s: %u files from the caches %s\n", names[i], reader.getNumFiles(), String::fromTime(time).get());
+		}
+	}
+	
 	// extern archive stream
 	if(1) {
 		
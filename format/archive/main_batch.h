@@ -0,0 +1,253 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_BATCH_H__
+#define __TELLUSIM_TESTS_ARCHIVE_BATCH_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimBlob.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimThread.h>
+#include <format/TellusimArchive.h>
+
+#include "main_pool.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class ArchiveBatch {
+			
+		public:
+			
+			/// open archive
+			/// every pool thread reads the entries through its own archive instance
+			bool open(const char *name) {
+				archives.clear();
+				archive_name = String(name);
+				if(!archives.append().open(name)) {
+					TS_LOGF(Error, "ArchiveBatch::open(): can't open %s archive\n", name);
+					archives.clear();
+					return false;
+				}
+				return true;
+			}
+			
+			/// archive files
+			uint32_t getNumFiles() const { return (archives.size()) ? archives[0].getNumFiles() : 0; }
+			String getFileName(uint32_t index) const { return archives[0].getFileName(index); }
+			size_t getFileSize(uint32_t index) const { return archives[0].getFileSize(index); }
+			
+			/// maximum size of the decompressed Blobs which are waiting for the callback
+			/// a single entry larger than the budget is decompressed alone
+			void setBudget(size_t size) { budget = max(size, (size_t)1); }
+			size_t getBudget() const { return budget; }
+			
+			/// decompresses the entries into the caller-provided buffers of getFileSize() bytes
+			/// the callback(i, size) calls are made in the indices order
+			/// the calls are serialized but can be made from any pool thread
+			bool decompress(ThreadPool &pool, const uint32_t *indices, uint32_t size, uint8_t **buffers) {
+				return run(pool, indices, size, buffers, [](uint32_t, Task&) { });
+			}
+			template <class Callback> bool decompress(ThreadPool &pool, const uint32_t *indices, uint32_t size, uint8_t **buffers, const Callback &callback) {
+				return run(pool, indices, size, buffers, [&callback](uint32_t i, Task &task) {
+					callback(i, task.size);
+				});
+			}
+			
+			/// decompresses the entries into Blobs
+			/// the callback(i, blob) calls are made in the indices order
+			/// the Blob memory is released after the callback unless it is moved out
+			template <class Callback> bool decompress(ThreadPool &pool, const uint32_t *indices, uint32_t size, const Callback &callback) {
+				return run(pool, indices, size, nullptr, [&callback](uint32_t i, Task &task) {
+					task.blob.seek(0);
+					callback(i, task.blob);
+				});
+			}
+			
+		private:
+			
+			enum {
+				ChunkSize = 1024 * 256,
+			};
+			
+			enum Status {
+				StatusPending = 0,
+				StatusDone,
+				StatusFailed,
+			};
+			
+			struct Task {
+				size_t size = 0;
+				Status status = StatusPending;
+				Blob blob;
+			};
+			
+			/// claims the entries in order under the memory budget and delivers them in order
+			template <class Deliver> bool run(ThreadPool &pool, const uint32_t *indices, uint32_t size, uint8_t **buffers, const Deliver &deliver) {
+				
+				if(archives.size() == 0) {
+					TS_LOG(Error, "ArchiveBatch::decompress(): archive is not opened\n");
+					return false;
+				}
+				
+				// archive per thread
+				uint32_t num_threads = min(pool.getNumThreads(), max(size, 1u));
+				while(archives.size() < num_threads) {
+					if(!archives.append().open(archive_name.get())) {
+						TS_LOGF(Error, "ArchiveBatch::decompress(): can't open %s archive\n", archive_name.get());
+						archives.removeBack();
+						return false;
+					}
+				}
+				chunks.resize(num_threads);
+				
+				// entry sizes
+				tasks.clear();
+				tasks.resize(size);
+				for(uint32_t i = 0; i < size; i++) {
+					if(indices[i] >= getNumFiles()) {
+						TS_LOGF(Error, "ArchiveBatch::decompress(): invalid %u index\n", indices[i]);
+						return false;
+					}
+					tasks[i].size = getFileSize(indices[i]);
+				}
+				
+				next_claim = 0;
+				next_deliver = 0;
+				in_flight = 0;
+				delivering = false;
+				failed = false;
+				
+				pool.dispatch(num_threads, 1, [&](uint32_t begin, uint32_t end) {
+					for(uint32_t slot = begin; slot < end; slot++) {
+						worker(slot, indices, size, buffers, deliver);
+					}
+				});
+				
+				tasks.clear();
+				
+				return !failed;
+			}
+			
+			template <class Deliver> void worker(uint32_t slot, const uint32_t *indices, uint32_t size, uint8_t **buffers, const Deliver &deliver) {
+				
+				Archive &archive = archives[slot];
+				
+				while(1) {
+					
+					// claim the next entry
+					// the budget is reserved in the claim order, so the entries before the waiting one are always deliverable
+					uint32_t i = Maxu32;
+					while(1) {
+						mutex.lock();
+						bool finished = (failed || next_claim == size);
+						if(!finished && (buffers || in_flight == 0 || in_flight + tasks[next_claim].size <= budget)) {
+							i = next_claim++;
+							in_flight += tasks[i].size;
+						}
+						mutex.unlock();
+						if(finished) return;
+						if(i != Maxu32) break;
+						Thread::yield();
+					}
+					
+					// decompress the entry
+					Task &task = tasks[i];
+					bool status = (buffers) ? read(archive, indices[i], buffers[i], task.size) : read(archive, slot, indices[i], task.blob, task.size);
+					
+					// deliver the completed entries
+					mutex.lock();
+					task.status = (status) ? StatusDone : StatusFailed;
+					if(delivering) {
+						mutex.unlock();
+						continue;
+					}
+					delivering = true;
+					while(!failed && next_deliver < size && tasks[next_deliver].status != StatusPending) {
+						uint32_t j = next_deliver++;
+						if(tasks[j].status == StatusFailed) {
+							failed = true;
+							break;
+						}
+						mutex.unlock();
+						deliver(j, tasks[j]);
+						tasks[j].blob = Blob();
+						mutex.lock();
+						in_flight -= tasks[j].size;
+					}
+					delivering = false;
+					mutex.unlock();
+				}
+			}
+			
+			/// read entry into the buffer
+			bool read(Archive &archive, uint32_t index, uint8_t *data, size_t size) {
+				String name = archive.getFileName(index);
+				Stream stream = archive.openFile(name.get());
+				if(!stream || stream.read(data, size) != size) {
+					TS_LOGF(Error, "ArchiveBatch::decompress(): can't read %s file\n", name.get());
+					return false;
+				}
+				return true;
+			}
+			
+			/// read entry into the Blob
+			bool read(Archive &archive, uint32_t slot, uint32_t index, Blob &blob, size_t size) {
+				String name = archive.getFileName(index);
+				Stream stream = archive.openFile(name.get());
+				if(!stream) {
+					TS_LOGF(Error, "ArchiveBatch::decompress(): can't open %s file\n", name.get());
+					return false;
+				}
+				Array<uint8_t> &chunk = chunks[slot];
+				chunk.resize(min(size, (size_t)ChunkSize));
+				for(size_t offset = 0; offset < size; offset += chunk.size()) {
+					size_t length = min(size - offset, (size_t)chunk.size());
+					if(stream.read(chunk.get(), length) != length || blob.write(chunk.get(), length) != length) {
+						TS_LOGF(Error, "ArchiveBatch::decompress(): can't read %s file\n", name.get());
+						return false;
+					}
+				}
+				return true;
+			}
+			
+			String archive_name;
+			Array<Archive> archives;
+			Array<Array<uint8_t>> chunks;
+			
+			size_t budget = 1024 * 1024 * 64;
+			
+			Mutex mutex;
+			
+			Array<Task> tasks;
+			uint32_t next_claim = 0;
+			uint32_t next_deliver = 0;
+			size_t in_flight = 0;
+			bool delivering = false;
+			bool failed = false;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_BATCH_H__ */
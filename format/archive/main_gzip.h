@@ -0,0 +1,311 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_GZIP_H__
+#define __TELLUSIM_TESTS_ARCHIVE_GZIP_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimFile.h>
+#include <core/TellusimBlob.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimSource.h>
+
+#include "main_inflate.h"
+#include "main_mapping.h"
+#include "main_tar.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class GzipArchive {
+			
+		public:
+			
+			enum {
+				DefaultSpan = 1024 * 1024 * 4,
+			};
+			
+			/// opens the tar.gz archive and builds the seek index on the first open
+			/// the seek index is loaded from the valid cache file without decompression
+			bool open(const char *name, const char *cache = nullptr, const char *seek_cache = nullptr, size_t span = DefaultSpan) {
+				clear();
+				if(!archive_index.open(name, cache)) return false;
+				if(!file.open(name)) {
+					TS_LOGF(Error, "GzipArchive::open(): can't map %s archive\n", name);
+					clear();
+					return false;
+				}
+				if(seek_cache && load(seek_cache)) return true;
+				if(!build(max(span, (size_t)GzipInflater::WindowSize))) {
+					TS_LOGF(Error, "GzipArchive::open(): can't index %s archive\n", name);
+					clear();
+					return false;
+				}
+				if(seek_cache && !save(seek_cache)) TS_LOGF(Warning, "GzipArchive::open(): can't save %s cache\n", seek_cache);
+				return true;
+			}
+			
+			void clear() {
+				archive_index.clear();
+				file.close();
+				checkpoints.clear();
+				offsets.clear();
+			}
+			
+			/// archive is opened
+			bool isLoaded() const { return archive_index.isLoaded(); }
+			
+			/// archive files
+			uint32_t getNumFiles() const { return archive_index.getNumFiles(); }
+			const String &getFileName(uint32_t index) const { return archive_index.getFileName(index); }
+			size_t getFileSize(uint32_t index) const { return archive_index.getFileSize(index); }
+			uint32_t findFile(const char *name) const { return archive_index.findFile(name); }
+			
+			/// seek index
+			uint32_t getNumCheckpoints() const { return checkpoints.size(); }
+			bool isIndexed(uint32_t index) const { return (offsets[index] != Maxu64); }
+			
+			/// reads the file starting from the nearest checkpoint
+			bool readFile(uint32_t index, uint8_t *data) const {
+				return read(index, [data](const uint8_t *src, size_t size, uint64_t offset) {
+					memcpy(data + offset, src, size);
+					return true;
+				});
+			}
+			
+			/// open file
+			/// indexed files are decompressed into a Blob from the nearest checkpoint
+			Stream openFile(const char *name) {
+				uint32_t index = findFile(name);
+				if(index == Maxu32) return Stream();
+				return openFile(index);
+			}
+			Stream openFile(uint32_t index) {
+				if(index >= offsets.size()) return Stream();
+				if(!isIndexed(index)) return archive_index.openFile(index);
+				Blob blob;
+				if(!read(index, [&blob](const uint8_t *src, size_t size, uint64_t offset) {
+					TS_UNUSED(offset);
+					return (blob.write(src, size) == size);
+				})) return Stream();
+				blob.seek(0);
+				return blob.move();
+			}
+			
+			/// save seek index cache
+			bool save(const char *name) const {
+				File file;
+				if(!file.open(name, "wb")) return false;
+				bool status = (file.writeu32(Magic) && file.writeu32(Version));
+				status = status && file.writeu64(archive_index.getArchiveSize()) && file.writeu64(archive_index.getArchiveHash());
+				status = status && file.writeu32(offsets.size());
+				for(uint32_t i = 0; status && i < offsets.size(); i++) {
+					status = file.writeu64(offsets[i]);
+				}
+				status = status && file.writeu32(checkpoints.size());
+				for(uint32_t i = 0; status && i < checkpoints.size(); i++) {
+					const GzipInflater::Checkpoint &checkpoint = checkpoints[i];
+					status = (file.writeu64(checkpoint.input) && file.writeu64(checkpoint.output) && file.writeu64(checkpoint.member));
+					status = status && file.writeu32(checkpoint.window.size());
+					status = status && (file.write(checkpoint.window.get(), checkpoint.window.size()) == checkpoint.window.size());
+				}
+				return status;
+			}
+			
+		private:
+			
+			enum {
+				Magic = 0x58535354,
+				Version = 1,
+			};
+			
+			/// decompresses the file range into the writer(data, size, offset) in order
+			template <class Writer> bool read(uint32_t index, const Writer &writer) const {
+				if(index >= offsets.size() || !isIndexed(index)) return false;
+				uint64_t begin = offsets[index];
+				uint64_t end = begin + getFileSize(index);
+				if(begin == end) return true;
+				
+				// nearest checkpoint
+				uint32_t left = 0;
+				uint32_t right = checkpoints.size();
+				while(left + 1 < right) {
+					uint32_t middle = (left + right) / 2;
+					if(checkpoints[middle].output <= begin) left = middle;
+					else right = middle;
+				}
+				
+				// file range
+				bool status = true;
+				auto consumer = [&](const uint8_t *src, size_t size, uint64_t offset) -> bool {
+					uint64_t src_begin = max(offset, begin);
+					uint64_t src_end = min(offset + size, end);
+					if(src_begin < src_end) status = writer(src + (src_begin - offset), (size_t)(src_end - src_begin), src_begin - begin);
+					return (status && offset + size < end);
+				};
+				GzipInflater inflater;
+				inflater.begin(file.getData(), file.getSize(), checkpoints[left]);
+				return (inflater.run(consumer) && status && inflater.getOutput() >= end);
+			}
+			
+			/// decompresses the archive once, records the checkpoints and scans the tar headers
+			bool build(size_t span) {
+				offsets.resize(getNumFiles());
+				for(uint32_t i = 0; i < offsets.size(); i++) offsets[i] = Maxu64;
+				
+				// tar header scanner
+				uint8_t header[TarHeader::Size];
+				uint32_t header_size = 0;
+				uint64_t skip = 0;
+				uint64_t meta = 0;
+				Array<char> meta_data;
+				Array<char> name;
+				uint8_t meta_type = 0;
+				bool finished = false;
+				auto consumer = [&](const uint8_t *src, size_t size, uint64_t offset) -> bool {
+					const uint8_t *src_end = src + size;
+					while(src < src_end && !finished) {
+						
+						// extended header data
+						if(meta) {
+							uint64_t length = min(meta, (uint64_t)(src_end - src));
+							uint32_t meta_size = meta_data.size();
+							meta_data.resize(meta_size + (uint32_t)length);
+							memcpy(meta_data.get() + meta_size, src, (size_t)length);
+							src += length;
+							meta -= length;
+							if(meta == 0) TarHeader::getLongName(meta_type, meta_data.get(), meta_data.size(), name);
+							continue;
+						}
+						
+						// file data and padding
+						if(skip) {
+							uint64_t length = min(skip, (uint64_t)(src_end - src));
+							src += length;
+							skip -= length;
+							continue;
+						}
+						
+						// file header
+						uint32_t length = min(TarHeader::Size - header_size, (uint32_t)(src_end - src));
+						memcpy(header + header_size, src, length);
+						header_size += length;
+						src += length;
+						if(header_size < TarHeader::Size) continue;
+						header_size = 0;
+						if(header[0] == 0) {
+							finished = true;
+							break;
+						}
+						uint64_t data_size = TarHeader::getSize(header);
+						uint64_t padding = ((data_size + TarHeader::Size - 1) & ~(uint64_t)(TarHeader::Size - 1)) - data_size;
+						uint8_t type = TarHeader::getType(header);
+						if(TarHeader::isLongName(type)) {
+							meta_type = type;
+							meta_data.clear();
+							meta = data_size;
+							skip = padding;
+							if(meta == 0) TarHeader::getLongName(meta_type, meta_data.get(), meta_data.size(), name);
+							continue;
+						}
+						if(TarHeader::isFile(type)) {
+							if(name.size() == 0) TarHeader::getName(header, name);
+							name.append('\0');
+							uint32_t index = findFile(name.get());
+							if(index != Maxu32 && getFileSize(index) == data_size) offsets[index] = offset + (size - (src_end - src));
+						}
+						name.clear();
+						skip = data_size + padding;
+					}
+					return true;
+				};
+				
+				GzipInflater inflater;
+				if(!inflater.begin(file.getData(), file.getSize())) return false;
+				return inflater.run(consumer, &checkpoints, span);
+			}
+			
+			/// load seek index cache
+			/// the cache is rejected if the archive size or hash is changed
+			bool load(const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				bool status = true;
+				if(source.readu32(&status) != Magic || !status) return false;
+				if(source.readu32(&status) != Version || !status) return false;
+				if(source.readu64(&status) != archive_index.getArchiveSize() || !status) return false;
+				if(source.readu64(&status) != archive_index.getArchiveHash() || !status) return false;
+				if(source.readu32(&status) != getNumFiles() || !status) return false;
+				offsets.resize(getNumFiles());
+				for(uint32_t i = 0; status && i < offsets.size(); i++) {
+					offsets[i] = source.readu64(&status);
+				}
+				uint32_t num_checkpoints = source.readu32(&status);
+				if(status) checkpoints.resize(num_checkpoints);
+				for(uint32_t i = 0; status && i < num_checkpoints; i++) {
+					GzipInflater::Checkpoint &checkpoint = checkpoints[i];
+					checkpoint.input = source.readu64(&status);
+					checkpoint.output = source.readu64(&status);
+					checkpoint.member = source.readu64(&status);
+					uint32_t size = source.readu32(&status);
+					if(!status || size > GzipInflater::WindowSize) status = false;
+					else checkpoint.window.resize(size);
+					status = status && (source.read(checkpoint.window.get(), size) == size);
+				}
+				if(!status || checkpoints.size() == 0) {
+					TS_LOGF(Warning, "GzipArchive::load(): %s cache is truncated\n", name);
+					checkpoints.clear();
+					offsets.clear();
+					return false;
+				}
+				
+				// the checkpoints are sorted and the inflater starts inside the archive with the whole member window
+				for(uint32_t i = 0; status && i < checkpoints.size(); i++) {
+					const GzipInflater::Checkpoint &checkpoint = checkpoints[i];
+					uint64_t pos = checkpoint.input >> 3;
+					if(pos > file.getSize() || (pos == file.getSize() && (checkpoint.input & 7))) status = false;
+					else if(checkpoint.output < checkpoint.member) status = false;
+					else if(checkpoint.window.size() != min(checkpoint.output - checkpoint.member, (uint64_t)GzipInflater::WindowSize)) status = false;
+					else if(i == 0 && checkpoint.output != 0) status = false;
+					else if(i > 0 && (checkpoint.input < checkpoints[i - 1].input || checkpoint.output < checkpoints[i - 1].output)) status = false;
+				}
+				if(!status) {
+					TS_LOGF(Warning, "GzipArchive::load(): %s cache has invalid checkpoints\n", name);
+					checkpoints.clear();
+					offsets.clear();
+					return false;
+				}
+				return true;
+			}
+			
+			ArchiveIndex archive_index;
+			MappedFile file;
+			
+			Array<GzipInflater::Checkpoint> checkpoints;
+			Array<uint64_t> offsets;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_GZIP_H__ */
@@ -0,0 +1,257 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_INDEX_H__
+#define __TELLUSIM_TESTS_ARCHIVE_INDEX_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimFile.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimSource.h>
+#include <format/TellusimArchive.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 * Hashed name index of the Archive directory
+	 *
+	 * The cache keeps only the directory: names, sizes and modification times.
+	 * Listings and lookups are served from the cache without touching the archive,
+	 * but the first openFile() call opens the Archive, which scans its directory again.
+	 * ArchiveReader serves the reads from the cached entry locations instead.
+	 */
+	class ArchiveIndex {
+			
+		public:
+			
+			/// opens the archive and builds the name index
+			/// the directory is loaded from the valid cache file without scanning the archive
+			bool open(const char *name, const char *cache = nullptr) {
+				clear();
+				archive_name = String(name);
+				if(!fingerprint(name, archive_size, archive_hash)) {
+					TS_LOGF(Error, "ArchiveIndex::open(): can't open %s archive\n", name);
+					return false;
+				}
+				if(cache && load(cache)) {
+					build();
+					return true;
+				}
+				if(!archive.open(name)) {
+					TS_LOGF(Error, "ArchiveIndex::open(): can't open %s archive\n", name);
+					clear();
+					return false;
+				}
+				loaded = true;
+				entries.resize(archive.getNumFiles());
+				for(uint32_t i = 0; i < entries.size(); i++) {
+					Entry &entry = entries[i];
+					entry.name = archive.getFileName(i);
+					entry.size = archive.getFileSize(i);
+					entry.mtime = archive.getFileMTime(i);
+				}
+				build();
+				if(cache && !save(cache)) TS_LOGF(Warning, "ArchiveIndex::open(): can't save %s cache\n", cache);
+				return true;
+			}
+			
+			void clear() {
+				archive.clear();
+				archive_name.clear();
+				archive_size = 0;
+				archive_hash = 0;
+				entries.clear();
+				table.clear();
+				loaded = false;
+			}
+			
+			/// archive is opened
+			bool isLoaded() const { return loaded; }
+			
+			/// archive size and hash of its modification time, head and tail
+			uint64_t getArchiveSize() const { return archive_size; }
+			uint64_t getArchiveHash() const { return archive_hash; }
+			
+			/// archive files
+			uint32_t getNumFiles() const { return entries.size(); }
+			const String &getFileName(uint32_t index) const { return entries[index].name; }
+			uint64_t getFileMTime(uint32_t index) const { return entries[index].mtime; }
+			size_t getFileSize(uint32_t index) const { return (size_t)entries[index].size; }
+			
+			/// file index or Maxu32 if the file is not found
+			uint32_t findFile(const char *name) const {
+				if(table.size() == 0) return Maxu32;
+				size_t length = strlen(name);
+				uint64_t hash = hash_name(name, length);
+				uint32_t mask = table.size() - 1;
+				for(uint32_t i = (uint32_t)hash & mask; table[i] != Maxu32; i = (i + 1) & mask) {
+					const Entry &entry = entries[table[i]];
+					if(entry.hash == hash && entry.name.size() == length && !memcmp(entry.name.get(), name, length)) return table[i];
+				}
+				return Maxu32;
+			}
+			bool isFile(const char *name) const {
+				return (findFile(name) != Maxu32);
+			}
+			
+			/// open file
+			/// the archive is opened and scanned on the first call after the cached open()
+			Stream openFile(const char *name) {
+				uint32_t index = findFile(name);
+				if(index == Maxu32) return Stream();
+				return openFile(index);
+			}
+			Stream openFile(uint32_t index) {
+				if(index >= entries.size()) return Stream();
+				if(!loaded) {
+					if(!archive.open(archive_name.get())) {
+						TS_LOGF(Error, "ArchiveIndex::openFile(): can't open %s archive\n", archive_name.get());
+						return Stream();
+					}
+					loaded = true;
+				}
+				return archive.openFile(entries[index].name.get());
+			}
+			
+			/// save directory cache
+			bool save(const char *name) const {
+				File file;
+				if(!file.open(name, "wb")) return false;
+				bool status = (file.writeu32(Magic) && file.writeu32(Version));
+				status = status && file.writeu64(archive_size) && file.writeu64(archive_hash);
+				status = status && file.writeu32(entries.size());
+				for(uint32_t i = 0; status && i < entries.size(); i++) {
+					const Entry &entry = entries[i];
+					status = (file.writeString(entry.name) && file.writeu64(entry.size) && file.writeu64(entry.mtime));
+				}
+				return status;
+			}
+			
+		private:
+			
+			enum {
+				Magic = 0x49415354,
+				Version = 2,
+				FingerprintSize = 1024 * 64,
+			};
+			
+			struct Entry {
+				String name;
+				uint64_t hash = 0;
+				uint64_t size = 0;
+				uint64_t mtime = 0;
+			};
+			
+			/// FNV-1a name hash
+			static uint64_t hash_name(const char *name, size_t length, uint64_t hash = 0xcbf29ce484222325ull) {
+				for(size_t i = 0; i < length; i++) {
+					hash = (hash ^ (uint8_t)name[i]) * 0x100000001b3ull;
+				}
+				return hash;
+			}
+			
+			/// archive size and hash of its modification time, head and tail
+			/// zip central directory and gzip trailer are at the tail, the modification time covers the edits in the middle
+			static bool fingerprint(const char *name, uint64_t &size, uint64_t &hash) {
+				#if _WIN32
+					struct _stat64 info;
+					if(_stat64(name, &info)) return false;
+				#else
+					struct stat info;
+					if(stat(name, &info)) return false;
+				#endif
+				uint64_t mtime = (uint64_t)info.st_mtime;
+				Source source;
+				if(!source.open(name)) return false;
+				size = source.getSize();
+				hash = hash_name((const char*)&size, sizeof(size));
+				hash = hash_name((const char*)&mtime, sizeof(mtime), hash);
+				Array<uint8_t> data(min(size, (uint64_t)FingerprintSize));
+				if(source.read(data.get(), data.size()) != data.size()) return false;
+				hash = hash_name((const char*)data.get(), data.size(), hash);
+				if(size > data.size()) {
+					if(!source.seek(size - data.size()) || source.read(data.get(), data.size()) != data.size()) return false;
+					hash = hash_name((const char*)data.get(), data.size(), hash);
+				}
+				return true;
+			}
+			
+			/// load directory cache
+			/// the cache is rejected if the archive size or hash is changed
+			bool load(const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				bool status = true;
+				if(source.readu32(&status) != Magic || !status) return false;
+				if(source.readu32(&status) != Version || !status) return false;
+				if(source.readu64(&status) != archive_size || !status) return false;
+				if(source.readu64(&status) != archive_hash || !status) return false;
+				uint32_t num_entries = source.readu32(&status);
+				if(!status) return false;
+				entries.resize(num_entries);
+				for(uint32_t i = 0; status && i < num_entries; i++) {
+					Entry &entry = entries[i];
+					entry.name = source.readString(&status);
+					entry.size = source.readu64(&status);
+					entry.mtime = source.readu64(&status);
+				}
+				if(!status) {
+					TS_LOGF(Warning, "ArchiveIndex::load(): %s cache is truncated\n", name);
+					entries.clear();
+				}
+				return status;
+			}
+			
+			/// open addressing table at most half full
+			void build() {
+				uint32_t size = 16;
+				while(size < entries.size() * 2) size *= 2;
+				table.resize(size);
+				for(uint32_t i = 0; i < size; i++) table[i] = Maxu32;
+				uint32_t mask = size - 1;
+				for(uint32_t i = 0; i < entries.size(); i++) {
+					Entry &entry = entries[i];
+					entry.hash = hash_name(entry.name.get(), entry.name.size());
+					uint32_t j = (uint32_t)entry.hash & mask;
+					while(table[j] != Maxu32) j = (j + 1) & mask;
+					table[j] = i;
+				}
+			}
+			
+			Archive archive;
+			String archive_name;
+			uint64_t archive_size = 0;
+			uint64_t archive_hash = 0;
+			
+			Array<Entry> entries;
+			Array<uint32_t> table;
+			
+			bool loaded = false;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_INDEX_H__ */
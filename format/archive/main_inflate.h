@@ -0,0 +1,411 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_INFLATE_H__
+#define __TELLUSIM_TESTS_ARCHIVE_INFLATE_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimArray.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class GzipInflater {
+			
+		public:
+			
+			enum {
+				WindowSize = 1024 * 32,
+				ChunkSize = 1024 * 64,
+			};
+			
+			/// decompression restart point at the deflate block boundary
+			/// the input is the bit offset, the window keeps the last output bytes of the member
+			struct Checkpoint {
+				uint64_t input = 0;
+				uint64_t output = 0;
+				uint64_t member = 0;
+				Array<uint8_t> window;
+			};
+			
+			GzipInflater() : window(WindowSize), chunk(ChunkSize) { }
+			
+			/// starts at the first gzip member
+			bool begin(const uint8_t *data, size_t size) {
+				src = data;
+				src_size = size;
+				pos = 0;
+				bit_buffer = 0;
+				bit_count = 0;
+				output = 0;
+				member = 0;
+				crc = 0;
+				check = true;
+				raw = false;
+				return header();
+			}
+			
+			/// starts at the raw deflate stream without the gzip framing
+			void beginDeflate(const uint8_t *data, size_t size) {
+				src = data;
+				src_size = size;
+				pos = 0;
+				bit_buffer = 0;
+				bit_count = 0;
+				output = 0;
+				member = 0;
+				crc = 0;
+				check = true;
+				raw = true;
+			}
+			
+			/// restarts at the checkpoint
+			/// the checksum of the member is verified only if the checkpoint is at its beginning
+			void begin(const uint8_t *data, size_t size, const Checkpoint &checkpoint) {
+				src = data;
+				src_size = size;
+				pos = (size_t)(checkpoint.input >> 3);
+				bit_buffer = 0;
+				bit_count = 0;
+				if(checkpoint.input & 7) {
+					fill(8);
+					drop(checkpoint.input & 7);
+				}
+				output = checkpoint.output;
+				member = checkpoint.member;
+				crc = 0;
+				check = (output == member);
+				raw = false;
+				uint32_t length = checkpoint.window.size();
+				for(uint32_t i = 0; i < length; i++) {
+					window[(uint32_t)(output - length + i) & (WindowSize - 1)] = checkpoint.window[i];
+				}
+			}
+			
+			/// decompresses the stream into the consumer(data, size, offset) until it returns false
+			/// checkpoints are appended at the block boundaries after every span bytes of output
+			template <class Consumer> bool run(Consumer &consumer, Array<Checkpoint> *checkpoints = nullptr, uint64_t span = 0) {
+				chunk_size = 0;
+				stopped = false;
+				while(!stopped) {
+					
+					// checkpoint
+					if(checkpoints && (checkpoints->size() == 0 || output - (*checkpoints)[checkpoints->size() - 1].output >= span)) {
+						Checkpoint &checkpoint = checkpoints->append();
+						checkpoint.input = (uint64_t)pos * 8 - bit_count;
+						checkpoint.output = output;
+						checkpoint.member = member;
+						uint32_t length = (uint32_t)min(output - member, (uint64_t)WindowSize);
+						checkpoint.window.resize(length);
+						for(uint32_t i = 0; i < length; i++) {
+							checkpoint.window[i] = window[(uint32_t)(output - length + i) & (WindowSize - 1)];
+						}
+					}
+					
+					// deflate block
+					if(!fill(3)) return error("unexpected end of stream");
+					uint32_t last = bits(1);
+					uint32_t type = bits(2);
+					bool status = false;
+					if(type == 0) status = stored(consumer);
+					else if(type == 1) status = fixed(consumer);
+					else if(type == 2) status = dynamic(consumer);
+					else return error("invalid block type");
+					if(!status) return false;
+					if(!last || stopped) continue;
+					if(!flush(consumer)) return true;
+					if(raw) break;
+					
+					// member trailer and the next member
+					drop(bit_count & 7);
+					uint8_t trailer[8];
+					for(uint32_t i = 0; i < 8; i++) {
+						if(!fill(8)) return error("unexpected end of stream");
+						trailer[i] = (uint8_t)bits(8);
+					}
+					if(check && read32(trailer) != crc) return error("invalid member checksum");
+					if(read32(trailer + 4) != (uint32_t)(output - member)) return error("invalid member size");
+					pos -= bit_count >> 3;
+					bit_buffer = 0;
+					bit_count = 0;
+					if(pos + 2 > src_size || src[pos] != 0x1f || src[pos + 1] != 0x8b) break;
+					member = output;
+					crc = 0;
+					check = true;
+					if(!header()) return false;
+				}
+				return (stopped || flush(consumer));
+			}
+			
+			/// current output offset
+			uint64_t getOutput() const { return output; }
+			
+			/// CRC-32 of the member output
+			uint32_t getChecksum() const { return crc; }
+			
+		private:
+			
+			/// canonical Huffman code with the single lookup table
+			struct Huffman {
+				bool create(const uint8_t *lengths, uint32_t num) {
+					uint32_t count[16] = {};
+					for(uint32_t i = 0; i < num; i++) count[lengths[i]]++;
+					count[0] = 0;
+					int32_t left = 1;
+					uint32_t code[16] = {};
+					bits = 0;
+					for(uint32_t i = 1; i < 16; i++) {
+						left = (left << 1) - (int32_t)count[i];
+						if(left < 0) return false;
+						code[i] = (code[i - 1] + count[i - 1]) << 1;
+						if(count[i]) bits = i;
+					}
+					table.resize(1u << bits);
+					for(uint32_t i = 0; i < table.size(); i++) table[i] = 0;
+					for(uint32_t i = 0; i < num; i++) {
+						uint32_t length = lengths[i];
+						if(length == 0) continue;
+						uint32_t reversed = 0;
+						for(uint32_t j = 0, c = code[length]++; j < length; j++, c >>= 1) reversed = (reversed << 1) | (c & 1);
+						for(uint32_t j = reversed; j < table.size(); j += 1u << length) table[j] = (uint16_t)((i << 4) | length);
+					}
+					return true;
+				}
+				Array<uint16_t> table;
+				uint32_t bits = 0;
+			};
+			
+			/// CRC-32 of the member data
+			static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t size) {
+				static const struct Table {
+					Table() {
+						for(uint32_t i = 0; i < 256; i++) {
+							uint32_t value = i;
+							for(uint32_t j = 0; j < 8; j++) value = (value >> 1) ^ ((value & 1) ? 0xedb88320u : 0u);
+							data[i] = value;
+						}
+					}
+					uint32_t data[256];
+				} table;
+				crc = ~crc;
+				for(size_t i = 0; i < size; i++) crc = table.data[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+				return ~crc;
+			}
+			
+			static uint32_t read32(const uint8_t *src) { return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24); }
+			
+			bool error(const char *message) {
+				TS_LOGF(Error, "GzipInflater::run(): %s\n", message);
+				return false;
+			}
+			
+			/// bit stream
+			bool fill(uint32_t num) {
+				while(bit_count < num) {
+					if(pos >= src_size) return false;
+					bit_buffer |= (uint64_t)src[pos++] << bit_count;
+					bit_count += 8;
+				}
+				return true;
+			}
+			void drop(uint32_t num) {
+				bit_buffer >>= num;
+				bit_count -= num;
+			}
+			uint32_t bits(uint32_t num) {
+				uint32_t ret = (uint32_t)bit_buffer & ((1u << num) - 1);
+				drop(num);
+				return ret;
+			}
+			int32_t decode(const Huffman &huffman) {
+				if(huffman.bits == 0) return -1;
+				fill(huffman.bits);
+				uint32_t entry = huffman.table[(uint32_t)bit_buffer & ((1u << huffman.bits) - 1)];
+				uint32_t length = entry & 15;
+				if(length == 0 || length > bit_count) return -1;
+				drop(length);
+				return (int32_t)(entry >> 4);
+			}
+			
+			/// gzip member header
+			bool header() {
+				if(pos + 10 > src_size || src[pos] != 0x1f || src[pos + 1] != 0x8b || src[pos + 2] != 8) return error("invalid gzip header");
+				uint32_t flags = src[pos + 3];
+				pos += 10;
+				if(flags & 0x04) {
+					if(pos + 2 > src_size) return error("invalid gzip header");
+					pos += 2 + (src[pos] | (src[pos + 1] << 8));
+				}
+				for(uint32_t mask = 0x08; mask <= 0x10; mask <<= 1) {
+					if(flags & mask) {
+						while(pos < src_size && src[pos]) pos++;
+						pos++;
+					}
+				}
+				if(flags & 0x02) pos += 2;
+				if(pos > src_size) return error("invalid gzip header");
+				return true;
+			}
+			
+			/// output
+			template <class Consumer> bool flush(Consumer &consumer) {
+				if(check && chunk_size) crc = crc32(crc, chunk.get(), chunk_size);
+				if(chunk_size && !consumer(chunk.get(), chunk_size, output - chunk_size)) stopped = true;
+				chunk_size = 0;
+				return !stopped;
+			}
+			template <class Consumer> bool put(Consumer &consumer, uint8_t value) {
+				window[(uint32_t)output & (WindowSize - 1)] = value;
+				chunk[chunk_size++] = value;
+				output++;
+				return (chunk_size < ChunkSize || flush(consumer));
+			}
+			
+			/// stored block
+			template <class Consumer> bool stored(Consumer &consumer) {
+				drop(bit_count & 7);
+				if(!fill(32)) return error("unexpected end of stream");
+				uint32_t length = bits(16);
+				if((length ^ bits(16)) != 0xffff) return error("invalid stored block");
+				for(; length && bit_count; length--) {
+					if(!put(consumer, (uint8_t)bits(8))) return true;
+				}
+				if(pos + length > src_size) return error("unexpected end of stream");
+				for(; length; length--) {
+					if(!put(consumer, src[pos++])) return true;
+				}
+				return true;
+			}
+			
+			/// fixed Huffman block
+			template <class Consumer> bool fixed(Consumer &consumer) {
+				if(fixed_literals.bits == 0) {
+					uint8_t lengths[288 + 30];
+					for(uint32_t i = 0; i < 288; i++) lengths[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8;
+					for(uint32_t i = 0; i < 30; i++) lengths[288 + i] = 5;
+					fixed_literals.create(lengths, 288);
+					fixed_distances.create(lengths + 288, 30);
+				}
+				return codes(consumer, fixed_literals, fixed_distances);
+			}
+			
+			/// dynamic Huffman block
+			template <class Consumer> bool dynamic(Consumer &consumer) {
+				static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+				if(!fill(14)) return error("unexpected end of stream");
+				uint32_t num_literals = bits(5) + 257;
+				uint32_t num_distances = bits(5) + 1;
+				uint32_t num_codes = bits(4) + 4;
+				if(num_literals > 286 || num_distances > 30) return error("invalid code lengths");
+				uint8_t lengths[286 + 30] = {};
+				for(uint32_t i = 0; i < num_codes; i++) {
+					if(!fill(3)) return error("unexpected end of stream");
+					lengths[order[i]] = (uint8_t)bits(3);
+				}
+				if(!code_lengths.create(lengths, 19)) return error("invalid code lengths");
+				for(uint32_t i = 0; i < 19; i++) lengths[i] = 0;
+				for(uint32_t i = 0; i < num_literals + num_distances;) {
+					int32_t symbol = decode(code_lengths);
+					if(symbol < 0) return error("invalid code lengths");
+					if(symbol < 16) {
+						lengths[i++] = (uint8_t)symbol;
+						continue;
+					}
+					uint32_t value = 0;
+					uint32_t repeat = 0;
+					if(symbol == 16) {
+						if(i == 0) return error("invalid code lengths");
+						value = lengths[i - 1];
+						if(!fill(2)) return error("unexpected end of stream");
+						repeat = 3 + bits(2);
+					} else if(symbol == 17) {
+						if(!fill(3)) return error("unexpected end of stream");
+						repeat = 3 + bits(3);
+					} else {
+						if(!fill(7)) return error("unexpected end of stream");
+						repeat = 11 + bits(7);
+					}
+					if(i + repeat > num_literals + num_distances) return error("invalid code lengths");
+					while(repeat--) lengths[i++] = (uint8_t)value;
+				}
+				if(lengths[256] == 0) return error("missing end of block code");
+				if(!literals.create(lengths, num_literals) || !distances.create(lengths + num_literals, num_distances)) return error("invalid code lengths");
+				return codes(consumer, literals, distances);
+			}
+			
+			/// compressed data
+			template <class Consumer> bool codes(Consumer &consumer, const Huffman &literals, const Huffman &distances) {
+				static const uint16_t length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+				static const uint8_t length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+				static const uint16_t distance_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+				static const uint8_t distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+				while(1) {
+					int32_t symbol = decode(literals);
+					if(symbol < 0) return error("invalid literal code");
+					if(symbol < 256) {
+						if(!put(consumer, (uint8_t)symbol)) return true;
+						continue;
+					}
+					if(symbol == 256) return true;
+					symbol -= 257;
+					if(symbol >= 29) return error("invalid length code");
+					if(!fill(length_extra[symbol])) return error("unexpected end of stream");
+					uint32_t length = length_base[symbol] + bits(length_extra[symbol]);
+					symbol = decode(distances);
+					if(symbol < 0 || symbol >= 30) return error("invalid distance code");
+					if(!fill(distance_extra[symbol])) return error("unexpected end of stream");
+					uint32_t distance = distance_base[symbol] + bits(distance_extra[symbol]);
+					if(distance > output - member) return error("invalid distance");
+					while(length--) {
+						if(!put(consumer, window[(uint32_t)(output - distance) & (WindowSize - 1)])) return true;
+					}
+				}
+			}
+			
+			const uint8_t *src = nullptr;
+			size_t src_size = 0;
+			size_t pos = 0;
+			uint64_t bit_buffer = 0;
+			uint32_t bit_count = 0;
+			
+			uint64_t output = 0;
+			uint64_t member = 0;
+			uint32_t crc = 0;
+			bool check = false;
+			bool raw = false;
+			Array<uint8_t> window;
+			Array<uint8_t> chunk;
+			uint32_t chunk_size = 0;
+			bool stopped = false;
+			
+			Huffman code_lengths;
+			Huffman literals;
+			Huffman distances;
+			Huffman fixed_literals;
+			Huffman fixed_distances;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_INFLATE_H__ */
@@ -0,0 +1,448 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_MAPPING_H__
+#define __TELLUSIM_TESTS_ARCHIVE_MAPPING_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimFile.h>
+#include <core/TellusimBlob.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimSource.h>
+
+#if _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#include "main_index.h"
+#include "main_inflate.h"
+#include "main_tar.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class MappedFile {
+			
+		public:
+			
+			MappedFile() { }
+			~MappedFile() { close(); }
+			
+			MappedFile(const MappedFile&) = delete;
+			MappedFile &operator=(const MappedFile&) = delete;
+			
+			/// maps the whole file for reading
+			bool open(const char *name) {
+				close();
+				#if _WIN32
+					HANDLE file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+					if(file == INVALID_HANDLE_VALUE) return false;
+					LARGE_INTEGER length;
+					if(!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+						CloseHandle(file);
+						return false;
+					}
+					HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					CloseHandle(file);
+					if(mapping == nullptr) return false;
+					data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					CloseHandle(mapping);
+					if(data == nullptr) return false;
+					size = (size_t)length.QuadPart;
+				#else
+					int32_t file = ::open(name, O_RDONLY);
+					if(file < 0) return false;
+					struct stat info;
+					if(fstat(file, &info) || info.st_size == 0) {
+						::close(file);
+						return false;
+					}
+					void *address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+					::close(file);
+					if(address == MAP_FAILED) return false;
+					data = (const uint8_t*)address;
+					size = (size_t)info.st_size;
+				#endif
+				return true;
+			}
+			
+			void close() {
+				if(data == nullptr) return;
+				#if _WIN32
+					UnmapViewOfFile(data);
+				#else
+					munmap((void*)data, size);
+				#endif
+				data = nullptr;
+				size = 0;
+			}
+			
+			/// hints the system to read the range ahead
+			void prefetch(size_t offset, size_t length) const {
+				#if !_WIN32
+					size_t page = (size_t)sysconf(_SC_PAGESIZE);
+					size_t begin = offset & ~(page - 1);
+					madvise((void*)(data + begin), offset + length - begin, MADV_WILLNEED);
+				#else
+					TS_UNUSED(offset);
+					TS_UNUSED(length);
+				#endif
+			}
+			
+			/// mapped data
+			const uint8_t *getData() const { return data; }
+			size_t getSize() const { return size; }
+			
+		private:
+			
+			const uint8_t *data = nullptr;
+			size_t size = 0;
+	};
+	
+	/*
+	 */
+	class ArchiveMapping {
+			
+		public:
+			
+			/// opens the archive and maps its entries
+			/// stored zip entries and plain tar entries are mapped, deflated zip entries are inflated from the mapping
+			/// the entry ranges are loaded from the valid cache file without parsing the archive
+			bool open(const char *name, const char *cache = nullptr, const char *range_cache = nullptr) {
+				clear();
+				if(!archive_index.open(name, cache)) return false;
+				ranges.resize(archive_index.getNumFiles());
+				if(!file.open(name)) {
+					TS_LOGF(Error, "ArchiveMapping::open(): can't map %s archive\n", name);
+					clear();
+					return false;
+				}
+				if(range_cache && load(range_cache)) return true;
+				
+				// the partial ranges of the failed parser are dropped
+				reset();
+				if(!parse_zip()) {
+					reset();
+					if(!parse_tar()) {
+						reset();
+						file.close();
+						return true;
+					}
+				}
+				if(range_cache && !save(range_cache)) TS_LOGF(Warning, "ArchiveMapping::open(): can't save %s cache\n", range_cache);
+				return true;
+			}
+			
+			void clear() {
+				archive_index.clear();
+				file.close();
+				ranges.clear();
+				num_mapped = 0;
+			}
+			
+			/// archive is opened
+			bool isLoaded() const { return archive_index.isLoaded(); }
+			
+			/// archive files
+			uint32_t getNumFiles() const { return archive_index.getNumFiles(); }
+			const String &getFileName(uint32_t index) const { return archive_index.getFileName(index); }
+			size_t getFileSize(uint32_t index) const { return archive_index.getFileSize(index); }
+			uint32_t findFile(const char *name) const { return archive_index.findFile(name); }
+			
+			/// files read from the mapping
+			bool isIndexed(uint32_t index) const { return (ranges[index].offset != Maxu64); }
+			
+			/// mapped files
+			uint32_t getNumMappedFiles() const { return num_mapped; }
+			bool isMapped(uint32_t index) const { return (isIndexed(index) && ranges[index].method == MethodStored); }
+			
+			/// file data aliasing the mapping or nullptr if the file is compressed
+			/// the data is valid until the archive is closed
+			const uint8_t *getFileData(uint32_t index) const {
+				if(!isMapped(index)) return nullptr;
+				return file.getData() + ranges[index].offset;
+			}
+			
+			/// hints the system to read the file ahead
+			void prefetchFile(uint32_t index) const {
+				if(isIndexed(index)) file.prefetch((size_t)ranges[index].offset, (size_t)ranges[index].size);
+			}
+			
+			/// file stream which does not alias the mapping
+			/// mapped files are copied and deflated files are inflated into a Blob without the archive reads
+			/// the remaining files are read through the Archive, use getFileData() for the zero-copy access
+			Stream copyFile(const char *name) {
+				uint32_t index = findFile(name);
+				if(index == Maxu32) return Stream();
+				return copyFile(index);
+			}
+			Stream copyFile(uint32_t index) {
+				if(index >= ranges.size()) return Stream();
+				if(!isIndexed(index)) return archive_index.openFile(index);
+				Blob blob;
+				size_t size = getFileSize(index);
+				if(isMapped(index)) {
+					if(blob.write(getFileData(index), size) != size) return Stream();
+				} else if(!inflate(index, blob)) {
+					return Stream();
+				}
+				blob.seek(0);
+				return blob.move();
+			}
+			
+			/// save range cache
+			bool save(const char *name) const {
+				File file;
+				if(!file.open(name, "wb")) return false;
+				bool status = (file.writeu32(Magic) && file.writeu32(Version));
+				status = status && file.writeu64(archive_index.getArchiveSize()) && file.writeu64(archive_index.getArchiveHash());
+				status = status && file.writeu32(ranges.size());
+				for(uint32_t i = 0; status && i < ranges.size(); i++) {
+					const Range &range = ranges[i];
+					status = (file.writeu64(range.offset) && file.writeu64(range.size) && file.writeu32(range.crc) && file.writeu32(range.method));
+				}
+				return status;
+			}
+			
+		private:
+			
+			enum {
+				Magic = 0x52415354,
+				Version = 1,
+			};
+			
+			enum Method {
+				MethodStored = 0,
+				MethodDeflated = 8,
+			};
+			
+			/// file data range, the size is the compressed size
+			struct Range {
+				uint64_t offset = Maxu64;
+				uint64_t size = 0;
+				uint32_t crc = 0;
+				uint32_t method = MethodStored;
+			};
+			
+			static uint32_t read16(const uint8_t *src) { return (uint32_t)src[0] | ((uint32_t)src[1] << 8); }
+			static uint32_t read32(const uint8_t *src) { return read16(src) | (read16(src + 2) << 16); }
+			static uint64_t read64(const uint8_t *src) { return (uint64_t)read32(src) | ((uint64_t)read32(src + 4) << 32); }
+			
+			/// unmaps all files
+			void reset() {
+				for(uint32_t i = 0; i < ranges.size(); i++) {
+					ranges[i] = Range();
+				}
+				num_mapped = 0;
+			}
+			
+			/// maps the file range if it matches the archive entry
+			void map(const char *name, size_t length, const Range &range) {
+				name_buffer.resize((uint32_t)length + 1);
+				memcpy(name_buffer.get(), name, length);
+				name_buffer[(uint32_t)length] = '\0';
+				uint32_t index = archive_index.findFile(name_buffer.get());
+				if(index == Maxu32 || isIndexed(index) || !is_valid(index, range)) return;
+				ranges[index] = range;
+				if(range.method == MethodStored) num_mapped++;
+			}
+			
+			/// the range is inside the mapping and the stored size matches the archive entry
+			bool is_valid(uint32_t index, const Range &range) const {
+				if(range.method != MethodStored && range.method != MethodDeflated) return false;
+				if(range.method == MethodStored && range.size != getFileSize(index)) return false;
+				return (range.offset <= file.getSize() && range.size <= file.getSize() - range.offset);
+			}
+			
+			/// inflates the deflated zip entry and verifies its size and checksum
+			bool inflate(uint32_t index, Blob &blob) const {
+				const Range &range = ranges[index];
+				GzipInflater inflater;
+				inflater.beginDeflate(file.getData() + range.offset, (size_t)range.size);
+				auto consumer = [&blob](const uint8_t *src, size_t size, uint64_t offset) -> bool {
+					TS_UNUSED(offset);
+					return (blob.write(src, size) == size);
+				};
+				if(!inflater.run(consumer)) return false;
+				if(inflater.getOutput() != getFileSize(index) || blob.getSize() != getFileSize(index) || inflater.getChecksum() != range.crc) {
+					TS_LOGF(Error, "ArchiveMapping::copyFile(): invalid %s file\n", getFileName(index).get());
+					return false;
+				}
+				return true;
+			}
+			
+			/// zip central directory
+			bool parse_zip() {
+				const uint8_t *data = file.getData();
+				size_t size = file.getSize();
+				if(size < 22 || read32(data) != 0x04034b50) return false;
+				
+				// end of central directory record followed by the comment
+				size_t end = size - 22;
+				while(read32(data + end) != 0x06054b50) {
+					if(end == 0 || size - end >= 22 + 0xffff) return false;
+					end--;
+				}
+				uint64_t num_entries = read16(data + end + 10);
+				uint64_t offset = read32(data + end + 16);
+				
+				// zip64 end of central directory
+				if((num_entries == 0xffff || offset == 0xffffffff) && end >= 20 && read32(data + end - 20) == 0x07064b50) {
+					uint64_t end64 = read64(data + end - 12);
+					if(end64 > size || size - end64 < 56 || read32(data + end64) != 0x06064b50) return false;
+					num_entries = read64(data + end64 + 32);
+					offset = read64(data + end64 + 48);
+				}
+				
+				// central directory headers
+				for(uint64_t i = 0; i < num_entries; i++) {
+					if(offset > size || size - offset < 46 || read32(data + offset) != 0x02014b50) return false;
+					const uint8_t *header = data + offset;
+					uint32_t flags = read16(header + 8);
+					uint32_t method = read16(header + 10);
+					uint32_t crc = read32(header + 16);
+					uint64_t compressed_size = read32(header + 20);
+					uint64_t uncompressed_size = read32(header + 24);
+					uint32_t name_length = read16(header + 28);
+					uint32_t extra_length = read16(header + 30);
+					uint32_t comment_length = read16(header + 32);
+					uint64_t local_offset = read32(header + 42);
+					offset += 46 + name_length + extra_length + comment_length;
+					if(offset > size) return false;
+					
+					// zip64 extended information
+					const uint8_t *extra = header + 46 + name_length;
+					for(uint32_t j = 0; j + 4 <= extra_length;) {
+						uint32_t id = read16(extra + j);
+						uint32_t length = read16(extra + j + 2);
+						const uint8_t *src = extra + j + 4;
+						const uint8_t *src_end = src + min(length, extra_length - j - 4);
+						if(id == 0x0001) {
+							if(uncompressed_size == 0xffffffff && src + 8 <= src_end) { uncompressed_size = read64(src); src += 8; }
+							if(compressed_size == 0xffffffff && src + 8 <= src_end) { compressed_size = read64(src); src += 8; }
+							if(local_offset == 0xffffffff && src + 8 <= src_end) { local_offset = read64(src); src += 8; }
+						}
+						j += 4 + length;
+					}
+					
+					// stored and deflated not encrypted entries
+					if((method != MethodStored && method != MethodDeflated) || (flags & 0x01)) continue;
+					if(method == MethodStored && compressed_size != uncompressed_size) continue;
+					if(local_offset > size || size - local_offset < 30 || read32(data + local_offset) != 0x04034b50) continue;
+					Range range;
+					range.offset = local_offset + 30 + read16(data + local_offset + 26) + read16(data + local_offset + 28);
+					range.size = compressed_size;
+					range.crc = crc;
+					range.method = method;
+					map((const char*)header + 46, name_length, range);
+				}
+				
+				return true;
+			}
+			
+			/// tar header table
+			bool parse_tar() {
+				const uint8_t *data = file.getData();
+				size_t size = file.getSize();
+				if(size < TarHeader::Size || memcmp(data + 257, "ustar", 5)) return false;
+				
+				Array<char> name;
+				for(uint64_t offset = 0; offset + TarHeader::Size <= size;) {
+					const uint8_t *header = data + offset;
+					if(header[0] == 0) break;
+					uint64_t length = TarHeader::getSize(header);
+					uint64_t data_offset = offset + TarHeader::Size;
+					if(length > size - data_offset) return false;
+					offset = data_offset + ((length + TarHeader::Size - 1) & ~(uint64_t)(TarHeader::Size - 1));
+					
+					// long names from GNU and pax extended headers
+					uint8_t type = TarHeader::getType(header);
+					if(TarHeader::isLongName(type)) {
+						TarHeader::getLongName(type, (const char*)data + data_offset, (size_t)length, name);
+						continue;
+					}
+					
+					// regular files
+					if(TarHeader::isFile(type)) {
+						Range range;
+						range.offset = data_offset;
+						range.size = length;
+						if(name.size() == 0) TarHeader::getName(header, name);
+						map(name.get(), name.size(), range);
+					}
+					name.clear();
+				}
+				
+				return true;
+			}
+			
+			/// load range cache
+			/// the cache is rejected if the archive size or hash is changed or a range is outside the mapping
+			bool load(const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				bool status = true;
+				if(source.readu32(&status) != Magic || !status) return false;
+				if(source.readu32(&status) != Version || !status) return false;
+				if(source.readu64(&status) != archive_index.getArchiveSize() || !status) return false;
+				if(source.readu64(&status) != archive_index.getArchiveHash() || !status) return false;
+				if(source.readu32(&status) != ranges.size() || !status) return false;
+				for(uint32_t i = 0; status && i < ranges.size(); i++) {
+					Range &range = ranges[i];
+					range.offset = source.readu64(&status);
+					range.size = source.readu64(&status);
+					range.crc = source.readu32(&status);
+					range.method = source.readu32(&status);
+					if(range.offset == Maxu64) {
+						range = Range();
+						continue;
+					}
+					status = status && is_valid(i, range);
+					if(range.method == MethodStored) num_mapped++;
+				}
+				if(!status) {
+					TS_LOGF(Warning, "ArchiveMapping::load(): %s cache is invalid\n", name);
+					reset();
+					return false;
+				}
+				return true;
+			}
+			
+			ArchiveIndex archive_index;
+			MappedFile file;
+			
+			Array<Range> ranges;
+			uint32_t num_mapped = 0;
+			
+			Array<char> name_buffer;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_MAPPING_H__ */
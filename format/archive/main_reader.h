@@ -0,0 +1,101 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_READER_H__
+#define __TELLUSIM_TESTS_ARCHIVE_READER_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimSource.h>
+
+#include "main_mapping.h"
+#include "main_gzip.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 * Archive reads served from the cached directory and entry locations
+	 *
+	 * tar.gz archives are read through the GzipArchive seek index,
+	 * zip and tar archives are read through the ArchiveMapping ranges.
+	 * Only the files without the known location open the Archive.
+	 */
+	class ArchiveReader {
+			
+		public:
+			
+			/// opens the archive with the directory cache and the seek index or range cache
+			bool open(const char *name, const char *cache = nullptr, const char *location_cache = nullptr) {
+				clear();
+				{
+					Source source;
+					uint8_t magic[2] = {};
+					if(!source.open(name)) {
+						TS_LOGF(Error, "ArchiveReader::open(): can't open %s archive\n", name);
+						return false;
+					}
+					gzip = (source.read(magic, sizeof(magic)) == sizeof(magic) && magic[0] == 0x1f && magic[1] == 0x8b);
+				}
+				if(gzip) return gzip_archive.open(name, cache, location_cache);
+				return mapping.open(name, cache, location_cache);
+			}
+			
+			void clear() {
+				gzip_archive.clear();
+				mapping.clear();
+				gzip = false;
+			}
+			
+			/// archive is opened
+			bool isLoaded() const { return (gzip) ? gzip_archive.isLoaded() : mapping.isLoaded(); }
+			
+			/// archive files
+			uint32_t getNumFiles() const { return (gzip) ? gzip_archive.getNumFiles() : mapping.getNumFiles(); }
+			const String &getFileName(uint32_t index) const { return (gzip) ? gzip_archive.getFileName(index) : mapping.getFileName(index); }
+			size_t getFileSize(uint32_t index) const { return (gzip) ? gzip_archive.getFileSize(index) : mapping.getFileSize(index); }
+			uint32_t findFile(const char *name) const { return (gzip) ? gzip_archive.findFile(name) : mapping.findFile(name); }
+			
+			/// file is read without the Archive
+			bool isIndexed(uint32_t index) const { return (gzip) ? gzip_archive.isIndexed(index) : mapping.isIndexed(index); }
+			
+			/// open file
+			Stream openFile(const char *name) {
+				uint32_t index = findFile(name);
+				if(index == Maxu32) return Stream();
+				return openFile(index);
+			}
+			Stream openFile(uint32_t index) {
+				if(index >= getNumFiles()) return Stream();
+				return (gzip) ? gzip_archive.openFile(index) : mapping.copyFile(index);
+			}
+			
+		private:
+			
+			GzipArchive gzip_archive;
+			ArchiveMapping mapping;
+			bool gzip = false;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_READER_H__ */
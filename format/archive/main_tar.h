@@ -0,0 +1,103 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_ARCHIVE_TAR_H__
+#define __TELLUSIM_TESTS_ARCHIVE_TAR_H__
+
+#include <core/TellusimArray.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 * Tar header fields shared by the mapped and the compressed archives
+	 */
+	class TarHeader {
+			
+		public:
+			
+			enum {
+				Size = 512,
+			};
+			
+			/// data size of the entry
+			static uint64_t getSize(const uint8_t *header) { return get_number(header + 124, 12); }
+			
+			/// entry type
+			static uint8_t getType(const uint8_t *header) { return header[156]; }
+			static bool isFile(uint8_t type) { return (type == '0' || type == 0); }
+			static bool isLongName(uint8_t type) { return (type == 'L' || type == 'x'); }
+			
+			/// ustar name with the prefix
+			static void getName(const uint8_t *header, Array<char> &name) {
+				uint32_t prefix_length = (uint32_t)strnlen((const char*)header + 345, 155);
+				uint32_t name_length = (uint32_t)strnlen((const char*)header, 100);
+				name.resize((prefix_length) ? prefix_length + 1 + name_length : name_length);
+				if(prefix_length) {
+					memcpy(name.get(), header + 345, prefix_length);
+					name[prefix_length++] = '/';
+				}
+				memcpy(name.get() + prefix_length, header, name_length);
+			}
+			
+			/// long name from the GNU or pax extended header data
+			/// the name is unchanged if the pax header has no path record
+			static void getLongName(uint8_t type, const char *data, size_t size, Array<char> &name) {
+				if(type == 'L') {
+					name.resize((uint32_t)strnlen(data, size));
+					memcpy(name.get(), data, name.size());
+					return;
+				}
+				const char *src = data;
+				const char *src_end = data + size;
+				while(src < src_end) {
+					const char *record = src;
+					size_t record_length = 0;
+					while(src < src_end && *src >= '0' && *src <= '9') record_length = record_length * 10 + (*src++ - '0');
+					if(record_length == 0 || record_length > (size_t)(src_end - record)) break;
+					if(src + 6 < record + record_length && !memcmp(src, " path=", 6)) {
+						name.resize((uint32_t)(record + record_length - src - 7));
+						memcpy(name.get(), src + 6, name.size());
+					}
+					src = record + record_length;
+				}
+			}
+			
+		private:
+			
+			/// octal or base-256 number
+			static uint64_t get_number(const uint8_t *src, uint32_t length) {
+				uint64_t ret = 0;
+				if(src[0] & 0x80) {
+					for(uint32_t i = 1; i < length; i++) ret = (ret << 8) | src[i];
+					return ret;
+				}
+				for(uint32_t i = 0; i < length && src[i]; i++) {
+					if(src[i] >= '0' && src[i] <= '7') ret = (ret << 3) | (src[i] - '0');
+				}
+				return ret;
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_ARCHIVE_TAR_H__ */
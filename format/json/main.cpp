@@ -21,12 +21,46 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimFile.h>
+#include <core/TellusimSource.h>
+#include <math/TellusimRandom.h>
 #include <format/TellusimJson.h>
 
+#if _LINUX
+	#include <unistd.h>
+#endif
+
+#include "main_reader.h"
+#include "main_scanner.h"
+#include "main_document.h"
+#include "main_cbor.h"
+
 /*
  */
 using namespace Tellusim;
 
+/*
+ */
+size_t get_memory() {
+	#if _LINUX
+		size_t pages = 0;
+		size_t resident = 0;
+		FILE *file = fopen("/proc/self/statm", "rb");
+		if(file == nullptr) return 0;
+		if(fscanf(file, "%zu %zu", &pages, &resident) != 2) resident = 0;
+		fclose(file);
+		return resident * (size_t)sysconf(_SC_PAGESIZE);
+	#else
+		return 0;
+	#endif
+}
+
+size_t get_memory(size_t begin) {
+	size_t end = get_memory();
+	return (end > begin) ? end - begin : 0;
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -98,5 +132,540 @@ int32_t main(int32_t argc, char **argv) {
 		if(!copy.save("test_save_b.json")) return 1;
 	}
 	
+	// streaming reader
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		// event log
+		struct LogHandler : public JsonReader::Handler {
+			bool beginObject() { events += "{"; return true; }
+			bool endObject() { events += "}"; return true; }
+			bool beginArray() { events += "["; return true; }
+			bool endArray() { events += "]"; return true; }
+			bool key(const JsonReader::View &name) { events += name.get() + ":"; return true; }
+			bool value(const JsonReader::Value &value) { events += value.getString() + ","; return true; }
+			String events;
+		};
+		
+		const char *src = " { \"a\" : [ 1, -2.5e3, true, false, null, \"x\\ty\\u00e9\\ud83d\\ude00\" ], \"b\": { }, \"c\": [ ], \"d\": { \"e\": [ [ ] ] } } ";
+		
+		JsonReader reader;
+		LogHandler handler;
+		if(!reader.parse(src, strlen(src), handler)) return 1;
+		TS_LOGF(Message, "events: %s\n", handler.events.get());
+		if(handler.events != "{a:[1,-2.5e3,true,false,null,x\ty\xc3\xa9\xf0\x9f\x98\x80,]b:{}c:[]d:{e:[[]]}}") return 1;
+		
+		// malformed unicode escapes
+		if(JsonReader::decode(JsonReader::View("a\\u00", 6)) != "a\xef\xbf\xbd" "00") return 1;
+		if(JsonReader::decode(JsonReader::View("\\u00g1", 6)) != "\xef\xbf\xbd" "00g1") return 1;
+		
+		// malformed inputs are rejected
+		const char *errors[] = { "", "{", "[1,]", "{\"a\" 1}", "[01]", "[1.]", "\"a", "[tru]", "{} {}", "[1 2]", "[\"a\x01\"]", "[true1]" };
+		for(uint32_t i = 0; i < TS_COUNTOF(errors); i++) {
+			JsonReader::Handler handler;
+			if(reader.parse(errors[i], strlen(errors[i]), handler)) return 1;
+		}
+		
+		// structural scanner produces the same events
+		JsonScanner scanner;
+		LogHandler scanner_handler;
+		if(!scanner.parse(src, strlen(src), scanner_handler)) return 1;
+		if(scanner_handler.events != handler.events) return 1;
+		for(uint32_t i = 0; i < TS_COUNTOF(errors); i++) {
+			JsonReader::Handler handler;
+			if(scanner.parse(errors[i], strlen(errors[i]), handler)) return 1;
+		}
+		
+		// escape sequences crossing the block boundaries
+		String str = "[";
+		for(uint32_t i = 0; i < 96; i++) {
+			str += "\"";
+			for(uint32_t j = 0; j < i % 61; j++) str += " ";
+			str += "\\\\\\\"";
+			for(uint32_t j = 0; j < i % 3; j++) str += "\\\\";
+			str += "\",";
+		}
+		str += "true]";
+		LogHandler reader_events;
+		LogHandler scanner_events;
+		if(!reader.parse(str.get(), str.size(), reader_events)) return 1;
+		if(!scanner.parse(str.get(), str.size(), scanner_events)) return 1;
+		if(scanner_events.events != reader_events.events) return 1;
+	}
+	
+	// streaming reader benchmark
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t num_frames = 200000;
+		const char *name = "test_reader.json";
+		
+		// telemetry frames
+		{
+			File file;
+			if(!file.open(name, "wb")) return 1;
+			file.puts("{\n\t\"name\": \"telemetry\",\n\t\"frames\": [\n");
+			for(uint32_t i = 0; i < num_frames; i++) {
+				file.puts(String::format("\t\t{ \"id\": %u, \"time\": %.3f, \"name\": \"frame \\\"%u\\\"\", \"position\": [ %.4f, %.4f, %.4f ], \"valid\": %s, \"parent\": null }%s\n",
+					i, i * 0.016, i, Tellusim::sin(i * 0.01f), Tellusim::cos(i * 0.01f), i * 0.001f, (i % 3) ? "true" : "false", (i + 1 < num_frames) ? "," : ""));
+			}
+			file.puts("\t]\n}\n");
+		}
+		
+		// frame fields
+		struct FrameHandler : public JsonReader::Handler {
+			bool beginObject() { depth++; return true; }
+			bool endObject() { depth--; return true; }
+			bool beginArray() { depth++; return true; }
+			bool endArray() { depth--; return true; }
+			bool key(const JsonReader::View &name) {
+				field = FieldUnknown;
+				if(depth != 3) return true;
+				if(name == "time") field = FieldTime;
+				else if(name == "valid") field = FieldValid;
+				else if(name == "name" && first_name.size() == 0) field = FieldName;
+				return true;
+			}
+			bool value(const JsonReader::Value &value) {
+				if(field == FieldTime) { time += value.getNumber(); num_frames++; }
+				else if(field == FieldValid) num_valid += value.getBool();
+				else if(field == FieldName) first_name = value.getString();
+				return true;
+			}
+			enum Field {
+				FieldUnknown = 0,
+				FieldTime,
+				FieldValid,
+				FieldName,
+			};
+			Field field = FieldUnknown;
+			uint32_t depth = 0;
+			uint32_t num_frames = 0;
+			uint32_t num_valid = 0;
+			float64_t time = 0.0;
+			String first_name;
+		};
+		
+		// single pass field extraction
+		size_t memory = get_memory();
+		uint64_t begin = Time::current();
+		FrameHandler handler;
+		size_t size = 0;
+		{
+			Source source;
+			if(!source.open(name)) return 1;
+			size = source.getSize();
+			Array<char> data(size);
+			if(source.read(data.get(), size) != size) return 1;
+			JsonReader reader;
+			if(!reader.parse(data.get(), size, handler)) return 1;
+			memory = get_memory(memory);
+		}
+		uint64_t reader_time = Time::current() - begin;
+		TS_LOGF(Message, "JsonReader: %s %s (%.1f MB/s) %s\n", String::fromBytes(size).get(), String::fromTime(reader_time).get(), size / (float64_t)max(reader_time, (uint64_t)1), String::fromBytes(memory).get());
+		TS_LOGF(Message, "frames: %u valid: %u time: %.1f first: %s\n", handler.num_frames, handler.num_valid, handler.time, handler.first_name.get());
+		if(handler.num_frames != num_frames || handler.num_valid != num_frames - (num_frames + 2) / 3) return 1;
+		if(handler.first_name != "frame \"0\"") return 1;
+		
+		// document tree
+		memory = get_memory();
+		begin = Time::current();
+		{
+			Json json;
+			if(!json.load(name)) return 1;
+			memory = get_memory(memory);
+		}
+		uint64_t load_time = Time::current() - begin;
+		TS_LOGF(Message, "Json::load: %s %s (%.1f MB/s) %s\n", String::fromBytes(size).get(), String::fromTime(load_time).get(), size / (float64_t)max(load_time, (uint64_t)1), String::fromBytes(memory).get());
+	}
+	
+	// arena document
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t num_frames = 200000;
+		const char *name = "test_reader.json";
+		
+		// arena nodes
+		uint64_t begin = Time::current();
+		JsonDocument document;
+		if(!document.load(name)) return 1;
+		uint64_t load_time = Time::current() - begin;
+		
+		begin = Time::current();
+		JsonDocument copy;
+		document.clone(copy);
+		uint64_t clone_time = Time::current() - begin;
+		
+		const JsonDocument::Node *frames = copy.getRoot()->getChild("frames");
+		if(frames == nullptr || frames->num_children != num_frames) return 1;
+		if(document.getString() != copy.getString()) return 1;
+		
+		size_t memory = document.getMemory();
+		begin = Time::current();
+		document.clear();
+		copy.clear();
+		uint64_t clear_time = Time::current() - begin;
+		TS_LOGF(Message, "JsonDocument: load %s clone %s clear %s (%s)\n", String::fromTime(load_time).get(), String::fromTime(clone_time).get(), String::fromTime(clear_time).get(), String::fromBytes(memory).get());
+		
+		// heap nodes
+		begin = Time::current();
+		Json *json = new Json();
+		if(!json->load(name)) return 1;
+		load_time = Time::current() - begin;
+		
+		begin = Time::current();
+		Json *json_copy = new Json(json->clonePtr());
+		clone_time = Time::current() - begin;
+		
+		begin = Time::current();
+		delete json;
+		delete json_copy;
+		clear_time = Time::current() - begin;
+		TS_LOGF(Message, "Json: load %s clone %s clear %s\n", String::fromTime(load_time).get(), String::fromTime(clone_time).get(), String::fromTime(clear_time).get());
+		
+		// programmatic construction and the source round trip
+		const char *src = "{\"a\\\"b\":[1,-2.5e3,true,false,null,\"x\\ty\"],\"c\":{},\"d\":[]}";
+		document.clear();
+		JsonDocument::Node *root = document.addChild(nullptr, nullptr, JsonDocument::TypeObject);
+		document.addChild(root, "e", JsonDocument::TypeNumber, "13");
+		if(document.getString() != "{\"e\":13}") return 1;
+		if(!document.create(src, strlen(src))) return 1;
+		document.clone(copy);
+		document.clear();
+		TS_LOGF(Message, "copy: %s\n", copy.getString().get());
+		if(copy.getString() != "{\"a\\\"b\":[1,-2.5e3,true,false,null,\"x\\u0009y\"],\"c\":{},\"d\":[]}") return 1;
+		
+		// deeply nested containers are written without recursion
+		String nested;
+		for(uint32_t i = 0; i < 1024 * 64; i++) nested += "[{\"a\":";
+		nested += "1";
+		for(uint32_t i = 0; i < 1024 * 64; i++) nested += "}]";
+		if(!document.create(nested.get(), nested.size()) || document.getString() != nested) return 1;
+	}
+	
+	// structural scanner
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		// correctly rounded numbers
+		Random<> random(1);
+		const char *numbers[] = { "0", "-0", "0.1", "1e23", "9007199254740993", "2.2250738585072011e-308", "4.9e-324", "2.4703282292062327e-324", "1.7976931348623157e308",
+			"1.7976931348623159e308", "123456789012345678901234567890", "0.000000000000000000000000000001", "7.2057594037927933e16", "1e-400", "3.14159265358979323846264338327950288" };
+		uint32_t num_numbers = 0;
+		uint32_t num_errors = 0;
+		for(uint32_t i = 0; i < TS_COUNTOF(numbers) + 100000; i++) {
+			String str;
+			if(i < TS_COUNTOF(numbers)) {
+				str = numbers[i];
+			} else {
+				if(random.geti32(0, 1)) str += "-";
+				uint32_t num_digits = (uint32_t)random.geti32(1, 24);
+				uint32_t point = (uint32_t)random.geti32(0, num_digits);
+				for(uint32_t j = 0; j < num_digits; j++) {
+					if(j == point && j) str += ".";
+					char digit[2] = { (char)('0' + random.geti32((j == 0 && num_digits > 1) ? 1 : 0, 9)), '\0' };
+					str += digit;
+				}
+				if(random.geti32(0, 1)) str += String::format("e%d", random.geti32(-330, 310));
+			}
+			float64_t value = 0.0;
+			float64_t reference = strtod(str.get(), nullptr);
+			const char *end = JsonNumber::parse(str.get(), str.get() + str.size(), value);
+			if(end != str.get() + str.size() || memcmp(&value, &reference, sizeof(value)) != 0) {
+				TS_LOGF(Error, "JsonNumber: %s %.17g != %.17g\n", str.get(), value, reference);
+				num_errors++;
+			}
+			num_numbers++;
+		}
+		TS_LOGF(Message, "JsonNumber: %u numbers %u errors\n", num_numbers, num_errors);
+		if(num_errors) return 1;
+		
+		// number-heavy data
+		constexpr uint32_t num_points = 400000;
+		const char *name = "test_scanner.json";
+		{
+			File file;
+			if(!file.open(name, "wb")) return 1;
+			file.puts("{\n\t\"name\": \"points\",\n\t\"points\": [\n");
+			for(uint32_t i = 0; i < num_points; i++) {
+				file.puts(String::format("\t\t[ %.7g, %.7g, %.7g, %.17g, %d ]%s\n", random.getf32(-1000.0f, 1000.0f), random.getf32(-1.0f, 1.0f), random.getf32(0.0f, 1e-3f),
+					random.getf32(-1.0f, 1.0f) * 1e-300, random.geti32(-100000, 100000), (i + 1 < num_points) ? "," : ""));
+			}
+			file.puts("\t]\n}\n");
+		}
+		
+		Array<char> data;
+		{
+			Source source;
+			if(!source.open(name)) return 1;
+			data.resize(source.getSize());
+			if(source.read(data.get(), data.size()) != data.size()) return 1;
+		}
+		const char *src = data.get();
+		size_t size = data.size();
+		
+		// number sum
+		struct SumHandler : public JsonReader::Handler {
+			bool value(const JsonReader::Value &value) {
+				if(value.type == JsonReader::TypeNumber) { sum += value.getNumber(); num_values++; }
+				return true;
+			}
+			float64_t sum = 0.0;
+			uint32_t num_values = 0;
+		};
+		
+		auto print_speed = [size](const char *name, uint64_t time) {
+			TS_LOGF(Message, "%s: %s %s (%.2f GB/s)\n", name, String::fromBytes(size).get(), String::fromTime(time).get(), size / (float64_t)max(time, (uint64_t)1) * 1e-3);
+		};
+		
+		// stage one, the first scan allocates the index
+		JsonScanner scanner;
+		if(!scanner.scan(src, size)) return 1;
+		uint64_t begin = Time::current();
+		if(!scanner.scan(src, size)) return 1;
+		print_speed("JsonScanner::scan", Time::current() - begin);
+		
+		// both stages
+		SumHandler scanner_handler;
+		begin = Time::current();
+		if(!scanner.parse(src, size, scanner_handler)) return 1;
+		print_speed("JsonScanner::parse", Time::current() - begin);
+		
+		// byte-by-byte reader
+		JsonReader reader;
+		SumHandler reader_handler;
+		begin = Time::current();
+		if(!reader.parse(src, size, reader_handler)) return 1;
+		print_speed("JsonReader::parse", Time::current() - begin);
+		
+		// arena document
+		JsonDocument document;
+		begin = Time::current();
+		if(!document.create(src, size)) return 1;
+		print_speed("JsonDocument::create", Time::current() - begin);
+		
+		// document tree
+		Json json;
+		begin = Time::current();
+		if(!json.load(name)) return 1;
+		print_speed("Json::load", Time::current() - begin);
+		
+		TS_LOGF(Message, "values: %u sum: %.17g\n", scanner_handler.num_values, scanner_handler.sum);
+		if(scanner_handler.num_values != num_points * 5 || reader_handler.num_values != num_points * 5) return 1;
+		if(scanner_handler.sum != reader_handler.sum) return 1;
+		
+		const JsonDocument::Node *points = document.getRoot()->getChild("points");
+		if(points == nullptr || points->num_children != num_points) return 1;
+		float64_t sum = 0.0;
+		for(const JsonDocument::Node *point = points->child; point; point = point->next) {
+			for(const JsonDocument::Node *node = point->child; node; node = node->next) sum += node->getNumber();
+		}
+		if(sum != scanner_handler.sum) return 1;
+	}
+	
+	// binary encoding
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		// scene snapshot
+		constexpr uint32_t num_meshes = 32;
+		constexpr uint32_t num_vertices = 8192;
+		Random<> random(1);
+		Array<float32_t> vertices(num_vertices * 8);
+		Array<uint32_t> indices(num_vertices * 3);
+		JsonDocument document;
+		JsonDocument::Node *root = document.addChild(nullptr, nullptr, JsonDocument::TypeObject);
+		document.addChild(root, "name", JsonDocument::TypeString, "scene \"snapshot\"");
+		document.addChild(root, "time", JsonDocument::TypeNumber, "1.5");
+		JsonDocument::Node *numbers = document.addChild(root, "values", JsonDocument::TypeArray);
+		for(const char *number : { "0.1", "1e+300", "-0", "18446744073709551615", "-9223372036854775808", "3.4028234663852886e+38" }) {
+			document.addChild(numbers, nullptr, JsonDocument::TypeNumber, number);
+		}
+		JsonDocument::Node *meshes = document.addChild(root, "meshes", JsonDocument::TypeArray);
+		for(uint32_t i = 0; i < num_meshes; i++) {
+			JsonDocument::Node *mesh = document.addChild(meshes, nullptr, JsonDocument::TypeObject);
+			document.addChild(mesh, "name", JsonDocument::TypeString, String::format("mesh %u", i).get());
+			document.addChild(mesh, "visible", JsonDocument::TypeBool, (i % 3) ? "true" : "false");
+			document.addChild(mesh, "parent", JsonDocument::TypeNull);
+			document.addChild(mesh, "lod", JsonDocument::TypeNumber, String::format("%d", (int32_t)i - 3).get());
+			for(uint32_t j = 0; j < vertices.size(); j++) vertices[j] = random.getf32(-1000.0f, 1000.0f);
+			for(uint32_t j = 0; j < indices.size(); j++) indices[j] = (uint32_t)random.geti32(0, num_vertices - 1);
+			document.addChild(mesh, "vertices", vertices.get(), vertices.size());
+			document.addChild(mesh, "indices", indices.get(), indices.size());
+		}
+		
+		// text round trip
+		uint64_t begin = Time::current();
+		String text = document.getString();
+		uint64_t save_time = Time::current() - begin;
+		begin = Time::current();
+		JsonDocument text_document;
+		if(!text_document.create(text.get(), text.size())) return 1;
+		uint64_t load_time = Time::current() - begin;
+		TS_LOGF(Message, "JSON: %s save %s load %s\n", String::fromBytes(text.size()).get(), String::fromTime(save_time).get(), String::fromTime(load_time).get());
+		
+		// binary round trip
+		Array<uint8_t> data;
+		begin = Time::current();
+		if(!JsonCbor::encode(document, data)) return 1;
+		save_time = Time::current() - begin;
+		begin = Time::current();
+		JsonDocument binary_document;
+		if(!JsonCbor::decode(binary_document, data.get(), data.size())) return 1;
+		load_time = Time::current() - begin;
+		begin = Time::current();
+		JsonDocument copy_document;
+		if(!JsonCbor::decode(copy_document, data.get(), data.size(), true)) return 1;
+		uint64_t copy_time = Time::current() - begin;
+		TS_LOGF(Message, "CBOR: %s save %s load %s (copy %s)\n", String::fromBytes(data.size()).get(), String::fromTime(save_time).get(), String::fromTime(load_time).get(), String::fromTime(copy_time).get());
+		
+		// typed arrays reference the encoded data
+		const JsonDocument::Node *mesh = binary_document.getRoot()->getChild("meshes")->child;
+		const float32_t *mesh_vertices = mesh->getChild("vertices")->getFloat32Array();
+		if(mesh_vertices == nullptr || (const uint8_t*)mesh_vertices < data.get() || (const uint8_t*)mesh_vertices >= data.get() + data.size()) return 1;
+		if(mesh->getChild("indices")->getUint32Array() == nullptr || mesh->getChild("indices")->num_children != num_vertices * 3) return 1;
+		
+		// both documents match the source
+		if(binary_document.getString() != text || copy_document.getString() != text) return 1;
+		JsonDocument clone;
+		binary_document.clone(clone);
+		if(clone.getString() != text) return 1;
+		
+		// generic CBOR items
+		const uint8_t items[] = { 0xa2, 0x61, 'a', 0x83, 0x01, 0x21, 0xf9, 0x3e, 0x00, 0x61, 'b', 0x9f, 0x7f, 0x61, 'a', 0x61, 'b', 0xff, 0xf5, 0xff };
+		if(!JsonCbor::decode(binary_document, items, sizeof(items))) return 1;
+		TS_LOGF(Message, "items: %s\n", binary_document.getString().get());
+		if(binary_document.getString() != "{\"a\":[1,-2,1.5],\"b\":[\"ab\",true]}") return 1;
+		
+		// malformed items are rejected
+		if(JsonCbor::decode(binary_document, items, sizeof(items) - 1)) return 1;
+		if(JsonCbor::decode(binary_document, data.get(), data.size() / 2)) return 1;
+		const uint8_t errors[][4] = { { 0xa1, 0x01, 0x01, 0x00 }, { 0x81, 0x01, 0x01, 0x00 }, { 0xd8, 0x55, 0x43, 0x00 }, { 0x5f, 0x00, 0x00, 0x00 } };
+		for(uint32_t i = 0; i < TS_COUNTOF(errors); i++) {
+			if(JsonCbor::decode(binary_document, errors[i], sizeof(errors[i]))) return 1;
+		}
+	}
+	
+	// number formatting
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		// shortest round trip of the random bit patterns
+		uint64_t state = 1;
+		auto get_bits = [&state]() -> uint64_t {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			return state;
+		};
+		// significant digits of the text
+		auto get_digits = [](const char *str) -> uint32_t {
+			uint32_t num_digits = 0;
+			uint32_t num_zeros = 0;
+			for(; *str && *str != 'e'; str++) {
+				if(*str < '0' || *str > '9' || (*str == '0' && num_digits == 0)) continue;
+				num_zeros = (*str == '0') ? num_zeros + 1 : 0;
+				num_digits++;
+			}
+			return num_digits - num_zeros;
+		};
+		
+		char str[JsonNumber::MaxLength];
+		char buffer[JsonNumber::MaxLength];
+		uint32_t num_errors = 0;
+		for(uint32_t i = 0; i < 200000; i++) {
+			uint64_t bits = get_bits();
+			float64_t value = 0.0;
+			memcpy(&value, &bits, sizeof(value));
+			if(!(value >= -Maxf64 && value <= Maxf64)) continue;
+			JsonNumber::format(str, value);
+			float64_t result = strtod(str, nullptr);
+			if(memcmp(&result, &value, sizeof(value)) != 0) num_errors++;
+			// no shorter text reads back
+			if(i % 16 == 0) {
+				uint32_t num_digits = 1;
+				for(; num_digits < 17; num_digits++) {
+					snprintf(buffer, sizeof(buffer), "%.*e", num_digits - 1, value);
+					if(strtod(buffer, nullptr) == value) break;
+				}
+				if(get_digits(str) != num_digits) num_errors++;
+			}
+		}
+		for(uint32_t i = 0; i < 200000; i++) {
+			uint32_t bits = (uint32_t)get_bits();
+			float32_t value = 0.0f;
+			memcpy(&value, &bits, sizeof(value));
+			if(!(value >= -Maxf32 && value <= Maxf32)) continue;
+			JsonNumber::format(str, value);
+			float32_t result = strtof(str, nullptr);
+			if(memcmp(&result, &value, sizeof(value)) != 0) num_errors++;
+		}
+		for(uint32_t i = 0; i < 200000; i++) {
+			int64_t value = (int64_t)get_bits() >> (i % 64);
+			JsonNumber::format(str, value);
+			snprintf(buffer, sizeof(buffer), "%lld", (long long)value);
+			if(strcmp(str, buffer) != 0) num_errors++;
+		}
+		const float64_t numbers[] = { 0.1, 1e23, 5e-324, 1e16, 1e17, 1e-5, -0.0, 9007199254740993.0 };
+		String text;
+		for(float64_t value : numbers) {
+			JsonNumber::format(str, value);
+			text += String(str) + " ";
+		}
+		TS_LOGF(Message, "numbers: %s\n", text.get());
+		if(text != "0.1 1e+23 5e-324 10000000000000000 1e+17 1e-05 -0 9007199254740992 ") return 1;
+		if(num_errors) return 1;
+		
+		// formatting speed
+		constexpr uint32_t size = 1000000;
+		Random<> random(1);
+		Array<float32_t> values(size);
+		for(uint32_t i = 0; i < size; i++) values[i] = random.getf32(-1000.0f, 1000.0f) * ((i % 4 == 0) ? 1e-6f : 1.0f);
+		
+		auto print_time = [](const char *name, uint64_t time, uint64_t printf_time) {
+			TS_LOGF(Message, "%s: %s (printf %s x%.1f)\n", name, String::fromTime(time).get(), String::fromTime(printf_time).get(), (float64_t)printf_time / max(time, (uint64_t)1));
+		};
+		
+		size_t length = 0;
+		uint64_t begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += snprintf(str, sizeof(str), "%.17g", values[i] / 3.0);
+		uint64_t printf_time = Time::current() - begin;
+		begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += JsonNumber::format(str, values[i] / 3.0);
+		print_time("float64", Time::current() - begin, printf_time);
+		
+		begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += snprintf(str, sizeof(str), "%.9g", values[i]);
+		printf_time = Time::current() - begin;
+		begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += JsonNumber::format(str, values[i]);
+		print_time("float32", Time::current() - begin, printf_time);
+		
+		begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += snprintf(str, sizeof(str), "%d", (int32_t)(values[i] * 1000.0f));
+		printf_time = Time::current() - begin;
+		begin = Time::current();
+		for(uint32_t i = 0; i < size; i++) length += JsonNumber::format(str, (int32_t)(values[i] * 1000.0f));
+		print_time("int32", Time::current() - begin, printf_time);
+		
+		// typed array export
+		JsonDocument document;
+		JsonDocument::Node *root = document.addChild(nullptr, nullptr, JsonDocument::TypeObject);
+		document.addChild(root, "time", 0.1);
+		document.addChild(root, "frame", 13u);
+		document.addChild(root, "values", values.get(), values.size());
+		begin = Time::current();
+		text = document.getString();
+		TS_LOGF(Message, "JsonDocument::getString: %s %s\n", String::fromBytes(text.size()).get(), String::fromTime(Time::current() - begin).get());
+		if(length == 0 || strncmp(text.get(), "{\"time\":0.1,\"frame\":13,\"values\":[", 33) != 0) return 1;
+	}
+	
 	return 0;
 }
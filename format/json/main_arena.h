@@ -0,0 +1,203 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_ARENA_H__
+#define __TELLUSIM_TESTS_JSON_ARENA_H__
+
+#include <core/TellusimArray.h>
+
+#include <new>
+#include <type_traits>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class Arena {
+			
+		public:
+			
+			enum {
+				BlockSize = 1024 * 1024,
+			};
+			
+			explicit Arena(size_t block_size = BlockSize) : block_size(block_size) { }
+			~Arena() { clear(); }
+			
+			Arena(const Arena&) = delete;
+			Arena &operator=(const Arena&) = delete;
+			
+			/// releases all blocks at once, no destructors are called
+			void clear() {
+				for(Block &block : blocks) delete [] block.data;
+				blocks.clear();
+				memory = 0;
+			}
+			
+			/// bump allocation from the last block
+			void *allocate(size_t size, size_t alignment = sizeof(void*)) {
+				if(blocks.size()) {
+					void *ret = allocate(blocks[blocks.size() - 1], size, alignment);
+					if(ret) return ret;
+				}
+				return allocate(append(max(size + alignment, block_size)), size, alignment);
+			}
+			
+			/// trivially destructible objects only, the arena never calls destructors
+			template <class Type> Type *create() {
+				TS_STATIC_ASSERT(std::is_trivially_destructible<Type>::value);
+				return new(allocate(sizeof(Type), alignof(Type))) Type();
+			}
+			
+			/// null-terminated copy of the string
+			const char *copy(const char *str, size_t size) {
+				char *ret = (char*)allocate(size + 1, 1);
+				memcpy(ret, str, size);
+				ret[size] = '\0';
+				return ret;
+			}
+			
+			/// aligned copy of the binary data
+			void *copy(const void *data, size_t size, size_t alignment) {
+				void *ret = allocate(size, alignment);
+				memcpy(ret, data, size);
+				return ret;
+			}
+			
+			/// copies the blocks of the source arena, the previous content is released
+			/// pointers inside the copied data must be fixed with the Relocation
+			/// the block copies keep the alignment up to the operator new alignment
+			void copy(const Arena &src) {
+				clear();
+				block_size = src.block_size;
+				for(const Block &block : src.blocks) {
+					Block &dest = append(block.size);
+					memcpy(dest.data, block.data, block.used);
+					dest.used = block.used;
+				}
+			}
+			
+			/// allocated and used memory in bytes
+			size_t getMemory() const { return memory; }
+			size_t getUsed() const {
+				size_t ret = 0;
+				for(const Block &block : blocks) ret += block.used;
+				return ret;
+			}
+			
+			uint32_t getNumBlocks() const { return blocks.size(); }
+			
+			/// maps pointers of the source arena into its block copy
+			class Relocation {
+					
+				public:
+					
+					Relocation(const Arena &src, const Arena &dest) {
+						TS_ASSERT(src.blocks.size() == dest.blocks.size());
+						ranges.resize(src.blocks.size());
+						for(uint32_t i = 0; i < src.blocks.size(); i++) {
+							Range &range = ranges[i];
+							range.begin = (size_t)src.blocks[i].data;
+							range.end = range.begin + src.blocks[i].size;
+							range.offset = (size_t)dest.blocks[i].data - range.begin;
+						}
+						// sorted by address for the binary search
+						for(uint32_t i = 1; i < ranges.size(); i++) {
+							for(uint32_t j = i; j > 0 && ranges[j].begin < ranges[j - 1].begin; j--) {
+								Range temp = ranges[j];
+								ranges[j] = ranges[j - 1];
+								ranges[j - 1] = temp;
+							}
+						}
+					}
+					
+					/// pointer inside the source arena blocks
+					bool contains(const void *ptr) const {
+						size_t address = (size_t)ptr;
+						for(const Range &range : ranges) {
+							if(address - range.begin < range.end - range.begin) return true;
+						}
+						return false;
+					}
+					
+					template <class Type> TS_INLINE Type *get(Type *ptr) const {
+						if(ptr == nullptr) return nullptr;
+						size_t address = (size_t)ptr;
+						// consecutive pointers usually share the block
+						if(address - last.begin >= last.end - last.begin) {
+							uint32_t left = 0;
+							uint32_t right = ranges.size();
+							while(right - left > 1) {
+								uint32_t middle = (left + right) / 2;
+								if(ranges[middle].begin <= address) left = middle;
+								else right = middle;
+							}
+							last = ranges[left];
+							TS_ASSERT(address - last.begin < last.end - last.begin);
+						}
+						return (Type*)(address + last.offset);
+					}
+					
+				private:
+					
+					struct Range {
+						size_t begin;
+						size_t end;
+						size_t offset;
+					};
+					
+					Array<Range> ranges;
+					mutable Range last = { 0, 0, 0 };
+			};
+			
+		private:
+			
+			struct Block {
+				uint8_t *data;
+				size_t size;
+				size_t used;
+			};
+			
+			static void *allocate(Block &block, size_t size, size_t alignment) {
+				size_t address = ((size_t)block.data + block.used + alignment - 1) & ~(alignment - 1);
+				size_t offset = address - (size_t)block.data;
+				if(offset + size > block.size) return nullptr;
+				block.used = offset + size;
+				return block.data + offset;
+			}
+			
+			Block &append(size_t size) {
+				blocks.append(Block { new uint8_t[size], size, 0 });
+				memory += size;
+				return blocks[blocks.size() - 1];
+			}
+			
+			size_t block_size = BlockSize;
+			size_t memory = 0;
+			
+			Array<Block> blocks;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_ARENA_H__ */
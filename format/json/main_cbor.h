@@ -0,0 +1,489 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_CBOR_H__
+#define __TELLUSIM_TESTS_JSON_CBOR_H__
+
+#include <core/TellusimFile.h>
+
+#include <cmath>
+
+#include "main_document.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class JsonCbor {
+			
+		public:
+			
+			using Node = JsonDocument::Node;
+			
+			/// RFC 8949 major types
+			enum Major {
+				MajorUnsigned = 0,
+				MajorNegative,
+				MajorBytes,
+				MajorString,
+				MajorArray,
+				MajorMap,
+				MajorTag,
+				MajorSimple,
+			};
+			
+			/// RFC 8746 little-endian typed array tags
+			enum Tag {
+				TagUint32Array = 70,
+				TagFloat32Array = 85,
+				TagSelfDescribed = 55799,
+			};
+			
+			enum {
+				MaxDepth = 1024,
+			};
+			
+			/// encodes the document, typed array payloads are aligned to four bytes from the data beginning
+			static bool encode(const JsonDocument &document, Array<uint8_t> &data) {
+				data.clear();
+				if(document.getRoot() == nullptr) {
+					TS_LOG(Error, "JsonCbor::encode(): document is empty\n");
+					return false;
+				}
+				head(data, MajorTag, TagSelfDescribed);
+				return encode(data, document.getRoot());
+			}
+			
+			static bool save(const JsonDocument &document, const char *name) {
+				Array<uint8_t> data;
+				if(!encode(document, data)) return false;
+				File file;
+				if(!file.open(name, "wb")) return false;
+				return (file.write(data.get(), data.size()) == data.size());
+			}
+			
+			/// decodes the document, aligned typed arrays reference the data without a copy
+			/// the data must outlive the document unless all payloads are copied
+			static bool decode(JsonDocument &document, const uint8_t *data, size_t size, bool copy = false) {
+				document.clear();
+				Decoder decoder(document, data, size, copy);
+				if(!decoder.item(nullptr, nullptr, 0, 0)) {
+					document.clear();
+					return false;
+				}
+				if(decoder.src != decoder.end) {
+					decoder.error("unexpected data after the root item");
+					document.clear();
+					return false;
+				}
+				return true;
+			}
+			
+			static bool load(JsonDocument &document, const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				size_t size = source.getSize();
+				Array<uint8_t> data(size);
+				if(source.read(data.get(), size) != size) return false;
+				return decode(document, data.get(), size, true);
+			}
+			
+		private:
+			
+			/// item head with the big-endian argument
+			static void head(Array<uint8_t> &data, Major major, uint64_t value) {
+				uint8_t type = (uint8_t)(major << 5);
+				if(value < 24) {
+					data.append(type | (uint8_t)value);
+				} else if(value <= 0xff) {
+					data.append(type | 24);
+					write(data, value, 1);
+				} else if(value <= 0xffff) {
+					data.append(type | 25);
+					write(data, value, 2);
+				} else if(value <= 0xffffffffull) {
+					data.append(type | 26);
+					write(data, value, 4);
+				} else {
+					data.append(type | 27);
+					write(data, value, 8);
+				}
+			}
+			
+			static uint32_t getHeadSize(uint64_t value) {
+				if(value < 24) return 1;
+				if(value <= 0xff) return 2;
+				if(value <= 0xffff) return 3;
+				if(value <= 0xffffffffull) return 5;
+				return 9;
+			}
+			
+			static void write(Array<uint8_t> &data, uint64_t value, uint32_t bytes) {
+				for(uint32_t i = bytes; i > 0; i--) data.append((uint8_t)(value >> ((i - 1) * 8)));
+			}
+			
+			static void write(Array<uint8_t> &data, const void *src, size_t size) {
+				size_t offset = data.size();
+				data.resize(offset + size);
+				if(size) memcpy(data.get() + offset, src, size);
+			}
+			
+			static bool encode(Array<uint8_t> &data, const Node *node) {
+				switch(node->type) {
+					case JsonDocument::TypeNull:
+						data.append(SimpleNull);
+						return true;
+					case JsonDocument::TypeBool:
+						data.append(node->getBool() ? SimpleTrue : SimpleFalse);
+						return true;
+					case JsonDocument::TypeNumber:
+						return number(data, node->data);
+					case JsonDocument::TypeString:
+						string(data, node->data);
+						return true;
+					case JsonDocument::TypeArray:
+						head(data, MajorArray, node->num_children);
+						for(const Node *child = node->child; child; child = child->next) {
+							if(!encode(data, child)) return false;
+						}
+						return true;
+					case JsonDocument::TypeObject:
+						head(data, MajorMap, node->num_children);
+						for(const Node *child = node->child; child; child = child->next) {
+							string(data, child->name);
+							if(!encode(data, child)) return false;
+						}
+						return true;
+					case JsonDocument::TypeFloat32Array:
+						typed(data, TagFloat32Array, node->data, sizeof(float32_t) * node->num_children);
+						return true;
+					case JsonDocument::TypeUint32Array:
+						typed(data, TagUint32Array, node->data, sizeof(uint32_t) * node->num_children);
+						return true;
+				}
+				return false;
+			}
+			
+			static void string(Array<uint8_t> &data, const char *str) {
+				size_t size = strlen(str);
+				head(data, MajorString, size);
+				write(data, str, size);
+			}
+			
+			/// integers up to 64 bits are stored as the integers, the remaining numbers are the
+			/// single-precision floats when the conversion is exact and the double-precision floats otherwise
+			static bool number(Array<uint8_t> &data, const char *str) {
+				const char *s = str + (*str == '-');
+				uint64_t value = 0;
+				uint32_t num_digits = 0;
+				for(; *s >= '0' && *s <= '9'; s++, num_digits++) {
+					uint64_t digit = (uint64_t)(*s - '0');
+					if(value > (Maxu64 - digit) / 10) break;
+					value = value * 10 + digit;
+				}
+				if(*s == '\0' && num_digits && (*str != '-' || value)) {
+					if(*str == '-') head(data, MajorNegative, value - 1);
+					else head(data, MajorUnsigned, value);
+					return true;
+				}
+				float64_t number = 0.0;
+				if(JsonNumber::parse(str, str + strlen(str), number) != str + strlen(str)) {
+					TS_LOGF(Error, "JsonCbor::encode(): invalid number \"%s\"\n", str);
+					return false;
+				}
+				float32_t number_f32 = (float32_t)number;
+				if((float64_t)number_f32 == number) {
+					uint32_t bits = 0;
+					memcpy(&bits, &number_f32, sizeof(bits));
+					data.append(SimpleFloat32);
+					write(data, bits, 4);
+				} else {
+					uint64_t bits = 0;
+					memcpy(&bits, &number, sizeof(bits));
+					data.append(SimpleFloat64);
+					write(data, bits, 8);
+				}
+				return true;
+			}
+			
+			/// typed array in the byte string, the misaligned payloads are moved by the empty chunks of the indefinite string
+			static void typed(Array<uint8_t> &data, Tag tag, const void *src, size_t size) {
+				head(data, MajorTag, tag);
+				uint32_t head_size = getHeadSize(size);
+				if((data.size() + head_size) % 4) {
+					data.append((uint8_t)(MajorBytes << 5) | Indefinite);
+					while((data.size() + head_size) % 4) data.append((uint8_t)(MajorBytes << 5));
+					head(data, MajorBytes, size);
+					write(data, src, size);
+					data.append(Break);
+				} else {
+					head(data, MajorBytes, size);
+					write(data, src, size);
+				}
+			}
+			
+			enum {
+				Indefinite = 31,
+				SimpleFalse = 0xf4,
+				SimpleTrue = 0xf5,
+				SimpleNull = 0xf6,
+				SimpleFloat16 = 0xf9,
+				SimpleFloat32 = 0xfa,
+				SimpleFloat64 = 0xfb,
+				Break = 0xff,
+			};
+			
+			/// recursive item decoder
+			struct Decoder {
+				
+				Decoder(JsonDocument &document, const uint8_t *data, size_t size, bool copy) : document(document), begin(data), src(data), end(data + size), copy(copy) { }
+				
+				/// item head, the indefinite length is reported by the flag
+				bool head(uint32_t &major, uint64_t &value, bool &indefinite) {
+					if(src == end) return error("unexpected end of data");
+					uint8_t type = *src++;
+					major = type >> 5;
+					value = type & 0x1f;
+					indefinite = false;
+					if(value < 24) return true;
+					if(value == Indefinite) {
+						if(major == MajorUnsigned || major == MajorNegative || major == MajorTag) return error("invalid indefinite length");
+						indefinite = true;
+						return true;
+					}
+					if(value > 27) return error("invalid additional information");
+					uint32_t bytes = 1u << (value - 24);
+					if((size_t)(end - src) < bytes) return error("unexpected end of data");
+					value = 0;
+					for(uint32_t i = 0; i < bytes; i++) value = (value << 8) | *src++;
+					return true;
+				}
+				
+				/// byte or text string, single-chunk strings are referenced in place
+				bool string(uint32_t major, uint64_t size, bool indefinite, const uint8_t *&data, size_t &data_size, bool &inplace) {
+					if(!indefinite) {
+						if((uint64_t)(end - src) < size) return error("unexpected end of data");
+						data = src;
+						data_size = (size_t)size;
+						inplace = true;
+						src += size;
+						return true;
+					}
+					data = nullptr;
+					data_size = 0;
+					inplace = true;
+					buffer.clear();
+					while(true) {
+						if(src != end && *src == Break) {
+							src++;
+							return true;
+						}
+						uint32_t chunk_major = 0;
+						uint64_t chunk_size = 0;
+						bool chunk_indefinite = false;
+						if(!head(chunk_major, chunk_size, chunk_indefinite)) return false;
+						if(chunk_major != major || chunk_indefinite) return error("invalid string chunk");
+						if((uint64_t)(end - src) < chunk_size) return error("unexpected end of data");
+						if(chunk_size == 0) continue;
+						if(data_size == 0 && inplace) {
+							data = src;
+						} else {
+							if(inplace) {
+								buffer.resize(data_size);
+								memcpy(buffer.get(), data, data_size);
+								inplace = false;
+							}
+							buffer.resize(data_size + (size_t)chunk_size);
+							memcpy(buffer.get() + data_size, src, (size_t)chunk_size);
+							data = buffer.get();
+						}
+						data_size += (size_t)chunk_size;
+						src += chunk_size;
+					}
+				}
+				
+				bool item(Node *parent, const char *name, size_t name_size, uint32_t depth) {
+					
+					if(depth > MaxDepth) return error("nesting is too deep");
+					
+					const uint8_t *type = src;
+					uint32_t major = 0;
+					uint64_t value = 0;
+					bool indefinite = false;
+					if(!head(major, value, indefinite)) return false;
+					
+					switch(major) {
+						
+						// integers
+						case MajorUnsigned:
+						case MajorNegative: {
+							char str[JsonNumber::MaxLength];
+							uint32_t size = 0;
+							if(major == MajorUnsigned) {
+								size = JsonNumber::format(str, value);
+							} else if(value < Maxu64) {
+								str[0] = '-';
+								size = JsonNumber::format(str + 1, value + 1) + 1;
+							} else {
+								// -2^64 is out of the 64-bit integer range
+								size = JsonNumber::format(str, -18446744073709551616.0);
+							}
+							return add(parent, name, name_size, JsonDocument::TypeNumber, str, size);
+						}
+						
+						// strings
+						case MajorBytes:
+							return error("byte string outside of the typed array");
+						case MajorString: {
+							const uint8_t *data = nullptr;
+							size_t size = 0;
+							bool inplace = false;
+							if(!string(major, value, indefinite, data, size, inplace)) return false;
+							return add(parent, name, name_size, JsonDocument::TypeString, (const char*)data, size);
+						}
+						
+						// containers
+						case MajorArray: {
+							Node *node = document.addChild(parent, name, name_size, JsonDocument::TypeArray, nullptr, 0);
+							for(uint64_t i = 0; indefinite || i < value; i++) {
+								if(indefinite && src != end && *src == Break) {
+									src++;
+									break;
+								}
+								if(!item(node, nullptr, 0, depth + 1)) return false;
+							}
+							return true;
+						}
+						case MajorMap: {
+							Node *node = document.addChild(parent, name, name_size, JsonDocument::TypeObject, nullptr, 0);
+							for(uint64_t i = 0; indefinite || i < value; i++) {
+								if(indefinite && src != end && *src == Break) {
+									src++;
+									break;
+								}
+								uint32_t key_major = 0;
+								uint64_t key_size = 0;
+								bool key_indefinite = false;
+								if(!head(key_major, key_size, key_indefinite)) return false;
+								if(key_major != MajorString) return error("map key is not a text string");
+								const uint8_t *key = nullptr;
+								size_t size = 0;
+								bool inplace = false;
+								if(!string(key_major, key_size, key_indefinite, key, size, inplace)) return false;
+								// the chunk buffer is reused by the value
+								if(!inplace) key = (const uint8_t*)document.arena.copy((const char*)key, size);
+								if(!item(node, (const char*)key, size, depth + 1)) return false;
+							}
+							return true;
+						}
+						
+						// typed arrays and the transparent tags
+						case MajorTag:
+							if(value == TagFloat32Array || value == TagUint32Array) return typed(parent, name, name_size, (Tag)value);
+							return item(parent, name, name_size, depth + 1);
+						
+						// simple values and floats
+						case MajorSimple:
+							if(indefinite) return error("unexpected break");
+							if(value == 20 || value == 21) return add(parent, name, name_size, JsonDocument::TypeBool, (value == 21) ? "true" : "false", (value == 21) ? 4 : 5);
+							if(value == 22 || value == 23) return add(parent, name, name_size, JsonDocument::TypeNull, nullptr, 0);
+							if(*type == SimpleFloat16) return number(parent, name, name_size, get_half((uint16_t)value));
+							if(*type == SimpleFloat32) {
+								uint32_t bits = (uint32_t)value;
+								float32_t number_f32 = 0.0f;
+								memcpy(&number_f32, &bits, sizeof(number_f32));
+								return number(parent, name, name_size, number_f32);
+							}
+							if(*type == SimpleFloat64) {
+								float64_t number_f64 = 0.0;
+								memcpy(&number_f64, &value, sizeof(number_f64));
+								return number(parent, name, name_size, number_f64);
+							}
+							return error("unsupported simple value");
+					}
+					
+					return false;
+				}
+				
+				bool typed(Node *parent, const char *name, size_t name_size, Tag tag) {
+					uint32_t major = 0;
+					uint64_t size = 0;
+					bool indefinite = false;
+					if(!head(major, size, indefinite)) return false;
+					if(major != MajorBytes) return error("typed array is not a byte string");
+					const uint8_t *data = nullptr;
+					size_t data_size = 0;
+					bool inplace = false;
+					if(!string(major, size, indefinite, data, data_size, inplace)) return false;
+					if(data_size % 4) return error("invalid typed array size");
+					if(data_size / 4 > Maxu32) return error("typed array is too large");
+					JsonDocument::Type type = (tag == TagFloat32Array) ? JsonDocument::TypeFloat32Array : JsonDocument::TypeUint32Array;
+					// the host is little-endian, the aligned payloads are referenced in place
+					if(copy || !inplace || ((size_t)data & 3)) data = (const uint8_t*)document.arena.copy(data, data_size, 4);
+					document.addArray(parent, name, name_size, type, data, (uint32_t)(data_size / 4));
+					return true;
+				}
+				
+				/// shortest text of the floating-point number which reads back exactly
+				bool number(Node *parent, const char *name, size_t name_size, float64_t value) {
+					// JSON has no infinities and NaNs
+					if(!(value >= -Maxf64 && value <= Maxf64)) return add(parent, name, name_size, JsonDocument::TypeNull, nullptr, 0);
+					char str[JsonNumber::MaxLength];
+					uint32_t size = JsonNumber::format(str, value);
+					return add(parent, name, name_size, JsonDocument::TypeNumber, str, size);
+				}
+				
+				static float64_t get_half(uint16_t bits) {
+					int32_t exponent = (bits >> 10) & 0x1f;
+					float64_t mantissa = bits & 0x3ff;
+					float64_t value = 0.0;
+					if(exponent == 0) value = std::ldexp(mantissa, -24);
+					else if(exponent != 31) value = std::ldexp(mantissa + 1024.0, exponent - 25);
+					else value = (mantissa == 0.0) ? HUGE_VAL : std::nan("");
+					return (bits & 0x8000) ? -value : value;
+				}
+				
+				bool add(Node *parent, const char *name, size_t name_size, JsonDocument::Type type, const char *data, size_t size) {
+					if(data == nullptr && type == JsonDocument::TypeString) data = "";
+					document.addChild(parent, name, name_size, type, data, size);
+					return true;
+				}
+				
+				bool error(const char *message) {
+					TS_LOGF(Error, "JsonCbor::decode(): %s at offset %u\n", message, (uint32_t)(src - begin));
+					return false;
+				}
+				
+				JsonDocument &document;
+				const uint8_t *begin;
+				const uint8_t *src;
+				const uint8_t *end;
+				bool copy;
+				
+				Array<uint8_t> buffer;
+			};
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_CBOR_H__ */
@@ -0,0 +1,326 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_DOCUMENT_H__
+#define __TELLUSIM_TESTS_JSON_DOCUMENT_H__
+
+#include <core/TellusimSource.h>
+
+#include "main_arena.h"
+#include "main_scanner.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class JsonDocument {
+			
+		public:
+			
+			/// node types
+			enum Type {
+				TypeNull = 0,
+				TypeBool,
+				TypeNumber,
+				TypeString,
+				TypeArray,
+				TypeObject,
+				TypeFloat32Array,
+				TypeUint32Array,
+			};
+			
+			/// arena node, names and data are null-terminated arena strings
+			/// numbers keep their source text, strings are decoded
+			/// typed arrays keep the raw elements in the data, the number of elements is in the num_children
+			struct Node {
+				
+				const Node *getChild(const char *str) const {
+					for(const Node *node = child; node; node = node->next) {
+						if(node->name && strcmp(node->name, str) == 0) return node;
+					}
+					return nullptr;
+				}
+				
+				bool getBool() const { return (type == TypeBool && data[0] == 't'); }
+				float64_t getNumber() const {
+					float64_t value = 0.0;
+					if(type == TypeNumber) JsonNumber::parse(data, data + strlen(data), value);
+					return value;
+				}
+				
+				const float32_t *getFloat32Array() const { return (type == TypeFloat32Array) ? (const float32_t*)data : nullptr; }
+				const uint32_t *getUint32Array() const { return (type == TypeUint32Array) ? (const uint32_t*)data : nullptr; }
+				
+				Type type = TypeNull;
+				uint32_t num_children = 0;
+				const char *name = nullptr;
+				const char *data = nullptr;
+				Node *child = nullptr;
+				Node *last = nullptr;
+				Node *next = nullptr;
+			};
+			
+			explicit JsonDocument(size_t block_size = Arena::BlockSize) : arena(block_size) { }
+			
+			/// releases all nodes at once
+			void clear() {
+				arena.clear();
+				root = nullptr;
+			}
+			
+			/// creates the document from the JSON text
+			bool create(const char *src, size_t size) {
+				clear();
+				Builder builder(*this);
+				JsonScanner scanner;
+				if(!scanner.parse(src, size, builder) || root == nullptr) {
+					clear();
+					return false;
+				}
+				return true;
+			}
+			
+			bool load(const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				size_t size = source.getSize();
+				Array<char> data(size);
+				if(source.read(data.get(), size) != size) return false;
+				return create(data.get(), size);
+			}
+			
+			/// appends a new node, the null parent creates the root
+			Node *addChild(Node *parent, const char *name, Type type, const char *data = nullptr) {
+				return addChild(parent, name, (name) ? strlen(name) : 0, type, data, (data) ? strlen(data) : 0);
+			}
+			
+			/// appends a new number node with the shortest text, infinities and NaNs are null nodes
+			Node *addChild(Node *parent, const char *name, float32_t value) { return addNumber(parent, name, value); }
+			Node *addChild(Node *parent, const char *name, float64_t value) { return addNumber(parent, name, value); }
+			Node *addChild(Node *parent, const char *name, int32_t value) { return addNumber(parent, name, value); }
+			Node *addChild(Node *parent, const char *name, uint32_t value) { return addNumber(parent, name, value); }
+			Node *addChild(Node *parent, const char *name, int64_t value) { return addNumber(parent, name, value); }
+			Node *addChild(Node *parent, const char *name, uint64_t value) { return addNumber(parent, name, value); }
+			
+			/// appends a new typed array node, the elements are copied into the arena
+			Node *addChild(Node *parent, const char *name, const float32_t *data, uint32_t size) {
+				return addArray(parent, name, (name) ? strlen(name) : 0, TypeFloat32Array, arena.copy(data, sizeof(float32_t) * size, alignof(float32_t)), size);
+			}
+			Node *addChild(Node *parent, const char *name, const uint32_t *data, uint32_t size) {
+				return addArray(parent, name, (name) ? strlen(name) : 0, TypeUint32Array, arena.copy(data, sizeof(uint32_t) * size, alignof(uint32_t)), size);
+			}
+			
+			/// copies the arena blocks and relocates the node pointers
+			/// typed arrays referencing the external memory are kept as is
+			void clone(JsonDocument &dest) const {
+				dest.clear();
+				if(root == nullptr) return;
+				dest.arena.copy(arena);
+				Arena::Relocation relocation(arena, dest.arena);
+				dest.root = relocation.get(root);
+				Array<Node*> stack;
+				stack.append(dest.root);
+				while(stack.size()) {
+					Node *node = stack[stack.size() - 1];
+					stack.removeBack();
+					node->name = relocation.get(node->name);
+					if(node->type < TypeFloat32Array || relocation.contains(node->data)) node->data = relocation.get(node->data);
+					node->child = relocation.get(node->child);
+					node->last = relocation.get(node->last);
+					node->next = relocation.get(node->next);
+					if(node->next) stack.append(node->next);
+					if(node->child) stack.append(node->child);
+				}
+			}
+			
+			/// compact JSON text
+			String getString() const {
+				Array<char> buffer;
+				if(root) write(buffer, root);
+				buffer.append('\0');
+				return String(buffer.get());
+			}
+			
+			const Node *getRoot() const { return root; }
+			
+			size_t getMemory() const { return arena.getMemory(); }
+			
+		private:
+			
+			friend class JsonCbor;
+			
+			/// reader events to nodes
+			struct Builder : public JsonReader::Handler {
+				
+				explicit Builder(JsonDocument &document) : document(document) { }
+				
+				bool beginObject() { return begin(TypeObject); }
+				bool beginArray() { return begin(TypeArray); }
+				bool endObject() { stack.removeBack(); return true; }
+				bool endArray() { stack.removeBack(); return true; }
+				
+				bool key(const JsonReader::View &view) {
+					name = view;
+					return true;
+				}
+				
+				bool value(const JsonReader::Value &value) {
+					Node *parent = (stack.size()) ? stack[stack.size() - 1] : nullptr;
+					if(value.type == JsonReader::TypeString && value.escaped) {
+						String data = JsonReader::decode(value.view);
+						add(parent, TypeString, data.get(), data.size());
+					} else {
+						// reader value types match the node types
+						add(parent, (Type)value.type, value.view.data, value.view.size);
+					}
+					return true;
+				}
+				
+				bool begin(Type type) {
+					Node *parent = (stack.size()) ? stack[stack.size() - 1] : nullptr;
+					stack.append(add(parent, type, nullptr, 0));
+					return true;
+				}
+				
+				Node *add(Node *parent, Type type, const char *data, size_t size) {
+					// object member names
+					if(parent && parent->type == TypeObject) {
+						if(memchr(name.data, '\\', name.size)) {
+							String str = JsonReader::decode(name);
+							return document.addChild(parent, str.get(), str.size(), type, data, size);
+						}
+						return document.addChild(parent, name.data, name.size, type, data, size);
+					}
+					return document.addChild(parent, nullptr, 0, type, data, size);
+				}
+				
+				JsonDocument &document;
+				JsonReader::View name;
+				Array<Node*> stack;
+			};
+			
+			Node *addChild(Node *parent, const char *name, size_t name_size, Type type, const char *data, size_t data_size) {
+				Node *node = arena.create<Node>();
+				node->type = type;
+				if(name) node->name = arena.copy(name, name_size);
+				if(data) node->data = arena.copy(data, data_size);
+				if(parent == nullptr) {
+					root = node;
+				} else {
+					if(parent->last) parent->last->next = node;
+					else parent->child = node;
+					parent->last = node;
+					parent->num_children++;
+				}
+				return node;
+			}
+			
+			template <class Type> Node *addNumber(Node *parent, const char *name, Type value) {
+				if(value != value || value - value != 0) return addChild(parent, name, TypeNull);
+				char data[JsonNumber::MaxLength];
+				uint32_t size = JsonNumber::format(data, value);
+				return addChild(parent, name, (name) ? strlen(name) : 0, TypeNumber, data, size);
+			}
+			
+			/// typed array node referencing the elements without a copy
+			Node *addArray(Node *parent, const char *name, size_t name_size, Type type, const void *data, uint32_t size) {
+				Node *node = addChild(parent, name, name_size, type, nullptr, 0);
+				node->data = (const char*)data;
+				node->num_children = size;
+				return node;
+			}
+			
+			static void write(Array<char> &buffer, const char *str) {
+				while(*str) buffer.append(*str++);
+			}
+			
+			static void quote(Array<char> &buffer, const char *str) {
+				static const char digits[] = "0123456789abcdef";
+				buffer.append('"');
+				for(; *str; str++) {
+					uint8_t c = (uint8_t)*str;
+					if(c == '"' || c == '\\') {
+						buffer.append('\\');
+						buffer.append((char)c);
+					} else if(c < 0x20) {
+						write(buffer, "\\u00");
+						buffer.append(digits[c >> 4]);
+						buffer.append(digits[c & 0x0f]);
+					} else {
+						buffer.append((char)c);
+					}
+				}
+				buffer.append('"');
+			}
+			
+			/// writes the tree with an explicit stack of the open containers
+			static void write(Array<char> &buffer, const Node *node) {
+				Array<const Node*> stack;
+				while(true) {
+					if(stack.size() && stack[stack.size() - 1]->type == TypeObject) {
+						quote(buffer, node->name);
+						buffer.append(':');
+					}
+					if(node->type == TypeObject || node->type == TypeArray) {
+						buffer.append((node->type == TypeObject) ? '{' : '[');
+						if(node->child) {
+							stack.append(node);
+							node = node->child;
+							continue;
+						}
+						buffer.append((node->type == TypeObject) ? '}' : ']');
+					} else if(node->type == TypeFloat32Array || node->type == TypeUint32Array) {
+						char str[JsonNumber::MaxLength];
+						buffer.append('[');
+						for(uint32_t i = 0; i < node->num_children; i++) {
+							if(i) buffer.append(',');
+							if(node->type == TypeFloat32Array) JsonNumber::format(str, node->getFloat32Array()[i]);
+							else JsonNumber::format(str, node->getUint32Array()[i]);
+							write(buffer, str);
+						}
+						buffer.append(']');
+					} else if(node->type == TypeString) {
+						quote(buffer, node->data);
+					} else if(node->data) {
+						write(buffer, node->data);
+					} else {
+						write(buffer, "null");
+					}
+					while(stack.size() && node->next == nullptr) {
+						node = stack[stack.size() - 1];
+						stack.removeBack();
+						buffer.append((node->type == TypeObject) ? '}' : ']');
+					}
+					if(stack.size() == 0) break;
+					buffer.append(',');
+					node = node->next;
+				}
+			}
+			
+			Arena arena;
+			Node *root = nullptr;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_DOCUMENT_H__ */
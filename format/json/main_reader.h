@@ -0,0 +1,371 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_READER_H__
+#define __TELLUSIM_TESTS_JSON_READER_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
+
+#include "main_number.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class JsonReader {
+			
+		public:
+			
+			/// zero-copy view into the input buffer
+			struct View {
+				View() { }
+				View(const char *data, size_t size) : data(data), size(size) { }
+				
+				bool operator==(const char *str) const {
+					size_t length = strlen(str);
+					return (size == length && memcmp(data, str, size) == 0);
+				}
+				bool operator!=(const char *str) const {
+					return !(*this == str);
+				}
+				
+				/// copy of the raw text
+				String get() const {
+					Array<char> buffer(size + 1);
+					memcpy(buffer.get(), data, size);
+					buffer[size] = '\0';
+					return String(buffer.get());
+				}
+				
+				const char *data = nullptr;
+				size_t size = 0;
+			};
+			
+			/// value types
+			enum Type {
+				TypeNull = 0,
+				TypeBool,
+				TypeNumber,
+				TypeString,
+			};
+			
+			/// value token
+			/// string views exclude the quotes and keep the escape sequences
+			struct Value {
+				
+				bool getBool() const {
+					return (type == TypeBool && view.size == 4);
+				}
+				
+				/// numbers are converted on demand
+				float64_t getNumber() const {
+					float64_t ret = 0.0;
+					if(type == TypeNumber) JsonNumber::parse(view.data, view.data + view.size, ret);
+					return ret;
+				}
+				
+				/// decoded string, views without escapes are copied as is
+				String getString() const {
+					if(type != TypeString) return view.get();
+					if(!escaped) return view.get();
+					return decode(view);
+				}
+				
+				Type type = TypeNull;
+				View view;
+				bool escaped = false;
+			};
+			
+			/// default handler
+			/// the derived handlers hide the events of interest, the false result stops parsing successfully
+			struct Handler {
+				bool beginObject() { return true; }
+				bool endObject() { return true; }
+				bool beginArray() { return true; }
+				bool endArray() { return true; }
+				bool key(const View &name) { TS_UNUSED(name); return true; }
+				bool value(const Value &value) { TS_UNUSED(value); return true; }
+			};
+			
+			/// parses the buffer in a single pass without memory allocations except the nesting stack
+			template <class Type> bool parse(const char *src, size_t size, Type &handler) {
+				
+				begin = src;
+				end = src + size;
+				stack.clear();
+				
+				const char *s = skip(src);
+				State state = StateValue;
+				Value value;
+				
+				while(true) {
+					
+					// value
+					if(state == StateValue) {
+						if(s == end) return error(s, "unexpected end of data");
+						char c = *s;
+						if(c == '{') {
+							if(!handler.beginObject()) return true;
+							s = skip(s + 1);
+							if(s != end && *s == '}') {
+								if(!handler.endObject()) return true;
+								s++;
+								state = StateNext;
+							} else {
+								stack.append(TypeObject);
+								state = StateKey;
+							}
+							continue;
+						}
+						if(c == '[') {
+							if(!handler.beginArray()) return true;
+							s = skip(s + 1);
+							if(s != end && *s == ']') {
+								if(!handler.endArray()) return true;
+								s++;
+								state = StateNext;
+							} else {
+								stack.append(TypeArray);
+							}
+							continue;
+						}
+						if(c == '"') {
+							s = string(s, value);
+						} else if(c == 't') {
+							s = literal(s, "true", TypeBool, value);
+						} else if(c == 'f') {
+							s = literal(s, "false", TypeBool, value);
+						} else if(c == 'n') {
+							s = literal(s, "null", TypeNull, value);
+						} else {
+							s = number(s, value);
+						}
+						if(s == nullptr) return false;
+						if(!handler.value(value)) return true;
+						state = StateNext;
+					}
+					
+					// object key
+					else if(state == StateKey) {
+						if(s == end || *s != '"') return error(s, "object key is expected");
+						s = string(s, value);
+						if(s == nullptr) return false;
+						if(!handler.key(value.view)) return true;
+						s = skip(s);
+						if(s == end || *s != ':') return error(s, "':' is expected");
+						s = skip(s + 1);
+						state = StateValue;
+					}
+					
+					// separator or the end of the container
+					else {
+						s = skip(s);
+						if(stack.size() == 0) {
+							if(s != end) return error(s, "unexpected data after the root value");
+							return true;
+						}
+						char c = (s != end) ? *s : '\0';
+						uint8_t container = stack[stack.size() - 1];
+						if(c == ',') {
+							s = skip(s + 1);
+							state = (container == TypeObject) ? StateKey : StateValue;
+						} else if(c == '}' && container == TypeObject) {
+							if(!handler.endObject()) return true;
+							stack.removeBack();
+							s++;
+						} else if(c == ']' && container == TypeArray) {
+							if(!handler.endArray()) return true;
+							stack.removeBack();
+							s++;
+						} else {
+							return error(s, (container == TypeObject) ? "',' or '}' is expected" : "',' or ']' is expected");
+						}
+					}
+				}
+			}
+			
+			/// decodes the escape sequences of the string view
+			static String decode(const View &view) {
+				Array<char> buffer;
+				buffer.reserve(view.size + 1);
+				const char *s = view.data;
+				const char *end = view.data + view.size;
+				while(s < end) {
+					char c = *s++;
+					if(c != '\\' || s == end) {
+						buffer.append(c);
+						continue;
+					}
+					c = *s++;
+					if(c == 'b') buffer.append('\b');
+					else if(c == 'f') buffer.append('\f');
+					else if(c == 'n') buffer.append('\n');
+					else if(c == 'r') buffer.append('\r');
+					else if(c == 't') buffer.append('\t');
+					else if(c == 'u') {
+						// malformed escapes are replaced by U+FFFD
+						uint32_t code = hex(s, end);
+						if(code == Maxu32) {
+							utf8(buffer, 0xfffd);
+							continue;
+						}
+						s += 4;
+						// surrogate pair
+						if(code >= 0xd800 && code < 0xdc00 && end - s >= 6 && s[0] == '\\' && s[1] == 'u') {
+							uint32_t low = hex(s + 2, end);
+							if(low >= 0xdc00 && low < 0xe000) {
+								code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+								s += 6;
+							}
+						}
+						utf8(buffer, code);
+					}
+					else buffer.append(c);
+				}
+				buffer.append('\0');
+				return String(buffer.get());
+			}
+			
+		private:
+			
+			enum State {
+				StateValue = 0,
+				StateKey,
+				StateNext,
+			};
+			
+			enum {
+				TypeObject = 0,
+				TypeArray,
+			};
+			
+			/// skips whitespaces
+			TS_INLINE const char *skip(const char *s) const {
+				while(s != end && (*s == ' ' || *s == '\n' || *s == '\r' || *s == '\t')) s++;
+				return s;
+			}
+			
+			/// quoted string
+			const char *string(const char *s, Value &value) {
+				const char *data = ++s;
+				bool escaped = false;
+				while(s != end) {
+					uint8_t c = (uint8_t)*s;
+					if(c == '"') {
+						value.type = TypeString;
+						value.view = View(data, (size_t)(s - data));
+						value.escaped = escaped;
+						return s + 1;
+					}
+					if(c == '\\') {
+						if(++s == end) break;
+						escaped = true;
+					} else if(c < 0x20) {
+						error(s, "control character in the string");
+						return nullptr;
+					}
+					s++;
+				}
+				error(data - 1, "unterminated string");
+				return nullptr;
+			}
+			
+			/// true, false, or null literal
+			const char *literal(const char *s, const char *str, Type type, Value &value) {
+				size_t length = strlen(str);
+				if((size_t)(end - s) < length || memcmp(s, str, length) != 0) {
+					error(s, "unknown literal");
+					return nullptr;
+				}
+				value.type = type;
+				value.view = View(s, length);
+				value.escaped = false;
+				return s + length;
+			}
+			
+			/// number with the JSON grammar
+			const char *number(const char *s, Value &value) {
+				const char *data = s;
+				s = JsonNumber::skip(s, end);
+				if(s == nullptr) {
+					error(data, "invalid number");
+					return nullptr;
+				}
+				value.type = TypeNumber;
+				value.view = View(data, (size_t)(s - data));
+				value.escaped = false;
+				return s;
+			}
+			
+			/// four hex digits or Maxu32 if the digits are missing or invalid
+			static uint32_t hex(const char *s, const char *end) {
+				if(end - s < 4) return Maxu32;
+				uint32_t ret = 0;
+				for(uint32_t i = 0; i < 4; i++) {
+					char c = s[i];
+					ret <<= 4;
+					if(c >= '0' && c <= '9') ret |= (uint32_t)(c - '0');
+					else if(c >= 'a' && c <= 'f') ret |= (uint32_t)(c - 'a' + 10);
+					else if(c >= 'A' && c <= 'F') ret |= (uint32_t)(c - 'A' + 10);
+					else return Maxu32;
+				}
+				return ret;
+			}
+			
+			static void utf8(Array<char> &buffer, uint32_t code) {
+				if(code < 0x80) {
+					buffer.append((char)code);
+				} else if(code < 0x800) {
+					buffer.append((char)(0xc0 | (code >> 6)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				} else if(code < 0x10000) {
+					buffer.append((char)(0xe0 | (code >> 12)));
+					buffer.append((char)(0x80 | ((code >> 6) & 0x3f)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				} else {
+					buffer.append((char)(0xf0 | (code >> 18)));
+					buffer.append((char)(0x80 | ((code >> 12) & 0x3f)));
+					buffer.append((char)(0x80 | ((code >> 6) & 0x3f)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				}
+			}
+			
+			/// error with the line number
+			bool error(const char *s, const char *message) const {
+				uint32_t line = 1;
+				for(const char *p = begin; p < s; p++) line += (*p == '\n');
+				TS_LOGF(Error, "JsonReader::parse(): %s at line %u offset %u\n", message, line, (uint32_t)(s - begin));
+				return false;
+			}
+			
+			const char *begin = nullptr;
+			const char *end = nullptr;
+			
+			Array<uint8_t> stack;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_READER_H__ */
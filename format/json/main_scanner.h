@@ -0,0 +1,420 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_SCANNER_H__
+#define __TELLUSIM_TESTS_JSON_SCANNER_H__
+
+#include "main_reader.h"
+
+#if TS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+	#include <arm_neon.h>
+	#define TS_JSON_NEON	1
+#else
+	#define TS_JSON_NEON	0
+#endif
+
+#if TS_AVX && defined(__AVX2__)
+	#define TS_JSON_AVX2	1
+#else
+	#define TS_JSON_AVX2	0
+#endif
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class JsonScanner {
+			
+		public:
+			
+			using View = JsonReader::View;
+			using Value = JsonReader::Value;
+			
+			enum {
+				BlockSize = 64,
+			};
+			
+			/// character classes of the 64-byte block, one bit per byte
+			struct Block {
+				uint64_t quote;
+				uint64_t backslash;
+				uint64_t op;
+				uint64_t space;
+				uint64_t control;
+			};
+			
+			/// stage one: offsets of the structural characters, the string quotes, and the scalar starts
+			bool scan(const char *src, size_t size) {
+				
+				begin = src;
+				end = src + size;
+				if(size >= Maxu32) return error(src, "data is too large");
+				
+				indices.resize(size + 1);
+				uint32_t *index = indices.get();
+				num_indices = 0;
+				
+				uint64_t prev_escaped = 0;
+				uint64_t prev_in_string = 0;
+				uint64_t prev_scalar = 0;
+				uint64_t error_mask = 0;
+				
+				TS_ALIGNAS64 char buffer[BlockSize];
+				for(size_t offset = 0; offset < size; offset += BlockSize) {
+					
+					// the last block is padded with spaces
+					const char *data = src + offset;
+					if(size - offset < BlockSize) {
+						memset(buffer, ' ', BlockSize);
+						memcpy(buffer, data, size - offset);
+						data = buffer;
+					}
+					Block block;
+					classify(data, block);
+					
+					// escaped characters follow the odd-length backslash sequences
+					uint64_t backslash = block.backslash & ~prev_escaped;
+					uint64_t follows_escape = (backslash << 1) | prev_escaped;
+					uint64_t odd_starts = backslash & ~EvenBits & ~follows_escape;
+					uint64_t even_sequences = odd_starts + backslash;
+					prev_escaped = (even_sequences < odd_starts) ? 1 : 0;
+					uint64_t escaped = (EvenBits ^ (even_sequences << 1)) & follows_escape;
+					
+					// strings from the opening quote up to the closing quote
+					uint64_t quote = block.quote & ~escaped;
+					uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+					prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+					uint64_t outside = ~(in_string | quote);
+					
+					// scalars start after the whitespaces, the operators, and the quotes
+					uint64_t scalar = ~(block.op | block.space | quote) & outside;
+					uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+					prev_scalar = scalar >> 63;
+					
+					// unescaped control characters inside the strings
+					error_mask |= block.control & in_string;
+					
+					// index flattening
+					uint64_t bits = (block.op & outside) | quote | scalar_start;
+					uint32_t base = (uint32_t)offset;
+					while(bits) {
+						index[num_indices++] = base + ctz(bits);
+						bits &= bits - 1;
+					}
+				}
+				
+				if(error_mask) return error(src, "control character in the string");
+				if(prev_in_string) return error(src, "unterminated string");
+				
+				// the padding spaces are not indexed
+				while(num_indices && index[num_indices - 1] >= size) num_indices--;
+				
+				return true;
+			}
+			
+			/// stage two: walks the index and emits the JsonReader handler events
+			template <class Type> bool parse(const char *src, size_t size, Type &handler) {
+				
+				if(!scan(src, size)) return false;
+				
+				const uint32_t *index = indices.get();
+				const uint32_t *index_end = index + num_indices;
+				stack.clear();
+				
+				State state = StateValue;
+				Value value;
+				
+				while(true) {
+					
+					// value
+					if(state == StateValue) {
+						if(index == index_end) return error(end, "unexpected end of data");
+						const char *s = src + *index++;
+						char c = *s;
+						if(c == '{') {
+							if(!handler.beginObject()) return true;
+							if(index != index_end && src[*index] == '}') {
+								if(!handler.endObject()) return true;
+								index++;
+								state = StateNext;
+							} else {
+								stack.append(TypeObject);
+								state = StateKey;
+							}
+							continue;
+						}
+						if(c == '[') {
+							if(!handler.beginArray()) return true;
+							if(index != index_end && src[*index] == ']') {
+								if(!handler.endArray()) return true;
+								index++;
+								state = StateNext;
+							} else {
+								stack.append(TypeArray);
+							}
+							continue;
+						}
+						if(c == '"') {
+							string(s, src + *index++, value);
+						} else if(c == 't') {
+							if(!literal(s, "true", JsonReader::TypeBool, value)) return false;
+						} else if(c == 'f') {
+							if(!literal(s, "false", JsonReader::TypeBool, value)) return false;
+						} else if(c == 'n') {
+							if(!literal(s, "null", JsonReader::TypeNull, value)) return false;
+						} else {
+							if(!number(s, value)) return false;
+						}
+						if(!handler.value(value)) return true;
+						state = StateNext;
+					}
+					
+					// object key
+					else if(state == StateKey) {
+						if(index == index_end || src[*index] != '"') return error(get(index, index_end), "object key is expected");
+						const char *s = src + *index++;
+						string(s, src + *index++, value);
+						if(!handler.key(value.view)) return true;
+						if(index == index_end || src[*index] != ':') return error(get(index, index_end), "':' is expected");
+						index++;
+						state = StateValue;
+					}
+					
+					// separator or the end of the container
+					else {
+						if(stack.size() == 0) {
+							if(index != index_end) return error(src + *index, "unexpected data after the root value");
+							return true;
+						}
+						char c = (index != index_end) ? src[*index] : '\0';
+						uint8_t container = stack[stack.size() - 1];
+						if(c == ',') {
+							index++;
+							state = (container == TypeObject) ? StateKey : StateValue;
+						} else if(c == '}' && container == TypeObject) {
+							if(!handler.endObject()) return true;
+							stack.removeBack();
+							index++;
+						} else if(c == ']' && container == TypeArray) {
+							if(!handler.endArray()) return true;
+							stack.removeBack();
+							index++;
+						} else {
+							return error(get(index, index_end), (container == TypeObject) ? "',' or '}' is expected" : "',' or ']' is expected");
+						}
+					}
+				}
+			}
+			
+			uint32_t getNumIndices() const { return num_indices; }
+			const uint32_t *getIndices() const { return indices.get(); }
+			
+			/// character classification of the 64-byte block
+			static TS_INLINE void classify(const char *data, Block &block) {
+				#if TS_JSON_AVX2
+					block = {};
+					const __m256i quote = _mm256_set1_epi8('"');
+					const __m256i backslash = _mm256_set1_epi8('\\');
+					const __m256i open = _mm256_set1_epi8('{');
+					const __m256i close = _mm256_set1_epi8('}');
+					const __m256i colon = _mm256_set1_epi8(':');
+					const __m256i comma = _mm256_set1_epi8(',');
+					const __m256i lower = _mm256_set1_epi8(0x20);
+					const __m256i space = _mm256_set1_epi8(' ');
+					const __m256i tab = _mm256_set1_epi8('\t');
+					const __m256i line = _mm256_set1_epi8('\n');
+					const __m256i ret = _mm256_set1_epi8('\r');
+					const __m256i control = _mm256_set1_epi8(0x1f);
+					for(uint32_t i = 0; i < 2; i++) {
+						__m256i v = _mm256_loadu_si256((const __m256i*)(data + 32 * i));
+						__m256i l = _mm256_or_si256(v, lower);
+						__m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(l, open), _mm256_cmpeq_epi8(l, close)), _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+						__m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)), _mm256_or_si256(_mm256_cmpeq_epi8(v, line), _mm256_cmpeq_epi8(v, ret)));
+						uint32_t shift = 32 * i;
+						block.quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)) << shift;
+						block.backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)) << shift;
+						block.op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+						block.space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ws) << shift;
+						block.control |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v)) << shift;
+					}
+				#elif TS_SSE
+					block = {};
+					const __m128i quote = _mm_set1_epi8('"');
+					const __m128i backslash = _mm_set1_epi8('\\');
+					const __m128i open = _mm_set1_epi8('{');
+					const __m128i close = _mm_set1_epi8('}');
+					const __m128i colon = _mm_set1_epi8(':');
+					const __m128i comma = _mm_set1_epi8(',');
+					const __m128i lower = _mm_set1_epi8(0x20);
+					const __m128i space = _mm_set1_epi8(' ');
+					const __m128i tab = _mm_set1_epi8('\t');
+					const __m128i line = _mm_set1_epi8('\n');
+					const __m128i ret = _mm_set1_epi8('\r');
+					const __m128i control = _mm_set1_epi8(0x1f);
+					for(uint32_t i = 0; i < 4; i++) {
+						__m128i v = _mm_loadu_si128((const __m128i*)(data + 16 * i));
+						__m128i l = _mm_or_si128(v, lower);
+						__m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(l, open), _mm_cmpeq_epi8(l, close)), _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+						__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)), _mm_or_si128(_mm_cmpeq_epi8(v, line), _mm_cmpeq_epi8(v, ret)));
+						uint32_t shift = 16 * i;
+						block.quote |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << shift;
+						block.backslash |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)) << shift;
+						block.op |= (uint64_t)(uint32_t)_mm_movemask_epi8(op) << shift;
+						block.space |= (uint64_t)(uint32_t)_mm_movemask_epi8(ws) << shift;
+						block.control |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, control), v)) << shift;
+					}
+				#elif TS_JSON_NEON
+					uint8x16_t v[4];
+					for(uint32_t i = 0; i < 4; i++) v[i] = vld1q_u8((const uint8_t*)data + 16 * i);
+					const uint8x16_t lower = vdupq_n_u8(0x20);
+					uint8x16_t quote[4], backslash[4], op[4], ws[4], control[4];
+					for(uint32_t i = 0; i < 4; i++) {
+						uint8x16_t l = vorrq_u8(v[i], lower);
+						quote[i] = vceqq_u8(v[i], vdupq_n_u8('"'));
+						backslash[i] = vceqq_u8(v[i], vdupq_n_u8('\\'));
+						op[i] = vorrq_u8(vorrq_u8(vceqq_u8(l, vdupq_n_u8('{')), vceqq_u8(l, vdupq_n_u8('}'))), vorrq_u8(vceqq_u8(v[i], vdupq_n_u8(':')), vceqq_u8(v[i], vdupq_n_u8(','))));
+						ws[i] = vorrq_u8(vorrq_u8(vceqq_u8(v[i], vdupq_n_u8(' ')), vceqq_u8(v[i], vdupq_n_u8('\t'))), vorrq_u8(vceqq_u8(v[i], vdupq_n_u8('\n')), vceqq_u8(v[i], vdupq_n_u8('\r'))));
+						control[i] = vcleq_u8(v[i], vdupq_n_u8(0x1f));
+					}
+					block.quote = movemask(quote);
+					block.backslash = movemask(backslash);
+					block.op = movemask(op);
+					block.space = movemask(ws);
+					block.control = movemask(control);
+				#else
+					block = {};
+					for(uint32_t i = 0; i < BlockSize; i++) {
+						uint8_t c = (uint8_t)data[i];
+						uint64_t bit = 1ull << i;
+						if(c == '"') block.quote |= bit;
+						else if(c == '\\') block.backslash |= bit;
+						else if(c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') block.op |= bit;
+						else if(c == ' ' || c == '\t' || c == '\n' || c == '\r') block.space |= bit;
+						if(c < 0x20) block.control |= bit;
+					}
+				#endif
+			}
+			
+		private:
+			
+			enum State {
+				StateValue = 0,
+				StateKey,
+				StateNext,
+			};
+			
+			enum {
+				TypeObject = 0,
+				TypeArray,
+			};
+			
+			static constexpr uint64_t EvenBits = 0x5555555555555555ull;
+			
+			/// inclusive prefix xor, the bits between the quote pairs are set
+			static TS_INLINE uint64_t prefix_xor(uint64_t bits) {
+				bits ^= bits << 1;
+				bits ^= bits << 2;
+				bits ^= bits << 4;
+				bits ^= bits << 8;
+				bits ^= bits << 16;
+				bits ^= bits << 32;
+				return bits;
+			}
+			
+			static TS_INLINE uint32_t ctz(uint64_t bits) {
+				#if _WIN32
+					unsigned long index = 0;
+					_BitScanForward64(&index, bits);
+					return (uint32_t)index;
+				#else
+					return (uint32_t)__builtin_ctzll(bits);
+				#endif
+			}
+			
+			#if TS_JSON_NEON
+				static TS_INLINE uint64_t movemask(const uint8x16_t (&v)[4]) {
+					static const uint8_t bits[16] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+					const uint8x16_t mask = vld1q_u8(bits);
+					uint8x16_t sum_0 = vpaddq_u8(vandq_u8(v[0], mask), vandq_u8(v[1], mask));
+					uint8x16_t sum_1 = vpaddq_u8(vandq_u8(v[2], mask), vandq_u8(v[3], mask));
+					sum_0 = vpaddq_u8(sum_0, sum_1);
+					sum_0 = vpaddq_u8(sum_0, sum_0);
+					return vgetq_lane_u64(vreinterpretq_u64_u8(sum_0), 0);
+				}
+			#endif
+			
+			/// string between the indexed quotes
+			TS_INLINE void string(const char *s, const char *e, Value &value) const {
+				value.type = JsonReader::TypeString;
+				value.view = View(s + 1, (size_t)(e - s - 1));
+				value.escaped = (memchr(value.view.data, '\\', value.view.size) != nullptr);
+			}
+			
+			bool literal(const char *s, const char *str, JsonReader::Type type, Value &value) const {
+				size_t length = strlen(str);
+				if((size_t)(end - s) < length || memcmp(s, str, length) != 0 || !isDelimiter(s + length)) return error(s, "unknown literal");
+				value.type = type;
+				value.view = View(s, length);
+				value.escaped = false;
+				return true;
+			}
+			
+			bool number(const char *s, Value &value) const {
+				const char *e = JsonNumber::skip(s, end);
+				if(e == nullptr || !isDelimiter(e)) return error(s, "invalid number");
+				value.type = JsonReader::TypeNumber;
+				value.view = View(s, (size_t)(e - s));
+				value.escaped = false;
+				return true;
+			}
+			
+			/// scalars end with the whitespace or the structural character
+			TS_INLINE bool isDelimiter(const char *s) const {
+				if(s == end) return true;
+				char c = *s;
+				return (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ']' || c == '}' || c == ':' || c == '[' || c == '{' || c == '"');
+			}
+			
+			const char *get(const uint32_t *index, const uint32_t *index_end) const {
+				return (index != index_end) ? begin + *index : end;
+			}
+			
+			bool error(const char *s, const char *message) const {
+				uint32_t line = 1;
+				for(const char *p = begin; p < s; p++) line += (*p == '\n');
+				TS_LOGF(Error, "JsonScanner::parse(): %s at line %u offset %u\n", message, line, (uint32_t)(s - begin));
+				return false;
+			}
+			
+			const char *begin = nullptr;
+			const char *end = nullptr;
+			
+			Array<uint32_t> indices;
+			uint32_t num_indices = 0;
+			
+			Array<uint8_t> stack;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_SCANNER_H__ */
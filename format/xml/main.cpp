@@ -21,8 +21,14 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimFile.h>
+#include <core/TellusimSource.h>
 #include <format/TellusimXml.h>
 
+#include "main_reader.h"
+#include "main_document.h"
+
 /*
  */
 using namespace Tellusim;
@@ -74,5 +80,226 @@ int32_t main(int32_t argc, char **argv) {
 		if(!copy.save("test_save_b.xml")) return 1;
 	}
 	
+	// arena document
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 200000;
+		
+		// arena nodes
+		uint64_t begin = Time::current();
+		XmlDocument document;
+		XmlDocument::Node *root = document.addChild(nullptr, "root");
+		for(uint32_t i = 0; i < size; i++) {
+			XmlDocument::Node *item = document.addChild(root, "item");
+			document.setAttribute(item, "id", String::format("%u", i).get());
+			document.setAttribute(item, "name", String::format("item \"%u\"", i).get());
+			document.setData(document.addChild(item, "value"), String::format("%u < %u", i, i + 1).get());
+		}
+		uint64_t create_time = Time::current() - begin;
+		
+		begin = Time::current();
+		XmlDocument copy;
+		document.clone(copy);
+		uint64_t clone_time = Time::current() - begin;
+		
+		if(copy.getRoot()->num_children != size) return 1;
+		if(strcmp(copy.getRoot()->child->next->getAttribute("name"), "item \"1\"") != 0) return 1;
+		if(document.getString() != copy.getString()) return 1;
+		
+		size_t memory = document.getMemory();
+		begin = Time::current();
+		document.clear();
+		copy.clear();
+		uint64_t clear_time = Time::current() - begin;
+		TS_LOGF(Message, "XmlDocument: create %s clone %s clear %s (%s)\n", String::fromTime(create_time).get(), String::fromTime(clone_time).get(), String::fromTime(clear_time).get(), String::fromBytes(memory).get());
+		
+		// heap nodes
+		begin = Time::current();
+		Xml *xml = new Xml("root");
+		for(uint32_t i = 0; i < size; i++) {
+			Xml item(xml, "item");
+			item.setAttribute("id", String::format("%u", i).get());
+			item.setAttribute("name", String::format("item \"%u\"", i).get());
+			Xml(&item, "value").setData(String::format("%u < %u", i, i + 1).get());
+		}
+		create_time = Time::current() - begin;
+		
+		begin = Time::current();
+		Xml *xml_copy = new Xml(xml->clonePtr());
+		clone_time = Time::current() - begin;
+		
+		begin = Time::current();
+		delete xml;
+		delete xml_copy;
+		clear_time = Time::current() - begin;
+		TS_LOGF(Message, "Xml: create %s clone %s clear %s\n", String::fromTime(create_time).get(), String::fromTime(clone_time).get(), String::fromTime(clear_time).get());
+		
+		// escaped text
+		root = document.addChild(nullptr, "root");
+		document.setAttribute(root, "version", "2");
+		document.setData(document.addChild(root, "first"), "<first & data>");
+		document.addChild(root, "second");
+		document.clone(copy);
+		document.clear();
+		TS_LOGF(Message, "copy: %s\n", copy.getString().get());
+		if(copy.getString() != "<root version=\"2\"><first>&lt;first &amp; data&gt;</first><second/></root>") return 1;
+		
+		// shortest numbers
+		const float32_t positions[] = { 0.1f, -2.5f, 1e-7f, 16777216.0f };
+		const uint32_t indices[] = { 0, 1, 4294967295u };
+		root = document.addChild(nullptr, "mesh");
+		document.setAttribute(root, "scale", 0.3);
+		document.setAttribute(root, "offset", -1.1f);
+		document.setAttribute(root, "count", 4u);
+		document.setData(document.addChild(root, "positions"), positions, TS_COUNTOF(positions));
+		document.setData(document.addChild(root, "indices"), indices, TS_COUNTOF(indices));
+		TS_LOGF(Message, "numbers: %s\n", document.getString().get());
+		if(document.getString() != "<mesh scale=\"0.3\" offset=\"-1.1\" count=\"4\"><positions>0.1 -2.5 1e-07 16777216</positions><indices>0 1 4294967295</indices></mesh>") return 1;
+		document.clear();
+	}
+	
+	// streaming reader
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		// event log
+		const char *src = "<?xml version=\"1.0\"?>\n<!DOCTYPE svg [ <!ENTITY e \"x\"> ]>\n<!-- comment -->\n<svg width='10' title=\"a &amp; b &#x41;&#66;\">\n"
+			"\t<g id=\"layer\"><rect x=\"1\"/><text>1 &lt; 2</text><![CDATA[<raw & data>]]></g>\n</svg>\n";
+		XmlReader reader(src, strlen(src));
+		String events;
+		while(true) {
+			XmlReader::Event event = reader.next();
+			if(event == XmlReader::EventStart) {
+				events += String::format("<%s", reader.getName().get().get());
+				for(uint32_t i = 0; i < reader.getNumAttributes(); i++) {
+					events += String::format(" %s=%s", reader.getAttribute(i).name.get().get(), reader.getAttribute(i).get().get());
+				}
+				events += ">";
+			}
+			else if(event == XmlReader::EventEnd) events += String::format("</%s>", reader.getName().get().get());
+			else if(event == XmlReader::EventText) events += String::format("[%s]", reader.getTextString().get());
+			else if(event == XmlReader::EventNone) break;
+			else return 1;
+		}
+		TS_LOGF(Message, "events: %s\n", events.get());
+		if(events != "<svg width=10 title=a & b AB><g id=layer><rect x=1></rect><text>[1 < 2]</text>[<raw & data>]</g></svg>") return 1;
+		
+		// attributes are decoded on demand
+		reader.open(src, strlen(src));
+		if(reader.next() != XmlReader::EventStart) return 1;
+		if(reader.findAttribute("title")->value != "a &amp; b &#x41;&#66;" || reader.getAttribute("title") != "a & b AB") return 1;
+		
+		// skipped subtrees
+		if(reader.next() != XmlReader::EventStart || reader.getName() != "g" || !reader.skip()) return 1;
+		if(reader.next() != XmlReader::EventEnd || reader.getName() != "svg" || reader.next() != XmlReader::EventNone) return 1;
+		
+		// document built on the reader
+		XmlDocument document;
+		if(!document.create(src, strlen(src))) return 1;
+		TS_LOGF(Message, "document: %s\n", document.getString().get());
+		if(document.getString() != "<svg width=\"10\" title=\"a &amp; b AB\"><g id=\"layer\"><rect x=\"1\"/><text>1 &lt; 2</text>&lt;raw &amp; data&gt;</g></svg>") return 1;
+		
+		// mixed content keeps the document order
+		const char *mixed = "<p>a<b/>c<!-- d -->e<i>f</i>g</p>";
+		if(!document.create(mixed, strlen(mixed)) || document.getString() != "<p>a<b/>ce<i>f</i>g</p>") return 1;
+		
+		// deeply nested elements are written without recursion
+		String nested;
+		for(uint32_t i = 0; i < 1024 * 64; i++) nested += "<a>";
+		nested += "x";
+		for(uint32_t i = 0; i < 1024 * 64; i++) nested += "</a>";
+		if(!document.create(nested.get(), nested.size()) || document.getString() != nested) return 1;
+		
+		// invalid character references are kept as is
+		if(XmlReader::decode(XmlReader::View("&#xZ1;&#x;&#0;&#65;", 19)) != "&#xZ1;&#x;&#0;A") return 1;
+		
+		// malformed inputs are rejected
+		const char *errors[] = { "", "<a>", "<a></b>", "<a b></a>", "<a b=\"1></a>", "<a/><b/>", "text<a/>", "<a><!-- </a>", "<a b=\"<\"/>" };
+		for(uint32_t i = 0; i < TS_COUNTOF(errors); i++) {
+			if(document.create(errors[i], strlen(errors[i]))) return 1;
+		}
+	}
+	
+	// streaming reader benchmark
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t num_geometries = 2000;
+		constexpr uint32_t num_values = 600;
+		const char *name = "test_reader.xml";
+		
+		// COLLADA geometry library
+		{
+			File file;
+			if(!file.open(name, "wb")) return 1;
+			file.puts("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n");
+			file.puts("\t<asset><unit name=\"meter\" meter=\"1\"/><up_axis>Y_UP</up_axis></asset>\n\t<library_geometries>\n");
+			Array<float32_t> values(num_values);
+			for(uint32_t i = 0; i < num_geometries; i++) {
+				for(uint32_t j = 0; j < num_values; j++) values[j] = Tellusim::sin(i * 0.1f + j * 0.01f) * 100.0f;
+				XmlDocument array;
+				XmlDocument::Node *node = array.addChild(nullptr, "float_array");
+				array.setAttribute(node, "id", String::format("mesh_%u_positions", i).get());
+				array.setAttribute(node, "count", num_values);
+				array.setData(node, values.get(), num_values);
+				file.puts(String::format("\t\t<geometry id=\"mesh_%u\" name=\"mesh &quot;%u&quot;\">\n\t\t\t<mesh>\n\t\t\t\t<source id=\"mesh_%u_positions\">\n\t\t\t\t\t", i, i, i));
+				file.puts(array.getString());
+				file.puts("\n\t\t\t\t\t<technique_common><accessor source=\"#positions\" count=\"200\" stride=\"3\"/></technique_common>\n\t\t\t\t</source>\n\t\t\t</mesh>\n\t\t</geometry>\n");
+			}
+			file.puts("\t</library_geometries>\n</COLLADA>\n");
+		}
+		
+		Array<char> data;
+		{
+			Source source;
+			if(!source.open(name)) return 1;
+			data.resize(source.getSize());
+			if(source.read(data.get(), data.size()) != data.size()) return 1;
+		}
+		
+		// geometry names only, the arrays are skipped
+		uint64_t begin = Time::current();
+		XmlReader reader(data.get(), data.size());
+		uint32_t num_names = 0;
+		uint32_t num_count = 0;
+		String last_name;
+		while(true) {
+			XmlReader::Event event = reader.next();
+			if(event == XmlReader::EventNone) break;
+			if(event == XmlReader::EventError) return 1;
+			if(event != XmlReader::EventStart) continue;
+			if(reader.getName() == "geometry") {
+				last_name = reader.getAttribute("name");
+				num_names++;
+			} else if(reader.getName() == "float_array") {
+				num_count += (uint32_t)atoi(reader.getAttribute("count").get());
+				if(!reader.skip()) return 1;
+			}
+		}
+		uint64_t reader_time = Time::current() - begin;
+		TS_LOGF(Message, "XmlReader: %s %s (%.1f MB/s) %u %s\n", String::fromBytes(data.size()).get(), String::fromTime(reader_time).get(), data.size() / (float64_t)max(reader_time, (uint64_t)1), num_names, last_name.get());
+		if(num_names != num_geometries || num_count != num_geometries * num_values || last_name != String::format("mesh \"%u\"", num_geometries - 1)) return 1;
+		
+		// arena document
+		begin = Time::current();
+		XmlDocument document;
+		if(!document.create(data.get(), data.size())) return 1;
+		uint64_t create_time = Time::current() - begin;
+		TS_LOGF(Message, "XmlDocument::create: %s (%.1f MB/s)\n", String::fromTime(create_time).get(), data.size() / (float64_t)max(create_time, (uint64_t)1));
+		const XmlDocument::Node *geometries = document.getRoot()->getChild("library_geometries");
+		if(geometries == nullptr || geometries->num_children != num_geometries) return 1;
+		
+		// heap nodes
+		begin = Time::current();
+		Xml xml;
+		if(!xml.load(name)) return 1;
+		uint64_t load_time = Time::current() - begin;
+		TS_LOGF(Message, "Xml::load: %s (%.1f MB/s)\n", String::fromTime(load_time).get(), data.size() / (float64_t)max(load_time, (uint64_t)1));
+	}
+	
 	return 0;
 }
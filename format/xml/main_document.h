@@ -0,0 +1,332 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_XML_DOCUMENT_H__
+#define __TELLUSIM_TESTS_XML_DOCUMENT_H__
+
+#include <core/TellusimString.h>
+#include <core/TellusimSource.h>
+
+#include "main_reader.h"
+#include "main_arena.h"
+#include "main_number.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class XmlDocument {
+			
+		public:
+			
+			/// arena attribute
+			struct Attribute {
+				const char *name = nullptr;
+				const char *value = nullptr;
+				Attribute *next = nullptr;
+			};
+			
+			/// arena node, all strings are null-terminated and decoded
+			struct Node {
+				
+				/// text nodes have no name
+				bool isText() const { return (name == nullptr); }
+				
+				const Node *getChild(const char *str) const {
+					for(const Node *node = child; node; node = node->next) {
+						if(node->name && strcmp(node->name, str) == 0) return node;
+					}
+					return nullptr;
+				}
+				
+				const char *getAttribute(const char *str) const {
+					for(const Attribute *attribute = attributes; attribute; attribute = attribute->next) {
+						if(strcmp(attribute->name, str) == 0) return attribute->value;
+					}
+					return nullptr;
+				}
+				
+				uint32_t num_children = 0;
+				uint32_t num_attributes = 0;
+				const char *name = nullptr;
+				const char *data = nullptr;
+				Attribute *attributes = nullptr;
+				Attribute *last_attribute = nullptr;
+				Node *child = nullptr;
+				Node *last = nullptr;
+				Node *next = nullptr;
+			};
+			
+			explicit XmlDocument(size_t block_size = Arena::BlockSize) : arena(block_size) { }
+			
+			/// releases all nodes at once
+			void clear() {
+				arena.clear();
+				root = nullptr;
+			}
+			
+			/// creates the document from the XML text with the pull reader
+			/// the text before the first child element is the node data, the text after
+			/// the child elements is kept in the unnamed text nodes in the document order
+			bool create(const char *src, size_t size) {
+				clear();
+				XmlReader reader(src, size);
+				Array<Node*> stack;
+				Array<char> buffer;
+				Array<char> text;
+				while(true) {
+					XmlReader::Event event = reader.next();
+					if(event == XmlReader::EventStart) {
+						Node *parent = (stack.size()) ? stack[stack.size() - 1] : nullptr;
+						if(parent) commit(parent, text);
+						const XmlReader::View &name = reader.getName();
+						Node *node = addChild(parent, name.data, name.size);
+						for(uint32_t i = 0; i < reader.getNumAttributes(); i++) {
+							const XmlReader::Attribute &attribute = reader.getAttribute(i);
+							if(attribute.escaped) {
+								buffer.clear();
+								XmlReader::decode(attribute.value, buffer);
+								setAttribute(node, attribute.name.data, attribute.name.size, buffer.get(), buffer.size());
+							} else {
+								setAttribute(node, attribute.name.data, attribute.name.size, attribute.value.data, attribute.value.size);
+							}
+						}
+						stack.append(node);
+					} else if(event == XmlReader::EventEnd) {
+						commit(stack[stack.size() - 1], text);
+						stack.removeBack();
+					} else if(event == XmlReader::EventText) {
+						if(reader.isTextEscaped()) {
+							XmlReader::decode(reader.getText(), text);
+						} else {
+							size_t offset = text.size();
+							text.resize(offset + reader.getText().size);
+							memcpy(text.get() + offset, reader.getText().data, reader.getText().size);
+						}
+					} else if(event == XmlReader::EventNone) {
+						return true;
+					} else {
+						clear();
+						return false;
+					}
+				}
+			}
+			
+			bool load(const char *name) {
+				Source source;
+				if(!source.open(name)) return false;
+				size_t size = source.getSize();
+				Array<char> data(size);
+				if(source.read(data.get(), size) != size) return false;
+				return create(data.get(), size);
+			}
+			
+			/// appends a new node, the null parent creates the root
+			Node *addChild(Node *parent, const char *name) {
+				return addChild(parent, name, strlen(name));
+			}
+			
+			Node *addChild(Node *parent, const char *name, size_t size) {
+				Node *node = arena.create<Node>();
+				if(name) node->name = arena.copy(name, size);
+				if(parent == nullptr) {
+					root = node;
+				} else {
+					if(parent->last) parent->last->next = node;
+					else parent->child = node;
+					parent->last = node;
+					parent->num_children++;
+				}
+				return node;
+			}
+			
+			/// appends the attribute, duplicate names are not checked
+			void setAttribute(Node *node, const char *name, const char *value) {
+				setAttribute(node, name, strlen(name), value, strlen(value));
+			}
+			
+			void setAttribute(Node *node, const char *name, size_t name_size, const char *value, size_t value_size) {
+				Attribute *attribute = arena.create<Attribute>();
+				attribute->name = arena.copy(name, name_size);
+				attribute->value = arena.copy(value, value_size);
+				if(node->last_attribute) node->last_attribute->next = attribute;
+				else node->attributes = attribute;
+				node->last_attribute = attribute;
+				node->num_attributes++;
+			}
+			
+			/// number attributes with the shortest text
+			void setAttribute(Node *node, const char *name, float32_t value) { setNumber(node, name, value); }
+			void setAttribute(Node *node, const char *name, float64_t value) { setNumber(node, name, value); }
+			void setAttribute(Node *node, const char *name, int32_t value) { setNumber(node, name, value); }
+			void setAttribute(Node *node, const char *name, uint32_t value) { setNumber(node, name, value); }
+			
+			void setData(Node *node, const char *data) {
+				setData(node, data, strlen(data));
+			}
+			
+			void setData(Node *node, const char *data, size_t size) {
+				node->data = arena.copy(data, size);
+			}
+			
+			/// space-separated number lists
+			void setData(Node *node, const float32_t *data, uint32_t size) { setNumbers(node, data, size); }
+			void setData(Node *node, const uint32_t *data, uint32_t size) { setNumbers(node, data, size); }
+			
+			/// copies the arena blocks and relocates the node pointers
+			void clone(XmlDocument &dest) const {
+				dest.clear();
+				if(root == nullptr) return;
+				dest.arena.copy(arena);
+				Arena::Relocation relocation(arena, dest.arena);
+				dest.root = relocation.get(root);
+				Array<Node*> stack;
+				stack.append(dest.root);
+				while(stack.size()) {
+					Node *node = stack[stack.size() - 1];
+					stack.removeBack();
+					node->name = relocation.get(node->name);
+					node->data = relocation.get(node->data);
+					node->attributes = relocation.get(node->attributes);
+					node->last_attribute = relocation.get(node->last_attribute);
+					for(Attribute *attribute = node->attributes; attribute; attribute = attribute->next) {
+						attribute->name = relocation.get(attribute->name);
+						attribute->value = relocation.get(attribute->value);
+						attribute->next = relocation.get(attribute->next);
+					}
+					node->child = relocation.get(node->child);
+					node->last = relocation.get(node->last);
+					node->next = relocation.get(node->next);
+					if(node->next) stack.append(node->next);
+					if(node->child) stack.append(node->child);
+				}
+			}
+			
+			/// XML text without indentation
+			String getString() const {
+				Array<char> buffer;
+				if(root) write(buffer, root);
+				buffer.append('\0');
+				return String(buffer.get());
+			}
+			
+			const Node *getRoot() const { return root; }
+			Node *getRoot() { return root; }
+			
+			size_t getMemory() const { return arena.getMemory(); }
+			
+		private:
+			
+			template <class Type> void setNumber(Node *node, const char *name, Type value) {
+				char data[JsonNumber::MaxLength];
+				uint32_t size = JsonNumber::format(data, value);
+				setAttribute(node, name, strlen(name), data, size);
+			}
+			
+			template <class Type> void setNumbers(Node *node, const Type *data, uint32_t size) {
+				Array<char> buffer;
+				buffer.resize((size_t)size * JsonNumber::MaxLength + 1);
+				char *d = buffer.get();
+				for(uint32_t i = 0; i < size; i++) {
+					if(i) *d++ = ' ';
+					d += JsonNumber::format(d, data[i]);
+				}
+				setData(node, buffer.get(), (size_t)(d - buffer.get()));
+			}
+			
+			/// pending text of the node is the data or the text node after the child elements
+			void commit(Node *node, Array<char> &text) {
+				if(text.size() == 0) return;
+				if(node->child == nullptr) setData(node, text.get(), text.size());
+				else setData(addChild(node, nullptr, 0), text.get(), text.size());
+				text.clear();
+			}
+			
+			static void write(Array<char> &buffer, const char *str) {
+				while(*str) buffer.append(*str++);
+			}
+			
+			/// escaped attribute values and data
+			static void escape(Array<char> &buffer, const char *str) {
+				for(; *str; str++) {
+					char c = *str;
+					if(c == '&') write(buffer, "&amp;");
+					else if(c == '<') write(buffer, "&lt;");
+					else if(c == '>') write(buffer, "&gt;");
+					else if(c == '"') write(buffer, "&quot;");
+					else buffer.append(c);
+				}
+			}
+			
+			/// writes the tree with an explicit stack of the open elements
+			static void write(Array<char> &buffer, const Node *node) {
+				Array<const Node*> stack;
+				while(true) {
+					if(node->isText()) {
+						escape(buffer, node->data);
+					} else {
+						buffer.append('<');
+						write(buffer, node->name);
+						for(const Attribute *attribute = node->attributes; attribute; attribute = attribute->next) {
+							buffer.append(' ');
+							write(buffer, attribute->name);
+							write(buffer, "=\"");
+							escape(buffer, attribute->value);
+							buffer.append('"');
+						}
+						if(node->child == nullptr && node->data == nullptr) {
+							write(buffer, "/>");
+						} else {
+							buffer.append('>');
+							if(node->data) escape(buffer, node->data);
+							if(node->child) {
+								stack.append(node);
+								node = node->child;
+								continue;
+							}
+							close(buffer, node);
+						}
+					}
+					while(stack.size() && node->next == nullptr) {
+						node = stack[stack.size() - 1];
+						stack.removeBack();
+						close(buffer, node);
+					}
+					if(stack.size() == 0) break;
+					node = node->next;
+				}
+			}
+			
+			static void close(Array<char> &buffer, const Node *node) {
+				write(buffer, "</");
+				write(buffer, node->name);
+				buffer.append('>');
+			}
+			
+			Arena arena;
+			Node *root = nullptr;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_XML_DOCUMENT_H__ */
@@ -0,0 +1,506 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_JSON_NUMBER_H__
+#define __TELLUSIM_TESTS_JSON_NUMBER_H__
+
+#include <core/TellusimArray.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class JsonNumber {
+			
+		public:
+			
+			enum {
+				MaxLength = 32,
+			};
+			
+			/// skips the number with the JSON grammar without the conversion
+			/// returns the end of the number or nullptr for the invalid numbers
+			static const char *skip(const char *s, const char *end) {
+				if(s != end && *s == '-') s++;
+				if(s == end || !isDigit(*s)) return nullptr;
+				if(*s == '0') s++;
+				else while(s != end && isDigit(*s)) s++;
+				if(s != end && *s == '.') {
+					if(++s == end || !isDigit(*s)) return nullptr;
+					while(s != end && isDigit(*s)) s++;
+				}
+				if(s != end && (*s == 'e' || *s == 'E')) {
+					if(++s != end && (*s == '+' || *s == '-')) s++;
+					if(s == end || !isDigit(*s)) return nullptr;
+					while(s != end && isDigit(*s)) s++;
+				}
+				return s;
+			}
+			
+			/// parses the number with the JSON grammar
+			/// returns the end of the number or nullptr for the invalid numbers
+			/// the result is correctly rounded, exactly representable mantissas use the
+			/// floating-point fast path and the remaining numbers are converted by strtod
+			static const char *parse(const char *s, const char *end, float64_t &value) {
+				
+				const char *str = s;
+				bool negative = false;
+				if(s != end && *s == '-') {
+					negative = true;
+					s++;
+				}
+				
+				// integer part
+				uint64_t mantissa = 0;
+				uint32_t num_digits = 0;
+				int32_t exponent = 0;
+				if(s == end || !isDigit(*s)) return nullptr;
+				if(*s == '0') {
+					s++;
+				} else {
+					while(num_digits + 8 <= MaxDigits && end - s >= 8 && getEightDigits(s, mantissa)) {
+						num_digits += 8;
+						s += 8;
+					}
+					while(s != end && isDigit(*s)) {
+						if(num_digits < MaxDigits) mantissa = mantissa * 10 + (uint64_t)(*s - '0');
+						else exponent++;
+						num_digits++;
+						s++;
+					}
+				}
+				
+				// fractional part
+				if(s != end && *s == '.') {
+					if(++s == end || !isDigit(*s)) return nullptr;
+					while(s != end && isDigit(*s)) {
+						if(mantissa && num_digits + 8 <= MaxDigits && end - s >= 8 && getEightDigits(s, mantissa)) {
+							exponent -= 8;
+							num_digits += 8;
+							s += 8;
+							continue;
+						}
+						if(mantissa == 0 && *s == '0') {
+							exponent--;
+						} else if(num_digits < MaxDigits) {
+							mantissa = mantissa * 10 + (uint64_t)(*s - '0');
+							exponent--;
+							num_digits++;
+						} else {
+							num_digits++;
+						}
+						s++;
+					}
+				}
+				
+				// exponent part
+				if(s != end && (*s == 'e' || *s == 'E')) {
+					bool exponent_negative = false;
+					if(++s != end && (*s == '+' || *s == '-')) exponent_negative = (*s++ == '-');
+					if(s == end || !isDigit(*s)) return nullptr;
+					int32_t e = 0;
+					while(s != end && isDigit(*s)) {
+						if(e < 100000) e = e * 10 + (*s - '0');
+						s++;
+					}
+					exponent += (exponent_negative) ? -e : e;
+				}
+				
+				// exact fast path, both operands are exactly representable
+				if(num_digits <= MaxDigits && mantissa <= MaxMantissa) {
+					float64_t m = (float64_t)mantissa;
+					if(exponent == 0) {
+						value = (negative) ? -m : m;
+						return s;
+					}
+					if(exponent < 0 && exponent >= -22) {
+						m /= get_power(-exponent);
+						value = (negative) ? -m : m;
+						return s;
+					}
+					if(exponent > 0 && exponent <= 22 + 15) {
+						// the excess exponent is moved into the mantissa while it stays exact
+						if(exponent > 22) {
+							m *= get_power(exponent - 22);
+							exponent = 22;
+						}
+						if(m < (float64_t)MaxMantissa) {
+							m *= get_power(exponent);
+							value = (negative) ? -m : m;
+							return s;
+						}
+					}
+				}
+				
+				// correctly rounded slow path
+				size_t size = (size_t)(s - str);
+				char buffer[64];
+				if(size < sizeof(buffer)) {
+					memcpy(buffer, str, size);
+					buffer[size] = '\0';
+					value = strtod(buffer, nullptr);
+				} else {
+					Array<char> data(size + 1);
+					memcpy(data.get(), str, size);
+					data[size] = '\0';
+					value = strtod(data.get(), nullptr);
+				}
+				return s;
+			}
+			
+			/// shortest text which reads back to the same value, the destination holds MaxLength characters
+			/// the fixed notation is used for the decimal exponents from -4 up to the type precision like the %g
+			static uint32_t format(char *dest, float64_t value) {
+				uint64_t bits = 0;
+				memcpy(&bits, &value, sizeof(bits));
+				uint32_t exponent = (uint32_t)(bits >> 52) & 0x7ff;
+				uint64_t mantissa = bits & ((1ull << 52) - 1);
+				char *d = dest;
+				if(bits >> 63) *d++ = '-';
+				if(exponent == 0x7ff) return (uint32_t)(write(d, (mantissa) ? "nan" : "inf") - dest);
+				if(exponent == 0 && mantissa == 0) return (uint32_t)(write(d, "0") - dest);
+				Decimal decimal;
+				if(exponent) decimal = get_shortest(mantissa | (1ull << 52), (int32_t)exponent - 1075, (mantissa == 0 && exponent > 1));
+				else decimal = get_shortest(mantissa, -1074, false);
+				if(decimal.size == 0) decimal = get_decimal((bits >> 63) ? -value : value, 15, 17, false);
+				return (uint32_t)(write(d, decimal, 17) - dest);
+			}
+			
+			static uint32_t format(char *dest, float32_t value) {
+				uint32_t bits = 0;
+				memcpy(&bits, &value, sizeof(bits));
+				uint32_t exponent = (bits >> 23) & 0xff;
+				uint32_t mantissa = bits & ((1u << 23) - 1);
+				char *d = dest;
+				if(bits >> 31) *d++ = '-';
+				if(exponent == 0xff) return (uint32_t)(write(d, (mantissa) ? "nan" : "inf") - dest);
+				if(exponent == 0 && mantissa == 0) return (uint32_t)(write(d, "0") - dest);
+				Decimal decimal;
+				if(exponent) decimal = get_shortest(mantissa | (1u << 23), (int32_t)exponent - 150, (mantissa == 0 && exponent > 1));
+				else decimal = get_shortest(mantissa, -149, false);
+				if(decimal.size == 0) decimal = get_decimal((bits >> 31) ? -value : value, 6, 9, true);
+				return (uint32_t)(write(d, decimal, 9) - dest);
+			}
+			
+			/// integers are written by the digit pairs
+			static uint32_t format(char *dest, uint64_t value) {
+				char buffer[24];
+				char *d = buffer + sizeof(buffer);
+				while(value >= 100) {
+					const char *pair = get_pair((uint32_t)(value % 100));
+					value /= 100;
+					*--d = pair[1];
+					*--d = pair[0];
+				}
+				if(value >= 10) {
+					const char *pair = get_pair((uint32_t)value);
+					*--d = pair[1];
+					*--d = pair[0];
+				} else {
+					*--d = (char)('0' + value);
+				}
+				uint32_t size = (uint32_t)(buffer + sizeof(buffer) - d);
+				memcpy(dest, d, size);
+				dest[size] = '\0';
+				return size;
+			}
+			
+			static uint32_t format(char *dest, int64_t value) {
+				if(value >= 0) return format(dest, (uint64_t)value);
+				*dest = '-';
+				return format(dest + 1, 0 - (uint64_t)value) + 1;
+			}
+			
+			static uint32_t format(char *dest, uint32_t value) { return format(dest, (uint64_t)value); }
+			static uint32_t format(char *dest, int32_t value) { return format(dest, (int64_t)value); }
+			
+		private:
+			
+			enum {
+				MaxDigits = 19,
+			};
+			
+			static constexpr uint64_t MaxMantissa = 1ull << 53;
+			
+			static TS_INLINE bool isDigit(char c) {
+				return (c >= '0' && c <= '9');
+			}
+			
+			/// appends eight digits at once, the data is loaded in the little-endian order
+			static TS_INLINE bool getEightDigits(const char *s, uint64_t &mantissa) {
+				uint64_t value = 0;
+				memcpy(&value, s, sizeof(value));
+				if((((value & 0xf0f0f0f0f0f0f0f0ull) | (((value + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) != 0x3333333333333333ull)) return false;
+				value = ((value & 0x0f0f0f0f0f0f0f0full) * 2561) >> 8;
+				value = ((value & 0x00ff00ff00ff00ffull) * 6553601) >> 16;
+				value = ((value & 0x0000ffff0000ffffull) * 42949672960001ull) >> 32;
+				mantissa = mantissa * 100000000 + (uint32_t)value;
+				return true;
+			}
+			
+			/// exactly representable powers of ten
+			static TS_INLINE float64_t get_power(int32_t exponent) {
+				static const float64_t powers[] = {
+					1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+				};
+				return powers[exponent];
+			}
+			
+			/// decimal digits and the exponent of the last digit
+			struct Decimal {
+				char digits[20];
+				uint32_t size = 0;
+				int32_t exponent = 0;
+			};
+			
+			/// extended float with the 64-bit significand
+			struct DiyFp {
+				uint64_t f;
+				int32_t e;
+			};
+			
+			/// rounded product of the significands
+			static TS_INLINE DiyFp mul(const DiyFp &a, const DiyFp &b) {
+				uint64_t a1 = a.f >> 32;
+				uint64_t a0 = a.f & 0xffffffffull;
+				uint64_t b1 = b.f >> 32;
+				uint64_t b0 = b.f & 0xffffffffull;
+				uint64_t a1b0 = a1 * b0;
+				uint64_t a0b1 = a0 * b1;
+				uint64_t temp = ((a0 * b0) >> 32) + (a1b0 & 0xffffffffull) + (a0b1 & 0xffffffffull) + (1ull << 31);
+				return DiyFp { a1 * b1 + (a1b0 >> 32) + (a0b1 >> 32) + (temp >> 32), a.e + b.e + 64 };
+			}
+			
+			static TS_INLINE DiyFp normalize(DiyFp v) {
+				#if _WIN32
+					unsigned long index = 0;
+					_BitScanReverse64(&index, v.f);
+					uint32_t shift = 63 - (uint32_t)index;
+				#else
+					uint32_t shift = (uint32_t)__builtin_clzll(v.f);
+				#endif
+				return DiyFp { v.f << shift, v.e - (int32_t)shift };
+			}
+			
+			/// Grisu3 shortest digits of the f * 2^e value
+			/// the empty result means that the shortest digits can not be proved and the slow path is required
+			static Decimal get_shortest(uint64_t f, int32_t e, bool lower_closer) {
+				
+				// normalized value and its rounding boundaries
+				DiyFp w = normalize(DiyFp { f, e });
+				DiyFp plus = normalize(DiyFp { (f << 1) + 1, e - 1 });
+				DiyFp minus = (lower_closer) ? DiyFp { (f << 2) - 1, e - 2 } : DiyFp { (f << 1) - 1, e - 1 };
+				minus.f <<= minus.e - plus.e;
+				minus.e = plus.e;
+				
+				// cached power of ten moving the binary exponent into the [-60, -32] range
+				float64_t k = (-60 - (w.e + 64) + 63) * 0.30102999566398114;
+				int32_t power_exponent = (int32_t)k;
+				if(k > power_exponent) power_exponent++;
+				const CachedPower &power = get_cached_power((348 + power_exponent - 1) / 8 + 1);
+				DiyFp c = { power.f, power.e };
+				w = mul(w, c);
+				minus = mul(minus, c);
+				plus = mul(plus, c);
+				
+				// digits generation inside the unsafe interval
+				Decimal decimal;
+				uint64_t unit = 1;
+				DiyFp too_low = { minus.f - unit, minus.e };
+				DiyFp too_high = { plus.f + unit, plus.e };
+				uint64_t unsafe_interval = too_high.f - too_low.f;
+				uint32_t shift = (uint32_t)-w.e;
+				uint64_t one = 1ull << shift;
+				uint32_t integrals = (uint32_t)(too_high.f >> shift);
+				uint64_t fractionals = too_high.f & (one - 1);
+				uint32_t divisor = 1;
+				int32_t kappa = 0;
+				if(integrals) {
+					kappa = 1;
+					while(kappa < 10 && integrals >= divisor * 10) {
+						divisor *= 10;
+						kappa++;
+					}
+				}
+				while(kappa > 0) {
+					decimal.digits[decimal.size++] = (char)('0' + integrals / divisor);
+					integrals %= divisor;
+					kappa--;
+					uint64_t rest = ((uint64_t)integrals << shift) + fractionals;
+					if(rest < unsafe_interval) {
+						decimal.exponent = kappa - power.k;
+						if(!round_weed(decimal, too_high.f - w.f, unsafe_interval, rest, (uint64_t)divisor << shift, unit)) decimal.size = 0;
+						return decimal;
+					}
+					divisor /= 10;
+				}
+				while(true) {
+					fractionals *= 10;
+					unit *= 10;
+					unsafe_interval *= 10;
+					decimal.digits[decimal.size++] = (char)('0' + (fractionals >> shift));
+					fractionals &= one - 1;
+					kappa--;
+					if(fractionals < unsafe_interval) {
+						decimal.exponent = kappa - power.k;
+						if(!round_weed(decimal, (too_high.f - w.f) * unit, unsafe_interval, fractionals, one, unit)) decimal.size = 0;
+						return decimal;
+					}
+					if(decimal.size == sizeof(decimal.digits)) {
+						decimal.size = 0;
+						return decimal;
+					}
+				}
+			}
+			
+			/// moves the last digit closer to the value and rejects the ambiguous results
+			static bool round_weed(Decimal &decimal, uint64_t distance, uint64_t unsafe_interval, uint64_t rest, uint64_t ten_kappa, uint64_t unit) {
+				uint64_t small_distance = distance - unit;
+				uint64_t big_distance = distance + unit;
+				while(rest < small_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < small_distance || small_distance - rest >= rest + ten_kappa - small_distance)) {
+					decimal.digits[decimal.size - 1]--;
+					rest += ten_kappa;
+				}
+				if(rest < big_distance && unsafe_interval - rest >= ten_kappa && (rest + ten_kappa < big_distance || big_distance - rest > rest + ten_kappa - big_distance)) return false;
+				return (2 * unit <= rest && rest <= unsafe_interval - 4 * unit);
+			}
+			
+			/// correctly rounded digits with the increasing precision
+			static Decimal get_decimal(float64_t value, int32_t min_precision, int32_t max_precision, bool single) {
+				Decimal decimal;
+				char buffer[32];
+				for(int32_t precision = min_precision; precision <= max_precision; precision++) {
+					snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+					if(single && strtof(buffer, nullptr) == (float32_t)value) break;
+					if(!single && strtod(buffer, nullptr) == value) break;
+				}
+				char *s = buffer;
+				decimal.size = 0;
+				for(; *s != 'e'; s++) {
+					if(isDigit(*s)) decimal.digits[decimal.size++] = *s;
+				}
+				decimal.exponent = atoi(s + 1) - (int32_t)(decimal.size - 1);
+				while(decimal.size > 1 && decimal.digits[decimal.size - 1] == '0') {
+					decimal.size--;
+					decimal.exponent++;
+				}
+				return decimal;
+			}
+			
+			/// fixed or scientific notation of the digits
+			static char *write(char *d, const Decimal &decimal, int32_t precision) {
+				int32_t size = (int32_t)decimal.size;
+				int32_t point = size + decimal.exponent;
+				int32_t exponent = point - 1;
+				if(exponent >= -4 && exponent < precision) {
+					if(point <= 0) {
+						*d++ = '0';
+						*d++ = '.';
+						for(int32_t i = point; i < 0; i++) *d++ = '0';
+						for(int32_t i = 0; i < size; i++) *d++ = decimal.digits[i];
+					} else if(point >= size) {
+						for(int32_t i = 0; i < size; i++) *d++ = decimal.digits[i];
+						for(int32_t i = size; i < point; i++) *d++ = '0';
+					} else {
+						for(int32_t i = 0; i < size; i++) {
+							if(i == point) *d++ = '.';
+							*d++ = decimal.digits[i];
+						}
+					}
+				} else {
+					*d++ = decimal.digits[0];
+					if(size > 1) {
+						*d++ = '.';
+						for(int32_t i = 1; i < size; i++) *d++ = decimal.digits[i];
+					}
+					*d++ = 'e';
+					*d++ = (exponent < 0) ? '-' : '+';
+					if(exponent < 0) exponent = -exponent;
+					if(exponent >= 100) *d++ = (char)('0' + exponent / 100);
+					const char *pair = get_pair((uint32_t)(exponent % 100));
+					*d++ = pair[0];
+					*d++ = pair[1];
+				}
+				*d = '\0';
+				return d;
+			}
+			
+			static char *write(char *d, const char *str) {
+				while(*str) *d++ = *str++;
+				*d = '\0';
+				return d;
+			}
+			
+			static TS_INLINE const char *get_pair(uint32_t value) {
+				static const char pairs[] =
+					"00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839" "40414243444546474849"
+					"50515253545556575859" "60616263646566676869" "70717273747576777879" "80818283848586878889" "90919293949596979899";
+				return pairs + value * 2;
+			}
+			
+			/// normalized powers of ten from 10^-348 to 10^340 with the step of 8
+			struct CachedPower {
+				uint64_t f;
+				int16_t e;
+				int16_t k;
+			};
+			
+			static const CachedPower &get_cached_power(int32_t index) {
+				static const CachedPower powers[] = {
+					{ 0xfa8fd5a0081c0288ull, -1220, -348 }, { 0xbaaee17fa23ebf76ull, -1193, -340 }, { 0x8b16fb203055ac76ull, -1166, -332 },
+					{ 0xcf42894a5dce35eaull, -1140, -324 }, { 0x9a6bb0aa55653b2dull, -1113, -316 }, { 0xe61acf033d1a45dfull, -1087, -308 },
+					{ 0xab70fe17c79ac6caull, -1060, -300 }, { 0xff77b1fcbebcdc4full, -1034, -292 }, { 0xbe5691ef416bd60cull, -1007, -284 },
+					{ 0x8dd01fad907ffc3cull, -980, -276 }, { 0xd3515c2831559a83ull, -954, -268 }, { 0x9d71ac8fada6c9b5ull, -927, -260 },
+					{ 0xea9c227723ee8bcbull, -901, -252 }, { 0xaecc49914078536dull, -874, -244 }, { 0x823c12795db6ce57ull, -847, -236 },
+					{ 0xc21094364dfb5637ull, -821, -228 }, { 0x9096ea6f3848984full, -794, -220 }, { 0xd77485cb25823ac7ull, -768, -212 },
+					{ 0xa086cfcd97bf97f4ull, -741, -204 }, { 0xef340a98172aace5ull, -715, -196 }, { 0xb23867fb2a35b28eull, -688, -188 },
+					{ 0x84c8d4dfd2c63f3bull, -661, -180 }, { 0xc5dd44271ad3cdbaull, -635, -172 }, { 0x936b9fcebb25c996ull, -608, -164 },
+					{ 0xdbac6c247d62a584ull, -582, -156 }, { 0xa3ab66580d5fdaf6ull, -555, -148 }, { 0xf3e2f893dec3f126ull, -529, -140 },
+					{ 0xb5b5ada8aaff80b8ull, -502, -132 }, { 0x87625f056c7c4a8bull, -475, -124 }, { 0xc9bcff6034c13053ull, -449, -116 },
+					{ 0x964e858c91ba2655ull, -422, -108 }, { 0xdff9772470297ebdull, -396, -100 }, { 0xa6dfbd9fb8e5b88full, -369, -92 },
+					{ 0xf8a95fcf88747d94ull, -343, -84 }, { 0xb94470938fa89bcfull, -316, -76 }, { 0x8a08f0f8bf0f156bull, -289, -68 },
+					{ 0xcdb02555653131b6ull, -263, -60 }, { 0x993fe2c6d07b7facull, -236, -52 }, { 0xe45c10c42a2b3b06ull, -210, -44 },
+					{ 0xaa242499697392d3ull, -183, -36 }, { 0xfd87b5f28300ca0eull, -157, -28 }, { 0xbce5086492111aebull, -130, -20 },
+					{ 0x8cbccc096f5088ccull, -103, -12 }, { 0xd1b71758e219652cull, -77, -4 }, { 0x9c40000000000000ull, -50, 4 },
+					{ 0xe8d4a51000000000ull, -24, 12 }, { 0xad78ebc5ac620000ull, 3, 20 }, { 0x813f3978f8940984ull, 30, 28 },
+					{ 0xc097ce7bc90715b3ull, 56, 36 }, { 0x8f7e32ce7bea5c70ull, 83, 44 }, { 0xd5d238a4abe98068ull, 109, 52 },
+					{ 0x9f4f2726179a2245ull, 136, 60 }, { 0xed63a231d4c4fb27ull, 162, 68 }, { 0xb0de65388cc8ada8ull, 189, 76 },
+					{ 0x83c7088e1aab65dbull, 216, 84 }, { 0xc45d1df942711d9aull, 242, 92 }, { 0x924d692ca61be758ull, 269, 100 },
+					{ 0xda01ee641a708deaull, 295, 108 }, { 0xa26da3999aef774aull, 322, 116 }, { 0xf209787bb47d6b85ull, 348, 124 },
+					{ 0xb454e4a179dd1877ull, 375, 132 }, { 0x865b86925b9bc5c2ull, 402, 140 }, { 0xc83553c5c8965d3dull, 428, 148 },
+					{ 0x952ab45cfa97a0b3ull, 455, 156 }, { 0xde469fbd99a05fe3ull, 481, 164 }, { 0xa59bc234db398c25ull, 508, 172 },
+					{ 0xf6c69a72a3989f5cull, 534, 180 }, { 0xb7dcbf5354e9beceull, 561, 188 }, { 0x88fcf317f22241e2ull, 588, 196 },
+					{ 0xcc20ce9bd35c78a5ull, 614, 204 }, { 0x98165af37b2153dfull, 641, 212 }, { 0xe2a0b5dc971f303aull, 667, 220 },
+					{ 0xa8d9d1535ce3b396ull, 694, 228 }, { 0xfb9b7cd9a4a7443cull, 720, 236 }, { 0xbb764c4ca7a44410ull, 747, 244 },
+					{ 0x8bab8eefb6409c1aull, 774, 252 }, { 0xd01fef10a657842cull, 800, 260 }, { 0x9b10a4e5e9913129ull, 827, 268 },
+					{ 0xe7109bfba19c0c9dull, 853, 276 }, { 0xac2820d9623bf429ull, 880, 284 }, { 0x80444b5e7aa7cf85ull, 907, 292 },
+					{ 0xbf21e44003acdd2dull, 933, 300 }, { 0x8e679c2f5e44ff8full, 960, 308 }, { 0xd433179d9c8cb841ull, 986, 316 },
+					{ 0x9e19db92b4e31ba9ull, 1013, 324 }, { 0xeb96bf6ebadf77d9ull, 1039, 332 }, { 0xaf87023b9bf0ee6bull, 1066, 340 },				};
+				return powers[index];
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_JSON_NUMBER_H__ */
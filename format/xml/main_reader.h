@@ -0,0 +1,438 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_XML_READER_H__
+#define __TELLUSIM_TESTS_XML_READER_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class XmlReader {
+			
+		public:
+			
+			/// zero-copy view into the input buffer
+			struct View {
+				View() { }
+				View(const char *data, size_t size) : data(data), size(size) { }
+				
+				bool operator==(const char *str) const {
+					size_t length = strlen(str);
+					return (size == length && memcmp(data, str, size) == 0);
+				}
+				bool operator!=(const char *str) const {
+					return !(*this == str);
+				}
+				bool operator==(const View &view) const {
+					return (size == view.size && memcmp(data, view.data, size) == 0);
+				}
+				
+				/// copy of the raw text
+				String get() const {
+					Array<char> buffer(size + 1);
+					memcpy(buffer.get(), data, size);
+					buffer[size] = '\0';
+					return String(buffer.get());
+				}
+				
+				const char *data = nullptr;
+				size_t size = 0;
+			};
+			
+			/// raw attribute, the value keeps the entity references
+			struct Attribute {
+				
+				/// decoded value
+				String get() const {
+					return (escaped) ? decode(value) : value.get();
+				}
+				
+				View name;
+				View value;
+				bool escaped = false;
+			};
+			
+			/// reader events
+			enum Event {
+				EventNone = 0,
+				EventStart,
+				EventEnd,
+				EventText,
+				EventError,
+			};
+			
+			XmlReader() { }
+			XmlReader(const char *src, size_t size) { open(src, size); }
+			
+			/// starts reading of the buffer, the buffer must outlive the reader
+			void open(const char *src, size_t size) {
+				begin = src;
+				end = src + size;
+				s = src;
+				stack.clear();
+				attributes.clear();
+				closed = false;
+				pending_end = false;
+				has_root = false;
+				failed = false;
+			}
+			
+			/// next event, the document end is EventNone
+			/// self-closing elements produce both start and end events
+			/// whitespace-only text, comments, processing instructions, and doctypes are skipped
+			Event next() {
+				
+				attributes.clear();
+				text_escaped = false;
+				if(failed) return EventError;
+				
+				if(pending_end) {
+					pending_end = false;
+					return pop();
+				}
+				
+				while(true) {
+					
+					// end of data
+					if(s == end) {
+						if(stack.size()) return error(s, "unexpected end of data");
+						if(!has_root) return error(s, "root element is expected");
+						return EventNone;
+					}
+					
+					// text
+					if(*s != '<') {
+						const char *data = s;
+						const char *e = (const char*)memchr(s, '<', (size_t)(end - s));
+						s = (e) ? e : end;
+						bool space = true;
+						for(const char *t = data; t < s && space; t++) space = isSpace(*t);
+						if(space) continue;
+						if(stack.size() == 0) return error(data, "text outside of the root element");
+						text = View(data, (size_t)(s - data));
+						text_escaped = (memchr(data, '&', text.size) != nullptr);
+						return EventText;
+					}
+					
+					// processing instructions and declarations
+					if(startsWith(s, "<?")) {
+						if(!skipTo(s + 2, "?>")) return error(s, "unterminated processing instruction");
+						continue;
+					}
+					if(startsWith(s, "<!--")) {
+						if(!skipTo(s + 4, "-->")) return error(s, "unterminated comment");
+						continue;
+					}
+					if(startsWith(s, "<![CDATA[")) {
+						const char *data = s + 9;
+						if(!skipTo(data, "]]>")) return error(data - 9, "unterminated CDATA section");
+						if(stack.size() == 0) return error(data - 9, "CDATA outside of the root element");
+						text = View(data, (size_t)(s - 3 - data));
+						return EventText;
+					}
+					if(startsWith(s, "<!")) {
+						if(!skipDoctype()) return error(s, "unterminated declaration");
+						continue;
+					}
+					
+					// end tag
+					if(startsWith(s, "</")) {
+						const char *data = s;
+						s += 2;
+						View tag = readName();
+						s = skipSpace(s);
+						if(s == end || *s != '>') return error(s, "'>' is expected");
+						s++;
+						if(stack.size() == 0 || !(stack[stack.size() - 1] == tag)) return error(data, "mismatched end tag");
+						return pop();
+					}
+					
+					// start tag
+					const char *data = s++;
+					if(closed) return error(data, "multiple root elements");
+					name = readName();
+					if(name.size == 0) return error(s, "element name is expected");
+					while(true) {
+						const char *e = skipSpace(s);
+						if(e == end) return error(e, "unexpected end of data");
+						if(*e == '>') {
+							s = e + 1;
+							break;
+						}
+						if(*e == '/') {
+							if(e + 1 == end || e[1] != '>') return error(e, "'>' is expected");
+							s = e + 2;
+							pending_end = true;
+							break;
+						}
+						if(e == s) return error(e, "whitespace is expected");
+						s = e;
+						if(!attribute()) return EventError;
+					}
+					stack.append(name);
+					has_root = true;
+					return EventStart;
+				}
+			}
+			
+			/// skips the children of the current start element up to its end event
+			bool skip() {
+				uint32_t depth = stack.size();
+				while(true) {
+					Event event = next();
+					if(event == EventError || event == EventNone) return false;
+					if(event == EventEnd && stack.size() < depth) return true;
+				}
+			}
+			
+			/// element name of the start and end events
+			const View &getName() const { return name; }
+			
+			/// raw text of the text events, CDATA sections are never escaped
+			const View &getText() const { return text; }
+			bool isTextEscaped() const { return text_escaped; }
+			String getTextString() const { return (text_escaped) ? decode(text) : text.get(); }
+			
+			/// raw attributes of the start events
+			uint32_t getNumAttributes() const { return attributes.size(); }
+			const Attribute &getAttribute(uint32_t index) const { return attributes[index]; }
+			const Attribute *findAttribute(const char *str) const {
+				for(const Attribute &attribute : attributes) {
+					if(attribute.name == str) return &attribute;
+				}
+				return nullptr;
+			}
+			
+			/// decoded attribute value, the entity decoding is deferred until the value is read
+			String getAttribute(const char *str) const {
+				const Attribute *attribute = findAttribute(str);
+				return (attribute) ? attribute->get() : String();
+			}
+			
+			/// number of open elements
+			uint32_t getDepth() const { return stack.size(); }
+			
+			/// predefined and numeric character references
+			static void decode(const View &view, Array<char> &buffer) {
+				const char *s = view.data;
+				const char *end = view.data + view.size;
+				uint32_t code = 0;
+				while(s < end) {
+					const char *e = (const char*)memchr(s, '&', (size_t)(end - s));
+					if(e == nullptr) e = end;
+					for(; s < e; s++) buffer.append(*s);
+					if(s == end) break;
+					const char *semicolon = (const char*)memchr(s, ';', (size_t)(end - s));
+					View entity = (semicolon) ? View(s + 1, (size_t)(semicolon - s - 1)) : View();
+					if(entity == "lt") buffer.append('<');
+					else if(entity == "gt") buffer.append('>');
+					else if(entity == "amp") buffer.append('&');
+					else if(entity == "quot") buffer.append('"');
+					else if(entity == "apos") buffer.append('\'');
+					else if(entity.size > 1 && entity.data[0] == '#' && (code = reference(entity)) != Maxu32) {
+						utf8(buffer, code);
+					} else {
+						// unknown references are kept as is
+						buffer.append(*s++);
+						continue;
+					}
+					s = semicolon + 1;
+				}
+			}
+			
+			static String decode(const View &view) {
+				Array<char> buffer;
+				buffer.reserve(view.size + 1);
+				decode(view, buffer);
+				buffer.append('\0');
+				return String(buffer.get());
+			}
+			
+		private:
+			
+			/// attribute name, value, and the quotes
+			bool attribute() {
+				Attribute &attribute = attributes.append();
+				attribute.name = readName();
+				if(attribute.name.size == 0) {
+					error(s, "attribute name is expected");
+					return false;
+				}
+				s = skipSpace(s);
+				if(s == end || *s != '=') {
+					error(s, "'=' is expected");
+					return false;
+				}
+				s = skipSpace(s + 1);
+				if(s == end || (*s != '"' && *s != '\'')) {
+					error(s, "quote is expected");
+					return false;
+				}
+				const char *data = s + 1;
+				const char *e = (const char*)memchr(data, *s, (size_t)(end - data));
+				if(e == nullptr) {
+					error(s, "unterminated attribute value");
+					return false;
+				}
+				attribute.value = View(data, (size_t)(e - data));
+				if(memchr(data, '<', attribute.value.size)) {
+					error(data, "'<' in the attribute value");
+					return false;
+				}
+				attribute.escaped = (memchr(data, '&', attribute.value.size) != nullptr);
+				s = e + 1;
+				return true;
+			}
+			
+			Event pop() {
+				name = stack[stack.size() - 1];
+				stack.removeBack();
+				closed = (stack.size() == 0);
+				return EventEnd;
+			}
+			
+			View readName() {
+				const char *data = s;
+				while(s != end && !isSpace(*s) && *s != '>' && *s != '/' && *s != '=') s++;
+				return View(data, (size_t)(s - data));
+			}
+			
+			bool skipTo(const char *data, const char *str) {
+				size_t length = strlen(str);
+				for(; (size_t)(end - data) >= length; data++) {
+					if(*data == str[0] && memcmp(data, str, length) == 0) {
+						s = data + length;
+						return true;
+					}
+				}
+				return false;
+			}
+			
+			/// doctype with the internal subset
+			bool skipDoctype() {
+				uint32_t depth = 0;
+				char quote = 0;
+				for(const char *data = s + 2; data != end; data++) {
+					char c = *data;
+					if(quote) {
+						if(c == quote) quote = 0;
+					} else if(c == '"' || c == '\'') {
+						quote = c;
+					} else if(c == '[') {
+						depth++;
+					} else if(c == ']') {
+						if(depth) depth--;
+					} else if(c == '>' && depth == 0) {
+						s = data + 1;
+						return true;
+					}
+				}
+				return false;
+			}
+			
+			bool startsWith(const char *data, const char *str) const {
+				size_t length = strlen(str);
+				return ((size_t)(end - data) >= length && memcmp(data, str, length) == 0);
+			}
+			
+			const char *skipSpace(const char *data) const {
+				while(data != end && isSpace(*data)) data++;
+				return data;
+			}
+			
+			static TS_INLINE bool isSpace(char c) {
+				return (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+			}
+			
+			static uint32_t hex(char c) {
+				if(c >= '0' && c <= '9') return (uint32_t)(c - '0');
+				if(c >= 'a' && c <= 'f') return (uint32_t)(c - 'a' + 10);
+				if(c >= 'A' && c <= 'F') return (uint32_t)(c - 'A' + 10);
+				return Maxu32;
+			}
+			
+			/// numeric character reference or Maxu32 for the invalid digits and code points
+			static uint32_t reference(const View &entity) {
+				bool is_hex = (entity.data[1] == 'x');
+				size_t begin = (is_hex) ? 2 : 1;
+				if(begin == entity.size || entity.size - begin > 8) return Maxu32;
+				uint32_t code = 0;
+				for(size_t i = begin; i < entity.size; i++) {
+					uint32_t digit = (is_hex) ? hex(entity.data[i]) : (uint32_t)(entity.data[i] - '0');
+					if(digit >= ((is_hex) ? 16u : 10u)) return Maxu32;
+					code = code * ((is_hex) ? 16 : 10) + digit;
+				}
+				if(code == 0 || code > 0x10ffff || (code >= 0xd800 && code < 0xe000)) return Maxu32;
+				return code;
+			}
+			
+			static void utf8(Array<char> &buffer, uint32_t code) {
+				if(code < 0x80) {
+					buffer.append((char)code);
+				} else if(code < 0x800) {
+					buffer.append((char)(0xc0 | (code >> 6)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				} else if(code < 0x10000) {
+					buffer.append((char)(0xe0 | (code >> 12)));
+					buffer.append((char)(0x80 | ((code >> 6) & 0x3f)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				} else {
+					buffer.append((char)(0xf0 | (code >> 18)));
+					buffer.append((char)(0x80 | ((code >> 12) & 0x3f)));
+					buffer.append((char)(0x80 | ((code >> 6) & 0x3f)));
+					buffer.append((char)(0x80 | (code & 0x3f)));
+				}
+			}
+			
+			Event error(const char *data, const char *message) {
+				uint32_t line = 1;
+				for(const char *p = begin; p < data; p++) line += (*p == '\n');
+				TS_LOGF(Error, "XmlReader::next(): %s at line %u offset %u\n", message, line, (uint32_t)(data - begin));
+				failed = true;
+				return EventError;
+			}
+			
+			const char *begin = nullptr;
+			const char *end = nullptr;
+			const char *s = nullptr;
+			
+			View name;
+			View text;
+			bool text_escaped = false;
+			bool pending_end = false;
+			bool closed = false;
+			bool has_root = false;
+			bool failed = false;
+			
+			Array<View> stack;
+			Array<Attribute> attributes;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_XML_READER_H__ */
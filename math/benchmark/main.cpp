@@ -0,0 +1,334 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
+#include <math/TellusimSimd.h>
+#include <math/TellusimMatrix.h>
+#include <math/TellusimQuaternion.h>
+#include <math/TellusimNumerical.h>
+#include <format/TellusimJson.h>
+
+#include "main_simd16.h"
+#include "main_matrix.h"
+
+/*
+ */
+using namespace Tellusim;
+
+/*
+ */
+constexpr uint32_t Size = 1024;
+constexpr uint32_t NumMatrices = 64;
+
+TS_ALIGNAS64 static float32_t src_0[Size];
+TS_ALIGNAS64 static float32_t src_1[Size];
+TS_ALIGNAS64 static float32_t src_2[Size];
+TS_ALIGNAS64 static float32_t dest_f[Size];
+TS_ALIGNAS64 static int32_t src_i[Size];
+TS_ALIGNAS64 static int32_t dest_i[Size];
+
+/*
+ */
+class Benchmark {
+		
+	public:
+		
+		/// runs the function which performs num operations with the flops per operation
+		/// the best time of the runs is reported, zero flops skips the GFLOP/s output
+		template <class Function> void run(const char *group, const char *name, uint32_t num, uint32_t flops, const Function &function) {
+			
+			// calibrate number of repeats
+			uint32_t num_repeats = 1;
+			while(num_repeats < (1u << 20)) {
+				uint64_t begin = Time::current();
+				for(uint32_t i = 0; i < num_repeats; i++) function();
+				if(Time::current() - begin > 1000) break;
+				num_repeats *= 2;
+			}
+			
+			// best time
+			uint64_t time = Maxu64;
+			for(uint32_t i = 0; i < 5; i++) {
+				uint64_t begin = Time::current();
+				for(uint32_t j = 0; j < num_repeats; j++) function();
+				time = min(time, Time::current() - begin);
+			}
+			
+			Result result;
+			result.group = group;
+			result.name = name;
+			result.ns = (float64_t)time * 1000.0 / ((float64_t)num * num_repeats);
+			result.gflops = (flops) ? flops / result.ns : 0.0;
+			results.append(result);
+			
+			if(flops) TS_LOGF(Message, "%12s %12s: %9.3f ns/op %8.2f GFLOP/s\n", group, name, result.ns, result.gflops);
+			else TS_LOGF(Message, "%12s %12s: %9.3f ns/op\n", group, name, result.ns);
+		}
+		
+		/// machine-readable results
+		bool save(const char *name) const {
+			Json root("root");
+			root.setData("level", SimdCPU::getLevelName(SimdCPU::getLevel()));
+			root.setData("features", SimdCPU::getFeatures());
+			Json array(&root, "results");
+			for(const Result &result : results) {
+				Json json(&array, nullptr);
+				json.setData("group", result.group);
+				json.setData("name", result.name);
+				json.setData("ns", (float32_t)result.ns);
+				json.setData("gflops", (float32_t)result.gflops);
+			}
+			return root.save(name);
+		}
+		
+	private:
+		
+		struct Result {
+			const char *group;
+			const char *name;
+			float64_t ns;
+			float64_t gflops;
+		};
+		
+		Array<Result> results;
+};
+
+/*
+ */
+template <class Type> void run_matrix(Benchmark &benchmark, const char *name) {
+	
+	using Matrix4x4 = Tellusim::Matrix4x4<Type>;
+	using Vector4 = Tellusim::Vector4<Type>;
+	
+	static Matrix4x4 src[NumMatrices];
+	static Matrix4x4 dest[NumMatrices];
+	static Vector4 vectors[NumMatrices];
+	for(uint32_t i = 0; i < NumMatrices; i++) {
+		src[i] = Matrix4x4::rotateX((Type)i) * Matrix4x4::translate((Type)i, (Type)1, (Type)2) * Matrix4x4::rotateZ((Type)(i * 3));
+		vectors[i] = Vector4((Type)i, (Type)1, (Type)2, (Type)1);
+	}
+	
+	String group = String::format("Matrix4x4%s", name);
+	benchmark.run(group.get(), "mul", NumMatrices, 112, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = src[i] * src[(i + 1) % NumMatrices];
+	});
+	benchmark.run(group.get(), "mul vector", NumMatrices, 28, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) vectors[i] = src[i] * vectors[i];
+	});
+	benchmark.run(group.get(), "transpose", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = transpose(src[i]);
+	});
+	benchmark.run(group.get(), "inverse", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = inverse(src[i]);
+	});
+	benchmark.run(group.get(), "inverse43", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = inverse43(src[i]);
+	});
+}
+
+template <class Type, uint32_t N> void run_matrix_nxm(Benchmark &benchmark, const char *name) {
+	
+	using VectorN = Tellusim::VectorN<Type, N>;
+	using MatrixNxN = Tellusim::MatrixNxM<Type, N, N>;
+	
+	static MatrixNxN src[NumMatrices];
+	static MatrixNxN dest[NumMatrices];
+	static VectorN vectors[NumMatrices];
+	for(uint32_t i = 0; i < NumMatrices; i++) {
+		for(uint32_t j = 0; j < MatrixNxN::Size; j++) src[i].m[j] = (Type)((i + j) % 7) * (Type)0.25 - (Type)0.5;
+		for(uint32_t j = 0; j < N; j++) vectors[i].v[j] = (Type)j;
+	}
+	
+	uint32_t flops = N * N * (2 * N - 1);
+	String group = String::format("MatrixNxM%u%s", N, name);
+	benchmark.run(group.get(), "mul", NumMatrices, flops, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = src[i] * src[(i + 1) % NumMatrices];
+	});
+	benchmark.run(group.get(), "simd mul", NumMatrices, flops, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = MatrixSimd::mul(src[i], src[(i + 1) % NumMatrices]);
+	});
+	benchmark.run(group.get(), "mul vector", NumMatrices, N * (2 * N - 1), []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) vectors[i] = src[i] * vectors[i];
+	});
+	benchmark.run(group.get(), "simd mul vector", NumMatrices, N * (2 * N - 1), []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) vectors[i] = MatrixSimd::mul(src[i], vectors[i]);
+	});
+	benchmark.run(group.get(), "add", NumMatrices, N * N, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = src[i] + src[(i + 1) % NumMatrices];
+	});
+	benchmark.run(group.get(), "simd add", NumMatrices, N * N, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = MatrixSimd::add(src[i], src[(i + 1) % NumMatrices]);
+	});
+	benchmark.run(group.get(), "transpose", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = transpose(src[i]);
+	});
+	benchmark.run(group.get(), "simd transpose", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = MatrixSimd::transpose(src[i]);
+	});
+}
+
+template <class Type> void run_quaternion(Benchmark &benchmark, const char *name) {
+	
+	using Matrix4x4 = Tellusim::Matrix4x4<Type>;
+	using Quaternion = Tellusim::Quaternion<Type>;
+	
+	static Quaternion src[NumMatrices];
+	static Quaternion dest[NumMatrices];
+	static Matrix4x4 matrices[NumMatrices];
+	for(uint32_t i = 0; i < NumMatrices; i++) {
+		src[i] = Quaternion::rotateX((Type)i) * Quaternion::rotateZ((Type)(i * 3));
+	}
+	
+	String group = String::format("Quaternion%s", name);
+	benchmark.run(group.get(), "mul", NumMatrices, 28, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = src[i] * src[(i + 1) % NumMatrices];
+	});
+	benchmark.run(group.get(), "normalize", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = normalize(src[i]);
+	});
+	benchmark.run(group.get(), "slerp", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) dest[i] = slerp(src[i], src[(i + 1) % NumMatrices], (Type)0.3);
+	});
+	benchmark.run(group.get(), "matrix", NumMatrices, 0, []() {
+		for(uint32_t i = 0; i < NumMatrices; i++) matrices[i] = Matrix4x4(src[i]);
+	});
+}
+
+/*
+ */
+int32_t main(int32_t argc, char **argv) {
+	
+	const char *name = (argc > 1) ? argv[1] : "benchmark.json";
+	
+	for(uint32_t i = 0; i < Size; i++) {
+		src_0[i] = (float32_t)(i % 17) + 1.0f;
+		src_1[i] = (float32_t)(i % 13) * 0.5f + 1.0f;
+		src_2[i] = (float32_t)(i % 11) - 5.0f;
+		src_i[i] = (int32_t)(i % 19) - 9;
+	}
+	
+	Benchmark benchmark;
+	
+	TS_LOGF(Message, "CPU level: %s\n\n", SimdCPU::getLevelName(SimdCPU::getLevel()));
+	
+	// multiply-add
+	benchmark.run("mad", "scalar", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = src_0[i] * src_1[i] + src_2[i];
+	});
+	benchmark.run("mad", "float32x4", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 4) (float32x4_t(src_0 + i) * float32x4_t(src_1 + i) + float32x4_t(src_2 + i)).get(dest_f + i);
+	});
+	benchmark.run("mad", "float32x8", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 8) (float32x8_t(src_0 + i) * float32x8_t(src_1 + i) + float32x8_t(src_2 + i)).get(dest_f + i);
+	});
+	benchmark.run("mad", "float32x16", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 16) (float32x16_t(src_0 + i) * float32x16_t(src_1 + i) + float32x16_t(src_2 + i)).get(dest_f + i);
+	});
+	
+	// division
+	benchmark.run("div", "scalar", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = src_1[i] / src_0[i];
+	});
+	benchmark.run("div", "float32x4", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i += 4) (float32x4_t(src_1 + i) / float32x4_t(src_0 + i)).get(dest_f + i);
+	});
+	benchmark.run("div", "float32x8", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i += 8) (float32x8_t(src_1 + i) / float32x8_t(src_0 + i)).get(dest_f + i);
+	});
+	
+	// square root
+	benchmark.run("sqrt", "scalar", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = Tellusim::sqrt(src_0[i]);
+	});
+	benchmark.run("sqrt", "float32x4", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i += 4) sqrt(float32x4_t(src_0 + i)).get(dest_f + i);
+	});
+	benchmark.run("sqrt", "float32x8", Size, 1, []() {
+		for(uint32_t i = 0; i < Size; i += 8) sqrt(float32x8_t(src_0 + i)).get(dest_f + i);
+	});
+	
+	// reciprocal square root
+	benchmark.run("rsqrt", "scalar", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = 1.0f / Tellusim::sqrt(src_0[i]);
+	});
+	benchmark.run("rsqrt", "float32x4", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 4) rsqrt(float32x4_t(src_0 + i)).get(dest_f + i);
+	});
+	benchmark.run("rsqrt", "float32x8", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 8) rsqrt(float32x8_t(src_0 + i)).get(dest_f + i);
+	});
+	benchmark.run("rsqrtFast", "float32x4", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 4) rsqrtFast(float32x4_t(src_0 + i)).get(dest_f + i);
+	});
+	benchmark.run("rsqrtFast", "float32x8", Size, 2, []() {
+		for(uint32_t i = 0; i < Size; i += 8) rsqrtFast(float32x8_t(src_0 + i)).get(dest_f + i);
+	});
+	
+	// select
+	benchmark.run("select", "scalar", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = (src_2[i] < 0.0f) ? src_1[i] : src_0[i];
+	});
+	benchmark.run("select", "float32x4", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 4) select(float32x4_t(src_0 + i), float32x4_t(src_1 + i), float32x4_t(src_2 + i)).get(dest_f + i);
+	});
+	benchmark.run("select", "float32x8", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 8) select(float32x8_t(src_0 + i), float32x8_t(src_1 + i), float32x8_t(src_2 + i)).get(dest_f + i);
+	});
+	
+	// conversions
+	benchmark.run("i32->f32", "scalar", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_f[i] = (float32_t)src_i[i];
+	});
+	benchmark.run("i32->f32", "float32x4", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 4) float32x4_t(int32x4_t(src_i + i)).get(dest_f + i);
+	});
+	benchmark.run("i32->f32", "float32x8", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 8) float32x8_t(int32x8_t(src_i + i)).get(dest_f + i);
+	});
+	benchmark.run("f32->i32", "scalar", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i++) dest_i[i] = (int32_t)src_2[i];
+	});
+	benchmark.run("f32->i32", "int32x4", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 4) int32x4_t(float32x4_t(src_2 + i)).get(dest_i + i);
+	});
+	benchmark.run("f32->i32", "int32x8", Size, 0, []() {
+		for(uint32_t i = 0; i < Size; i += 8) int32x8_t(float32x8_t(src_2 + i)).get(dest_i + i);
+	});
+	
+	// matrices and quaternions
+	run_matrix<float32_t>(benchmark, "f");
+	run_matrix<float64_t>(benchmark, "d");
+	run_matrix_nxm<float32_t, 4>(benchmark, "f");
+	run_matrix_nxm<float64_t, 4>(benchmark, "d");
+	run_matrix_nxm<float32_t, 8>(benchmark, "f");
+	run_quaternion<float32_t>(benchmark, "f");
+	run_quaternion<float64_t>(benchmark, "d");
+	
+	// save results
+	if(!benchmark.save(name)) return 1;
+	TS_LOGF(Message, "\n%s\n", name);
+	
+	return 0;
+}
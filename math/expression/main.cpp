@@ -21,9 +21,14 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
 #include <math/TellusimString.h>
 #include <math/TellusimExpression.h>
 
+#include "main_program.h"
+
 /*
  */
 using namespace Tellusim;
@@ -56,5 +61,98 @@ int32_t main(int32_t argc, char **argv) {
 		TS_LOG(Error, "can't evaluate expression\n");
 	}
 	
+	{
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 1024 * 64 + 3;
+		
+		const char *names[] = { "x", "y" };
+		const char *expression = "sin(x) * 2 + y ^ 2 - clamp(x, 0, 1) * (3 * 4 - 2) + exp(-abs(y)) * cos(pi / 4)";
+		
+		ExpressionProgram program;
+		if(!program.compile(expression, names, TS_COUNTOF(names))) return 1;
+		TS_LOGF(Message, "%s: %u instructions %u constants\n", expression, program.getNumInstructions(), program.getNumConstants());
+		
+		// constant folding
+		ExpressionProgram constant;
+		if(!constant.compile("pow(2, 10) + sqrt(16) * -(3 - 1)") || !constant.isConstant()) return 1;
+		TS_LOGF(Message, "constant: %f\n", constant.evaluate());
+		
+		// invalid expressions
+		if(program.compile("x + ", names, TS_COUNTOF(names))) return 1;
+		if(program.compile("z * 2", names, TS_COUNTOF(names))) return 1;
+		
+		// nesting limit
+		String nested;
+		for(uint32_t i = 0; i < 4096; i++) nested += "(-";
+		nested += "x";
+		for(uint32_t i = 0; i < 4096; i++) nested += ")";
+		if(program.compile(nested.get(), names, TS_COUNTOF(names))) return 1;
+		
+		// long flat chain
+		String chain = "x";
+		for(uint32_t i = 0; i < 1024 * 256; i++) chain += "+x";
+		const float32_t chain_variables[] = { 1.0f, 0.0f };
+		if(!program.compile(chain.get(), names, TS_COUNTOF(names))) return 1;
+		if(program.evaluate(chain_variables) != 1024.0f * 256.0f + 1.0f) return 1;
+		
+		// power of the zero and negative bases
+		{
+			const float32_t bases[] = { 0.0f, -0.0f, 1.0f, -1.0f, 2.0f, -2.0f, -0.5f, -3.0f, 2.5f };
+			const float32_t exponents[] = { 0.0f, 1.0f, 2.0f, 3.0f, -1.0f, -2.0f, -3.0f, 0.5f, 2.5f };
+			Array<float32_t> a(TS_COUNTOF(bases) * TS_COUNTOF(exponents)), b(a.size()), r(a.size());
+			for(uint32_t i = 0; i < a.size(); i++) {
+				a[i] = bases[i % TS_COUNTOF(bases)];
+				b[i] = exponents[i / TS_COUNTOF(bases)];
+			}
+			ExpressionProgram power;
+			const char *power_names[] = { "a", "b" };
+			const float32_t *power_arrays[] = { a.get(), b.get() };
+			if(!power.compile("pow(a, b)", power_names, TS_COUNTOF(power_names))) return 1;
+			power.evaluate(r.get(), power_arrays, a.size());
+			for(uint32_t i = 0; i < a.size(); i++) {
+				float32_t v = Tellusim::pow(a[i], b[i]);
+				if((v != v) != (r[i] != r[i])) return 1;
+				if(v == v && Tellusim::abs(v - r[i]) > Tellusim::abs(v) * 1e-5f) return 1;
+			}
+		}
+		
+		if(!program.compile(expression, names, TS_COUNTOF(names))) return 1;
+		
+		// inputs
+		Array<float32_t> x(size), y(size), r0(size), r1(size), r2(size);
+		for(uint32_t i = 0; i < size; i++) {
+			x[i] = (float32_t)i / size * 4.0f - 2.0f;
+			y[i] = Tellusim::sin((float32_t)i * 0.01f) * 3.0f;
+			r0[i] = Tellusim::sin(x[i]) * 2.0f + Tellusim::pow(y[i], 2.0f) - Tellusim::clamp(x[i], 0.0f, 1.0f) * 10.0f + Tellusim::exp(-Tellusim::abs(y[i])) * Tellusim::cos(Pi / 4.0f);
+		}
+		
+		// scalar evaluation
+		uint64_t begin = Time::current();
+		float32_t variables[2];
+		for(uint32_t i = 0; i < size; i++) {
+			variables[0] = x[i];
+			variables[1] = y[i];
+			r1[i] = program.evaluate(variables);
+		}
+		float32_t time_0 = (float32_t)(Time::current() - begin) * 1e3f / size;
+		
+		// array evaluation
+		begin = Time::current();
+		const float32_t *arrays[] = { x.get(), y.get() };
+		program.evaluate(r2.get(), arrays, size);
+		float32_t time_1 = (float32_t)(Time::current() - begin) * 1e3f / size;
+		
+		float32_t error_0 = 0.0f;
+		float32_t error_1 = 0.0f;
+		for(uint32_t i = 0; i < size; i++) {
+			error_0 = max(error_0, Tellusim::abs(r1[i] - r0[i]));
+			error_1 = max(error_1, Tellusim::abs(r2[i] - r0[i]));
+		}
+		TS_LOGF(Message, "scalar: %.2f ns %g\n", time_0, error_0);
+		TS_LOGF(Message, "arrays: %.2f ns %g\n", time_1, error_1);
+		if(error_0 > 1e-5f || error_1 > 1e-5f) return 1;
+	}
+	
 	return 0;
 }
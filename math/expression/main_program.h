@@ -0,0 +1,540 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_EXPRESSION_PROGRAM_H__
+#define __TELLUSIM_TESTS_EXPRESSION_PROGRAM_H__
+
+#include <core/TellusimLog.h>
+#include <core/TellusimArray.h>
+#include <math/TellusimSimd.h>
+
+#include "main_simd_math.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class ExpressionProgram {
+			
+		public:
+			
+			enum {
+				MaxDepth = 32,
+				MaxNesting = 256,
+				MaxVariables = 256,
+			};
+			
+			/// compiles the scalar expression with the named variables
+			/// variable indices follow the order of names
+			bool compile(const char *src, const char *const *names = nullptr, uint32_t num_names = 0) {
+				
+				clear();
+				if(num_names > MaxVariables) {
+					TS_LOGF(Error, "ExpressionProgram::compile(): too many variables %u\n", num_names);
+					return false;
+				}
+				
+				// parse the source
+				Parser parser = { src, src, names, num_names, 0 };
+				uint32_t root = parse_expression(parser);
+				if(root != Maxu32 && *skip(parser) != '\0') root = error(parser, "unexpected symbol");
+				if(root == Maxu32) {
+					nodes.clear();
+					return false;
+				}
+				
+				// emit bytecode
+				emit(root);
+				nodes.clear();
+				if(max_depth > MaxDepth) {
+					TS_LOGF(Error, "ExpressionProgram::compile(): expression is too deep %u\n", max_depth);
+					clear();
+					return false;
+				}
+				
+				return true;
+			}
+			
+			void clear() {
+				code.clear();
+				constants.clear();
+				nodes.clear();
+				max_depth = 0;
+			}
+			
+			/// program info
+			TS_INLINE bool isCompiled() const { return (code.size() > 0); }
+			TS_INLINE bool isConstant() const { return (code.size() == 1 && get_op(code[0]) == OpConstant); }
+			TS_INLINE uint32_t getNumInstructions() const { return code.size(); }
+			TS_INLINE uint32_t getNumConstants() const { return constants.size(); }
+			
+			/// evaluates the program with the variable values
+			float32_t evaluate(const float32_t *variables = nullptr) const {
+				float32_t stack[MaxDepth];
+				uint32_t depth = 0;
+				for(uint32_t instruction : code) {
+					Op op = get_op(instruction);
+					uint32_t operand = get_operand(instruction);
+					if(op == OpConstant) stack[depth++] = constants[operand];
+					else if(op == OpVariable) stack[depth++] = variables[operand];
+					else {
+						uint32_t num = get_num_arguments(op);
+						depth -= num;
+						float32_t *s = stack + depth;
+						stack[depth++] = evaluate(op, s[0], (num > 1) ? s[1] : 0.0f, (num > 2) ? s[2] : 0.0f);
+					}
+				}
+				return (depth) ? stack[0] : 0.0f;
+			}
+			
+			/// evaluates the program over the arrays of variables
+			/// the variables[i] array provides size values of the variable i
+			void evaluate(float32_t *dest, const float32_t *const *variables, uint32_t size) const {
+				
+				TS_ALIGNAS32 float32x8_t stack[MaxDepth][Vectors];
+				TS_ALIGNAS32 float32_t data[Lanes * Vectors];
+				
+				for(uint32_t offset = 0; offset < size; offset += Lanes * Vectors) {
+					uint32_t count = min(size - offset, (uint32_t)(Lanes * Vectors));
+					uint32_t depth = 0;
+					
+					for(uint32_t instruction : code) {
+						Op op = get_op(instruction);
+						uint32_t operand = get_operand(instruction);
+						
+						// load values
+						if(op == OpConstant) {
+							float32x8_t v = float32x8_t(constants[operand]);
+							for(uint32_t i = 0; i < Vectors; i++) stack[depth][i] = v;
+							depth++;
+							continue;
+						}
+						if(op == OpVariable) {
+							memcpy(data, variables[operand] + offset, sizeof(float32_t) * count);
+							for(uint32_t i = count; i < Lanes * Vectors; i++) data[i] = 0.0f;
+							for(uint32_t i = 0; i < Vectors; i++) stack[depth][i] = float32x8_t(data + Lanes * i);
+							depth++;
+							continue;
+						}
+						
+						// instruction over the block
+						uint32_t num = get_num_arguments(op);
+						depth -= num;
+						float32x8_t *a = stack[depth];
+						float32x8_t *b = stack[depth + 1];
+						float32x8_t *c = stack[depth + 2];
+						switch(op) {
+							case OpNeg: for(uint32_t i = 0; i < Vectors; i++) a[i] = -a[i]; break;
+							case OpAdd: for(uint32_t i = 0; i < Vectors; i++) a[i] = a[i] + b[i]; break;
+							case OpSub: for(uint32_t i = 0; i < Vectors; i++) a[i] = a[i] - b[i]; break;
+							case OpMul: for(uint32_t i = 0; i < Vectors; i++) a[i] = a[i] * b[i]; break;
+							case OpDiv: for(uint32_t i = 0; i < Vectors; i++) a[i] = a[i] / b[i]; break;
+							case OpPow: for(uint32_t i = 0; i < Vectors; i++) a[i] = pow(a[i], b[i]); break;
+							case OpMin: for(uint32_t i = 0; i < Vectors; i++) a[i] = min(a[i], b[i]); break;
+							case OpMax: for(uint32_t i = 0; i < Vectors; i++) a[i] = max(a[i], b[i]); break;
+							case OpClamp: for(uint32_t i = 0; i < Vectors; i++) a[i] = min(max(a[i], b[i]), c[i]); break;
+							case OpLerp: for(uint32_t i = 0; i < Vectors; i++) a[i] = a[i] + (b[i] - a[i]) * c[i]; break;
+							case OpStep: for(uint32_t i = 0; i < Vectors; i++) a[i] = select(float32x8_t(1.0f), float32x8_t(0.0f), b[i] - a[i]); break;
+							case OpAtan2: for(uint32_t i = 0; i < Vectors; i++) a[i] = atan2(a[i], b[i]); break;
+							case OpSin: for(uint32_t i = 0; i < Vectors; i++) a[i] = sin(a[i]); break;
+							case OpCos: for(uint32_t i = 0; i < Vectors; i++) a[i] = cos(a[i]); break;
+							case OpTan: for(uint32_t i = 0; i < Vectors; i++) { float32x8_t sv, cv; sincos(a[i], sv, cv); a[i] = sv / cv; } break;
+							case OpExp: for(uint32_t i = 0; i < Vectors; i++) a[i] = exp(a[i]); break;
+							case OpExp2: for(uint32_t i = 0; i < Vectors; i++) a[i] = exp2(a[i]); break;
+							case OpLog: for(uint32_t i = 0; i < Vectors; i++) a[i] = log(a[i]); break;
+							case OpLog2: for(uint32_t i = 0; i < Vectors; i++) a[i] = log2(a[i]); break;
+							case OpTanh: for(uint32_t i = 0; i < Vectors; i++) a[i] = tanh(a[i]); break;
+							case OpSqrt: for(uint32_t i = 0; i < Vectors; i++) a[i] = sqrt(a[i]); break;
+							case OpAbs: for(uint32_t i = 0; i < Vectors; i++) a[i] = abs(a[i]); break;
+							case OpFloor: for(uint32_t i = 0; i < Vectors; i++) a[i] = floor(a[i]); break;
+							case OpCeil: for(uint32_t i = 0; i < Vectors; i++) a[i] = ceil(a[i]); break;
+							default: break;
+						}
+						depth++;
+					}
+					
+					// store values
+					if(depth) {
+						for(uint32_t i = 0; i < Vectors; i++) stack[0][i].get(data + Lanes * i);
+						memcpy(dest + offset, data, sizeof(float32_t) * count);
+					} else {
+						memset(dest + offset, 0, sizeof(float32_t) * count);
+					}
+				}
+			}
+			
+		private:
+			
+			enum {
+				Lanes = 8,
+				Vectors = 8,
+			};
+			
+			enum Op {
+				OpConstant = 0,
+				OpVariable,
+				OpNeg,
+				OpAdd,
+				OpSub,
+				OpMul,
+				OpDiv,
+				OpPow,
+				OpMin,
+				OpMax,
+				OpClamp,
+				OpLerp,
+				OpStep,
+				OpAtan2,
+				OpSin,
+				OpCos,
+				OpTan,
+				OpExp,
+				OpExp2,
+				OpLog,
+				OpLog2,
+				OpTanh,
+				OpSqrt,
+				OpAbs,
+				OpFloor,
+				OpCeil,
+				NumOps,
+			};
+			
+			struct Function {
+				const char *name;
+				Op op;
+				uint32_t num_arguments;
+			};
+			
+			struct Node {
+				Op op;
+				uint32_t operand;
+				uint32_t arguments[3];
+				float32_t value;
+			};
+			
+			struct Parser {
+				const char *src;
+				const char *begin;
+				const char *const *names;
+				uint32_t num_names;
+				uint32_t nesting;
+			};
+			
+			/// parser recursion level
+			struct Nesting {
+				explicit Nesting(Parser &parser) : parser(parser) { parser.nesting++; }
+				~Nesting() { parser.nesting--; }
+				bool isValid() const { return (parser.nesting <= MaxNesting); }
+				Parser &parser;
+			};
+			
+			/// instruction encoding
+			static TS_INLINE Op get_op(uint32_t instruction) { return (Op)(instruction & 0xff); }
+			static TS_INLINE uint32_t get_operand(uint32_t instruction) { return (instruction >> 8); }
+			static TS_INLINE uint32_t get_instruction(Op op, uint32_t operand) { return ((uint32_t)op | (operand << 8)); }
+			
+			static uint32_t get_num_arguments(Op op) {
+				static const uint8_t num_arguments[NumOps] = {
+					0, 0, 1, 2, 2, 2, 2, 2, 2, 2, 3, 3, 2, 2,
+					1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+				};
+				return num_arguments[op];
+			}
+			
+			static const Function *get_function(const char *name, size_t length) {
+				static const Function functions[] = {
+					{ "pow", OpPow, 2 }, { "min", OpMin, 2 }, { "max", OpMax, 2 }, { "clamp", OpClamp, 3 },
+					{ "lerp", OpLerp, 3 }, { "step", OpStep, 2 }, { "atan2", OpAtan2, 2 },
+					{ "sin", OpSin, 1 }, { "cos", OpCos, 1 }, { "tan", OpTan, 1 }, { "exp", OpExp, 1 },
+					{ "exp2", OpExp2, 1 }, { "log", OpLog, 1 }, { "log2", OpLog2, 1 }, { "tanh", OpTanh, 1 },
+					{ "sqrt", OpSqrt, 1 }, { "abs", OpAbs, 1 }, { "floor", OpFloor, 1 }, { "ceil", OpCeil, 1 },
+				};
+				for(const Function &function : functions) {
+					if(strlen(function.name) == length && strncmp(function.name, name, length) == 0) return &function;
+				}
+				return nullptr;
+			}
+			
+			/// vector power matching the scalar one for the zero, one and negative bases
+			static TS_INLINE int32x8_t is_zero(const int32x8_t &u) {
+				return ((u & 0x7fffffff) - 1) >> 31;
+			}
+			static TS_INLINE float32x8_t pow(const float32x8_t &a, const float32x8_t &b) {
+				int32x8_t ua = a.asi32x8();
+				int32x8_t ub = b.asi32x8() & 0x7fffffff;
+				float32x8_t half = b * 0.5f;
+				int32x8_t negative = ua >> 31;
+				int32x8_t finite_a = ((ua & 0x7fffffff) - 0x7f800000) >> 31;
+				int32x8_t finite_b = (ub - 0x7f800000) >> 31;
+				int32x8_t integer = is_zero((b - floor(b)).asi32x8()) & finite_b;
+				int32x8_t odd = (is_zero((half - floor(half)).asi32x8()) ^ -1) & integer;
+				int32x8_t abs_one = is_zero(ua ^ 0x3f800000);
+				
+				// the sign of the odd integer powers
+				int32x8_t ret = exp2(log2(abs(a)) * b).asi32x8() ^ (negative & odd & (int32_t)0x80000000);
+				
+				// NaN for the finite negative bases with the fractional exponents
+				int32x8_t nan = negative & finite_a & finite_b & (integer ^ -1) & (is_zero(ua) ^ -1);
+				ret = (ret & (nan ^ -1)) | (nan & 0x7fc00000);
+				
+				// one for the zero exponents, the positive one base and the unit base with the infinite exponents
+				int32x8_t one = is_zero(ub) | (abs_one & (negative ^ -1)) | (abs_one & is_zero(ub ^ 0x7f800000));
+				ret = (ret & (one ^ -1)) | (one & 0x3f800000);
+				
+				return ret.asf32x8();
+			}
+			
+			/// scalar operation
+			static float32_t evaluate(Op op, float32_t a, float32_t b, float32_t c) {
+				switch(op) {
+					case OpNeg: return -a;
+					case OpAdd: return a + b;
+					case OpSub: return a - b;
+					case OpMul: return a * b;
+					case OpDiv: return a / b;
+					case OpPow: return Tellusim::pow(a, b);
+					case OpMin: return Tellusim::min(a, b);
+					case OpMax: return Tellusim::max(a, b);
+					case OpClamp: return Tellusim::min(Tellusim::max(a, b), c);
+					case OpLerp: return a + (b - a) * c;
+					case OpStep: return (b < a) ? 0.0f : 1.0f;
+					case OpAtan2: return Tellusim::atan2(a, b);
+					case OpSin: return Tellusim::sin(a);
+					case OpCos: return Tellusim::cos(a);
+					case OpTan: return Tellusim::tan(a);
+					case OpExp: return Tellusim::exp(a);
+					case OpExp2: return Tellusim::exp2(a);
+					case OpLog: return Tellusim::log(a);
+					case OpLog2: return Tellusim::log2(a);
+					case OpTanh: return Tellusim::tanh(a);
+					case OpSqrt: return Tellusim::sqrt(a);
+					case OpAbs: return Tellusim::abs(a);
+					case OpFloor: return Tellusim::floor(a);
+					case OpCeil: return Tellusim::ceil(a);
+					default: return 0.0f;
+				}
+			}
+			
+			/*
+			 */
+			static const char *skip(Parser &parser) {
+				while(*parser.src == ' ' || *parser.src == '\t' || *parser.src == '\n' || *parser.src == '\r') parser.src++;
+				return parser.src;
+			}
+			
+			static uint32_t error(const Parser &parser, const char *message) {
+				TS_LOGF(Error, "ExpressionProgram::compile(): %s at %u\n", message, (uint32_t)(parser.src - parser.begin));
+				return Maxu32;
+			}
+			
+			/// creates the node and folds the constant arguments
+			uint32_t create_node(Op op, uint32_t operand, const uint32_t *arguments = nullptr, float32_t value = 0.0f) {
+				Node node = { op, operand, { Maxu32, Maxu32, Maxu32 }, value };
+				uint32_t num = get_num_arguments(op);
+				bool constant = (op > OpVariable);
+				float32_t values[3] = { 0.0f, 0.0f, 0.0f };
+				for(uint32_t i = 0; i < num; i++) {
+					const Node &argument = nodes[arguments[i]];
+					constant &= (argument.op == OpConstant);
+					values[i] = argument.value;
+					node.arguments[i] = arguments[i];
+				}
+				if(constant) node = { OpConstant, 0, { Maxu32, Maxu32, Maxu32 }, evaluate(op, values[0], values[1], values[2]) };
+				nodes.append(node);
+				return nodes.size() - 1;
+			}
+			
+			/// expression := term (('+' | '-') term)*
+			uint32_t parse_expression(Parser &parser) {
+				Nesting nesting(parser);
+				if(!nesting.isValid()) return error(parser, "expression is too deep");
+				uint32_t ret = parse_term(parser);
+				while(ret != Maxu32) {
+					char c = *skip(parser);
+					if(c != '+' && c != '-') break;
+					parser.src++;
+					uint32_t arguments[2] = { ret, parse_term(parser) };
+					if(arguments[1] == Maxu32) return Maxu32;
+					ret = create_node((c == '+') ? OpAdd : OpSub, 0, arguments);
+				}
+				return ret;
+			}
+			
+			/// term := unary (('*' | '/') unary)*
+			uint32_t parse_term(Parser &parser) {
+				uint32_t ret = parse_unary(parser);
+				while(ret != Maxu32) {
+					char c = *skip(parser);
+					if(c != '*' && c != '/') break;
+					parser.src++;
+					uint32_t arguments[2] = { ret, parse_unary(parser) };
+					if(arguments[1] == Maxu32) return Maxu32;
+					ret = create_node((c == '*') ? OpMul : OpDiv, 0, arguments);
+				}
+				return ret;
+			}
+			
+			/// unary := ('-' | '+') unary | power
+			uint32_t parse_unary(Parser &parser) {
+				Nesting nesting(parser);
+				if(!nesting.isValid()) return error(parser, "expression is too deep");
+				char c = *skip(parser);
+				if(c == '+' || c == '-') {
+					parser.src++;
+					uint32_t argument = parse_unary(parser);
+					if(argument == Maxu32 || c == '+') return argument;
+					return create_node(OpNeg, 0, &argument);
+				}
+				return parse_power(parser);
+			}
+			
+			/// power := primary ('^' unary)?
+			uint32_t parse_power(Parser &parser) {
+				uint32_t ret = parse_primary(parser);
+				if(ret != Maxu32 && *skip(parser) == '^') {
+					parser.src++;
+					uint32_t arguments[2] = { ret, parse_unary(parser) };
+					if(arguments[1] == Maxu32) return Maxu32;
+					ret = create_node(OpPow, 0, arguments);
+				}
+				return ret;
+			}
+			
+			/// primary := number | variable | function '(' arguments ')' | '(' expression ')'
+			uint32_t parse_primary(Parser &parser) {
+				
+				Nesting nesting(parser);
+				if(!nesting.isValid()) return error(parser, "expression is too deep");
+				
+				const char *s = skip(parser);
+				
+				// parentheses
+				if(*s == '(') {
+					parser.src++;
+					uint32_t ret = parse_expression(parser);
+					if(ret == Maxu32) return Maxu32;
+					if(*skip(parser) != ')') return error(parser, "missing ')'");
+					parser.src++;
+					return ret;
+				}
+				
+				// number
+				if((*s >= '0' && *s <= '9') || *s == '.') {
+					char *end = nullptr;
+					float32_t value = strtof(s, &end);
+					if(end == s) return error(parser, "invalid number");
+					if(*end == 'f' || *end == 'F') end++;
+					parser.src = end;
+					return create_node(OpConstant, 0, nullptr, value);
+				}
+				
+				// identifier
+				if(!is_name(*s, false)) return error(parser, (*s) ? "unexpected symbol" : "unexpected end");
+				size_t length = 0;
+				while(is_name(s[length], true)) length++;
+				parser.src += length;
+				
+				// function
+				if(*skip(parser) == '(') {
+					const Function *function = get_function(s, length);
+					if(function == nullptr) {
+						parser.src = s;
+						return error(parser, "unknown function");
+					}
+					parser.src++;
+					uint32_t arguments[3];
+					for(uint32_t i = 0; i < function->num_arguments; i++) {
+						if(i && *skip(parser) != ',') return error(parser, "missing ','");
+						if(i) parser.src++;
+						arguments[i] = parse_expression(parser);
+						if(arguments[i] == Maxu32) return Maxu32;
+					}
+					if(*skip(parser) != ')') return error(parser, "missing ')'");
+					parser.src++;
+					return create_node(function->op, 0, arguments);
+				}
+				
+				// variable
+				for(uint32_t i = 0; i < parser.num_names; i++) {
+					if(strlen(parser.names[i]) == length && strncmp(parser.names[i], s, length) == 0) return create_node(OpVariable, i);
+				}
+				
+				// named constant
+				if(length == 2 && strncmp(s, "pi", 2) == 0) return create_node(OpConstant, 0, nullptr, Pi);
+				if(length == 1 && s[0] == 'e') return create_node(OpConstant, 0, nullptr, 2.71828182845904523536f);
+				
+				parser.src = s;
+				return error(parser, "unknown variable");
+			}
+			
+			static TS_INLINE bool is_name(char c, bool digits) {
+				return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (digits && c >= '0' && c <= '9'));
+			}
+			
+			/// emits the post-order bytecode with an explicit stack
+			void emit(uint32_t root) {
+				struct Item {
+					uint32_t index;
+					uint32_t argument;
+				};
+				uint32_t depth = 0;
+				Array<Item> stack;
+				stack.append({ root, 0 });
+				while(stack.size()) {
+					Item &item = stack[stack.size() - 1];
+					const Node &node = nodes[item.index];
+					uint32_t num = get_num_arguments(node.op);
+					if(item.argument < num) {
+						uint32_t index = node.arguments[item.argument++];
+						stack.append({ index, 0 });
+						continue;
+					}
+					stack.removeBack();
+					if(node.op == OpConstant) {
+						uint32_t operand = 0;
+						for(; operand < constants.size(); operand++) {
+							if(memcmp(&constants[operand], &node.value, sizeof(float32_t)) == 0) break;
+						}
+						if(operand == constants.size()) constants.append(node.value);
+						code.append(get_instruction(OpConstant, operand));
+						max_depth = max(max_depth, ++depth);
+					} else if(node.op == OpVariable) {
+						code.append(get_instruction(OpVariable, node.operand));
+						max_depth = max(max_depth, ++depth);
+					} else {
+						code.append(get_instruction(node.op, 0));
+						depth -= num - 1;
+					}
+				}
+			}
+			
+			Array<uint32_t> code;
+			Array<float32_t> constants;
+			Array<Node> nodes;
+			uint32_t max_depth = 0;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_EXPRESSION_PROGRAM_H__ */
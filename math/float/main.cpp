@@ -21,12 +21,42 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
 #include <math/TellusimFloat.h>
 
+#include "main_float.h"
+
 /*
  */
 using namespace Tellusim;
 
+/*
+ */
+template <class Function> uint64_t get_time(uint32_t num, const Function &function) {
+	uint64_t begin = Time::current();
+	for(uint32_t i = 0; i < num; i++) function();
+	return (Time::current() - begin) / num;
+}
+
+void print_speed(const char *str, size_t bytes, uint64_t time, uint64_t scalar_time) {
+	float64_t speed = (float64_t)bytes / max(time, (uint64_t)1) * 1e-3;
+	TS_LOGF(Message, "%s%s %.2f GB/s (scalar %s x%.1f)\n", str, String::fromTime(time).get(), speed, String::fromTime(scalar_time).get(), (float64_t)scalar_time / max(time, (uint64_t)1));
+}
+
+/*
+ */
+bool is_nan(float32_t value) {
+	return (value != value);
+}
+
+bool is_equal(float32_t value, float32_t reference, float32_t epsilon) {
+	if(is_nan(value) || is_nan(reference)) return (is_nan(value) == is_nan(reference));
+	if(value == reference) return true;
+	return (Tellusim::abs(value - reference) <= max(Tellusim::abs(reference) * epsilon, 6.0e-8f));
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -42,5 +72,109 @@ int32_t main(int32_t argc, char **argv) {
 		}
 	}
 	
+	// bulk conversion
+	{
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 1024 * 1024 * 4 + 3;
+		constexpr uint32_t num_iterations = 8;
+		
+		// special values and random bit patterns
+		const float32_t values[] = { 0.0f, -0.0f, 1.0f, -1.0f, 65504.0f, 65519.0f, 65520.0f, 1.0e-5f, 5.9604645e-8f, 2.9802322e-8f, 1.0e30f, -1.0e-30f };
+		Array<float32_t> src(size);
+		uint32_t seed = 0x12345678u;
+		for(uint32_t i = 0; i < size; i++) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			union { uint32_t u; float32_t f; } value = { (i & 1) ? seed : (seed & 0x8fffffffu) | 0x30000000u };
+			src[i] = (i < TS_COUNTOF(values)) ? values[i] : value.f;
+		}
+		
+		Array<float16_t> f16(size);
+		Array<float16_t> f16_simd(size);
+		Array<float21_t> f21(size);
+		Array<float24_t> f24(size);
+		Array<float32_t> dest(size);
+		Array<float32_t> dest_simd(size);
+		
+		// float16_t validation
+		FloatConverter::toFloat16(f16.get(), src.get(), size);
+		FloatConverter::toFloat16Simd(f16_simd.get(), src.get(), size);
+		FloatConverter::fromFloat16(dest.get(), f16.get(), size);
+		FloatConverter::fromFloat16Simd(dest_simd.get(), f16_simd.get(), size);
+		for(uint32_t i = 0; i < size; i++) {
+			if(!is_equal(dest[i], dest_simd[i], 0.0f)) return 1;
+			if(!is_equal(dest[i], float16_t(src[i]).get(), 1.0f / 1024.0f)) return 1;
+		}
+		
+		// float21_t and float24_t validation
+		FloatConverter::toFloat21(f21.get(), src.get(), size);
+		FloatConverter::fromFloat21(dest.get(), f21.get(), size);
+		for(uint32_t i = 0; i < size; i++) {
+			if(!is_equal(dest[i], f21[i].get(), 0.0f)) return 1;
+			if(!is_equal(dest[i], float21_t(src[i]).get(), 1.0f / 4096.0f)) return 1;
+		}
+		FloatConverter::toFloat24(f24.get(), src.get(), size);
+		FloatConverter::fromFloat24(dest.get(), f24.get(), size);
+		for(uint32_t i = 0; i < size; i++) {
+			if(!is_equal(dest[i], f24[i].get(), 0.0f)) return 1;
+			if(!is_equal(dest[i], float24_t(src[i]).get(), 1.0f / 32768.0f)) return 1;
+		}
+		
+		TS_LOGF(Message, "hardware f16: %s\n", FloatConverter::isHardware() ? "yes" : "no");
+		
+		// float16_t throughput
+		uint64_t scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) f16[i] = float16_t(src[i]);
+		});
+		uint64_t time = get_time(num_iterations, [&]() {
+			FloatConverter::toFloat16(f16.get(), src.get(), size);
+		});
+		print_speed("f32 -> f16: ", size * 6ull, time, scalar_time);
+		
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) dest[i] = f16[i].get();
+		});
+		time = get_time(num_iterations, [&]() {
+			FloatConverter::fromFloat16(dest.get(), f16.get(), size);
+		});
+		print_speed("f16 -> f32: ", size * 6ull, time, scalar_time);
+		
+		// float21_t throughput
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) f21[i] = float21_t(src[i]);
+		});
+		time = get_time(num_iterations, [&]() {
+			FloatConverter::toFloat21(f21.get(), src.get(), size);
+		});
+		print_speed("f32 -> f21: ", size * 8ull, time, scalar_time);
+		
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) dest[i] = f21[i].get();
+		});
+		time = get_time(num_iterations, [&]() {
+			FloatConverter::fromFloat21(dest.get(), f21.get(), size);
+		});
+		print_speed("f21 -> f32: ", size * 8ull, time, scalar_time);
+		
+		// float24_t throughput
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) f24[i] = float24_t(src[i]);
+		});
+		time = get_time(num_iterations, [&]() {
+			FloatConverter::toFloat24(f24.get(), src.get(), size);
+		});
+		print_speed("f32 -> f24: ", size * 8ull, time, scalar_time);
+		
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) dest[i] = f24[i].get();
+		});
+		time = get_time(num_iterations, [&]() {
+			FloatConverter::fromFloat24(dest.get(), f24.get(), size);
+		});
+		print_speed("f24 -> f32: ", size * 8ull, time, scalar_time);
+	}
+	
 	return 0;
 }
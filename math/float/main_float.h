@@ -0,0 +1,288 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_FLOAT_H__
+#define __TELLUSIM_TESTS_FLOAT_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimFloat.h>
+
+#include "main_simd16.h"
+
+#if TS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+	#include <arm_neon.h>
+	#define TS_FLOAT_NEON	1
+#else
+	#define TS_FLOAT_NEON	0
+#endif
+
+/*
+ */
+#if TS_SSE && !_WIN32
+	#define TS_TARGET_F16C	__attribute__((target("avx,f16c")))
+#else
+	#define TS_TARGET_F16C
+#endif
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 * Bulk float32_t conversions
+	 *
+	 * float16_t: IEEE 754 half precision, round to nearest even, denormals are preserved
+	 * float21_t: sign, 8-bit exponent, 12-bit mantissa in the low bits of the 32-bit storage
+	 * float24_t: sign, 8-bit exponent, 15-bit mantissa in the low bits of the 32-bit storage
+	 *
+	 * float21_t and float24_t are float32_t values with the truncated mantissa, conversion
+	 * rounds to nearest even and keeps NaN values quiet.
+	 */
+	class FloatConverter {
+			
+		public:
+			
+			/// hardware conversion is available
+			static bool isHardware() {
+				#if TS_FLOAT_NEON
+					return true;
+				#elif TS_SSE
+					return SimdCPU::hasFeature(SimdCPU::FeatureF16C);
+				#else
+					return false;
+				#endif
+			}
+			
+			/// float16_t conversion
+			static void toFloat16(float16_t *dest, const float32_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float16_t) == sizeof(uint16_t));
+				uint16_t *d = (uint16_t*)dest;
+				#if TS_FLOAT_NEON
+					size_t i = 0;
+					for(; i + 4 <= size; i += 4) {
+						vst1_u16(d + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+					}
+					to_float16_simd(d + i, src + i, size - i);
+				#elif TS_SSE
+					if(isHardware()) to_float16_f16c(d, src, size);
+					else to_float16_simd(d, src, size);
+				#else
+					to_float16_simd(d, src, size);
+				#endif
+			}
+			
+			static void fromFloat16(float32_t *dest, const float16_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float16_t) == sizeof(uint16_t));
+				const uint16_t *s = (const uint16_t*)src;
+				#if TS_FLOAT_NEON
+					size_t i = 0;
+					for(; i + 4 <= size; i += 4) {
+						vst1q_f32(dest + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(s + i))));
+					}
+					from_float16_simd(dest + i, s + i, size - i);
+				#elif TS_SSE
+					if(isHardware()) from_float16_f16c(dest, s, size);
+					else from_float16_simd(dest, s, size);
+				#else
+					from_float16_simd(dest, s, size);
+				#endif
+			}
+			
+			/// float21_t conversion
+			static void toFloat21(float21_t *dest, const float32_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float21_t) == sizeof(uint32_t));
+				to_truncated<23 - Float21Mantissa>((uint32_t*)dest, src, size);
+			}
+			
+			static void fromFloat21(float32_t *dest, const float21_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float21_t) == sizeof(uint32_t));
+				from_truncated<23 - Float21Mantissa>(dest, (const uint32_t*)src, size);
+			}
+			
+			/// float24_t conversion
+			static void toFloat24(float24_t *dest, const float32_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float24_t) == sizeof(uint32_t));
+				to_truncated<23 - Float24Mantissa>((uint32_t*)dest, src, size);
+			}
+			
+			static void fromFloat24(float32_t *dest, const float24_t *src, size_t size) {
+				TS_STATIC_ASSERT(sizeof(float24_t) == sizeof(uint32_t));
+				from_truncated<23 - Float24Mantissa>(dest, (const uint32_t*)src, size);
+			}
+			
+			/// portable conversion, used for the validation of the hardware path
+			static void toFloat16Simd(float16_t *dest, const float32_t *src, size_t size) {
+				to_float16_simd((uint16_t*)dest, src, size);
+			}
+			
+			static void fromFloat16Simd(float32_t *dest, const float16_t *src, size_t size) {
+				from_float16_simd(dest, (const uint16_t*)src, size);
+			}
+			
+		private:
+			
+			/// mantissa bits of the truncated formats
+			enum {
+				Float21Mantissa = 12,
+				Float24Mantissa = 15,
+			};
+			
+			/// per-lane mask selection
+			static TS_INLINE int32x8_t blend(const int32x8_t &mask, const int32x8_t &v0, const int32x8_t &v1) {
+				return (v0 & mask) | (v1 & (mask ^ -1));
+			}
+			
+			/// float32_t to float16_t bits
+			static TS_INLINE int32x8_t to_float16(const float32x8_t &f) {
+				int32x8_t u = f.asi32x8();
+				int32x8_t sign = (u >> 16) & 0x8000;
+				u = u & 0x7fffffff;
+				
+				// NaN, infinity and overflow
+				int32x8_t big = ((int32x8_t(0x7f800000) - u) >> 31) & 0x0200;
+				big = big | 0x7c00;
+				int32x8_t is_big = (u - 0x47800000) >> 31;
+				
+				// denormals are rounded by the float32_t addition
+				int32x8_t small = (u.asf32x8() + int32x8_t(0x3f000000).asf32x8()).asi32x8() - 0x3f000000;
+				int32x8_t is_small = (u - 0x38800000) >> 31;
+				
+				// round to nearest even
+				int32x8_t normal = (u - 0x37fff001 + ((u >> 13) & 1)) >> 13;
+				
+				int32x8_t ret = blend(is_small, small, normal);
+				return blend(is_big, ret, big) | sign;
+			}
+			
+			/// float16_t bits to float32_t
+			static TS_INLINE float32x8_t from_float16(const int32x8_t &h) {
+				int32x8_t o = (h & 0x7fff) << 13;
+				int32x8_t e = o & 0x0f800000;
+				o = o + 0x38000000;
+				
+				// NaN and infinity
+				o = o + ((((e - 0x0f800000) >> 31) ^ -1) & 0x38000000);
+				
+				// denormals are normalized by the float32_t subtraction
+				int32x8_t small = ((o + 0x00800000).asf32x8() - int32x8_t(0x38800000).asf32x8()).asi32x8();
+				o = blend((e - 1) >> 31, small, o);
+				
+				return (o | ((h & 0x8000) << 16)).asf32x8();
+			}
+			
+			/// portable float16_t conversion
+			static void to_float16_simd(uint16_t *dest, const float32_t *src, size_t size) {
+				TS_ALIGNAS32 float32_t s[8];
+				TS_ALIGNAS32 int32_t d[8];
+				for(size_t i = 0; i < size; i += 8) {
+					size_t num = min(size - i, (size_t)8);
+					for(size_t j = 0; j < num; j++) s[j] = src[i + j];
+					to_float16(float32x8_t(s)).get(d);
+					for(size_t j = 0; j < num; j++) dest[i + j] = (uint16_t)d[j];
+				}
+			}
+			
+			static void from_float16_simd(float32_t *dest, const uint16_t *src, size_t size) {
+				TS_ALIGNAS32 int32_t s[8];
+				TS_ALIGNAS32 float32_t d[8];
+				for(size_t i = 0; i < size; i += 8) {
+					size_t num = min(size - i, (size_t)8);
+					for(size_t j = 0; j < num; j++) s[j] = src[i + j];
+					from_float16(int32x8_t(s)).get(d);
+					for(size_t j = 0; j < num; j++) dest[i + j] = d[j];
+				}
+			}
+			
+			/// hardware float16_t conversion
+			#if TS_SSE
+				
+				TS_TARGET_F16C static void to_float16_f16c(uint16_t *dest, const float32_t *src, size_t size) {
+					size_t i = 0;
+					for(; i + 8 <= size; i += 8) {
+						_mm_storeu_si128((__m128i*)(dest + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+					}
+					to_float16_simd(dest + i, src + i, size - i);
+				}
+				
+				TS_TARGET_F16C static void from_float16_f16c(float32_t *dest, const uint16_t *src, size_t size) {
+					size_t i = 0;
+					for(; i + 8 <= size; i += 8) {
+						_mm256_storeu_ps(dest + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+					}
+					from_float16_simd(dest + i, src + i, size - i);
+				}
+				
+			#endif
+			
+			/// truncated float32_t conversion
+			template <uint32_t Shift> static void to_truncated(uint32_t *dest, const float32_t *src, size_t size) {
+				constexpr int32_t mask = (int32_t)(0xffffffffu >> Shift);
+				constexpr int32_t quiet = (1 << (22 - Shift));
+				constexpr int32_t half = (1 << (Shift - 1)) - 1;
+				size_t i = 0;
+				#if TS_SSE
+					__m128i one_4 = _mm_set1_epi32(1);
+					__m128i half_4 = _mm_set1_epi32(half);
+					__m128i quiet_4 = _mm_set1_epi32(quiet);
+					__m128i abs_4 = _mm_set1_epi32(0x7fffffff);
+					__m128i inf_4 = _mm_set1_epi32(0x7f800000);
+					for(; i + 4 <= size; i += 4) {
+						__m128i u = _mm_castps_si128(_mm_loadu_ps(src + i));
+						__m128i ret = _mm_srli_epi32(_mm_add_epi32(u, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(u, Shift), one_4), half_4)), Shift);
+						__m128i nan = _mm_or_si128(_mm_srli_epi32(u, Shift), quiet_4);
+						__m128i is_nan = _mm_cmpgt_epi32(_mm_and_si128(u, abs_4), inf_4);
+						_mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(_mm_and_si128(is_nan, nan), _mm_andnot_si128(is_nan, ret)));
+					}
+				#endif
+				TS_ALIGNAS32 float32_t s[8];
+				TS_ALIGNAS32 int32_t d[8];
+				for(; i < size; i += 8) {
+					size_t num = min(size - i, (size_t)8);
+					for(size_t j = 0; j < num; j++) s[j] = src[i + j];
+					int32x8_t u = float32x8_t(s).asi32x8();
+					int32x8_t ret = ((u + ((u >> Shift) & 1) + half) >> Shift) & mask;
+					int32x8_t nan = ((u >> Shift) & mask) | quiet;
+					blend((int32x8_t(0x7f800000) - (u & 0x7fffffff)) >> 31, nan, ret).get(d);
+					for(size_t j = 0; j < num; j++) dest[i + j] = (uint32_t)d[j];
+				}
+			}
+			
+			template <uint32_t Shift> static void from_truncated(float32_t *dest, const uint32_t *src, size_t size) {
+				size_t i = 0;
+				#if TS_SSE
+					for(; i + 4 <= size; i += 4) {
+						_mm_storeu_si128((__m128i*)(dest + i), _mm_slli_epi32(_mm_loadu_si128((const __m128i*)(src + i)), Shift));
+					}
+				#endif
+				TS_ALIGNAS32 int32_t s[8];
+				TS_ALIGNAS32 float32_t d[8];
+				for(; i < size; i += 8) {
+					size_t num = min(size - i, (size_t)8);
+					for(size_t j = 0; j < num; j++) s[j] = (int32_t)src[i + j];
+					(int32x8_t(s) << Shift).asf32x8().get(d);
+					for(size_t j = 0; j < num; j++) dest[i + j] = d[j];
+				}
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_FLOAT_H__ */
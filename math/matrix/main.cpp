@@ -21,8 +21,14 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
 #include <math/TellusimMatrix.h>
 
+#include "main_transform.h"
+#include "main_inverse.h"
+
 /*
  */
 using namespace Tellusim;
@@ -39,6 +45,28 @@ template <class Type> void printm4x4(const char *str, const Type &m) {
 		m.m00, m.m01, m.m02, m.m03, m.m10, m.m11, m.m12, m.m13, m.m20, m.m21, m.m22, m.m23, m.m30, m.m31, m.m32, m.m33);
 }
 
+/*
+ */
+template <class Function> uint64_t get_time(uint32_t num, const Function &function) {
+	uint64_t begin = Time::current();
+	for(uint32_t i = 0; i < num; i++) function();
+	return (Time::current() - begin) / num;
+}
+
+void print_time(const char *str, uint32_t size, uint64_t scalar_time, uint64_t batch_time) {
+	float64_t speed = (float64_t)size / max(batch_time, (uint64_t)1);
+	float64_t ratio = (float64_t)scalar_time / max(batch_time, (uint64_t)1);
+	TS_LOGF(Message, "%s%s -> %s (%.1f M/s x%.2f)\n", str, String::fromTime(scalar_time).get(), String::fromTime(batch_time).get(), speed, ratio);
+}
+
+float32_t get_error(const float32_t *v0, const float32_t *v1, uint32_t size) {
+	float32_t ret = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		ret = max(ret, Tellusim::abs(v0[i] - v1[i]) / max(Tellusim::abs(v1[i]), 1.0f));
+	}
+	return ret;
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -105,5 +133,197 @@ int32_t main(int32_t argc, char **argv) {
 		printm4x3("m2: ", m2 * m0 * m2);
 	}
 	
+	{
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 1024 * 1024 + 5;
+		constexpr uint32_t num_iterations = 8;
+		
+		Matrix4x4f transform = Matrix4x4f::rotateX(45.0f) * Matrix4x4f::translate(10.0f, 20.0f, 30.0f) * Matrix4x4f::rotateZ(30.0f);
+		Matrix4x4f projection = Matrix4x4f::perspective(60.0f, 1.0f, 0.1f, 1000.0f) * Matrix4x4f::translate(0.0f, 0.0f, -200.0f);
+		Matrix4x4f rotation = transform;
+		rotation.m03 = 0.0f;
+		rotation.m13 = 0.0f;
+		rotation.m23 = 0.0f;
+		
+		Array<Vector3f> src(size);
+		Array<BoundBoxf> bounds(size);
+		for(uint32_t i = 0; i < size; i++) {
+			src[i] = Vector3f((float32_t)(i % 101) - 50.0f, (float32_t)(i % 89) - 44.0f, (float32_t)(i % 97) - 48.0f);
+			bounds[i] = BoundBoxf(src[i], src[i] + Vector3f((float32_t)(i % 3) + 1.0f));
+		}
+		
+		Array<Vector3f> scalar_dest(size);
+		Array<Vector3f> batch_dest(size);
+		
+		// points
+		uint64_t scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = transform * src[i];
+		});
+		uint64_t batch_time = get_time(num_iterations, [&]() {
+			BatchTransform::points(batch_dest.get(), transform, src.get(), size);
+		});
+		print_time("points: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].v, scalar_dest[0].v, size * 3) > 1e-5f) return 1;
+		
+		// strided points
+		Array<Vector4f> vectors(size, Vector4f(1.0f));
+		BatchTransform::points((Vector3f*)vectors.get(), transform, src.get(), size, sizeof(Vector4f));
+		for(uint32_t i = 0; i < size; i++) {
+			if(vectors[i].x != batch_dest[i].x || vectors[i].z != batch_dest[i].z || vectors[i].w != 1.0f) return 1;
+		}
+		
+		// homogeneous points
+		Array<Vector4f> scalar_vectors(size);
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_vectors[i] = transform * vectors[i];
+		});
+		Array<Vector4f> batch_vectors(size);
+		batch_time = get_time(num_iterations, [&]() {
+			BatchTransform::points(batch_vectors.get(), transform, vectors.get(), size);
+		});
+		print_time("vectors: ", size, scalar_time, batch_time);
+		if(get_error(batch_vectors[0].v, scalar_vectors[0].v, size * 4) > 1e-5f) return 1;
+		
+		// in-place homogeneous points
+		batch_vectors = vectors;
+		BatchTransform::points(batch_vectors.get(), transform, batch_vectors.get(), size);
+		if(get_error(batch_vectors[0].v, scalar_vectors[0].v, size * 4) > 1e-5f) return 1;
+		
+		// directions
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = rotation * src[i];
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchTransform::directions(batch_dest.get(), transform, src.get(), size);
+		});
+		print_time("directions: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].v, scalar_dest[0].v, size * 3) > 1e-5f) return 1;
+		
+		// perspective projection
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) {
+				Vector4f position = projection * Vector4f(src[i], 1.0f);
+				scalar_dest[i] = Vector3f(position.x, position.y, position.z) / position.w;
+			}
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchTransform::project(batch_dest.get(), projection, src.get(), size);
+		});
+		print_time("project: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].v, scalar_dest[0].v, size * 3) > 1e-5f) return 1;
+		
+		// bound boxes
+		Array<BoundBoxf> scalar_bounds(size);
+		Array<BoundBoxf> batch_bounds(size);
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_bounds[i] = transform * bounds[i];
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchTransform::bounds(batch_bounds.get(), transform, bounds.get(), size);
+		});
+		print_time("bounds: ", size, scalar_time, batch_time);
+		if(get_error(batch_bounds[0].min.v, scalar_bounds[0].min.v, size * 6) > 1e-5f) return 1;
+		
+		// invalid bound boxes
+		BoundBoxf invalid[3] = { BoundBoxf(), BoundBoxf(Vector3f(1.0f), Vector3f(-1.0f)), BoundBoxf(Vector3f(0.0f, 2.0f, 0.0f), Vector3f(1.0f, 1.0f, 1.0f)) };
+		for(uint32_t i = 0; i < size; i += 1021) batch_bounds[i] = invalid[i % TS_COUNTOF(invalid)];
+		BatchTransform::bounds(batch_bounds.get(), transform, batch_bounds.get(), size);
+		for(uint32_t i = 0; i < size; i += 1021) {
+			const BoundBoxf &bb = invalid[i % TS_COUNTOF(invalid)];
+			if(batch_bounds[i].min != bb.min || batch_bounds[i].max != bb.max) return 1;
+			if(i % TS_COUNTOF(invalid) < 2 && batch_bounds[i].isValid()) return 1;
+		}
+		if(!batch_bounds[1].isValid()) return 1;
+	}
+	
+	{
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 256 * 1024 + 5;
+		constexpr uint32_t num_iterations = 8;
+		
+		// affine and projective matrices
+		Array<Matrix4x4f> affine(size);
+		Array<Matrix4x4f> projective(size);
+		Array<Matrix4x3f> affine43(size);
+		Matrix4x4f projection = Matrix4x4f::perspective(60.0f, 1.0f, 0.1f, 1000.0f);
+		for(uint32_t i = 0; i < size; i++) {
+			float32_t angle = (float32_t)(i % 360);
+			affine[i] = Matrix4x4f::translate((float32_t)(i % 101) - 50.0f, (float32_t)(i % 89) - 44.0f, (float32_t)(i % 97) - 48.0f);
+			affine[i] *= Matrix4x4f::rotateX(angle) * Matrix4x4f::rotateZ(angle * 0.7f) * Matrix4x4f::scale((float32_t)(i % 5) + 0.5f);
+			projective[i] = projection * affine[i];
+			affine43[i] = Matrix4x3f(
+				affine[i].m00, affine[i].m01, affine[i].m02, affine[i].m03,
+				affine[i].m10, affine[i].m11, affine[i].m12, affine[i].m13,
+				affine[i].m20, affine[i].m21, affine[i].m22, affine[i].m23
+			);
+		}
+		
+		Array<Matrix4x4f> scalar_dest(size);
+		Array<Matrix4x4f> batch_dest(size);
+		
+		// projective inverse
+		uint64_t scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = inverse(projective[i]);
+		});
+		uint64_t batch_time = get_time(num_iterations, [&]() {
+			BatchInverse::inverse(batch_dest.get(), projective.get(), size);
+		});
+		print_time("inverse: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].m, scalar_dest[0].m, size * 16) > 1e-4f) return 1;
+		
+		// affine inverse
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = inverse43(affine[i]);
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchInverse::inverse43(batch_dest.get(), affine.get(), size);
+		});
+		print_time("inverse43: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].m, scalar_dest[0].m, size * 16) > 1e-5f) return 1;
+		
+		// affine inverse of the Matrix4x3
+		Array<Matrix4x3f> batch_dest43(size);
+		batch_time = get_time(num_iterations, [&]() {
+			BatchInverse::inverse(batch_dest43.get(), affine43.get(), size);
+		});
+		print_time("inverse 4x3: ", size, scalar_time, batch_time);
+		for(uint32_t i = 0; i < size; i++) {
+			if(get_error(batch_dest43[i].m, scalar_dest[i].m, 12) > 1e-5f) return 1;
+		}
+		
+		// normal matrices
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = transpose(inverse43(affine[i]));
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchInverse::transposeInverse(batch_dest.get(), affine.get(), size, true);
+		});
+		print_time("transpose inverse43: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].m, scalar_dest[0].m, size * 16) > 1e-5f) return 1;
+		
+		BatchInverse::transposeInverse(batch_dest43.get(), affine43.get(), size);
+		for(uint32_t i = 0; i < size; i++) {
+			const Matrix4x4f &m = scalar_dest[i];
+			Matrix4x3f normal = Matrix4x3f(m.m00, m.m01, m.m02, 0.0f, m.m10, m.m11, m.m12, 0.0f, m.m20, m.m21, m.m22, 0.0f);
+			if(get_error(batch_dest43[i].m, normal.m, 12) > 1e-5f) return 1;
+		}
+		
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = transpose(inverse(projective[i]));
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchInverse::transposeInverse(batch_dest.get(), projective.get(), size);
+		});
+		print_time("transpose inverse: ", size, scalar_time, batch_time);
+		if(get_error(batch_dest[0].m, scalar_dest[0].m, size * 16) > 1e-4f) return 1;
+		
+		// in-place inversion
+		BatchInverse::inverse(batch_dest.get(), projective.get(), size);
+		BatchInverse::inverse(projective.get(), projective.get(), size);
+		if(get_error(projective[0].m, batch_dest[0].m, size * 16) != 0.0f) return 1;
+	}
+	
 	return 0;
 }
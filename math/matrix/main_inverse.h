@@ -0,0 +1,245 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_INVERSE_H__
+#define __TELLUSIM_TESTS_INVERSE_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimMatrix.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class BatchInverse {
+			
+		public:
+			
+			/// inverts projective matrices, in-place inversion is allowed
+			static void inverse(Matrix4x4f *dest, const Matrix4x4f *src, uint32_t size) {
+				Lanes m, ret;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(m, src + i, num);
+					inverse(ret, m);
+					store(dest + i, ret, num);
+				}
+			}
+			
+			/// inverts affine matrices, the last row is assumed to be (0, 0, 0, 1)
+			static void inverse43(Matrix4x4f *dest, const Matrix4x4f *src, uint32_t size) {
+				Lanes m, ret;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(m, src + i, num);
+					inverse43(ret, m);
+					store(dest + i, ret, num);
+				}
+			}
+			
+			static void inverse(Matrix4x3f *dest, const Matrix4x3f *src, uint32_t size) {
+				Lanes m, ret;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(m, src + i, num);
+					inverse43(ret, m);
+					store(dest + i, ret, num);
+				}
+			}
+			
+			/// transposed inverse matrices for the normal transformation
+			/// the affine flag selects the inverse43() path
+			static void transposeInverse(Matrix4x4f *dest, const Matrix4x4f *src, uint32_t size, bool affine = false) {
+				Lanes m, ret;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(m, src + i, num);
+					if(affine) inverse43(ret, m);
+					else inverse(ret, m);
+					transpose(ret);
+					store(dest + i, ret, num);
+				}
+			}
+			
+			/// transposed inverse of the rotation part, the translation is zero
+			static void transposeInverse(Matrix4x3f *dest, const Matrix4x3f *src, uint32_t size) {
+				Lanes m, ret;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(m, src + i, num);
+					inverse43(ret, m);
+					transpose(ret);
+					ret.m[3] = ret.m[7] = ret.m[11] = float32x8_t(0.0f);
+					store(dest + i, ret, num);
+				}
+			}
+			
+		private:
+			
+			/// row-major matrix components
+			struct Lanes {
+				float32x8_t m[16];
+			};
+			
+			/// inverse by the 2x2 sub-determinants of the upper and the lower row pairs
+			static TS_INLINE void inverse(Lanes &ret, const Lanes &a) {
+				const float32x8_t *m = a.m;
+				float32x8_t s0 = m[0] * m[5] - m[4] * m[1];
+				float32x8_t s1 = m[0] * m[6] - m[4] * m[2];
+				float32x8_t s2 = m[0] * m[7] - m[4] * m[3];
+				float32x8_t s3 = m[1] * m[6] - m[5] * m[2];
+				float32x8_t s4 = m[1] * m[7] - m[5] * m[3];
+				float32x8_t s5 = m[2] * m[7] - m[6] * m[3];
+				float32x8_t c0 = m[8] * m[13] - m[12] * m[9];
+				float32x8_t c1 = m[8] * m[14] - m[12] * m[10];
+				float32x8_t c2 = m[8] * m[15] - m[12] * m[11];
+				float32x8_t c3 = m[9] * m[14] - m[13] * m[10];
+				float32x8_t c4 = m[9] * m[15] - m[13] * m[11];
+				float32x8_t c5 = m[10] * m[15] - m[14] * m[11];
+				float32x8_t idet = float32x8_t(1.0f) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+				float32x8_t *r = ret.m;
+				r[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * idet;
+				r[1] = (m[2] * c4 - m[1] * c5 - m[3] * c3) * idet;
+				r[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * idet;
+				r[3] = (m[10] * s4 - m[9] * s5 - m[11] * s3) * idet;
+				r[4] = (m[6] * c2 - m[4] * c5 - m[7] * c1) * idet;
+				r[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * idet;
+				r[6] = (m[14] * s2 - m[12] * s5 - m[15] * s1) * idet;
+				r[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * idet;
+				r[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * idet;
+				r[9] = (m[1] * c2 - m[0] * c4 - m[3] * c0) * idet;
+				r[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * idet;
+				r[11] = (m[9] * s2 - m[8] * s4 - m[11] * s0) * idet;
+				r[12] = (m[5] * c1 - m[4] * c3 - m[6] * c0) * idet;
+				r[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * idet;
+				r[14] = (m[13] * s1 - m[12] * s3 - m[14] * s0) * idet;
+				r[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * idet;
+			}
+			
+			/// inverse of the rotation part by cofactors and the rotated negative translation
+			static TS_INLINE void inverse43(Lanes &ret, const Lanes &a) {
+				const float32x8_t *m = a.m;
+				float32x8_t *r = ret.m;
+				float32x8_t i00 = m[5] * m[10] - m[6] * m[9];
+				float32x8_t i10 = m[6] * m[8] - m[4] * m[10];
+				float32x8_t i20 = m[4] * m[9] - m[5] * m[8];
+				float32x8_t idet = float32x8_t(1.0f) / (m[0] * i00 + m[1] * i10 + m[2] * i20);
+				r[0] = i00 * idet;
+				r[1] = (m[2] * m[9] - m[1] * m[10]) * idet;
+				r[2] = (m[1] * m[6] - m[2] * m[5]) * idet;
+				r[4] = i10 * idet;
+				r[5] = (m[0] * m[10] - m[2] * m[8]) * idet;
+				r[6] = (m[2] * m[4] - m[0] * m[6]) * idet;
+				r[8] = i20 * idet;
+				r[9] = (m[1] * m[8] - m[0] * m[9]) * idet;
+				r[10] = (m[0] * m[5] - m[1] * m[4]) * idet;
+				r[3] = -(r[0] * m[3] + r[1] * m[7] + r[2] * m[11]);
+				r[7] = -(r[4] * m[3] + r[5] * m[7] + r[6] * m[11]);
+				r[11] = -(r[8] * m[3] + r[9] * m[7] + r[10] * m[11]);
+				r[12] = r[13] = r[14] = float32x8_t(0.0f);
+				r[15] = float32x8_t(1.0f);
+			}
+			
+			static TS_INLINE void transpose(Lanes &m) {
+				for(uint32_t y = 1; y < 4; y++) {
+					for(uint32_t x = 0; x < y; x++) {
+						float32x8_t temp = m.m[y * 4 + x];
+						m.m[y * 4 + x] = m.m[x * 4 + y];
+						m.m[x * 4 + y] = temp;
+					}
+				}
+			}
+			
+			/// AoS to SoA conversion of the num matrices, the remaining lanes are identity
+			template <class Type> static TS_INLINE void load(Lanes &m, const Type *src, uint32_t num) {
+				enum { Size = sizeof(Type) / sizeof(float32_t) };
+				#if TS_AVX
+					if(Size == 16 && num == 8) {
+						for(uint32_t i = 0; i < Size; i += 8) {
+							__m256 r[8];
+							for(uint32_t j = 0; j < 8; j++) r[j] = _mm256_loadu_ps(src[j].m + i);
+							transpose(r);
+							for(uint32_t j = 0; j < 8; j++) m.m[i + j] = float32x8_t(r[j]);
+						}
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[16][8];
+				for(uint32_t i = 0; i < 8; i++) {
+					if(i < num) {
+						for(uint32_t j = 0; j < Size; j++) data[j][i] = src[i].m[j];
+					} else {
+						for(uint32_t j = 0; j < Size; j++) data[j][i] = (j % 5 == 0) ? 1.0f : 0.0f;
+					}
+				}
+				for(uint32_t j = 0; j < Size; j++) m.m[j] = float32x8_t(data[j]);
+				for(uint32_t j = Size; j < 16; j++) m.m[j] = float32x8_t((j == 15) ? 1.0f : 0.0f);
+			}
+			
+			/// SoA to AoS conversion of the num matrices
+			template <class Type> static TS_INLINE void store(Type *dest, const Lanes &m, uint32_t num) {
+				enum { Size = sizeof(Type) / sizeof(float32_t) };
+				#if TS_AVX
+					if(Size == 16 && num == 8) {
+						for(uint32_t i = 0; i < Size; i += 8) {
+							__m256 r[8];
+							for(uint32_t j = 0; j < 8; j++) r[j] = m.m[i + j].vec;
+							transpose(r);
+							for(uint32_t j = 0; j < 8; j++) _mm256_storeu_ps(dest[j].m + i, r[j]);
+						}
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[16][8];
+				for(uint32_t j = 0; j < Size; j++) m.m[j].get(data[j]);
+				for(uint32_t i = 0; i < num; i++) {
+					for(uint32_t j = 0; j < Size; j++) dest[i].m[j] = data[j][i];
+				}
+			}
+			
+			#if TS_AVX
+				/// in-register 8x8 transpose
+				static TS_INLINE void transpose(__m256 (&r)[8]) {
+					__m256 t[8];
+					for(uint32_t i = 0; i < 8; i += 2) {
+						t[i + 0] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+						t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+					}
+					for(uint32_t i = 0; i < 8; i += 4) {
+						r[i + 0] = _mm256_shuffle_ps(t[i + 0], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+						r[i + 1] = _mm256_shuffle_ps(t[i + 0], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+						r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+						r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+					}
+					for(uint32_t i = 0; i < 4; i++) {
+						t[i + 0] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x20);
+						t[i + 4] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x31);
+					}
+					for(uint32_t i = 0; i < 8; i++) r[i] = t[i];
+				}
+			#endif
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_INVERSE_H__ */
@@ -0,0 +1,278 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_TRANSFORM_H__
+#define __TELLUSIM_TESTS_TRANSFORM_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimMatrix.h>
+#include <geometry/TellusimBounds.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class BatchTransform {
+			
+		public:
+			
+			/// transforms points by the matrix with the implicit w = 1
+			/// strides are the distances between the elements in bytes, in-place transformation is allowed
+			static void points(Vector3f *dest, const Matrix4x4f &m, const Vector3f *src, uint32_t size, uint32_t dest_stride = sizeof(Vector3f), uint32_t src_stride = sizeof(Vector3f)) {
+				const Rows rows(m);
+				float32x8_t x, y, z;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(x, y, z, (const uint8_t*)src + (size_t)src_stride * i, src_stride, num);
+					float32x8_t rx = rows.m00 * x + rows.m01 * y + rows.m02 * z + rows.m03;
+					float32x8_t ry = rows.m10 * x + rows.m11 * y + rows.m12 * z + rows.m13;
+					float32x8_t rz = rows.m20 * x + rows.m21 * y + rows.m22 * z + rows.m23;
+					store((uint8_t*)dest + (size_t)dest_stride * i, dest_stride, rx, ry, rz, num);
+				}
+			}
+			
+			/// transforms homogeneous points by the matrix
+			static void points(Vector4f *dest, const Matrix4x4f &m, const Vector4f *src, uint32_t size, uint32_t dest_stride = sizeof(Vector4f), uint32_t src_stride = sizeof(Vector4f)) {
+				const Rows rows(m);
+				float32x8_t x, y, z, w;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(x, y, z, w, (const uint8_t*)src + (size_t)src_stride * i, src_stride, num);
+					float32x8_t rx = rows.m00 * x + rows.m01 * y + rows.m02 * z + rows.m03 * w;
+					float32x8_t ry = rows.m10 * x + rows.m11 * y + rows.m12 * z + rows.m13 * w;
+					float32x8_t rz = rows.m20 * x + rows.m21 * y + rows.m22 * z + rows.m23 * w;
+					float32x8_t rw = rows.m30 * x + rows.m31 * y + rows.m32 * z + rows.m33 * w;
+					store((uint8_t*)dest + (size_t)dest_stride * i, dest_stride, rx, ry, rz, rw, num);
+				}
+			}
+			
+			/// transforms directions by the upper 3x3 part of the matrix
+			static void directions(Vector3f *dest, const Matrix4x4f &m, const Vector3f *src, uint32_t size, uint32_t dest_stride = sizeof(Vector3f), uint32_t src_stride = sizeof(Vector3f)) {
+				const Rows rows(m);
+				float32x8_t x, y, z;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(x, y, z, (const uint8_t*)src + (size_t)src_stride * i, src_stride, num);
+					float32x8_t rx = rows.m00 * x + rows.m01 * y + rows.m02 * z;
+					float32x8_t ry = rows.m10 * x + rows.m11 * y + rows.m12 * z;
+					float32x8_t rz = rows.m20 * x + rows.m21 * y + rows.m22 * z;
+					store((uint8_t*)dest + (size_t)dest_stride * i, dest_stride, rx, ry, rz, num);
+				}
+			}
+			
+			/// transforms points by the projection matrix with the perspective divide
+			static void project(Vector3f *dest, const Matrix4x4f &m, const Vector3f *src, uint32_t size, uint32_t dest_stride = sizeof(Vector3f), uint32_t src_stride = sizeof(Vector3f)) {
+				const Rows rows(m);
+				float32x8_t x, y, z;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(x, y, z, (const uint8_t*)src + (size_t)src_stride * i, src_stride, num);
+					float32x8_t iw = float32x8_t(1.0f) / (rows.m30 * x + rows.m31 * y + rows.m32 * z + rows.m33);
+					float32x8_t rx = (rows.m00 * x + rows.m01 * y + rows.m02 * z + rows.m03) * iw;
+					float32x8_t ry = (rows.m10 * x + rows.m11 * y + rows.m12 * z + rows.m13) * iw;
+					float32x8_t rz = (rows.m20 * x + rows.m21 * y + rows.m22 * z + rows.m23) * iw;
+					store((uint8_t*)dest + (size_t)dest_stride * i, dest_stride, rx, ry, rz, num);
+				}
+			}
+			
+			/// transforms bound boxes by the affine matrix
+			/// the result is the bound box of the transformed box, invalid boxes are copied unchanged
+			static void bounds(BoundBoxf *dest, const Matrix4x4f &m, const BoundBoxf *src, uint32_t size, uint32_t dest_stride = sizeof(BoundBoxf), uint32_t src_stride = sizeof(BoundBoxf)) {
+				TS_STATIC_ASSERT(sizeof(BoundBoxf) == sizeof(Vector3f) * 2);
+				const Rows rows(m);
+				const Rows abs_rows(m, true);
+				float32x8_t min_x, min_y, min_z;
+				float32x8_t max_x, max_y, max_z;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					const uint8_t *s = (const uint8_t*)src + (size_t)src_stride * i;
+					load(min_x, min_y, min_z, s, src_stride, num);
+					load(max_x, max_y, max_z, s + sizeof(Vector3f), src_stride, num);
+					float32x8_t cx = (max_x + min_x) * 0.5f;
+					float32x8_t cy = (max_y + min_y) * 0.5f;
+					float32x8_t cz = (max_z + min_z) * 0.5f;
+					float32x8_t ex = (max_x - min_x) * 0.5f;
+					float32x8_t ey = (max_y - min_y) * 0.5f;
+					float32x8_t ez = (max_z - min_z) * 0.5f;
+					float32x8_t x = rows.m00 * cx + rows.m01 * cy + rows.m02 * cz + rows.m03;
+					float32x8_t y = rows.m10 * cx + rows.m11 * cy + rows.m12 * cz + rows.m13;
+					float32x8_t z = rows.m20 * cx + rows.m21 * cy + rows.m22 * cz + rows.m23;
+					float32x8_t rx = abs_rows.m00 * ex + abs_rows.m01 * ey + abs_rows.m02 * ez;
+					float32x8_t ry = abs_rows.m10 * ex + abs_rows.m11 * ey + abs_rows.m12 * ez;
+					float32x8_t rz = abs_rows.m20 * ex + abs_rows.m21 * ey + abs_rows.m22 * ez;
+					float32x8_t invalid = min(ex, min(ey, ez));
+					uint8_t *d = (uint8_t*)dest + (size_t)dest_stride * i;
+					store(d, dest_stride, select(x - rx, min_x, invalid), select(y - ry, min_y, invalid), select(z - rz, min_z, invalid), num);
+					store(d + sizeof(Vector3f), dest_stride, select(x + rx, max_x, invalid), select(y + ry, max_y, invalid), select(z + rz, max_z, invalid), num);
+				}
+			}
+			
+		private:
+			
+			/// broadcasted matrix components
+			struct Rows {
+				explicit Rows(const Matrix4x4f &m, bool absolute = false) :
+					m00(get(m.m00, absolute)), m01(get(m.m01, absolute)), m02(get(m.m02, absolute)), m03(get(m.m03, absolute)),
+					m10(get(m.m10, absolute)), m11(get(m.m11, absolute)), m12(get(m.m12, absolute)), m13(get(m.m13, absolute)),
+					m20(get(m.m20, absolute)), m21(get(m.m21, absolute)), m22(get(m.m22, absolute)), m23(get(m.m23, absolute)),
+					m30(get(m.m30, absolute)), m31(get(m.m31, absolute)), m32(get(m.m32, absolute)), m33(get(m.m33, absolute)) { }
+				static float32x8_t get(float32_t value, bool absolute) {
+					return float32x8_t(absolute ? Tellusim::abs(value) : value);
+				}
+				float32x8_t m00, m01, m02, m03;
+				float32x8_t m10, m11, m12, m13;
+				float32x8_t m20, m21, m22, m23;
+				float32x8_t m30, m31, m32, m33;
+			};
+			
+			/// AoS to SoA conversion of the num elements, the remaining lanes are zero
+			template <uint32_t Size> static TS_INLINE void load(float32_t (&dest)[Size][8], const uint8_t *src, uint32_t stride, uint32_t num) {
+				for(uint32_t i = 0; i < num; i++) {
+					const float32_t *s = (const float32_t*)(src + (size_t)stride * i);
+					for(uint32_t j = 0; j < Size; j++) dest[j][i] = s[j];
+				}
+				for(uint32_t i = num; i < 8; i++) {
+					for(uint32_t j = 0; j < Size; j++) dest[j][i] = 0.0f;
+				}
+			}
+			
+			/// SoA to AoS conversion of the num elements
+			template <uint32_t Size> static TS_INLINE void store(uint8_t *dest, uint32_t stride, const float32_t (&src)[Size][8], uint32_t num) {
+				for(uint32_t i = 0; i < num; i++) {
+					float32_t *d = (float32_t*)(dest + (size_t)stride * i);
+					for(uint32_t j = 0; j < Size; j++) d[j] = src[j][i];
+				}
+			}
+			
+			/// three component elements
+			static TS_INLINE void load(float32x8_t &x, float32x8_t &y, float32x8_t &z, const uint8_t *src, uint32_t stride, uint32_t num) {
+				#if TS_AVX
+					if(num == 8 && stride == sizeof(float32_t) * 3) {
+						const float32_t *s = (const float32_t*)src;
+						__m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 0)), _mm_loadu_ps(s + 12), 1);
+						__m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 4)), _mm_loadu_ps(s + 16), 1);
+						__m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 8)), _mm_loadu_ps(s + 20), 1);
+						__m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+						__m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+						x = float32x8_t(_mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0)));
+						y = float32x8_t(_mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+						z = float32x8_t(_mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1)));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[3][8];
+				load(data, src, stride, num);
+				x = float32x8_t(data[0]);
+				y = float32x8_t(data[1]);
+				z = float32x8_t(data[2]);
+			}
+			
+			static TS_INLINE void store(uint8_t *dest, uint32_t stride, const float32x8_t &x, const float32x8_t &y, const float32x8_t &z, uint32_t num) {
+				#if TS_AVX
+					if(num == 8 && stride == sizeof(float32_t) * 3) {
+						float32_t *d = (float32_t*)dest;
+						__m256 xy = _mm256_shuffle_ps(x.vec, y.vec, _MM_SHUFFLE(2, 0, 2, 0));
+						__m256 yz = _mm256_shuffle_ps(y.vec, z.vec, _MM_SHUFFLE(3, 1, 3, 1));
+						__m256 zx = _mm256_shuffle_ps(z.vec, x.vec, _MM_SHUFFLE(3, 1, 2, 0));
+						__m256 m03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+						__m256 m14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+						__m256 m25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+						_mm_storeu_ps(d + 0, _mm256_castps256_ps128(m03));
+						_mm_storeu_ps(d + 4, _mm256_castps256_ps128(m14));
+						_mm_storeu_ps(d + 8, _mm256_castps256_ps128(m25));
+						_mm_storeu_ps(d + 12, _mm256_extractf128_ps(m03, 1));
+						_mm_storeu_ps(d + 16, _mm256_extractf128_ps(m14, 1));
+						_mm_storeu_ps(d + 20, _mm256_extractf128_ps(m25, 1));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[3][8];
+				x.get(data[0]);
+				y.get(data[1]);
+				z.get(data[2]);
+				store(dest, stride, data, num);
+			}
+			
+			/// four component elements
+			static TS_INLINE void load(float32x8_t &x, float32x8_t &y, float32x8_t &z, float32x8_t &w, const uint8_t *src, uint32_t stride, uint32_t num) {
+				#if TS_AVX
+					if(num == 8 && stride == sizeof(float32_t) * 4) {
+						const float32_t *s = (const float32_t*)src;
+						__m256 m04 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 0)), _mm_loadu_ps(s + 16), 1);
+						__m256 m15 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 4)), _mm_loadu_ps(s + 20), 1);
+						__m256 m26 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 8)), _mm_loadu_ps(s + 24), 1);
+						__m256 m37 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 12)), _mm_loadu_ps(s + 28), 1);
+						__m256 xy01 = _mm256_unpacklo_ps(m04, m15);
+						__m256 zw01 = _mm256_unpackhi_ps(m04, m15);
+						__m256 xy23 = _mm256_unpacklo_ps(m26, m37);
+						__m256 zw23 = _mm256_unpackhi_ps(m26, m37);
+						x = float32x8_t(_mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0)));
+						y = float32x8_t(_mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2)));
+						z = float32x8_t(_mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0)));
+						w = float32x8_t(_mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(3, 2, 3, 2)));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[4][8];
+				load(data, src, stride, num);
+				x = float32x8_t(data[0]);
+				y = float32x8_t(data[1]);
+				z = float32x8_t(data[2]);
+				w = float32x8_t(data[3]);
+			}
+			
+			static TS_INLINE void store(uint8_t *dest, uint32_t stride, const float32x8_t &x, const float32x8_t &y, const float32x8_t &z, const float32x8_t &w, uint32_t num) {
+				#if TS_AVX
+					if(num == 8 && stride == sizeof(float32_t) * 4) {
+						float32_t *d = (float32_t*)dest;
+						__m256 xy01 = _mm256_unpacklo_ps(x.vec, y.vec);
+						__m256 xy23 = _mm256_unpackhi_ps(x.vec, y.vec);
+						__m256 zw01 = _mm256_unpacklo_ps(z.vec, w.vec);
+						__m256 zw23 = _mm256_unpackhi_ps(z.vec, w.vec);
+						__m256 m04 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+						__m256 m15 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+						__m256 m26 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+						__m256 m37 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+						_mm_storeu_ps(d + 0, _mm256_castps256_ps128(m04));
+						_mm_storeu_ps(d + 4, _mm256_castps256_ps128(m15));
+						_mm_storeu_ps(d + 8, _mm256_castps256_ps128(m26));
+						_mm_storeu_ps(d + 12, _mm256_castps256_ps128(m37));
+						_mm_storeu_ps(d + 16, _mm256_extractf128_ps(m04, 1));
+						_mm_storeu_ps(d + 20, _mm256_extractf128_ps(m15, 1));
+						_mm_storeu_ps(d + 24, _mm256_extractf128_ps(m26, 1));
+						_mm_storeu_ps(d + 28, _mm256_extractf128_ps(m37, 1));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[4][8];
+				x.get(data[0]);
+				y.get(data[1]);
+				z.get(data[2]);
+				w.get(data[3]);
+				store(dest, stride, data, num);
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_TRANSFORM_H__ */
@@ -21,9 +21,18 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
 #include <math/TellusimMatrix.h>
+#include <math/TellusimRandom.h>
 #include <math/TellusimNumerical.h>
 
+#include "main_dense.h"
+#include "main_batch.h"
+#include "main_sparse.h"
+#include "main_matrix.h"
+#include "main_kabsch.h"
+
 /*
  */
 using namespace Tellusim;
@@ -59,6 +68,121 @@ template <class Type, uint32_t N, uint32_t M> void printNxM(const char *str, con
 	}
 }
 
+/*
+ */
+template <uint32_t N> bool check_batch(Random<> &random, uint32_t size) {
+	
+	using Tellusim::abs;
+	
+	using VectorN = Tellusim::VectorN<float32_t, N>;
+	using MatrixNxN = Tellusim::MatrixNxM<float32_t, N, N>;
+	
+	Array<MatrixNxN> m(size), s(size), u(size), v(size);
+	Array<VectorN> b(size), x(size), w(size);
+	for(uint32_t i = 0; i < size; i++) {
+		for(uint32_t j = 0; j < MatrixNxN::Size; j++) m[i].m[j] = random.getf32(-1.0f, 1.0f);
+		for(uint32_t j = 0; j < N; j++) b[i][j] = random.getf32(-1.0f, 1.0f);
+		s[i] = m[i] + transpose(m[i]);
+	}
+	
+	// linear systems
+	uint64_t begin = Time::current();
+	if(!BatchLU::solve(m.get(), b.get(), x.get(), size)) return false;
+	float32_t time = (Time::current() - begin) / 1e3f;
+	float32_t error = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		VectorN r = m[i] * x[i] - b[i];
+		float32_t scale = 1.0f;
+		for(uint32_t j = 0; j < N; j++) scale = max(scale, abs(x[i][j]));
+		for(uint32_t j = 0; j < N; j++) error = max(error, abs(r[j]) / scale);
+	}
+	TS_LOGF(Message, " LU %ux%u: %g %.2f ms\n", N, N, error, time);
+	if(error > 1e-4f) return false;
+	
+	// singular value decomposition
+	begin = Time::current();
+	BatchSVD::decompose(m.get(), u.get(), w.get(), v.get(), size);
+	time = (Time::current() - begin) / 1e3f;
+	error = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		MatrixNxN r = m[i] - u[i] * diagonal(w[i]) * transpose(v[i]);
+		for(uint32_t j = 0; j < MatrixNxN::Size; j++) error = max(error, abs(r.m[j]));
+	}
+	TS_LOGF(Message, " SVD %ux%u: %g %.2f ms\n", N, N, error, time);
+	if(error > 1e-4f) return false;
+	
+	// symmetric eigen decomposition
+	begin = Time::current();
+	jacobi(s.get(), u.get(), v.get(), size);
+	time = (Time::current() - begin) / 1e3f;
+	error = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		MatrixNxN r = s[i] - v[i] * u[i] * transpose(v[i]);
+		for(uint32_t j = 0; j < MatrixNxN::Size; j++) error = max(error, abs(r.m[j]));
+	}
+	TS_LOGF(Message, " Jacobi %ux%u: %g %.2f ms\n", N, N, error, time);
+	if(error > 1e-4f) return false;
+	
+	return true;
+}
+
+/*
+ */
+template <class Type> void create_laplacian(SparseMatrix<Type> &m, uint32_t width, uint32_t height) {
+	Array<SparseTriplet<Type>> triplets;
+	triplets.reserve(width * height * 5);
+	for(uint32_t y = 0; y < height; y++) {
+		for(uint32_t x = 0; x < width; x++) {
+			uint32_t i = width * y + x;
+			triplets.append({ i, i, Type(4) });
+			if(x > 0) triplets.append({ i, i - 1, Type(-1) });
+			if(x + 1 < width) triplets.append({ i, i + 1, Type(-1) });
+			if(y > 0) triplets.append({ i, i - width, Type(-1) });
+			if(y + 1 < height) triplets.append({ i, i + width, Type(-1) });
+		}
+	}
+	m.create(width * height, width * height, triplets);
+}
+
+template <class Matrix, class Type> float64_t get_residual(const Matrix &m, const DenseVector<Type> &b, const DenseVector<Type> &x) {
+	DenseVector<Type> r = m * x;
+	for(uint32_t i = 0; i < r.getSize(); i++) r[i] -= b[i];
+	return length(r) / length(b);
+}
+
+/*
+ */
+template <class Type, uint32_t N, uint32_t M, uint32_t K> bool check_simd(Random<> &random) {
+	
+	using Tellusim::abs;
+	
+	MatrixNxM<Type, K, M> m0, m2;
+	MatrixNxM<Type, N, K> m1;
+	VectorN<Type, K> v0;
+	VectorN<Type, M> v1;
+	for(uint32_t i = 0; i < MatrixNxM<Type, K, M>::Size; i++) m0.m[i] = random.getf32(-1.0f, 1.0f);
+	for(uint32_t i = 0; i < MatrixNxM<Type, K, M>::Size; i++) m2.m[i] = random.getf32(-1.0f, 1.0f);
+	for(uint32_t i = 0; i < MatrixNxM<Type, N, K>::Size; i++) m1.m[i] = random.getf32(-1.0f, 1.0f);
+	for(uint32_t i = 0; i < K; i++) v0.v[i] = random.getf32(-1.0f, 1.0f);
+	for(uint32_t i = 0; i < M; i++) v1.v[i] = random.getf32(-1.0f, 1.0f);
+	
+	Type error = 0;
+	MatrixNxM<Type, N, M> r0 = MatrixSimd::mul(m0, m1) - m0 * m1;
+	for(uint32_t i = 0; i < MatrixNxM<Type, N, M>::Size; i++) error = max(error, abs(r0.m[i]));
+	MatrixNxM<Type, K, M> r1 = MatrixSimd::add(m0, m2) - (m0 + m2);
+	for(uint32_t i = 0; i < MatrixNxM<Type, K, M>::Size; i++) error = max(error, abs(r1.m[i]));
+	MatrixNxM<Type, M, K> r2 = MatrixSimd::transpose(m0) - transpose(m0);
+	for(uint32_t i = 0; i < MatrixNxM<Type, M, K>::Size; i++) error = max(error, abs(r2.m[i]));
+	VectorN<Type, M> r3 = MatrixSimd::mul(m0, v0) - m0 * v0;
+	for(uint32_t i = 0; i < M; i++) error = max(error, abs(r3.v[i]));
+	VectorN<Type, K> r4 = MatrixSimd::mul(v1, m0) - v1 * m0;
+	for(uint32_t i = 0; i < K; i++) error = max(error, abs(r4.v[i]));
+	
+	TS_LOGF(Message, " %s %ux%u %ux%u: %g\n", (sizeof(Type) == 4) ? "f32" : "f64", K, M, N, K, (float64_t)error);
+	
+	return (error < Type(1e-5));
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -357,5 +481,361 @@ int32_t main(int32_t argc, char **argv) {
 		}
 	}
 	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "Dense:\n");
+		
+		ThreadPool pool;
+		Random<> random(1);
+		
+		// matrix multiplication
+		if(1) {
+			
+			constexpr uint32_t rows = 301;
+			constexpr uint32_t columns = 263;
+			constexpr uint32_t size = 257;
+			
+			DenseMatrix<float32_t> m0(rows, size), m1(size, columns), m2;
+			for(uint32_t y = 0; y < rows; y++) {
+				for(uint32_t x = 0; x < size; x++) m0[y][x] = random.getf32(-1.0f, 1.0f);
+			}
+			for(uint32_t y = 0; y < size; y++) {
+				for(uint32_t x = 0; x < columns; x++) m1[y][x] = random.getf32(-1.0f, 1.0f);
+			}
+			mul(m2, m0, m1, &pool);
+			
+			float64_t error = 0.0;
+			for(uint32_t y = 0; y < rows; y++) {
+				for(uint32_t x = 0; x < columns; x++) {
+					float64_t value = 0.0;
+					for(uint32_t i = 0; i < size; i++) value += (float64_t)m0[y][i] * m1[i][x];
+					error = max(error, abs(value - m2[y][x]));
+				}
+			}
+			TS_LOGF(Message, " GEMM %ux%ux%u: %g\n", rows, columns, size, error);
+			if(error > 1e-3) return 1;
+		}
+		
+		// linear system
+		if(1) {
+			
+			constexpr uint32_t size = 500;
+			
+			DenseMatrix<float64_t> m(size, size);
+			DenseVector<float64_t> b(size);
+			for(uint32_t y = 0; y < size; y++) {
+				for(uint32_t x = 0; x < size; x++) m[y][x] = random.getf32(-1.0f, 1.0f);
+				b[y] = random.getf32(-1.0f, 1.0f);
+			}
+			
+			DenseMatrix<float64_t> lu;
+			Array<uint32_t> indices;
+			if(!DenseLU::decompose(m, lu, indices, &pool)) return 1;
+			
+			DenseVector<float64_t> x = DenseLU::solve(lu, indices, b);
+			DenseVector<float64_t> r = m * x;
+			float64_t error = 0.0;
+			for(uint32_t i = 0; i < size; i++) error = max(error, abs(r[i] - b[i]));
+			TS_LOGF(Message, " LU solve %u: %g\n", size, error);
+			if(error > 1e-8) return 1;
+			
+			DenseMatrix<float64_t> m1 = DenseLU::inverse(lu, indices, &pool);
+			DenseMatrix<float64_t> m2;
+			mul(m2, m, m1, &pool);
+			error = 0.0;
+			for(uint32_t y = 0; y < size; y++) {
+				for(uint32_t x = 0; x < size; x++) error = max(error, abs(m2[y][x] - ((x == y) ? 1.0 : 0.0)));
+			}
+			TS_LOGF(Message, " LU inverse %u: %g\n", size, error);
+			if(error > 1e-8) return 1;
+		}
+		
+		// least squares
+		if(1) {
+			
+			constexpr uint32_t rows = 400;
+			constexpr uint32_t columns = 300;
+			
+			DenseMatrix<float64_t> m(rows, columns);
+			DenseVector<float64_t> b(rows);
+			for(uint32_t y = 0; y < rows; y++) {
+				for(uint32_t x = 0; x < columns; x++) m[y][x] = random.getf32(-1.0f, 1.0f);
+				b[y] = random.getf32(-1.0f, 1.0f);
+			}
+			
+			DenseVector<float64_t> c, d;
+			DenseMatrix<float64_t> qr;
+			if(!DenseQR::decompose(m, qr, c, d, &pool)) return 1;
+			
+			// the residual is orthogonal to the columns
+			DenseVector<float64_t> x = DenseQR::solve(qr, c, d, b);
+			DenseVector<float64_t> r = m * x;
+			for(uint32_t i = 0; i < rows; i++) r[i] -= b[i];
+			DenseVector<float64_t> g = transpose(m) * r;
+			float64_t error = 0.0;
+			for(uint32_t i = 0; i < columns; i++) error = max(error, abs(g[i]));
+			TS_LOGF(Message, " QR solve %ux%u: %g\n", rows, columns, error);
+			if(error > 1e-8) return 1;
+		}
+		
+		// performance
+		if(1) {
+			
+			constexpr uint32_t size = 1024;
+			
+			DenseMatrix<float32_t> m0(size, size), m1(size, size), m2;
+			for(uint32_t y = 0; y < size; y++) {
+				for(uint32_t x = 0; x < size; x++) {
+					m0[y][x] = random.getf32(-1.0f, 1.0f);
+					m1[y][x] = random.getf32(-1.0f, 1.0f);
+				}
+			}
+			
+			float64_t flops = 2.0 * size * size * size;
+			for(uint32_t i = 0; i < 2; i++) {
+				ThreadPool *threads = (i) ? &pool : nullptr;
+				uint64_t begin = Time::current();
+				mul(m2, m0, m1, threads);
+				float64_t time = (Time::current() - begin) / 1e6;
+				TS_LOGF(Message, " GEMM %u %u threads: %.1f ms %.2f GFLOP/s\n", size, (i) ? pool.getNumThreads() : 1u, time * 1e3, flops / time * 1e-9);
+			}
+			
+			DenseMatrix<float32_t> lu;
+			Array<uint32_t> indices;
+			uint64_t begin = Time::current();
+			if(!DenseLU::decompose(m0, lu, indices, &pool)) return 1;
+			float64_t time = (Time::current() - begin) / 1e6;
+			TS_LOGF(Message, " LU %u: %.1f ms %.2f GFLOP/s\n", size, time * 1e3, flops / 3.0 / time * 1e-9);
+		}
+	}
+	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "Batch:\n");
+		
+		Random<> random(1);
+		if(!check_batch<3>(random, 10003)) return 1;
+		if(!check_batch<4>(random, 10003)) return 1;
+	}
+	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "Sparse:\n");
+		
+		ThreadPool pool;
+		Random<> random(1);
+		
+		// convergence
+		if(1) {
+			
+			constexpr uint32_t size = 256;
+			
+			SparseMatrix<float64_t> m;
+			create_laplacian(m, size, size);
+			
+			DenseVector<float64_t> b(m.getRows());
+			for(uint32_t i = 0; i < b.getSize(); i++) b[i] = random.getf32(-1.0f, 1.0f);
+			
+			SparseIdentity<float64_t> identity;
+			SparseJacobi<float64_t> jacobi;
+			SparseCholesky<float64_t> cholesky;
+			if(!jacobi.create(m) || !cholesky.create(m)) return 1;
+			
+			auto check = [&](const char *name, const SparseSolver::Result &result, const DenseVector<float64_t> &x, uint64_t begin) {
+				float64_t time = (Time::current() - begin) / 1e3;
+				float64_t residual = get_residual(m, b, x);
+				TS_LOGF(Message, " %-16s %ux%u: %4u iterations %.2e residual %.1f ms\n", name, size, size, result.iterations, residual, time);
+				return (result.converged && residual < 1e-7);
+			};
+			
+			DenseVector<float64_t> x;
+			uint64_t begin = Time::current();
+			SparseSolver::Result result = SparseSolver::cg(m, identity, b, x, 10000, 1e-8, &pool);
+			if(!check("CG", result, x, begin)) return 1;
+			
+			x.clear();
+			begin = Time::current();
+			result = SparseSolver::cg(m, jacobi, b, x, 10000, 1e-8, &pool);
+			if(!check("CG Jacobi", result, x, begin)) return 1;
+			
+			x.clear();
+			begin = Time::current();
+			result = SparseSolver::cg(m, cholesky, b, x, 10000, 1e-8, &pool);
+			if(!check("CG IC", result, x, begin)) return 1;
+			
+			x.clear();
+			begin = Time::current();
+			result = SparseSolver::bicgstab(m, jacobi, b, x, 10000, 1e-8, &pool);
+			if(!check("BiCGSTAB Jacobi", result, x, begin)) return 1;
+			
+			x.clear();
+			begin = Time::current();
+			result = SparseSolver::bicgstab(m, cholesky, b, x, 10000, 1e-8, &pool);
+			if(!check("BiCGSTAB IC", result, x, begin)) return 1;
+		}
+		
+		// throughput
+		if(1) {
+			
+			constexpr uint32_t size = 1024;
+			constexpr uint32_t repeats = 16;
+			
+			SparseMatrix<float32_t> m;
+			create_laplacian(m, size, size);
+			SparseBlockMatrix<float32_t, 4> bm(m);
+			
+			DenseVector<float32_t> v(m.getRows()), r0, r1;
+			for(uint32_t i = 0; i < v.getSize(); i++) v[i] = random.getf32(-1.0f, 1.0f);
+			
+			float64_t flops = 2.0 * m.getNumValues();
+			float64_t bytes = (sizeof(float32_t) + sizeof(uint32_t)) * (float64_t)m.getNumValues() + sizeof(float32_t) * 2.0 * m.getRows();
+			for(uint32_t i = 0; i < 2; i++) {
+				ThreadPool *threads = (i) ? &pool : nullptr;
+				uint32_t num_threads = (i) ? pool.getNumThreads() : 1;
+				
+				uint64_t begin = Time::current();
+				for(uint32_t j = 0; j < repeats; j++) mul(r0, m, v, threads);
+				float64_t time = (Time::current() - begin) / 1e6 / repeats;
+				TS_LOGF(Message, " CSR SpMV %u %u threads: %.2f ms %.2f GFLOP/s %.2f GB/s\n", m.getRows(), num_threads, time * 1e3, flops / time * 1e-9, bytes / time * 1e-9);
+				
+				begin = Time::current();
+				for(uint32_t j = 0; j < repeats; j++) mul(r1, bm, v, threads);
+				time = (Time::current() - begin) / 1e6 / repeats;
+				TS_LOGF(Message, " BSR SpMV %u %u threads: %.2f ms %.2f GFLOP/s\n", m.getRows(), num_threads, time * 1e3, flops / time * 1e-9);
+			}
+			
+			for(uint32_t i = 0; i < r0.getSize(); i++) {
+				if(abs(r0[i] - r1[i]) > 1e-5f) return 1;
+			}
+		}
+	}
+	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "SIMD:\n");
+		
+		Random<> random(1);
+		if(!check_simd<float32_t, 3, 3, 3>(random)) return 1;
+		if(!check_simd<float32_t, 4, 4, 4>(random)) return 1;
+		if(!check_simd<float32_t, 5, 7, 3>(random)) return 1;
+		if(!check_simd<float32_t, 8, 8, 8>(random)) return 1;
+		if(!check_simd<float64_t, 2, 3, 2>(random)) return 1;
+		if(!check_simd<float64_t, 4, 4, 4>(random)) return 1;
+		if(!check_simd<float64_t, 7, 5, 6>(random)) return 1;
+		if(!check_simd<float64_t, 8, 8, 8>(random)) return 1;
+	}
+	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "Kabsch:\n");
+		
+		constexpr uint32_t num_pairs = 4096;
+		
+		ThreadPool pool;
+		Random<> random(1);
+		
+		// point set pairs with known transformations
+		Array<uint32_t> offsets(num_pairs + 1);
+		Array<Matrix4x4f> transforms(num_pairs);
+		Array<Vector3f> src, dest;
+		offsets[0] = 0;
+		for(uint32_t i = 0; i < num_pairs; i++) {
+			uint32_t size = 3 + random.geti32(0, 125);
+			Matrix4x4f transform = Matrix4x4f::translate(random.getf32(-100.0f, 100.0f), random.getf32(-100.0f, 100.0f), random.getf32(-100.0f, 100.0f));
+			transform *= Matrix4x4f::rotateX(random.getf32(-180.0f, 180.0f)) * Matrix4x4f::rotateY(random.getf32(-180.0f, 180.0f));
+			transform *= Matrix4x4f::rotateZ(random.getf32(-180.0f, 180.0f)) * Matrix4x4f::scale(random.getf32(0.5f, 2.0f));
+			for(uint32_t j = 0; j < size; j++) {
+				Vector3f point = Vector3f(random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f));
+				// planar and collinear sets
+				if(i % 7 == 1) point.z = 0.0f;
+				if(i % 7 == 2) point = Vector3f(point.x, point.x * 2.0f, 0.0f);
+				src.append(point + Vector3f(10.0f));
+				dest.append(transform * (point + Vector3f(10.0f)));
+			}
+			transforms[i] = transform;
+			offsets[i + 1] = src.size();
+		}
+		
+		Array<Kabsch::Result> results(num_pairs);
+		for(uint32_t i = 0; i < 2; i++) {
+			uint64_t begin = Time::current();
+			Kabsch::fit(results.get(), src.get(), dest.get(), offsets.get(), num_pairs, true, (i) ? &pool : nullptr);
+			float32_t time = (Time::current() - begin) / 1e3f;
+			TS_LOGF(Message, " %u pairs %u points %u threads: %.2f ms\n", num_pairs, src.size(), (i) ? pool.getNumThreads() : 1u, time);
+		}
+		
+		float32_t error = 0.0f;
+		for(uint32_t i = 0; i < num_pairs; i++) {
+			const Matrix4x4f &transform = results[i].transform;
+			for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+				error = max(error, length(transform * src[j] - dest[j]));
+			}
+			// collinear sets are not determined around their axis
+			if(i % 7 == 2) continue;
+			for(uint32_t j = 0; j < 12; j++) {
+				error = max(error, abs(transform.m[j] - transforms[i].m[j]) / max(abs(transforms[i].m[j]), 1.0f));
+			}
+		}
+		TS_LOGF(Message, " error: %g\n", error);
+		if(error > 1e-3f) return 1;
+		
+		// reflected points are fitted by the proper rotation
+		Vector3f points[4] = { Vector3f(1.0f, 0.0f, 0.0f), Vector3f(0.0f, 1.0f, 0.0f), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 0.0f, 0.0f) };
+		Vector3f mirror[4];
+		for(uint32_t i = 0; i < 4; i++) mirror[i] = Vector3f(points[i].x, points[i].y, -points[i].z);
+		Kabsch::Result result = Kabsch::fit(points, mirror, 4, false);
+		const Matrix4x4f &m = result.transform;
+		float32_t det = m.m00 * (m.m11 * m.m22 - m.m12 * m.m21) - m.m01 * (m.m10 * m.m22 - m.m12 * m.m20) + m.m02 * (m.m10 * m.m21 - m.m11 * m.m20);
+		TS_LOGF(Message, " reflection: %g %g\n", det, result.error);
+		if(abs(det - 1.0f) > 1e-5f) return 1;
+	}
+	
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		TS_LOG(Message, "Mixed precision:\n");
+		
+		constexpr uint32_t size = 1024;
+		
+		ThreadPool pool;
+		Random<> random(1);
+		
+		DenseMatrix<float64_t> m(size, size);
+		DenseVector<float64_t> b(size);
+		for(uint32_t y = 0; y < size; y++) {
+			for(uint32_t x = 0; x < size; x++) m[y][x] = random.getf32(-1.0f, 1.0f);
+			b[y] = random.getf32(-1.0f, 1.0f);
+		}
+		
+		// double precision reference
+		DenseMatrix<float64_t> lu;
+		Array<uint32_t> indices;
+		uint64_t begin = Time::current();
+		if(!DenseLU::decompose(m, lu, indices, &pool)) return 1;
+		DenseVector<float64_t> x0 = DenseLU::solve(lu, indices, b);
+		float32_t time = (Time::current() - begin) / 1e3f;
+		TS_LOGF(Message, " f64 LU %u: %.1f ms\n", size, time);
+		
+		// single precision factorization with refinement
+		DenseMixedLU solver;
+		DenseVector<float64_t> x1;
+		begin = Time::current();
+		if(!solver.create(m, &pool)) return 1;
+		DenseMixedLU::Result result = solver.solve(b, x1);
+		time = (Time::current() - begin) / 1e3f;
+		TS_LOGF(Message, " f32 LU %u: %.1f ms %u iterations %.2e residual\n", size, time, result.iterations, result.residual);
+		if(!result.converged) return 1;
+		
+		float64_t error = 0.0;
+		for(uint32_t i = 0; i < size; i++) error = max(error, abs(x0[i] - x1[i]) / max(abs(x0[i]), 1.0));
+		TS_LOGF(Message, " difference: %g\n", error);
+		if(error > 1e-10) return 1;
+	}
+	
 	return 0;
 }
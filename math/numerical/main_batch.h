@@ -0,0 +1,324 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_BATCH_H__
+#define __TELLUSIM_TESTS_NUMERICAL_BATCH_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimNumerical.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <uint32_t N> struct BatchVector {
+		
+		enum {
+			Lanes = 8,
+		};
+		
+		/// loads up to eight vectors, unused lanes are zero
+		void load(const VectorN<float32_t, N> *src, uint32_t num) {
+			TS_ALIGNAS32 float32_t data[N][Lanes] = {};
+			for(uint32_t l = 0; l < num; l++) {
+				for(uint32_t i = 0; i < N; i++) data[i][l] = src[l][i];
+			}
+			for(uint32_t i = 0; i < N; i++) v[i] = float32x8_t(data[i]);
+		}
+		
+		/// stores up to eight vectors
+		void store(VectorN<float32_t, N> *dest, uint32_t num) const {
+			TS_ALIGNAS32 float32_t data[N][Lanes];
+			for(uint32_t i = 0; i < N; i++) v[i].get(data[i]);
+			for(uint32_t l = 0; l < num; l++) {
+				for(uint32_t i = 0; i < N; i++) dest[l][i] = data[i][l];
+			}
+		}
+		
+		float32x8_t v[N];
+	};
+	
+	/*
+	 */
+	template <uint32_t N> struct BatchMatrix {
+		
+		enum {
+			Lanes = 8,
+			Size = N * N,
+		};
+		
+		/// loads up to eight matrices, unused lanes are identity
+		void load(const MatrixNxM<float32_t, N, N> *src, uint32_t num) {
+			TS_ALIGNAS32 float32_t data[Size][Lanes];
+			for(uint32_t l = 0; l < Lanes; l++) {
+				if(l < num) {
+					for(uint32_t i = 0; i < Size; i++) data[i][l] = src[l].m[i];
+				} else {
+					for(uint32_t i = 0; i < Size; i++) data[i][l] = (i % (N + 1) == 0) ? 1.0f : 0.0f;
+				}
+			}
+			for(uint32_t i = 0; i < Size; i++) m[i] = float32x8_t(data[i]);
+		}
+		
+		/// stores up to eight matrices
+		void store(MatrixNxM<float32_t, N, N> *dest, uint32_t num) const {
+			TS_ALIGNAS32 float32_t data[Size][Lanes];
+			for(uint32_t i = 0; i < Size; i++) m[i].get(data[i]);
+			for(uint32_t l = 0; l < num; l++) {
+				for(uint32_t i = 0; i < Size; i++) dest[l].m[i] = data[i][l];
+			}
+		}
+		
+		/// row-major element access
+		TS_INLINE float32x8_t &get(uint32_t row, uint32_t column) { return m[N * row + column]; }
+		TS_INLINE const float32x8_t &get(uint32_t row, uint32_t column) const { return m[N * row + column]; }
+		
+		void setIdentity() {
+			for(uint32_t i = 0; i < Size; i++) m[i] = float32x8_t((i % (N + 1) == 0) ? 1.0f : 0.0f);
+		}
+		
+		float32x8_t m[Size];
+	};
+	
+	/*
+	 */
+	class BatchKernel {
+			
+		public:
+			
+			enum {
+				Sweeps = 6,
+			};
+			
+			/// Jacobi rotation annihilating gamma of the [alpha, gamma; gamma, beta] block
+			/// the rotation is identity for the zero gamma lanes
+			static TS_INLINE void rotation(const float32x8_t &alpha, const float32x8_t &beta, const float32x8_t &gamma, float32x8_t &c, float32x8_t &s) {
+				float32x8_t delta = beta - alpha;
+				float32x8_t sign = (float32x8_t(1.0f).asi32x8() | (delta.asi32x8() & int32x8_t(0x80000000))).asf32x8();
+				float32x8_t t = gamma * sign * 2.0f / (abs(delta) + sqrt(delta * delta + gamma * gamma * 4.0f) + float32x8_t(1e-30f));
+				c = float32x8_t(1.0f) / sqrt(t * t + 1.0f);
+				s = c * t;
+			}
+			
+			/// (x, y) = (x * c - y * s, x * s + y * c)
+			static TS_INLINE void rotate(float32x8_t &x, float32x8_t &y, const float32x8_t &c, const float32x8_t &s) {
+				float32x8_t t = x;
+				x = t * c - y * s;
+				y = t * s + y * c;
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * BatchLU
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class BatchLU {
+			
+		public:
+			
+			/// solves eight systems with partial pivoting in place, the solution is stored in b
+			/// returns the bitmask of lanes with non-singular matrices
+			template <uint32_t N> static uint32_t solve(BatchMatrix<N> &a, BatchVector<N> &b) {
+				
+				uint32_t ret = 0xff;
+				
+				for(uint32_t k = 0; k < N; k++) {
+					
+					// lane-wise row swaps with the larger pivot
+					for(uint32_t i = k + 1; i < N; i++) {
+						float32x8_t c = abs(a.get(k, k)) - abs(a.get(i, k));
+						for(uint32_t j = k; j < N; j++) {
+							float32x8_t t = a.get(k, j);
+							a.get(k, j) = select(t, a.get(i, j), c);
+							a.get(i, j) = select(a.get(i, j), t, c);
+						}
+						float32x8_t t = b.v[k];
+						b.v[k] = select(t, b.v[i], c);
+						b.v[i] = select(b.v[i], t, c);
+					}
+					
+					// elimination
+					ret &= (abs(a.get(k, k)) > float32x8_t(0.0f));
+					float32x8_t ipivot = float32x8_t(1.0f) / a.get(k, k);
+					for(uint32_t i = k + 1; i < N; i++) {
+						float32x8_t f = a.get(i, k) * ipivot;
+						for(uint32_t j = k + 1; j < N; j++) a.get(i, j) -= f * a.get(k, j);
+						b.v[i] -= f * b.v[k];
+					}
+				}
+				
+				// back substitution
+				for(uint32_t i = N; i > 0; i--) {
+					uint32_t k = i - 1;
+					float32x8_t v = b.v[k];
+					for(uint32_t j = i; j < N; j++) v -= a.get(k, j) * b.v[j];
+					b.v[k] = v / a.get(k, k);
+				}
+				
+				return ret;
+			}
+			
+			/// solves num systems m[i] * x[i] = b[i]
+			/// returns false if any of the matrices is singular
+			template <uint32_t N> static bool solve(const MatrixNxM<float32_t, N, N> *m, const VectorN<float32_t, N> *b, VectorN<float32_t, N> *x, uint32_t num) {
+				bool ret = true;
+				BatchMatrix<N> a;
+				BatchVector<N> v;
+				for(uint32_t i = 0; i < num; i += 8) {
+					uint32_t size = min(num - i, 8u);
+					a.load(m + i, size);
+					v.load(b + i, size);
+					uint32_t mask = (1u << size) - 1;
+					if((solve(a, v) & mask) != mask) ret = false;
+					v.store(x + i, size);
+				}
+				return ret;
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * BatchSVD
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class BatchSVD {
+			
+		public:
+			
+			/// one-sided Jacobi decomposition of eight matrices m = u * diagonal(w) * transpose(v)
+			/// the matrix is replaced by u, singular values are not sorted
+			template <uint32_t N> static void decompose(BatchMatrix<N> &a, BatchVector<N> &w, BatchMatrix<N> &v) {
+				
+				v.setIdentity();
+				
+				for(uint32_t sweep = 0; sweep < BatchKernel::Sweeps; sweep++) {
+					for(uint32_t p = 0; p < N; p++) {
+						for(uint32_t q = p + 1; q < N; q++) {
+							
+							// column products
+							float32x8_t alpha = float32x8_t(0.0f);
+							float32x8_t beta = float32x8_t(0.0f);
+							float32x8_t gamma = float32x8_t(0.0f);
+							for(uint32_t i = 0; i < N; i++) {
+								const float32x8_t &x = a.get(i, p);
+								const float32x8_t &y = a.get(i, q);
+								alpha += x * x;
+								beta += y * y;
+								gamma += x * y;
+							}
+							
+							// orthogonalize columns
+							float32x8_t c, s;
+							BatchKernel::rotation(alpha, beta, gamma, c, s);
+							for(uint32_t i = 0; i < N; i++) {
+								BatchKernel::rotate(a.get(i, p), a.get(i, q), c, s);
+								BatchKernel::rotate(v.get(i, p), v.get(i, q), c, s);
+							}
+						}
+					}
+				}
+				
+				// singular values and normalized columns
+				for(uint32_t j = 0; j < N; j++) {
+					float32x8_t length = float32x8_t(0.0f);
+					for(uint32_t i = 0; i < N; i++) length += a.get(i, j) * a.get(i, j);
+					w.v[j] = sqrt(length);
+					float32x8_t ilength = float32x8_t(1.0f) / max(w.v[j], float32x8_t(1e-30f));
+					for(uint32_t i = 0; i < N; i++) a.get(i, j) *= ilength;
+				}
+			}
+			
+			/// decomposes num matrices m[i] = u[i] * diagonal(w[i]) * transpose(v[i])
+			template <uint32_t N> static void decompose(const MatrixNxM<float32_t, N, N> *m, MatrixNxM<float32_t, N, N> *u, VectorN<float32_t, N> *w, MatrixNxM<float32_t, N, N> *v, uint32_t num) {
+				BatchMatrix<N> a, b;
+				BatchVector<N> c;
+				for(uint32_t i = 0; i < num; i += 8) {
+					uint32_t size = min(num - i, 8u);
+					a.load(m + i, size);
+					decompose(a, c, b);
+					a.store(u + i, size);
+					c.store(w + i, size);
+					b.store(v + i, size);
+				}
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * Jacobi eigenvalue algorithm
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <uint32_t N> void jacobi(BatchMatrix<N> &a, BatchMatrix<N> &v) {
+		
+		v.setIdentity();
+		
+		for(uint32_t sweep = 0; sweep < BatchKernel::Sweeps; sweep++) {
+			for(uint32_t p = 0; p < N; p++) {
+				for(uint32_t q = p + 1; q < N; q++) {
+					float32x8_t c, s;
+					BatchKernel::rotation(a.get(p, p), a.get(q, q), a.get(p, q), c, s);
+					for(uint32_t i = 0; i < N; i++) {
+						BatchKernel::rotate(a.get(i, p), a.get(i, q), c, s);
+						BatchKernel::rotate(v.get(i, p), v.get(i, q), c, s);
+					}
+					for(uint32_t i = 0; i < N; i++) {
+						BatchKernel::rotate(a.get(p, i), a.get(q, i), c, s);
+					}
+				}
+			}
+		}
+		
+		// clear off-diagonal residuals
+		for(uint32_t y = 0; y < N; y++) {
+			for(uint32_t x = 0; x < N; x++) {
+				if(x != y) a.get(y, x) = float32x8_t(0.0f);
+			}
+		}
+	}
+	
+	/// eigen decomposition of num symmetric matrices m[i] = v[i] * d[i] * transpose(v[i])
+	/// d receives the diagonal matrices of eigenvalues and v the eigenvector columns
+	template <uint32_t N> void jacobi(const MatrixNxM<float32_t, N, N> *m, MatrixNxM<float32_t, N, N> *d, MatrixNxM<float32_t, N, N> *v, uint32_t num) {
+		BatchMatrix<N> a, b;
+		for(uint32_t i = 0; i < num; i += 8) {
+			uint32_t size = min(num - i, 8u);
+			a.load(m + i, size);
+			jacobi(a, b);
+			a.store(d + i, size);
+			b.store(v + i, size);
+		}
+	}
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_BATCH_H__ */
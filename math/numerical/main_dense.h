@@ -0,0 +1,798 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_DENSE_H__
+#define __TELLUSIM_TESTS_NUMERICAL_DENSE_H__
+
+#include <core/TellusimArray.h>
+#include <math/TellusimSimd.h>
+
+#include "main_pool.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <class Type> struct DenseSimd;
+	
+	template <> struct DenseSimd<float32_t> {
+		using Vector = float32x8_t;
+		enum { Size = 8 };
+	};
+	
+	template <> struct DenseSimd<float64_t> {
+		using Vector = float64x4_t;
+		enum { Size = 4 };
+	};
+	
+	/*
+	 */
+	template <class Type> class DenseBuffer {
+			
+		public:
+			
+			enum {
+				Alignment = 64,
+			};
+			
+			DenseBuffer() { }
+			explicit DenseBuffer(size_t size) { allocate(size); }
+			DenseBuffer(const DenseBuffer &buffer) { copy(buffer); }
+			DenseBuffer(DenseBuffer &&buffer) : memory(buffer.memory), data(buffer.data), size(buffer.size) {
+				buffer.memory = nullptr;
+				buffer.data = nullptr;
+				buffer.size = 0;
+			}
+			~DenseBuffer() { release(); }
+			
+			DenseBuffer &operator=(const DenseBuffer &buffer) {
+				if(this != &buffer) copy(buffer);
+				return *this;
+			}
+			DenseBuffer &operator=(DenseBuffer &&buffer) {
+				if(this != &buffer) {
+					release();
+					memory = buffer.memory;
+					data = buffer.data;
+					size = buffer.size;
+					buffer.memory = nullptr;
+					buffer.data = nullptr;
+					buffer.size = 0;
+				}
+				return *this;
+			}
+			
+			/// allocates zero initialized aligned memory
+			void allocate(size_t s) {
+				release();
+				if(s == 0) return;
+				size = s;
+				memory = new uint8_t[sizeof(Type) * size + Alignment];
+				data = (Type*)(((size_t)memory + Alignment - 1) & ~(size_t)(Alignment - 1));
+				memset(data, 0, sizeof(Type) * size);
+			}
+			void release() {
+				delete [] memory;
+				memory = nullptr;
+				data = nullptr;
+				size = 0;
+			}
+			
+			TS_INLINE Type *get() { return data; }
+			TS_INLINE const Type *get() const { return data; }
+			TS_INLINE size_t getSize() const { return size; }
+			
+		private:
+			
+			void copy(const DenseBuffer &buffer) {
+				allocate(buffer.size);
+				if(size) memcpy(data, buffer.data, sizeof(Type) * size);
+			}
+			
+			uint8_t *memory = nullptr;
+			Type *data = nullptr;
+			size_t size = 0;
+	};
+	
+	/*
+	 */
+	template <class Type> class DenseKernel {
+			
+			using Vector = typename DenseSimd<Type>::Vector;
+			
+		public:
+			
+			enum {
+				Size = DenseSimd<Type>::Size,
+			};
+			
+			/// dot product of two arrays
+			static Type dot(const Type *a, const Type *b, uint32_t size) {
+				Type ret = 0;
+				uint32_t i = 0;
+				if(is_aligned(a, b)) {
+					for(; i < size && !is_aligned(a + i); i++) ret += a[i] * b[i];
+					Vector ret_0 = Vector(Type(0));
+					Vector ret_1 = Vector(Type(0));
+					for(; i + Size * 2 <= size; i += Size * 2) {
+						ret_0 += Vector(a + i) * Vector(b + i);
+						ret_1 += Vector(a + i + Size) * Vector(b + i + Size);
+					}
+					ret += (ret_0 + ret_1).sum();
+				}
+				for(; i < size; i++) ret += a[i] * b[i];
+				return ret;
+			}
+			
+			/// dest -= src * s
+			static void sub(Type *dest, const Type *src, Type s, uint32_t size) {
+				uint32_t i = 0;
+				if(is_aligned(dest, src)) {
+					for(; i < size && !is_aligned(dest + i); i++) dest[i] -= src[i] * s;
+					Vector v = Vector(s);
+					for(; i + Size <= size; i += Size) {
+						(Vector(dest + i) - Vector(src + i) * v).get(dest + i);
+					}
+				}
+				for(; i < size; i++) dest[i] -= src[i] * s;
+			}
+			
+			/// dest += src * s
+			static void add(Type *dest, const Type *src, Type s, uint32_t size) {
+				sub(dest, src, -s, size);
+			}
+			
+			/// C = A * B * alpha + (accumulate ? C : 0)
+			/// matrices are row-major with the leading dimensions in elements
+			static void gemm(uint32_t m, uint32_t n, uint32_t k, Type alpha, const Type *a, size_t lda, const Type *b, size_t ldb, Type *c, size_t ldc, bool accumulate, ThreadPool *pool) {
+				
+				if(m == 0 || n == 0) return;
+				if(k == 0) {
+					if(!accumulate) {
+						for(uint32_t i = 0; i < m; i++) memset(c + ldc * i, 0, sizeof(Type) * n);
+					}
+					return;
+				}
+				
+				DenseBuffer<Type> b_pack((size_t)KC * min(udiv(n, (uint32_t)NR) * NR, (uint32_t)NC));
+				
+				for(uint32_t jc = 0; jc < n; jc += NC) {
+					uint32_t nc = min(n - jc, (uint32_t)NC);
+					for(uint32_t pc = 0; pc < k; pc += KC) {
+						uint32_t kc = min(k - pc, (uint32_t)KC);
+						bool first = (!accumulate && pc == 0);
+						
+						// pack B block into the NR wide panels
+						pack_b(b_pack.get(), b + ldb * pc + jc, ldb, kc, nc);
+						
+						// the outer loop over the A row blocks
+						auto function = [&](uint32_t begin, uint32_t end) {
+							DenseBuffer<Type> a_pack((size_t)KC * MC);
+							for(uint32_t block = begin; block < end; block++) {
+								uint32_t ic = block * MC;
+								uint32_t mc = min(m - ic, (uint32_t)MC);
+								pack_a(a_pack.get(), a + lda * ic + pc, lda, kc, mc, alpha);
+								for(uint32_t jr = 0; jr < nc; jr += NR) {
+									uint32_t nr = min(nc - jr, (uint32_t)NR);
+									const Type *b_panel = b_pack.get() + (size_t)kc * jr;
+									for(uint32_t ir = 0; ir < mc; ir += MR) {
+										uint32_t mr = min(mc - ir, (uint32_t)MR);
+										kernel(kc, a_pack.get() + (size_t)kc * ir, b_panel, c + ldc * (ic + ir) + jc + jr, ldc, mr, nr, first);
+									}
+								}
+							}
+						};
+						uint32_t num_blocks = udiv(m, (uint32_t)MC);
+						if(pool) pool->dispatch(num_blocks, 1, function);
+						else function(0, num_blocks);
+					}
+				}
+			}
+			
+		private:
+			
+			enum {
+				MR = 4,
+				NR = Size * 2,
+				MC = 96,
+				KC = 256,
+				NC = 2048,
+			};
+			
+			static TS_INLINE bool is_aligned(const Type *ptr) {
+				return (((size_t)ptr & (sizeof(Vector) - 1)) == 0);
+			}
+			static TS_INLINE bool is_aligned(const Type *a, const Type *b) {
+				return ((((size_t)a ^ (size_t)b) & (sizeof(Vector) - 1)) == 0);
+			}
+			
+			/// packs kc x mc block of A into the MR high panels scaled by alpha
+			static void pack_a(Type *dest, const Type *src, size_t lda, uint32_t kc, uint32_t mc, Type alpha) {
+				for(uint32_t ir = 0; ir < mc; ir += MR) {
+					uint32_t mr = min(mc - ir, (uint32_t)MR);
+					for(uint32_t r = 0; r < MR; r++) {
+						const Type *s = src + lda * (ir + r);
+						Type *d = dest + r;
+						if(r < mr) {
+							for(uint32_t p = 0; p < kc; p++) d[p * MR] = s[p] * alpha;
+						} else {
+							for(uint32_t p = 0; p < kc; p++) d[p * MR] = Type(0);
+						}
+					}
+					dest += (size_t)kc * MR;
+				}
+			}
+			
+			/// packs kc x nc block of B into the NR wide panels
+			static void pack_b(Type *dest, const Type *src, size_t ldb, uint32_t kc, uint32_t nc) {
+				for(uint32_t jr = 0; jr < nc; jr += NR) {
+					uint32_t nr = min(nc - jr, (uint32_t)NR);
+					for(uint32_t p = 0; p < kc; p++) {
+						const Type *s = src + ldb * p + jr;
+						Type *d = dest + (size_t)NR * p;
+						uint32_t i = 0;
+						for(; i < nr; i++) d[i] = s[i];
+						for(; i < NR; i++) d[i] = Type(0);
+					}
+					dest += (size_t)kc * NR;
+				}
+			}
+			
+			/// MR x NR register block
+			static void kernel(uint32_t kc, const Type *a, const Type *b, Type *c, size_t ldc, uint32_t mr, uint32_t nr, bool first) {
+				
+				Vector c00 = Vector(Type(0)), c01 = Vector(Type(0));
+				Vector c10 = Vector(Type(0)), c11 = Vector(Type(0));
+				Vector c20 = Vector(Type(0)), c21 = Vector(Type(0));
+				Vector c30 = Vector(Type(0)), c31 = Vector(Type(0));
+				for(uint32_t p = 0; p < kc; p++) {
+					Vector b0 = Vector(b);
+					Vector b1 = Vector(b + Size);
+					Vector a0 = Vector(a[0]);
+					Vector a1 = Vector(a[1]);
+					c00 += a0 * b0; c01 += a0 * b1;
+					c10 += a1 * b0; c11 += a1 * b1;
+					Vector a2 = Vector(a[2]);
+					Vector a3 = Vector(a[3]);
+					c20 += a2 * b0; c21 += a2 * b1;
+					c30 += a3 * b0; c31 += a3 * b1;
+					a += MR;
+					b += NR;
+				}
+				
+				// full aligned block
+				if(mr == MR && nr == NR && is_aligned(c) && is_aligned(c + ldc)) {
+					if(!first) {
+						c00 += Vector(c); c01 += Vector(c + Size); c += ldc;
+						c10 += Vector(c); c11 += Vector(c + Size); c += ldc;
+						c20 += Vector(c); c21 += Vector(c + Size); c += ldc;
+						c30 += Vector(c); c31 += Vector(c + Size); c -= ldc * 3;
+					}
+					c00.get(c); c01.get(c + Size); c += ldc;
+					c10.get(c); c11.get(c + Size); c += ldc;
+					c20.get(c); c21.get(c + Size); c += ldc;
+					c30.get(c); c31.get(c + Size);
+					return;
+				}
+				
+				// partial block
+				TS_ALIGNAS64 Type block[MR * NR];
+				c00.get(block + NR * 0); c01.get(block + NR * 0 + Size);
+				c10.get(block + NR * 1); c11.get(block + NR * 1 + Size);
+				c20.get(block + NR * 2); c21.get(block + NR * 2 + Size);
+				c30.get(block + NR * 3); c31.get(block + NR * 3 + Size);
+				for(uint32_t r = 0; r < mr; r++) {
+					Type *d = c + ldc * r;
+					const Type *s = block + NR * r;
+					if(first) for(uint32_t i = 0; i < nr; i++) d[i] = s[i];
+					else for(uint32_t i = 0; i < nr; i++) d[i] += s[i];
+				}
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * DenseVector
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> class DenseVector {
+			
+		public:
+			
+			DenseVector() { }
+			explicit DenseVector(uint32_t size) { create(size); }
+			DenseVector(uint32_t size, Type value) { create(size, value); }
+			
+			/// creates zero initialized vector
+			void create(uint32_t s) {
+				size = s;
+				buffer.allocate(size);
+			}
+			void create(uint32_t s, Type value) {
+				create(s);
+				for(uint32_t i = 0; i < size; i++) buffer.get()[i] = value;
+			}
+			void clear() {
+				buffer.release();
+				size = 0;
+			}
+			
+			TS_INLINE uint32_t getSize() const { return size; }
+			
+			TS_INLINE Type *get() { return buffer.get(); }
+			TS_INLINE const Type *get() const { return buffer.get(); }
+			
+			TS_INLINE Type &operator[](uint32_t index) { return buffer.get()[index]; }
+			TS_INLINE Type operator[](uint32_t index) const { return buffer.get()[index]; }
+			
+		private:
+			
+			uint32_t size = 0;
+			DenseBuffer<Type> buffer;
+	};
+	
+	/*
+	 */
+	template <class Type> Type dot(const DenseVector<Type> &v0, const DenseVector<Type> &v1) {
+		TS_ASSERT(v0.getSize() == v1.getSize());
+		return DenseKernel<Type>::dot(v0.get(), v1.get(), v0.getSize());
+	}
+	
+	template <class Type> Type length(const DenseVector<Type> &v) {
+		return Tellusim::sqrt(dot(v, v));
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * DenseMatrix
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> class DenseMatrix {
+			
+		public:
+			
+			DenseMatrix() { }
+			DenseMatrix(uint32_t rows, uint32_t columns) { create(rows, columns); }
+			DenseMatrix(uint32_t rows, uint32_t columns, Type value) { create(rows, columns, value); }
+			
+			/// creates zero initialized matrix
+			/// rows are padded to the SIMD width and aligned
+			void create(uint32_t r, uint32_t c) {
+				rows = r;
+				columns = c;
+				stride = align(columns, (uint32_t)DenseKernel<Type>::Size);
+				buffer.allocate((size_t)stride * rows);
+			}
+			void create(uint32_t r, uint32_t c, Type value) {
+				create(r, c);
+				for(uint32_t y = 0; y < rows; y++) {
+					Type *d = get(y);
+					for(uint32_t x = 0; x < columns; x++) d[x] = value;
+				}
+			}
+			void clear() {
+				buffer.release();
+				rows = columns = stride = 0;
+			}
+			
+			/// identity matrix
+			void setIdentity() {
+				for(uint32_t y = 0; y < rows; y++) {
+					Type *d = get(y);
+					for(uint32_t x = 0; x < columns; x++) d[x] = (x == y) ? Type(1) : Type(0);
+				}
+			}
+			
+			TS_INLINE uint32_t getRows() const { return rows; }
+			TS_INLINE uint32_t getColumns() const { return columns; }
+			TS_INLINE uint32_t getStride() const { return stride; }
+			
+			TS_INLINE Type *get(uint32_t row = 0) { return buffer.get() + (size_t)stride * row; }
+			TS_INLINE const Type *get(uint32_t row = 0) const { return buffer.get() + (size_t)stride * row; }
+			
+			TS_INLINE Type *operator[](uint32_t row) { return get(row); }
+			TS_INLINE const Type *operator[](uint32_t row) const { return get(row); }
+			
+			TS_INLINE Type &operator()(uint32_t row, uint32_t column) { return get(row)[column]; }
+			TS_INLINE Type operator()(uint32_t row, uint32_t column) const { return get(row)[column]; }
+			
+		private:
+			
+			uint32_t rows = 0;
+			uint32_t columns = 0;
+			uint32_t stride = 0;
+			DenseBuffer<Type> buffer;
+	};
+	
+	/*
+	 */
+	template <class Type> void mul(DenseMatrix<Type> &ret, const DenseMatrix<Type> &m0, const DenseMatrix<Type> &m1, ThreadPool *pool = nullptr) {
+		TS_ASSERT(m0.getColumns() == m1.getRows());
+		TS_ASSERT(&ret != &m0 && &ret != &m1);
+		if(ret.getRows() != m0.getRows() || ret.getColumns() != m1.getColumns()) ret.create(m0.getRows(), m1.getColumns());
+		DenseKernel<Type>::gemm(m0.getRows(), m1.getColumns(), m0.getColumns(), Type(1), m0.get(), m0.getStride(), m1.get(), m1.getStride(), ret.get(), ret.getStride(), false, pool);
+	}
+	
+	template <class Type> void mul(DenseVector<Type> &ret, const DenseMatrix<Type> &m, const DenseVector<Type> &v, ThreadPool *pool = nullptr) {
+		TS_ASSERT(m.getColumns() == v.getSize());
+		TS_ASSERT(&ret != &v);
+		if(ret.getSize() != m.getRows()) ret.create(m.getRows());
+		auto function = [&](uint32_t begin, uint32_t end) {
+			for(uint32_t i = begin; i < end; i++) {
+				ret[i] = DenseKernel<Type>::dot(m[i], v.get(), m.getColumns());
+			}
+		};
+		if(pool) pool->dispatch(m.getRows(), 64, function);
+		else function(0, m.getRows());
+	}
+	
+	template <class Type> void transpose(DenseMatrix<Type> &ret, const DenseMatrix<Type> &m) {
+		TS_ASSERT(&ret != &m);
+		if(ret.getRows() != m.getColumns() || ret.getColumns() != m.getRows()) ret.create(m.getColumns(), m.getRows());
+		constexpr uint32_t block = 32;
+		for(uint32_t y = 0; y < m.getRows(); y += block) {
+			uint32_t height = min(m.getRows() - y, block);
+			for(uint32_t x = 0; x < m.getColumns(); x += block) {
+				uint32_t width = min(m.getColumns() - x, block);
+				for(uint32_t i = 0; i < height; i++) {
+					const Type *s = m[y + i] + x;
+					for(uint32_t j = 0; j < width; j++) ret[x + j][y + i] = s[j];
+				}
+			}
+		}
+	}
+	
+	template <class Type> DenseMatrix<Type> operator*(const DenseMatrix<Type> &m0, const DenseMatrix<Type> &m1) {
+		DenseMatrix<Type> ret;
+		mul(ret, m0, m1);
+		return ret;
+	}
+	
+	template <class Type> DenseVector<Type> operator*(const DenseMatrix<Type> &m, const DenseVector<Type> &v) {
+		DenseVector<Type> ret;
+		mul(ret, m, v);
+		return ret;
+	}
+	
+	template <class Type> DenseMatrix<Type> transpose(const DenseMatrix<Type> &m) {
+		DenseMatrix<Type> ret;
+		transpose(ret, m);
+		return ret;
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * DenseLU
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class DenseLU {
+			
+		public:
+			
+			enum {
+				BlockSize = 64,
+			};
+			
+			/// blocked right-looking LU decomposition with partial pivoting
+			/// the trailing submatrix update is performed by the blocked GEMM
+			template <class Type> static bool decompose(const DenseMatrix<Type> &m, DenseMatrix<Type> &lu, Array<uint32_t> &indices, ThreadPool *pool = nullptr) {
+				
+				using Tellusim::abs;
+				
+				uint32_t size = m.getRows();
+				if(size != m.getColumns()) return false;
+				
+				lu = m;
+				indices.resize(size);
+				for(uint32_t i = 0; i < size; i++) indices[i] = i;
+				
+				for(uint32_t k = 0; k < size; k += BlockSize) {
+					uint32_t block = min(size - k, (uint32_t)BlockSize);
+					uint32_t end = k + block;
+					
+					// panel factorization
+					for(uint32_t j = k; j < end; j++) {
+						
+						// find pivot
+						uint32_t pivot = j;
+						Type value = abs(lu[j][j]);
+						for(uint32_t i = j + 1; i < size; i++) {
+							Type v = abs(lu[i][j]);
+							if(value < v) { value = v; pivot = i; }
+						}
+						if(value == Type(0)) return false;
+						
+						// swap rows
+						if(pivot != j) {
+							Type *row_0 = lu[j];
+							Type *row_1 = lu[pivot];
+							for(uint32_t x = 0; x < size; x++) swap(row_0[x], row_1[x]);
+							swap(indices[j], indices[pivot]);
+						}
+						
+						// eliminate panel columns
+						const Type *row = lu[j];
+						Type ipivot = Type(1) / row[j];
+						for(uint32_t i = j + 1; i < size; i++) {
+							Type *d = lu[i];
+							d[j] *= ipivot;
+							if(j + 1 < end) DenseKernel<Type>::sub(d + j + 1, row + j + 1, d[j], end - j - 1);
+						}
+					}
+					
+					if(end < size) {
+						
+						// U12 = inverse(L11) * A12
+						for(uint32_t j = k; j < end; j++) {
+							const Type *row = lu[j] + end;
+							for(uint32_t i = j + 1; i < end; i++) {
+								DenseKernel<Type>::sub(lu[i] + end, row, lu[i][j], size - end);
+							}
+						}
+						
+						// A22 -= L21 * U12
+						size_t stride = lu.getStride();
+						DenseKernel<Type>::gemm(size - end, size - end, block, Type(-1), lu[end] + k, stride, lu[k] + end, stride, lu[end] + end, stride, true, pool);
+					}
+				}
+				
+				return true;
+			}
+			
+			/// solves the system for the right-hand side vector
+			template <class Type> static DenseVector<Type> solve(const DenseMatrix<Type> &lu, const Array<uint32_t> &indices, const DenseVector<Type> &b) {
+				uint32_t size = lu.getRows();
+				TS_ASSERT(b.getSize() == size);
+				DenseVector<Type> x(size);
+				for(uint32_t i = 0; i < size; i++) {
+					x[i] = b[indices[i]] - DenseKernel<Type>::dot(lu[i], x.get(), i);
+				}
+				for(uint32_t i = size; i > 0; i--) {
+					uint32_t j = i - 1;
+					x[j] = (x[j] - DenseKernel<Type>::dot(lu[j] + i, x.get() + i, size - i)) / lu[j][j];
+				}
+				return x;
+			}
+			
+			/// inverse matrix, the columns are solved in parallel
+			template <class Type> static DenseMatrix<Type> inverse(const DenseMatrix<Type> &lu, const Array<uint32_t> &indices, ThreadPool *pool = nullptr) {
+				uint32_t size = lu.getRows();
+				DenseMatrix<Type> ret(size, size);
+				auto function = [&](uint32_t begin, uint32_t end) {
+					DenseVector<Type> b(size);
+					for(uint32_t x = begin; x < end; x++) {
+						for(uint32_t i = 0; i < size; i++) b[i] = (i == x) ? Type(1) : Type(0);
+						DenseVector<Type> c = solve(lu, indices, b);
+						for(uint32_t y = 0; y < size; y++) ret[y][x] = c[y];
+					}
+				};
+				if(pool) pool->dispatch(size, 16, function);
+				else function(0, size);
+				return ret;
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * DenseMixedLU
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class DenseMixedLU {
+			
+		public:
+			
+			struct Result {
+				uint32_t iterations = 0;
+				float64_t residual = 0.0;
+				bool converged = false;
+			};
+			
+			/// factors the matrix in single precision
+			/// the matrix is referenced by the refinement and must outlive the solver
+			bool create(const DenseMatrix<float64_t> &m, ThreadPool *p = nullptr) {
+				matrix = &m;
+				pool = p;
+				uint32_t size = m.getRows();
+				if(size != m.getColumns()) return false;
+				DenseMatrix<float32_t> m32(size, size);
+				norm = 0.0;
+				for(uint32_t y = 0; y < size; y++) {
+					const float64_t *s = m[y];
+					float32_t *d = m32[y];
+					float64_t sum = 0.0;
+					for(uint32_t x = 0; x < size; x++) {
+						d[x] = (float32_t)s[x];
+						sum += Tellusim::abs(s[x]);
+					}
+					norm = Tellusim::max(norm, sum);
+				}
+				return DenseLU::decompose(m32, lu, indices, pool);
+			}
+			
+			/// solves the system with the double precision iterative refinement
+			/// the residual is the normwise backward error |b - A * x| / (|A| * |x| + |b|) in the infinity norm
+			Result solve(const DenseVector<float64_t> &b, DenseVector<float64_t> &x, float64_t tolerance = 1e-14, uint32_t max_iterations = 16) const {
+				
+				using Tellusim::abs;
+				
+				Result ret;
+				uint32_t size = lu.getRows();
+				TS_ASSERT(matrix && b.getSize() == size);
+				
+				float64_t b_norm = 0.0;
+				for(uint32_t i = 0; i < size; i++) b_norm = Tellusim::max(b_norm, abs(b[i]));
+				
+				DenseVector<float64_t> r;
+				DenseVector<float32_t> r32(size);
+				x.create(size);
+				
+				for(; ret.iterations <= max_iterations; ret.iterations++) {
+					
+					// double precision residual
+					mul(r, *matrix, x, pool);
+					float64_t r_norm = 0.0;
+					float64_t x_norm = 0.0;
+					for(uint32_t i = 0; i < size; i++) {
+						r[i] = b[i] - r[i];
+						r_norm = Tellusim::max(r_norm, abs(r[i]));
+						x_norm = Tellusim::max(x_norm, abs(x[i]));
+					}
+					float64_t scale = norm * x_norm + b_norm;
+					ret.residual = (scale > 0.0) ? r_norm / scale : 0.0;
+					if(ret.residual <= tolerance) {
+						ret.converged = true;
+						break;
+					}
+					if(ret.iterations == max_iterations) break;
+					
+					// single precision correction
+					for(uint32_t i = 0; i < size; i++) r32[i] = (float32_t)r[i];
+					DenseVector<float32_t> d = DenseLU::solve(lu, indices, r32);
+					for(uint32_t i = 0; i < size; i++) x[i] += d[i];
+				}
+				
+				return ret;
+			}
+			
+		private:
+			
+			const DenseMatrix<float64_t> *matrix = nullptr;
+			ThreadPool *pool = nullptr;
+			
+			float64_t norm = 0.0;
+			DenseMatrix<float32_t> lu;
+			Array<uint32_t> indices;
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * DenseQR
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class DenseQR {
+			
+		public:
+			
+			/// Householder QR decomposition of the matrix with rows >= columns
+			/// Householder vectors are stored below the diagonal of qr, c holds the reflector scales and d holds the diagonal of R
+			template <class Type> static bool decompose(const DenseMatrix<Type> &m, DenseMatrix<Type> &qr, DenseVector<Type> &c, DenseVector<Type> &d, ThreadPool *pool = nullptr) {
+				
+				using Tellusim::abs;
+				
+				uint32_t rows = m.getRows();
+				uint32_t columns = m.getColumns();
+				if(rows < columns) return false;
+				
+				qr = m;
+				c.create(columns);
+				d.create(columns);
+				
+				for(uint32_t k = 0; k < columns; k++) {
+					
+					// reflector
+					Type scale = Type(0);
+					for(uint32_t i = k; i < rows; i++) scale = max(scale, abs(qr[i][k]));
+					if(scale == Type(0)) return false;
+					
+					Type sum = Type(0);
+					Type iscale = Type(1) / scale;
+					for(uint32_t i = k; i < rows; i++) {
+						Type &v = qr[i][k];
+						v *= iscale;
+						sum += v * v;
+					}
+					Type sigma = Tellusim::sqrt(sum);
+					if(qr[k][k] < Type(0)) sigma = -sigma;
+					qr[k][k] += sigma;
+					c[k] = sigma * qr[k][k];
+					d[k] = -scale * sigma;
+					
+					// apply the reflector to the trailing columns
+					uint32_t offset = k + 1;
+					if(offset == columns) continue;
+					Type ic = Type(1) / c[k];
+					auto function = [&](uint32_t begin, uint32_t end) {
+						// the accumulator has the same alignment as the rows
+						uint32_t size = end - begin;
+						DenseVector<Type> buffer(size + DenseKernel<Type>::Size);
+						Type *w = buffer.get() + (offset + begin) % DenseKernel<Type>::Size;
+						for(uint32_t i = k; i < rows; i++) {
+							DenseKernel<Type>::add(w, qr[i] + offset + begin, qr[i][k], size);
+						}
+						for(uint32_t i = k; i < rows; i++) {
+							DenseKernel<Type>::sub(qr[i] + offset + begin, w, qr[i][k] * ic, size);
+						}
+					};
+					uint32_t size = columns - offset;
+					if(pool && (uint64_t)size * (rows - k) > 64 * 1024) pool->dispatch(size, 64, function);
+					else function(0, size);
+				}
+				
+				return true;
+			}
+			
+			/// least squares solution of the system for the right-hand side vector
+			template <class Type> static DenseVector<Type> solve(const DenseMatrix<Type> &qr, const DenseVector<Type> &c, const DenseVector<Type> &d, const DenseVector<Type> &b) {
+				
+				uint32_t rows = qr.getRows();
+				uint32_t columns = qr.getColumns();
+				TS_ASSERT(b.getSize() == rows);
+				
+				// transpose(Q) * b
+				DenseVector<Type> y = b;
+				for(uint32_t k = 0; k < columns; k++) {
+					Type sum = Type(0);
+					for(uint32_t i = k; i < rows; i++) sum += qr[i][k] * y[i];
+					Type tau = sum / c[k];
+					for(uint32_t i = k; i < rows; i++) y[i] -= qr[i][k] * tau;
+				}
+				
+				// R * x = y
+				DenseVector<Type> x(columns);
+				for(uint32_t i = columns; i > 0; i--) {
+					uint32_t j = i - 1;
+					x[j] = (y[j] - DenseKernel<Type>::dot(qr[j] + i, x.get() + i, columns - i)) / d[j];
+				}
+				
+				return x;
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_DENSE_H__ */
@@ -0,0 +1,291 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_KABSCH_H__
+#define __TELLUSIM_TESTS_NUMERICAL_KABSCH_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimVector.h>
+#include <math/TellusimMatrix.h>
+
+#include "main_pool.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class Kabsch {
+			
+		public:
+			
+			/// rigid fit result
+			/// dest points are approximated by transform * src points
+			struct Result {
+				Matrix4x4f transform;
+				float32_t scale = 1.0f;
+				float32_t error = 0.0f;
+			};
+			
+			/// fits the rotation, translation and optional uniform scale of a single point set pair
+			static Result fit(const Vector3f *src, const Vector3f *dest, uint32_t size, bool scale = true) {
+				
+				Result ret;
+				float64_t isize = (size) ? 1.0 / size : 0.0;
+				
+				// centroids
+				float64_t sums[6];
+				accumulate_centers(sums, src, dest, size);
+				Vector3d src_center = Vector3d(sums[0], sums[1], sums[2]) * isize;
+				Vector3d dest_center = Vector3d(sums[3], sums[4], sums[5]) * isize;
+				
+				// cross-covariance matrix and variances
+				float64_t covariance[11];
+				accumulate_covariance(covariance, src, dest, size, Vector3f(src_center), Vector3f(dest_center));
+				float64_t src_variance = covariance[9];
+				float64_t dest_variance = covariance[10];
+				
+				// rotation and signed singular values
+				Vector3d rows[3];
+				float64_t trace = rotation(rows, covariance);
+				
+				// scale and error
+				float64_t s = 1.0;
+				if(scale && src_variance > 0.0) s = trace / src_variance;
+				float64_t error = dest_variance - 2.0 * s * trace + s * s * src_variance;
+				ret.scale = (float32_t)s;
+				ret.error = (float32_t)Tellusim::sqrt(Tellusim::max(error, 0.0) * isize);
+				
+				// transformation
+				Vector3d translate = dest_center - Vector3d(dot(rows[0], src_center), dot(rows[1], src_center), dot(rows[2], src_center)) * s;
+				Matrix4x4f &m = ret.transform;
+				m.m00 = (float32_t)(rows[0].x * s); m.m01 = (float32_t)(rows[0].y * s); m.m02 = (float32_t)(rows[0].z * s); m.m03 = (float32_t)translate.x;
+				m.m10 = (float32_t)(rows[1].x * s); m.m11 = (float32_t)(rows[1].y * s); m.m12 = (float32_t)(rows[1].z * s); m.m13 = (float32_t)translate.y;
+				m.m20 = (float32_t)(rows[2].x * s); m.m21 = (float32_t)(rows[2].y * s); m.m22 = (float32_t)(rows[2].z * s); m.m23 = (float32_t)translate.z;
+				m.m30 = 0.0f; m.m31 = 0.0f; m.m32 = 0.0f; m.m33 = 1.0f;
+				
+				return ret;
+			}
+			
+			/// fits many point set pairs, the pair i uses [offsets[i], offsets[i + 1]) points
+			static void fit(Result *results, const Vector3f *src, const Vector3f *dest, const uint32_t *offsets, uint32_t num, bool scale = true, ThreadPool *pool = nullptr) {
+				auto function = [&](uint32_t begin, uint32_t end) {
+					for(uint32_t i = begin; i < end; i++) {
+						uint32_t offset = offsets[i];
+						results[i] = fit(src + offset, dest + offset, offsets[i + 1] - offset, scale);
+					}
+				};
+				if(pool) pool->dispatch(num, 16, function);
+				else function(0, num);
+			}
+			
+		private:
+			
+			enum {
+				Lanes = 8,
+				Block = 1024,
+			};
+			
+			/// loads eight points into SoA registers
+			static TS_INLINE void load(const Vector3f *src, uint32_t size, float32x8_t &x, float32x8_t &y, float32x8_t &z, const Vector3f &center) {
+				TS_ALIGNAS32 float32_t data[3][Lanes];
+				for(uint32_t i = 0; i < Lanes; i++) {
+					Vector3f v = (i < size) ? src[i] - center : Vector3f(0.0f);
+					data[0][i] = v.x;
+					data[1][i] = v.y;
+					data[2][i] = v.z;
+				}
+				x = float32x8_t(data[0]);
+				y = float32x8_t(data[1]);
+				z = float32x8_t(data[2]);
+			}
+			
+			/// sums of src and dest points
+			/// lanes are flushed into the float64 sums every block
+			static void accumulate_centers(float64_t *ret, const Vector3f *src, const Vector3f *dest, uint32_t size) {
+				for(uint32_t i = 0; i < 6; i++) ret[i] = 0.0;
+				Vector3f zero = Vector3f(0.0f);
+				for(uint32_t i = 0; i < size; i += Block) {
+					uint32_t end = min(i + Block, size);
+					float32x8_t sums[6];
+					for(uint32_t j = 0; j < 6; j++) sums[j] = float32x8_t(0.0f);
+					for(uint32_t j = i; j < end; j += Lanes) {
+						float32x8_t x, y, z;
+						load(src + j, end - j, x, y, z, zero);
+						sums[0] += x; sums[1] += y; sums[2] += z;
+						load(dest + j, end - j, x, y, z, zero);
+						sums[3] += x; sums[4] += y; sums[5] += z;
+					}
+					for(uint32_t j = 0; j < 6; j++) ret[j] += sums[j].sum();
+				}
+			}
+			
+			/// dest * transpose(src) covariance of the centered points followed by src and dest variances
+			static void accumulate_covariance(float64_t *ret, const Vector3f *src, const Vector3f *dest, uint32_t size, const Vector3f &src_center, const Vector3f &dest_center) {
+				for(uint32_t i = 0; i < 11; i++) ret[i] = 0.0;
+				for(uint32_t i = 0; i < size; i += Block) {
+					uint32_t end = min(i + Block, size);
+					float32x8_t sums[11];
+					for(uint32_t j = 0; j < 11; j++) sums[j] = float32x8_t(0.0f);
+					for(uint32_t j = i; j < end; j += Lanes) {
+						float32x8_t sx, sy, sz, dx, dy, dz;
+						load(src + j, end - j, sx, sy, sz, src_center);
+						load(dest + j, end - j, dx, dy, dz, dest_center);
+						sums[0] += dx * sx; sums[1] += dx * sy; sums[2] += dx * sz;
+						sums[3] += dy * sx; sums[4] += dy * sy; sums[5] += dy * sz;
+						sums[6] += dz * sx; sums[7] += dz * sy; sums[8] += dz * sz;
+						sums[9] += sx * sx + sy * sy + sz * sz;
+						sums[10] += dx * dx + dy * dy + dz * dz;
+					}
+					for(uint32_t j = 0; j < 11; j++) ret[j] += sums[j].sum();
+				}
+			}
+			
+			/*
+			 */
+			static void orthogonal(const Vector3d &w, Vector3d &u, Vector3d &v) {
+				if(abs(w.x) > abs(w.y)) u = Vector3d(-w.z, 0.0, w.x) / Tellusim::sqrt(w.x * w.x + w.z * w.z);
+				else u = Vector3d(0.0, w.z, -w.y) / Tellusim::sqrt(w.y * w.y + w.z * w.z);
+				v = cross(w, u);
+			}
+			
+			/// eigenvector of the most separated eigenvalue
+			static Vector3d eigenvector_0(const Vector3d *rows, float64_t value) {
+				Vector3d r0 = rows[0] - Vector3d(value, 0.0, 0.0);
+				Vector3d r1 = rows[1] - Vector3d(0.0, value, 0.0);
+				Vector3d r2 = rows[2] - Vector3d(0.0, 0.0, value);
+				Vector3d c0 = cross(r0, r1);
+				Vector3d c1 = cross(r0, r2);
+				Vector3d c2 = cross(r1, r2);
+				float64_t d0 = dot(c0, c0);
+				float64_t d1 = dot(c1, c1);
+				float64_t d2 = dot(c2, c2);
+				if(d0 >= d1 && d0 >= d2) return c0 / Tellusim::sqrt(d0);
+				if(d1 >= d2) return c1 / Tellusim::sqrt(d1);
+				return c2 / Tellusim::sqrt(d2);
+			}
+			
+			/// eigenvector of the middle eigenvalue orthogonal to the first one
+			static Vector3d eigenvector_1(const Vector3d *rows, const Vector3d &vector, float64_t value) {
+				Vector3d u, v;
+				orthogonal(vector, u, v);
+				Vector3d au = Vector3d(dot(rows[0], u), dot(rows[1], u), dot(rows[2], u));
+				Vector3d av = Vector3d(dot(rows[0], v), dot(rows[1], v), dot(rows[2], v));
+				float64_t m00 = dot(u, au) - value;
+				float64_t m01 = dot(u, av);
+				float64_t m11 = dot(v, av) - value;
+				float64_t a00 = abs(m00), a01 = abs(m01), a11 = abs(m11);
+				if(a00 >= a11) {
+					if(Tellusim::max(a00, a01) == 0.0) return u;
+					if(a00 >= a01) { m01 /= m00; m00 = 1.0 / Tellusim::sqrt(1.0 + m01 * m01); m01 *= m00; }
+					else { m00 /= m01; m01 = 1.0 / Tellusim::sqrt(1.0 + m00 * m00); m00 *= m01; }
+					return u * m01 - v * m00;
+				}
+				if(Tellusim::max(a11, a01) == 0.0) return u;
+				if(a11 >= a01) { m01 /= m11; m11 = 1.0 / Tellusim::sqrt(1.0 + m01 * m01); m01 *= m11; }
+				else { m11 /= m01; m01 = 1.0 / Tellusim::sqrt(1.0 + m11 * m11); m11 *= m01; }
+				return u * m11 - v * m01;
+			}
+			
+			/// closed-form SVD of the 3x3 covariance matrix M = U * S * transpose(V)
+			/// the eigenvectors of transpose(M) * M are computed analytically and both U and V are kept right-handed,
+			/// so the reflection case is handled by the negative last singular value and R = U * transpose(V)
+			/// returns the trace of the signed singular values
+			static float64_t rotation(Vector3d *ret, const float64_t *m) {
+				
+				// covariance rows
+				Vector3d r0 = Vector3d(m[0], m[1], m[2]);
+				Vector3d r1 = Vector3d(m[3], m[4], m[5]);
+				Vector3d r2 = Vector3d(m[6], m[7], m[8]);
+				
+				// symmetric transpose(M) * M matrix scaled for the stability
+				Vector3d c0 = Vector3d(r0.x, r1.x, r2.x);
+				Vector3d c1 = Vector3d(r0.y, r1.y, r2.y);
+				Vector3d c2 = Vector3d(r0.z, r1.z, r2.z);
+				Vector3d a[3] = {
+					Vector3d(dot(c0, c0), dot(c0, c1), dot(c0, c2)),
+					Vector3d(dot(c1, c0), dot(c1, c1), dot(c1, c2)),
+					Vector3d(dot(c2, c0), dot(c2, c1), dot(c2, c2)),
+				};
+				float64_t scale = Tellusim::max(Tellusim::max(a[0].x, a[1].y), a[2].z);
+				
+				ret[0] = Vector3d(1.0, 0.0, 0.0);
+				ret[1] = Vector3d(0.0, 1.0, 0.0);
+				ret[2] = Vector3d(0.0, 0.0, 1.0);
+				if(scale <= 0.0) return 0.0;
+				for(uint32_t i = 0; i < 3; i++) a[i] = a[i] / scale;
+				
+				// eigenvectors in descending order
+				Vector3d v0, v1, v2;
+				float64_t q = (a[0].x + a[1].y + a[2].z) / 3.0;
+				float64_t off = a[0].y * a[0].y + a[0].z * a[0].z + a[1].z * a[1].z;
+				float64_t b00 = a[0].x - q, b11 = a[1].y - q, b22 = a[2].z - q;
+				float64_t p = Tellusim::sqrt((b00 * b00 + b11 * b11 + b22 * b22 + off * 2.0) / 6.0);
+				if(p > 1e-12) {
+					float64_t ip = 1.0 / p;
+					b00 *= ip; b11 *= ip; b22 *= ip;
+					float64_t b01 = a[0].y * ip, b02 = a[0].z * ip, b12 = a[1].z * ip;
+					float64_t det = b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) + b02 * (b01 * b12 - b11 * b02);
+					float64_t half = Tellusim::clamp(det * 0.5, -1.0, 1.0);
+					float64_t angle = acos(half) / 3.0;
+					float64_t beta_2 = cos(angle) * 2.0;
+					float64_t beta_0 = cos(angle + Pi64 * 2.0 / 3.0) * 2.0;
+					float64_t beta_1 = -(beta_0 + beta_2);
+					if(half >= 0.0) {
+						v0 = eigenvector_0(a, q + p * beta_2);
+						v1 = eigenvector_1(a, v0, q + p * beta_1);
+					} else {
+						v2 = eigenvector_0(a, q + p * beta_0);
+						v1 = eigenvector_1(a, v2, q + p * beta_1);
+						v0 = cross(v1, v2);
+					}
+				} else {
+					v0 = Vector3d(1.0, 0.0, 0.0);
+					v1 = Vector3d(0.0, 1.0, 0.0);
+				}
+				v2 = cross(v0, v1);
+				
+				// left singular vectors
+				Vector3d m0 = Vector3d(dot(r0, v0), dot(r1, v0), dot(r2, v0));
+				Vector3d m1 = Vector3d(dot(r0, v1), dot(r1, v1), dot(r2, v1));
+				float64_t s0 = length(m0);
+				if(s0 == 0.0) return 0.0;
+				Vector3d u0 = m0 / s0, u2;
+				Vector3d u1 = m1 - u0 * dot(u0, m1);
+				float64_t s1 = length(u1);
+				if(s1 > s0 * 1e-12) u1 = u1 / s1;
+				else orthogonal(u0, u1, u2);
+				u2 = cross(u0, u1);
+				float64_t s2 = dot(u2, Vector3d(dot(r0, v2), dot(r1, v2), dot(r2, v2)));
+				
+				// R = U * transpose(V)
+				for(uint32_t i = 0; i < 3; i++) {
+					ret[i] = Vector3d(u0[i] * v0.x + u1[i] * v1.x + u2[i] * v2.x, u0[i] * v0.y + u1[i] * v1.y + u2[i] * v2.y, u0[i] * v0.z + u1[i] * v1.z + u2[i] * v2.z);
+				}
+				
+				return dot(u0, m0) + dot(u1, m1) + s2;
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_KABSCH_H__ */
@@ -0,0 +1,216 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_MATRIX_H__
+#define __TELLUSIM_TESTS_NUMERICAL_MATRIX_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimNumerical.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <class Type, bool Wide> struct MatrixSimdVector;
+	
+	template <> struct MatrixSimdVector<float32_t, false> { using Vector = float32x4_t; enum { Width = 4 }; };
+	template <> struct MatrixSimdVector<float32_t, true> { using Vector = float32x8_t; enum { Width = 8 }; };
+	template <> struct MatrixSimdVector<float64_t, false> { using Vector = float64x2_t; enum { Width = 2 }; };
+	template <> struct MatrixSimdVector<float64_t, true> { using Vector = float64x4_t; enum { Width = 4 }; };
+	
+	template <class Type, uint32_t N> struct MatrixSimdTraits;
+	
+	template <uint32_t N> struct MatrixSimdTraits<float32_t, N> : public MatrixSimdVector<float32_t, (N > 4)> {
+		TS_STATIC_ASSERT(N > 0 && N <= 8);
+	};
+	
+	template <uint32_t N> struct MatrixSimdTraits<float64_t, N> : public MatrixSimdVector<float64_t, (N > 2)> {
+		TS_STATIC_ASSERT(N > 0 && N <= 8);
+	};
+	
+	/*
+	 */
+	template <class Type, uint32_t N> struct MatrixSimdRow {
+		
+		using Vector = typename MatrixSimdTraits<Type, N>::Vector;
+		
+		enum {
+			Width = MatrixSimdTraits<Type, N>::Width,
+			Count = (N + Width - 1) / Width,
+			Size = Width * Count,
+		};
+		
+		/// loads N elements, padding lanes are zero
+		TS_INLINE void load(const Type *src) {
+			TS_ALIGNAS32 Type data[Size];
+			memcpy(data, src, sizeof(Type) * N);
+			for(uint32_t i = N; i < Size; i++) data[i] = Type(0);
+			for(uint32_t i = 0; i < Count; i++) v[i] = Vector(data + Width * i);
+		}
+		
+		/// stores N elements
+		TS_INLINE void store(Type *dest) const {
+			TS_ALIGNAS32 Type data[Size];
+			for(uint32_t i = 0; i < Count; i++) v[i].get(data + Width * i);
+			memcpy(dest, data, sizeof(Type) * N);
+		}
+		
+		/// this += row * s
+		TS_INLINE void mad(const MatrixSimdRow &row, Type s) {
+			Vector vs = Vector(s);
+			for(uint32_t i = 0; i < Count; i++) v[i] += row.v[i] * vs;
+		}
+		TS_INLINE void mul(const MatrixSimdRow &row, Type s) {
+			Vector vs = Vector(s);
+			for(uint32_t i = 0; i < Count; i++) v[i] = row.v[i] * vs;
+		}
+		
+		/// horizontal dot product
+		TS_INLINE Type dot(const MatrixSimdRow &row) const {
+			Vector ret = v[0] * row.v[0];
+			for(uint32_t i = 1; i < Count; i++) ret += v[i] * row.v[i];
+			return ret.sum();
+		}
+		
+		Vector v[Count];
+	};
+	
+	/*
+	 */
+	class MatrixSimd {
+			
+		public:
+			
+			/// matrix by matrix multiplication
+			/// rows of the right matrix are kept in registers and scaled by the left matrix elements
+			template <class Type, uint32_t N, uint32_t M, uint32_t K> static MatrixNxM<Type, N, M> mul(const MatrixNxM<Type, K, M> &m0, const MatrixNxM<Type, N, K> &m1) {
+				TS_STATIC_ASSERT(K <= 8 && M <= 8);
+				MatrixNxM<Type, N, M> ret;
+				MatrixSimdRow<Type, N> rows[K];
+				for(uint32_t k = 0; k < K; k++) rows[k].load(m1.m + N * k);
+				for(uint32_t y = 0; y < M; y++) {
+					MatrixSimdRow<Type, N> row;
+					const Type *s = m0.m + K * y;
+					row.mul(rows[0], s[0]);
+					for(uint32_t k = 1; k < K; k++) row.mad(rows[k], s[k]);
+					row.store(ret.m + N * y);
+				}
+				return ret;
+			}
+			
+			/// matrix by column vector multiplication
+			template <class Type, uint32_t N, uint32_t M> static VectorN<Type, M> mul(const MatrixNxM<Type, N, M> &m, const VectorN<Type, N> &v) {
+				TS_STATIC_ASSERT(M <= 8);
+				VectorN<Type, M> ret;
+				MatrixSimdRow<Type, N> column;
+				column.load(v.v);
+				for(uint32_t y = 0; y < M; y++) {
+					MatrixSimdRow<Type, N> row;
+					row.load(m.m + N * y);
+					ret.v[y] = row.dot(column);
+				}
+				return ret;
+			}
+			
+			/// row vector by matrix multiplication
+			template <class Type, uint32_t N, uint32_t M> static VectorN<Type, N> mul(const VectorN<Type, M> &v, const MatrixNxM<Type, N, M> &m) {
+				TS_STATIC_ASSERT(M <= 8);
+				VectorN<Type, N> ret;
+				MatrixSimdRow<Type, N> row, ret_row;
+				row.load(m.m);
+				ret_row.mul(row, v.v[0]);
+				for(uint32_t y = 1; y < M; y++) {
+					row.load(m.m + N * y);
+					ret_row.mad(row, v.v[y]);
+				}
+				ret_row.store(ret.v);
+				return ret;
+			}
+			
+			/// element-wise addition
+			template <class Type, uint32_t N, uint32_t M> static MatrixNxM<Type, N, M> add(const MatrixNxM<Type, N, M> &m0, const MatrixNxM<Type, N, M> &m1) {
+				TS_STATIC_ASSERT(M <= 8);
+				MatrixNxM<Type, N, M> ret;
+				for(uint32_t y = 0; y < M; y++) {
+					MatrixSimdRow<Type, N> row_0, row_1;
+					row_0.load(m0.m + N * y);
+					row_1.load(m1.m + N * y);
+					for(uint32_t i = 0; i < MatrixSimdRow<Type, N>::Count; i++) row_0.v[i] += row_1.v[i];
+					row_0.store(ret.m + N * y);
+				}
+				return ret;
+			}
+			
+			/// matrix transpose
+			template <class Type, uint32_t N, uint32_t M> static MatrixNxM<Type, M, N> transpose(const MatrixNxM<Type, N, M> &m) {
+				TS_STATIC_ASSERT(N <= 8 && M <= 8);
+				MatrixNxM<Type, M, N> ret;
+				for(uint32_t y = 0; y < M; y++) {
+					for(uint32_t x = 0; x < N; x++) ret.m[M * x + y] = m.m[N * y + x];
+				}
+				return ret;
+			}
+			
+			#if TS_SSE
+				static MatrixNxM<float32_t, 4, 4> transpose(const MatrixNxM<float32_t, 4, 4> &m) {
+					MatrixNxM<float32_t, 4, 4> ret;
+					__m128 row_0 = _mm_loadu_ps(m.m + 0);
+					__m128 row_1 = _mm_loadu_ps(m.m + 4);
+					__m128 row_2 = _mm_loadu_ps(m.m + 8);
+					__m128 row_3 = _mm_loadu_ps(m.m + 12);
+					_MM_TRANSPOSE4_PS(row_0, row_1, row_2, row_3);
+					_mm_storeu_ps(ret.m + 0, row_0);
+					_mm_storeu_ps(ret.m + 4, row_1);
+					_mm_storeu_ps(ret.m + 8, row_2);
+					_mm_storeu_ps(ret.m + 12, row_3);
+					return ret;
+				}
+			#endif
+			
+			#if TS_AVX
+				static MatrixNxM<float32_t, 8, 8> transpose(const MatrixNxM<float32_t, 8, 8> &m) {
+					MatrixNxM<float32_t, 8, 8> ret;
+					__m256 r[8], t[8];
+					for(uint32_t i = 0; i < 8; i++) r[i] = _mm256_loadu_ps(m.m + 8 * i);
+					for(uint32_t i = 0; i < 8; i += 2) {
+						t[i + 0] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+						t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+					}
+					for(uint32_t i = 0; i < 8; i += 4) {
+						r[i + 0] = _mm256_shuffle_ps(t[i + 0], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+						r[i + 1] = _mm256_shuffle_ps(t[i + 0], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+						r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+						r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+					}
+					for(uint32_t i = 0; i < 4; i++) {
+						_mm256_storeu_ps(ret.m + 8 * i, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+						_mm256_storeu_ps(ret.m + 8 * (i + 4), _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+					}
+					return ret;
+				}
+			#endif
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_MATRIX_H__ */
@@ -0,0 +1,99 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_POOL_H__
+#define __TELLUSIM_TESTS_NUMERICAL_POOL_H__
+
+#include <core/TellusimBase.h>
+#include <core/TellusimAsync.h>
+#include <core/TellusimThread.h>
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class ThreadPool {
+			
+		public:
+			
+			/// creates the pool with the number of threads including the calling one
+			/// zero number of threads uses the number of cores
+			explicit ThreadPool(uint32_t num = 0) {
+				if(num == 0) num = max(Async::getNumCores(), 1u);
+				if(num > 1 && async.init(num - 1)) num_threads = num;
+			}
+			~ThreadPool() {
+				async.shutdown();
+			}
+			
+			/// number of threads
+			uint32_t getNumThreads() const { return num_threads; }
+			
+			/// runs the function(begin, end) over the [0, size) range split into grain sized chunks
+			/// the calling thread takes part in the work, the dispatch is not reentrant
+			template <class Function> void dispatch(uint32_t size, uint32_t grain, const Function &function) {
+				if(size == 0) return;
+				grain = max(grain, 1u);
+				if(num_threads == 1 || size <= grain) {
+					function(0u, size);
+					return;
+				}
+				task_next = 0;
+				uint32_t num_tasks = min(num_threads, (size + grain - 1) / grain);
+				for(uint32_t i = 1; i < num_tasks; i++) {
+					async.run([this, &function, size, grain]() { run(function, size, grain); });
+				}
+				run(function, size, grain);
+				async.wait();
+			}
+			
+		private:
+			
+			/// next chunk or size if the range is exhausted
+			uint32_t next(uint32_t size, uint32_t grain) {
+				mutex.lock();
+				uint32_t begin = min(task_next, size);
+				task_next = begin + min(grain, size - begin);
+				mutex.unlock();
+				return begin;
+			}
+			
+			template <class Function> void run(const Function &function, uint32_t size, uint32_t grain) {
+				while(1) {
+					uint32_t begin = next(size, grain);
+					if(begin >= size) break;
+					function(begin, min(begin + grain, size));
+				}
+			}
+			
+			uint32_t num_threads = 1;
+			
+			Async async;
+			Mutex mutex;
+			
+			uint32_t task_next = 0;
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_POOL_H__ */
@@ -0,0 +1,559 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_NUMERICAL_SPARSE_H__
+#define __TELLUSIM_TESTS_NUMERICAL_SPARSE_H__
+
+#include "main_dense.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <class Type> struct SparseTriplet {
+		uint32_t row;
+		uint32_t column;
+		Type value;
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * SparseMatrix
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> class SparseMatrix {
+			
+		public:
+			
+			SparseMatrix() { }
+			SparseMatrix(uint32_t rows, uint32_t columns, const Array<SparseTriplet<Type>> &triplets) { create(rows, columns, triplets); }
+			
+			/// creates compressed sparse row matrix from the unordered triplets
+			/// duplicate entries are summed
+			void create(uint32_t r, uint32_t c, const Array<SparseTriplet<Type>> &triplets) {
+				
+				rows = r;
+				columns = c;
+				
+				// counting sort by rows
+				offsets.resize(rows + 1);
+				for(uint32_t i = 0; i <= rows; i++) offsets[i] = 0;
+				for(const SparseTriplet<Type> &t : triplets) {
+					TS_ASSERT(t.row < rows && t.column < columns);
+					offsets[t.row + 1]++;
+				}
+				for(uint32_t i = 0; i < rows; i++) offsets[i + 1] += offsets[i];
+				
+				Array<uint32_t> positions(rows);
+				for(uint32_t i = 0; i < rows; i++) positions[i] = offsets[i];
+				indices.resize(triplets.size());
+				values.resize(triplets.size());
+				for(const SparseTriplet<Type> &t : triplets) {
+					uint32_t position = positions[t.row]++;
+					indices[position] = t.column;
+					values[position] = t.value;
+				}
+				
+				// sort columns and merge duplicates
+				uint32_t size = 0;
+				for(uint32_t i = 0; i < rows; i++) {
+					uint32_t begin = offsets[i];
+					uint32_t end = offsets[i + 1];
+					for(uint32_t j = begin + 1; j < end; j++) {
+						uint32_t index = indices[j];
+						Type value = values[j];
+						uint32_t k = j;
+						for(; k > begin && indices[k - 1] > index; k--) {
+							indices[k] = indices[k - 1];
+							values[k] = values[k - 1];
+						}
+						indices[k] = index;
+						values[k] = value;
+					}
+					offsets[i] = size;
+					for(uint32_t j = begin; j < end; j++) {
+						if(size > offsets[i] && indices[size - 1] == indices[j]) {
+							values[size - 1] += values[j];
+						} else {
+							indices[size] = indices[j];
+							values[size] = values[j];
+							size++;
+						}
+					}
+				}
+				offsets[rows] = size;
+				indices.resize(size);
+				values.resize(size);
+			}
+			
+			/// matrix info
+			TS_INLINE uint32_t getRows() const { return rows; }
+			TS_INLINE uint32_t getColumns() const { return columns; }
+			TS_INLINE uint32_t getNumValues() const { return values.size(); }
+			
+			/// matrix data
+			TS_INLINE const uint32_t *getOffsets() const { return offsets.get(); }
+			TS_INLINE const uint32_t *getIndices() const { return indices.get(); }
+			TS_INLINE const Type *getValues() const { return values.get(); }
+			
+			/// diagonal value
+			Type getDiagonal(uint32_t row) const {
+				for(uint32_t i = offsets[row]; i < offsets[row + 1]; i++) {
+					if(indices[i] == row) return values[i];
+				}
+				return Type(0);
+			}
+			
+		private:
+			
+			uint32_t rows = 0;
+			uint32_t columns = 0;
+			Array<uint32_t> offsets;
+			Array<uint32_t> indices;
+			Array<Type> values;
+	};
+	
+	/*
+	 */
+	template <class Type> void mul(DenseVector<Type> &ret, const SparseMatrix<Type> &m, const DenseVector<Type> &v, ThreadPool *pool = nullptr) {
+		TS_ASSERT(m.getColumns() == v.getSize());
+		TS_ASSERT(&ret != &v);
+		if(ret.getSize() != m.getRows()) ret.create(m.getRows());
+		const uint32_t *offsets = m.getOffsets();
+		const uint32_t *indices = m.getIndices();
+		const Type *values = m.getValues();
+		const Type *src = v.get();
+		Type *dest = ret.get();
+		auto function = [&](uint32_t begin, uint32_t end) {
+			for(uint32_t i = begin; i < end; i++) {
+				Type value = Type(0);
+				for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+					value += values[j] * src[indices[j]];
+				}
+				dest[i] = value;
+			}
+		};
+		if(pool) pool->dispatch(m.getRows(), 4096, function);
+		else function(0, m.getRows());
+	}
+	
+	template <class Type> DenseVector<Type> operator*(const SparseMatrix<Type> &m, const DenseVector<Type> &v) {
+		DenseVector<Type> ret;
+		mul(ret, m, v);
+		return ret;
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * SparseBlockMatrix
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type, uint32_t Block> class SparseBlockMatrix {
+			
+		public:
+			
+			enum {
+				BlockSize = Block * Block,
+			};
+			
+			SparseBlockMatrix() { }
+			explicit SparseBlockMatrix(const SparseMatrix<Type> &m) { create(m); }
+			
+			/// creates block sparse row matrix from the compressed sparse row matrix
+			/// the dimensions are padded to the block size
+			void create(const SparseMatrix<Type> &m) {
+				
+				rows = m.getRows();
+				columns = m.getColumns();
+				uint32_t block_rows = udiv(rows, Block);
+				uint32_t block_columns = udiv(columns, Block);
+				
+				const uint32_t *src_offsets = m.getOffsets();
+				const uint32_t *src_indices = m.getIndices();
+				const Type *src_values = m.getValues();
+				
+				// block structure
+				Array<uint32_t> positions(block_columns, Maxu32);
+				offsets.resize(block_rows + 1);
+				indices.clear();
+				offsets[0] = 0;
+				for(uint32_t i = 0; i < block_rows; i++) {
+					uint32_t begin = indices.size();
+					for(uint32_t r = i * Block; r < min(rows, (i + 1) * Block); r++) {
+						for(uint32_t j = src_offsets[r]; j < src_offsets[r + 1]; j++) {
+							uint32_t column = src_indices[j] / Block;
+							if(positions[column] != Maxu32) continue;
+							positions[column] = indices.size();
+							indices.append(column);
+						}
+					}
+					for(uint32_t j = begin; j < indices.size(); j++) positions[indices[j]] = Maxu32;
+					offsets[i + 1] = indices.size();
+				}
+				
+				// block values
+				values.resize(indices.size() * BlockSize);
+				for(uint32_t i = 0; i < values.size(); i++) values[i] = Type(0);
+				for(uint32_t i = 0; i < block_rows; i++) {
+					for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) positions[indices[j]] = j;
+					for(uint32_t r = i * Block; r < min(rows, (i + 1) * Block); r++) {
+						for(uint32_t j = src_offsets[r]; j < src_offsets[r + 1]; j++) {
+							uint32_t column = src_indices[j];
+							values[positions[column / Block] * BlockSize + (r % Block) * Block + column % Block] = src_values[j];
+						}
+					}
+					for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) positions[indices[j]] = Maxu32;
+				}
+			}
+			
+			/// matrix info
+			TS_INLINE uint32_t getRows() const { return rows; }
+			TS_INLINE uint32_t getColumns() const { return columns; }
+			TS_INLINE uint32_t getNumBlocks() const { return indices.size(); }
+			
+			/// matrix data
+			TS_INLINE const uint32_t *getOffsets() const { return offsets.get(); }
+			TS_INLINE const uint32_t *getIndices() const { return indices.get(); }
+			TS_INLINE const Type *getValues() const { return values.get(); }
+			
+		private:
+			
+			uint32_t rows = 0;
+			uint32_t columns = 0;
+			Array<uint32_t> offsets;
+			Array<uint32_t> indices;
+			Array<Type> values;
+	};
+	
+	/*
+	 */
+	template <class Type, uint32_t Block> void mul(DenseVector<Type> &ret, const SparseBlockMatrix<Type, Block> &m, const DenseVector<Type> &v, ThreadPool *pool = nullptr) {
+		TS_ASSERT(m.getColumns() == v.getSize());
+		TS_ASSERT(&ret != &v);
+		if(ret.getSize() != m.getRows()) ret.create(m.getRows());
+		const uint32_t *offsets = m.getOffsets();
+		const uint32_t *indices = m.getIndices();
+		const Type *values = m.getValues();
+		const Type *src = v.get();
+		Type *dest = ret.get();
+		uint32_t rows = m.getRows();
+		uint32_t columns = m.getColumns();
+		auto function = [&](uint32_t begin, uint32_t end) {
+			Type x[Block], y[Block];
+			for(uint32_t i = begin; i < end; i++) {
+				for(uint32_t r = 0; r < Block; r++) y[r] = Type(0);
+				for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+					uint32_t column = indices[j] * Block;
+					if(column + Block <= columns) {
+						for(uint32_t c = 0; c < Block; c++) x[c] = src[column + c];
+					} else {
+						for(uint32_t c = 0; c < Block; c++) x[c] = (column + c < columns) ? src[column + c] : Type(0);
+					}
+					const Type *block = values + (size_t)j * SparseBlockMatrix<Type, Block>::BlockSize;
+					for(uint32_t r = 0; r < Block; r++) {
+						for(uint32_t c = 0; c < Block; c++) y[r] += block[r * Block + c] * x[c];
+					}
+				}
+				uint32_t row = i * Block;
+				for(uint32_t r = 0; r < Block && row + r < rows; r++) dest[row + r] = y[r];
+			}
+		};
+		uint32_t block_rows = udiv(rows, Block);
+		if(pool) pool->dispatch(block_rows, 4096 / Block, function);
+		else function(0, block_rows);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Preconditioners
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> class SparseIdentity {
+			
+		public:
+			
+			void apply(DenseVector<Type> &z, const DenseVector<Type> &r) const {
+				if(z.getSize() != r.getSize()) z.create(r.getSize());
+				memcpy(z.get(), r.get(), sizeof(Type) * r.getSize());
+			}
+	};
+	
+	/*
+	 */
+	template <class Type> class SparseJacobi {
+			
+		public:
+			
+			/// inverse diagonal preconditioner
+			bool create(const SparseMatrix<Type> &m) {
+				idiagonal.create(m.getRows());
+				for(uint32_t i = 0; i < m.getRows(); i++) {
+					Type value = m.getDiagonal(i);
+					if(value == Type(0)) return false;
+					idiagonal[i] = Type(1) / value;
+				}
+				return true;
+			}
+			
+			void apply(DenseVector<Type> &z, const DenseVector<Type> &r) const {
+				if(z.getSize() != r.getSize()) z.create(r.getSize());
+				const Type *s = r.get();
+				const Type *d = idiagonal.get();
+				Type *ret = z.get();
+				for(uint32_t i = 0; i < r.getSize(); i++) ret[i] = s[i] * d[i];
+			}
+			
+		private:
+			
+			DenseVector<Type> idiagonal;
+	};
+	
+	/*
+	 */
+	template <class Type> class SparseCholesky {
+			
+		public:
+			
+			/// zero fill-in incomplete Cholesky factorization of the symmetric positive definite matrix
+			/// the lower factor keeps the sparsity pattern of the lower triangle
+			bool create(const SparseMatrix<Type> &m) {
+				
+				size = m.getRows();
+				const uint32_t *src_offsets = m.getOffsets();
+				const uint32_t *src_indices = m.getIndices();
+				const Type *src_values = m.getValues();
+				
+				// lower triangle with the diagonal at the end of rows
+				offsets.resize(size + 1);
+				indices.clear();
+				values.clear();
+				offsets[0] = 0;
+				for(uint32_t i = 0; i < size; i++) {
+					bool diagonal = false;
+					for(uint32_t j = src_offsets[i]; j < src_offsets[i + 1] && src_indices[j] <= i; j++) {
+						indices.append(src_indices[j]);
+						values.append(src_values[j]);
+						diagonal = (src_indices[j] == i);
+					}
+					if(!diagonal) return false;
+					offsets[i + 1] = indices.size();
+				}
+				
+				// factorization
+				for(uint32_t i = 0; i < size; i++) {
+					uint32_t begin = offsets[i];
+					uint32_t end = offsets[i + 1] - 1;
+					for(uint32_t j = begin; j < end; j++) {
+						uint32_t k = indices[j];
+						Type value = values[j] - dot(begin, j, offsets[k], offsets[k + 1] - 1);
+						values[j] = value / values[offsets[k + 1] - 1];
+					}
+					Type value = values[end] - dot(begin, end, begin, end);
+					if(value <= Type(0)) return false;
+					values[end] = Tellusim::sqrt(value);
+				}
+				
+				return true;
+			}
+			
+			/// z = inverse(L * transpose(L)) * r
+			void apply(DenseVector<Type> &z, const DenseVector<Type> &r) const {
+				if(z.getSize() != r.getSize()) z.create(r.getSize());
+				Type *ret = z.get();
+				
+				// L * y = r
+				for(uint32_t i = 0; i < size; i++) {
+					Type value = r[i];
+					uint32_t end = offsets[i + 1] - 1;
+					for(uint32_t j = offsets[i]; j < end; j++) value -= values[j] * ret[indices[j]];
+					ret[i] = value / values[end];
+				}
+				
+				// transpose(L) * z = y
+				for(uint32_t i = size; i > 0; i--) {
+					uint32_t end = offsets[i] - 1;
+					Type value = ret[i - 1] / values[end];
+					ret[i - 1] = value;
+					for(uint32_t j = offsets[i - 1]; j < end; j++) ret[indices[j]] -= values[j] * value;
+				}
+			}
+			
+		private:
+			
+			/// sparse dot product of two row ranges
+			Type dot(uint32_t begin_0, uint32_t end_0, uint32_t begin_1, uint32_t end_1) const {
+				Type ret = Type(0);
+				while(begin_0 < end_0 && begin_1 < end_1) {
+					uint32_t index_0 = indices[begin_0];
+					uint32_t index_1 = indices[begin_1];
+					if(index_0 == index_1) ret += values[begin_0++] * values[begin_1++];
+					else if(index_0 < index_1) begin_0++;
+					else begin_1++;
+				}
+				return ret;
+			}
+			
+			uint32_t size = 0;
+			Array<uint32_t> offsets;
+			Array<uint32_t> indices;
+			Array<Type> values;
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * SparseSolver
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class SparseSolver {
+			
+		public:
+			
+			struct Result {
+				uint32_t iterations = 0;
+				float64_t residual = 0.0;
+				bool converged = false;
+			};
+			
+			/// preconditioned conjugate gradient for the symmetric positive definite matrices
+			/// the x vector contains the initial guess, the residual is relative to the right-hand side
+			template <class Matrix, class Preconditioner, class Type> static Result cg(const Matrix &m, const Preconditioner &preconditioner, const DenseVector<Type> &b, DenseVector<Type> &x, uint32_t max_iterations, Type tolerance, ThreadPool *pool = nullptr) {
+				
+				Result ret;
+				uint32_t size = b.getSize();
+				if(x.getSize() != size) x.create(size);
+				
+				DenseVector<Type> r, z, p, q;
+				mul(r, m, x, pool);
+				for(uint32_t i = 0; i < size; i++) r[i] = b[i] - r[i];
+				
+				Type norm = length(b);
+				if(norm == Type(0)) norm = Type(1);
+				Type threshold = tolerance * norm;
+				
+				preconditioner.apply(z, r);
+				p = z;
+				Type rz = dot(r, z);
+				
+				for(; ret.iterations < max_iterations; ret.iterations++) {
+					Type residual = length(r);
+					ret.residual = residual / norm;
+					if(residual <= threshold) {
+						ret.converged = true;
+						break;
+					}
+					
+					mul(q, m, p, pool);
+					Type pq = dot(p, q);
+					if(pq == Type(0)) break;
+					Type alpha = rz / pq;
+					DenseKernel<Type>::add(x.get(), p.get(), alpha, size);
+					DenseKernel<Type>::sub(r.get(), q.get(), alpha, size);
+					
+					preconditioner.apply(z, r);
+					Type rz_1 = dot(r, z);
+					Type beta = rz_1 / rz;
+					rz = rz_1;
+					Type *d = p.get();
+					const Type *s = z.get();
+					for(uint32_t i = 0; i < size; i++) d[i] = s[i] + d[i] * beta;
+				}
+				
+				return ret;
+			}
+			
+			/// preconditioned biconjugate gradient stabilized method for the general matrices
+			template <class Matrix, class Preconditioner, class Type> static Result bicgstab(const Matrix &m, const Preconditioner &preconditioner, const DenseVector<Type> &b, DenseVector<Type> &x, uint32_t max_iterations, Type tolerance, ThreadPool *pool = nullptr) {
+				
+				Result ret;
+				uint32_t size = b.getSize();
+				if(x.getSize() != size) x.create(size);
+				
+				DenseVector<Type> r, r0, p(size), v(size), s, t, y, z;
+				mul(r, m, x, pool);
+				for(uint32_t i = 0; i < size; i++) r[i] = b[i] - r[i];
+				r0 = r;
+				
+				Type norm = length(b);
+				if(norm == Type(0)) norm = Type(1);
+				Type threshold = tolerance * norm;
+				
+				Type rho = Type(1);
+				Type alpha = Type(1);
+				Type omega = Type(1);
+				
+				for(; ret.iterations < max_iterations; ret.iterations++) {
+					Type residual = length(r);
+					ret.residual = residual / norm;
+					if(residual <= threshold) {
+						ret.converged = true;
+						break;
+					}
+					
+					Type rho_1 = dot(r0, r);
+					if(rho_1 == Type(0) || omega == Type(0)) break;
+					Type beta = (rho_1 / rho) * (alpha / omega);
+					rho = rho_1;
+					for(uint32_t i = 0; i < size; i++) p[i] = r[i] + (p[i] - v[i] * omega) * beta;
+					
+					preconditioner.apply(y, p);
+					mul(v, m, y, pool);
+					Type r0v = dot(r0, v);
+					if(r0v == Type(0)) break;
+					alpha = rho / r0v;
+					
+					s = r;
+					DenseKernel<Type>::sub(s.get(), v.get(), alpha, size);
+					DenseKernel<Type>::add(x.get(), y.get(), alpha, size);
+					if(length(s) <= threshold) {
+						r = s;
+						continue;
+					}
+					
+					preconditioner.apply(z, s);
+					mul(t, m, z, pool);
+					Type tt = dot(t, t);
+					omega = (tt != Type(0)) ? dot(t, s) / tt : Type(0);
+					DenseKernel<Type>::add(x.get(), z.get(), omega, size);
+					r = s;
+					DenseKernel<Type>::sub(r.get(), t.get(), omega, size);
+				}
+				
+				return ret;
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_NUMERICAL_SPARSE_H__ */
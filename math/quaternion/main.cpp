@@ -21,9 +21,15 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <core/TellusimTime.h>
+#include <core/TellusimArray.h>
+#include <core/TellusimString.h>
 #include <math/TellusimMatrix.h>
+#include <math/TellusimRandom.h>
 #include <math/TellusimQuaternion.h>
 
+#include "main_batch.h"
+
 /*
  */
 using namespace Tellusim;
@@ -43,6 +49,50 @@ template <class Type> void printm4x4(const char *str, const Type &m) {
 		m.m00, m.m01, m.m02, m.m03, m.m10, m.m11, m.m12, m.m13, m.m20, m.m21, m.m22, m.m23, m.m30, m.m31, m.m32, m.m33);
 }
 
+/*
+ */
+float32_t get_ulp(const float32_t *a, const float32_t *b, uint32_t size) {
+	float32_t ret = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		// distance to the next representable value
+		float32_t v = Tellusim::abs(b[i]);
+		uint32_t bits;
+		memcpy(&bits, &v, sizeof(bits));
+		bits++;
+		float32_t ulp;
+		memcpy(&ulp, &bits, sizeof(ulp));
+		ret = Tellusim::max(ret, Tellusim::abs(a[i] - b[i]) / (ulp - v));
+	}
+	return ret;
+}
+
+float32_t get_length_ulp(const Quaternionf *a, const Quaternionf *b, uint32_t size) {
+	float32_t ret = 0.0f;
+	for(uint32_t i = 0; i < size; i++) {
+		// components in the distance to the next representable length
+		float32_t v = Tellusim::sqrt(dot(b[i], b[i]));
+		uint32_t bits;
+		memcpy(&bits, &v, sizeof(bits));
+		bits++;
+		float32_t ulp;
+		memcpy(&ulp, &bits, sizeof(ulp));
+		for(uint32_t j = 0; j < 4; j++) ret = Tellusim::max(ret, Tellusim::abs(a[i].q[j] - b[i].q[j]) / (ulp - v));
+	}
+	return ret;
+}
+
+template <class Function> uint64_t get_time(uint32_t num, const Function &function) {
+	uint64_t begin = Time::current();
+	for(uint32_t i = 0; i < num; i++) function();
+	return (Time::current() - begin) / num;
+}
+
+void print_time(const char *str, uint32_t size, uint64_t scalar_time, uint64_t batch_time, float32_t ulp) {
+	float64_t speed = (float64_t)size / max(batch_time, (uint64_t)1);
+	float64_t ratio = (float64_t)scalar_time / max(batch_time, (uint64_t)1);
+	TS_LOGF(Message, "%s%s -> %s (%.1f M/s x%.2f) %.1f ulp\n", str, String::fromTime(scalar_time).get(), String::fromTime(batch_time).get(), speed, ratio, ulp);
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -110,5 +160,108 @@ int32_t main(int32_t argc, char **argv) {
 		print3("zyx: ", Quaternion::rotateZYX(Quaternion::rotateZYX(x, y, z).getRotateZYX()).getRotateZYX());
 	}
 	
+	{
+		TS_LOG(Message, "\n");
+		
+		constexpr uint32_t size = 256 * 1024 + 3;
+		constexpr uint32_t num_iterations = 8;
+		
+		Random<> random(1);
+		Array<Quaternionf> q0(size);
+		Array<Quaternionf> q1(size);
+		Array<Vector3f> vectors(size);
+		for(uint32_t i = 0; i < size; i++) {
+			q0[i] = normalize(Quaternionf(random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f)));
+			q1[i] = normalize(Quaternionf(random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f)));
+			vectors[i] = Vector3f(random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f), random.getf32(-1.0f, 1.0f));
+		}
+		
+		// nearly parallel quaternions take the linear slerp path
+		for(uint32_t i = 0; i < size; i += 7) q1[i] = q0[i];
+		
+		Array<Quaternionf> scalar_dest(size);
+		Array<Quaternionf> batch_dest(size);
+		float32_t k = 0.3f;
+		
+		// normalize
+		Array<Quaternionf> src(size);
+		for(uint32_t i = 0; i < size; i++) src[i] = Quaternionf(q0[i].x * 3.0f, q0[i].y * 3.0f, q0[i].z * 3.0f, q0[i].w * 3.0f);
+		uint64_t scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = normalize(src[i]);
+		});
+		uint64_t batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::normalize(batch_dest.get(), src.get(), size);
+		});
+		float32_t ulp = get_ulp(batch_dest[0].q, scalar_dest[0].q, size * 4);
+		print_time("normalize: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 1.0f) return 1;
+		
+		// multiply
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = q0[i] * q1[i];
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::mul(batch_dest.get(), q0.get(), q1.get(), size);
+		});
+		ulp = get_ulp(batch_dest[0].q, scalar_dest[0].q, size * 4);
+		print_time("mul: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 1.0f) return 1;
+		
+		// normalized linear interpolation
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) {
+				const Quaternionf &a = q0[i];
+				const Quaternionf &b = q1[i];
+				float32_t s = (dot(a, b) < 0.0f) ? -k : k;
+				scalar_dest[i] = normalize(Quaternionf(a.x * (1.0f - k) + b.x * s, a.y * (1.0f - k) + b.y * s, a.z * (1.0f - k) + b.z * s, a.w * (1.0f - k) + b.w * s));
+			}
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::nlerp(batch_dest.get(), q0.get(), q1.get(), k, size);
+		});
+		ulp = get_ulp(batch_dest[0].q, scalar_dest[0].q, size * 4);
+		print_time("nlerp: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 1.0f) return 1;
+		
+		// spherical interpolation
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_dest[i] = slerp(q0[i], q1[i], k);
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::slerp(batch_dest.get(), q0.get(), q1.get(), k, size);
+		});
+		// the vector sine and arctangent differ from the scalar ones by a few ulp
+		ulp = get_length_ulp(batch_dest.get(), scalar_dest.get(), size);
+		print_time("slerp: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 8.0f) return 1;
+		
+		// vector rotation
+		Array<Vector3f> scalar_vectors(size);
+		Array<Vector3f> batch_vectors(size);
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_vectors[i] = q0[i] * vectors[i];
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::rotate(batch_vectors.get(), q0.get(), vectors.get(), size);
+		});
+		ulp = get_ulp(batch_vectors[0].v, scalar_vectors[0].v, size * 3);
+		print_time("rotate: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 1.0f) return 1;
+		
+		// rotation matrices
+		Array<Matrix4x4f> scalar_matrices(size);
+		Array<Matrix4x3f> batch_matrices(size);
+		scalar_time = get_time(num_iterations, [&]() {
+			for(uint32_t i = 0; i < size; i++) scalar_matrices[i] = Matrix4x4f(q0[i]);
+		});
+		batch_time = get_time(num_iterations, [&]() {
+			BatchQuaternion::getMatrix(batch_matrices.get(), q0.get(), size);
+		});
+		ulp = 0.0f;
+		for(uint32_t i = 0; i < size; i++) ulp = max(ulp, get_ulp(batch_matrices[i].m, scalar_matrices[i].m, 12));
+		print_time("matrix: ", size, scalar_time, batch_time, ulp);
+		if(ulp > 1.0f) return 1;
+	}
+	
 	return 0;
 }
@@ -0,0 +1,285 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_QUATERNION_BATCH_H__
+#define __TELLUSIM_TESTS_QUATERNION_BATCH_H__
+
+#include <math/TellusimSimd.h>
+#include <math/TellusimMatrix.h>
+#include <math/TellusimQuaternion.h>
+
+#include "main_simd_math.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	class BatchQuaternion {
+			
+		public:
+			
+			/// normalizes quaternions, in-place operation is allowed
+			static void normalize(Quaternionf *dest, const Quaternionf *src, uint32_t size) {
+				Lanes q;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(q, src + i, num);
+					store(dest + i, normalize(q), num);
+				}
+			}
+			
+			/// multiplies quaternions, the result is q0 * q1
+			static void mul(Quaternionf *dest, const Quaternionf *q0, const Quaternionf *q1, uint32_t size) {
+				Lanes a, b, r;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(a, q0 + i, num);
+					load(b, q1 + i, num);
+					r.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+					r.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+					r.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+					r.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+					store(dest + i, r, num);
+				}
+			}
+			
+			/// normalized linear interpolation along the shortest arc
+			static void nlerp(Quaternionf *dest, const Quaternionf *q0, const Quaternionf *q1, float32_t k, uint32_t size) {
+				const float32x8_t k0 = float32x8_t(1.0f - k);
+				const float32x8_t k1 = float32x8_t(k);
+				Lanes a, b, r;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(a, q0 + i, num);
+					load(b, q1 + i, num);
+					float32x8_t s = simd_xor(k1, simd_sign(dot(a, b)));
+					r.x = a.x * k0 + b.x * s;
+					r.y = a.y * k0 + b.y * s;
+					r.z = a.z * k0 + b.z * s;
+					r.w = a.w * k0 + b.w * s;
+					store(dest + i, normalize(r), num);
+				}
+			}
+			
+			/// spherical linear interpolation along the shortest arc
+			/// nearly parallel quaternions are interpolated linearly
+			static void slerp(Quaternionf *dest, const Quaternionf *q0, const Quaternionf *q1, float32_t k, uint32_t size) {
+				const float32x8_t k0 = float32x8_t(1.0f - k);
+				const float32x8_t k1 = float32x8_t(k);
+				const float32x8_t one = float32x8_t(1.0f);
+				Lanes a, b, r;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(a, q0 + i, num);
+					load(b, q1 + i, num);
+					
+					// the angle from the sine and the cosine is accurate over the whole range
+					float32x8_t c = dot(a, b);
+					float32x8_t sign = simd_sign(c);
+					c = simd_abs(c);
+					float32x8_t angle = atan2(sqrt((one - c) * (one + c)), c);
+					float32x8_t is = one / sin(angle);
+					
+					// the linear weights for the nearly parallel quaternions
+					float32x8_t linear = c - 0.9999f;
+					float32x8_t w0 = select(k0, sin(k0 * angle) * is, linear);
+					float32x8_t w1 = simd_xor(select(k1, sin(k1 * angle) * is, linear), sign);
+					
+					r.x = a.x * w0 + b.x * w1;
+					r.y = a.y * w0 + b.y * w1;
+					r.z = a.z * w0 + b.z * w1;
+					r.w = a.w * w0 + b.w * w1;
+					store(dest + i, r, num);
+				}
+			}
+			
+			/// rotates vectors by unit quaternions, the result is q * v * conjugate(q)
+			static void rotate(Vector3f *dest, const Quaternionf *q, const Vector3f *v, uint32_t size) {
+				Lanes a;
+				float32x8_t x, y, z;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(a, q + i, num);
+					load(x, y, z, v + i, num);
+					
+					// t = cross(q.xyz, v) * 2
+					float32x8_t tx = (a.y * z - a.z * y) * 2.0f;
+					float32x8_t ty = (a.z * x - a.x * z) * 2.0f;
+					float32x8_t tz = (a.x * y - a.y * x) * 2.0f;
+					
+					// v + t * q.w + cross(q.xyz, t)
+					x = x + tx * a.w + (a.y * tz - a.z * ty);
+					y = y + ty * a.w + (a.z * tx - a.x * tz);
+					z = z + tz * a.w + (a.x * ty - a.y * tx);
+					store(dest + i, x, y, z, num);
+				}
+			}
+			
+			/// converts unit quaternions to rotation matrices
+			static void getMatrix(Matrix4x3f *dest, const Quaternionf *q, uint32_t size) {
+				TS_STATIC_ASSERT(sizeof(Matrix4x3f) == sizeof(float32_t) * 12);
+				const float32x8_t one = float32x8_t(1.0f);
+				TS_ALIGNAS32 float32_t data[12][8];
+				Lanes a;
+				for(uint32_t i = 0; i < size; i += 8) {
+					uint32_t num = min(size - i, 8u);
+					load(a, q + i, num);
+					float32x8_t x2 = a.x + a.x;
+					float32x8_t y2 = a.y + a.y;
+					float32x8_t z2 = a.z + a.z;
+					float32x8_t xx = a.x * x2, yy = a.y * y2, zz = a.z * z2;
+					float32x8_t xy = a.x * y2, xz = a.x * z2, yz = a.y * z2;
+					float32x8_t wx = a.w * x2, wy = a.w * y2, wz = a.w * z2;
+					(one - (yy + zz)).get(data[0]);
+					(xy - wz).get(data[1]);
+					(xz + wy).get(data[2]);
+					(xy + wz).get(data[4]);
+					(one - (xx + zz)).get(data[5]);
+					(yz - wx).get(data[6]);
+					(xz - wy).get(data[8]);
+					(yz + wx).get(data[9]);
+					(one - (xx + yy)).get(data[10]);
+					for(uint32_t j = 0; j < num; j++) {
+						float32_t *d = dest[i + j].m;
+						d[0] = data[0][j]; d[1] = data[1][j]; d[2] = data[2][j]; d[3] = 0.0f;
+						d[4] = data[4][j]; d[5] = data[5][j]; d[6] = data[6][j]; d[7] = 0.0f;
+						d[8] = data[8][j]; d[9] = data[9][j]; d[10] = data[10][j]; d[11] = 0.0f;
+					}
+				}
+			}
+			
+		private:
+			
+			/// quaternion components
+			struct Lanes {
+				float32x8_t x, y, z, w;
+			};
+			
+			static TS_INLINE float32x8_t dot(const Lanes &a, const Lanes &b) {
+				return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+			}
+			
+			/// full precision division keeps the results identical to the scalar normalization
+			static TS_INLINE Lanes normalize(const Lanes &q) {
+				float32x8_t ilength = float32x8_t(1.0f) / sqrt(dot(q, q));
+				return Lanes { q.x * ilength, q.y * ilength, q.z * ilength, q.w * ilength };
+			}
+			
+			/// AoS to SoA conversion of the num quaternions, the remaining lanes are identity
+			static TS_INLINE void load(Lanes &q, const Quaternionf *src, uint32_t num) {
+				TS_STATIC_ASSERT(sizeof(Quaternionf) == sizeof(float32_t) * 4);
+				#if TS_AVX
+					if(num == 8) {
+						const float32_t *s = src->q;
+						__m256 m04 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 0)), _mm_loadu_ps(s + 16), 1);
+						__m256 m15 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 4)), _mm_loadu_ps(s + 20), 1);
+						__m256 m26 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 8)), _mm_loadu_ps(s + 24), 1);
+						__m256 m37 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + 12)), _mm_loadu_ps(s + 28), 1);
+						__m256 xy01 = _mm256_unpacklo_ps(m04, m15);
+						__m256 zw01 = _mm256_unpackhi_ps(m04, m15);
+						__m256 xy23 = _mm256_unpacklo_ps(m26, m37);
+						__m256 zw23 = _mm256_unpackhi_ps(m26, m37);
+						q.x = float32x8_t(_mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0)));
+						q.y = float32x8_t(_mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2)));
+						q.z = float32x8_t(_mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0)));
+						q.w = float32x8_t(_mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(3, 2, 3, 2)));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[4][8];
+				for(uint32_t i = 0; i < 8; i++) {
+					const Quaternionf &s = (i < num) ? src[i] : Quaternionf();
+					data[0][i] = s.x;
+					data[1][i] = s.y;
+					data[2][i] = s.z;
+					data[3][i] = s.w;
+				}
+				q.x = float32x8_t(data[0]);
+				q.y = float32x8_t(data[1]);
+				q.z = float32x8_t(data[2]);
+				q.w = float32x8_t(data[3]);
+			}
+			
+			/// SoA to AoS conversion of the num quaternions
+			static TS_INLINE void store(Quaternionf *dest, const Lanes &q, uint32_t num) {
+				#if TS_AVX
+					if(num == 8) {
+						float32_t *d = dest->q;
+						__m256 xy01 = _mm256_unpacklo_ps(q.x.vec, q.y.vec);
+						__m256 xy23 = _mm256_unpackhi_ps(q.x.vec, q.y.vec);
+						__m256 zw01 = _mm256_unpacklo_ps(q.z.vec, q.w.vec);
+						__m256 zw23 = _mm256_unpackhi_ps(q.z.vec, q.w.vec);
+						__m256 m04 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+						__m256 m15 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+						__m256 m26 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+						__m256 m37 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+						_mm_storeu_ps(d + 0, _mm256_castps256_ps128(m04));
+						_mm_storeu_ps(d + 4, _mm256_castps256_ps128(m15));
+						_mm_storeu_ps(d + 8, _mm256_castps256_ps128(m26));
+						_mm_storeu_ps(d + 12, _mm256_castps256_ps128(m37));
+						_mm_storeu_ps(d + 16, _mm256_extractf128_ps(m04, 1));
+						_mm_storeu_ps(d + 20, _mm256_extractf128_ps(m15, 1));
+						_mm_storeu_ps(d + 24, _mm256_extractf128_ps(m26, 1));
+						_mm_storeu_ps(d + 28, _mm256_extractf128_ps(m37, 1));
+						return;
+					}
+				#endif
+				TS_ALIGNAS32 float32_t data[4][8];
+				q.x.get(data[0]);
+				q.y.get(data[1]);
+				q.z.get(data[2]);
+				q.w.get(data[3]);
+				for(uint32_t i = 0; i < num; i++) {
+					dest[i] = Quaternionf(data[0][i], data[1][i], data[2][i], data[3][i]);
+				}
+			}
+			
+			/// AoS to SoA conversion of the num vectors, the remaining lanes are zero
+			static TS_INLINE void load(float32x8_t &x, float32x8_t &y, float32x8_t &z, const Vector3f *src, uint32_t num) {
+				TS_STATIC_ASSERT(sizeof(Vector3f) == sizeof(float32_t) * 3);
+				TS_ALIGNAS32 float32_t data[3][8] = {};
+				for(uint32_t i = 0; i < num; i++) {
+					data[0][i] = src[i].x;
+					data[1][i] = src[i].y;
+					data[2][i] = src[i].z;
+				}
+				x = float32x8_t(data[0]);
+				y = float32x8_t(data[1]);
+				z = float32x8_t(data[2]);
+			}
+			
+			/// SoA to AoS conversion of the num vectors
+			static TS_INLINE void store(Vector3f *dest, const float32x8_t &x, const float32x8_t &y, const float32x8_t &z, uint32_t num) {
+				TS_ALIGNAS32 float32_t data[3][8];
+				x.get(data[0]);
+				y.get(data[1]);
+				z.get(data[2]);
+				for(uint32_t i = 0; i < num; i++) {
+					dest[i] = Vector3f(data[0][i], data[1][i], data[2][i]);
+				}
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_QUATERNION_BATCH_H__ */
@@ -0,0 +1,1038 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_SIMD16_H__
+#define __TELLUSIM_TESTS_SIMD16_H__
+
+#include <math/TellusimSimd.h>
+
+#if TS_SSE
+	#include <immintrin.h>
+	#if _WIN32
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+/*
+ */
+#ifndef TS_AVX512
+	#if defined(__AVX512F__) && defined(__AVX512DQ__)
+		#define TS_AVX512	1
+	#else
+		#define TS_AVX512	0
+	#endif
+#endif
+
+/*
+ */
+#if TS_SSE && !_WIN32
+	#define TS_TARGET_AVX2		__attribute__((target("avx2,fma")))
+	#define TS_TARGET_AVX512	__attribute__((target("avx2,fma,avx512f,avx512dq")))
+#else
+	#define TS_TARGET_AVX2
+	#define TS_TARGET_AVX512
+#endif
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	struct int32x16_t;
+	struct uint32x16_t;
+	struct float32x16_t;
+	
+	/*****************************************************************************\
+	 *
+	 * int32x16_t
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	struct TS_ALIGNAS64 int32x16_t {
+		
+		int32x16_t() { }
+		#if TS_AVX512
+			int32x16_t(__m512i v) : vec(v) { }
+			explicit int32x16_t(int32_t v) : vec(_mm512_set1_epi32(v)) { }
+			explicit int32x16_t(const int32_t *v) : vec(_mm512_loadu_si512(v)) { }
+			int32x16_t(const int32x8_t &lo, const int32x8_t &hi) : vec(_mm512_inserti64x4(_mm512_castsi256_si512(lo.vec), hi.vec, 1)) { }
+		#else
+			explicit int32x16_t(int32_t v) : lo(v), hi(v) { }
+			explicit int32x16_t(const int32_t *v) { TS_ALIGNAS32 int32_t data[16]; memcpy(data, v, sizeof(data)); lo = int32x8_t(data); hi = int32x8_t(data + 8); }
+			int32x16_t(const int32x8_t &lo, const int32x8_t &hi) : lo(lo), hi(hi) { }
+		#endif
+		int32x16_t(int32_t x0, int32_t y0, int32_t z0, int32_t w0, int32_t x1, int32_t y1, int32_t z1, int32_t w1,
+			int32_t x2, int32_t y2, int32_t z2, int32_t w2, int32_t x3, int32_t y3, int32_t z3, int32_t w3) :
+			int32x16_t(int32x8_t(x0, y0, z0, w0, x1, y1, z1, w1), int32x8_t(x2, y2, z2, w2, x3, y3, z3, w3)) { }
+		explicit int32x16_t(const uint32x16_t &v);
+		explicit int32x16_t(const float32x16_t &v);
+		
+		/// cast vector data
+		TS_INLINE uint32x16_t asu32x16() const;
+		TS_INLINE float32x16_t asf32x16() const;
+		
+		/// vector halves
+		#if TS_AVX512
+			TS_INLINE int32x8_t getLo() const { return int32x8_t(_mm512_castsi512_si256(vec)); }
+			TS_INLINE int32x8_t getHi() const { return int32x8_t(_mm512_extracti64x4_epi64(vec, 1)); }
+		#else
+			TS_INLINE const int32x8_t &getLo() const { return lo; }
+			TS_INLINE const int32x8_t &getHi() const { return hi; }
+		#endif
+		
+		/// update vector data
+		template <uint32_t Index> void set(int32_t v) {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				vec = _mm512_mask_set1_epi32(vec, (__mmask16)(1u << Index), v);
+			#else
+				if(Index < 8) lo.template set<(Index & 7)>(v);
+				else hi.template set<(Index & 7)>(v);
+			#endif
+		}
+		
+		/// vector data
+		template <uint32_t Index> int32_t get() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return v[Index];
+			#else
+				if(Index < 8) return lo.template get<(Index & 7)>();
+				return hi.template get<(Index & 7)>();
+			#endif
+		}
+		void get(int32_t *v) const {
+			#if TS_AVX512
+				_mm512_storeu_si512(v, vec);
+			#else
+				for(uint32_t i = 0; i < 8; i++) v[i] = lo.v[i];
+				for(uint32_t i = 0; i < 8; i++) v[i + 8] = hi.v[i];
+			#endif
+		}
+		
+		/// broadcast vector element
+		template <uint32_t Index> int32x16_t get16() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return int32x16_t(_mm512_permutexvar_epi32(_mm512_set1_epi32(Index), vec));
+			#else
+				return int32x16_t(get<Index>());
+			#endif
+		}
+		
+		/// swizzle vector quads
+		#if TS_AVX512
+			TS_INLINE int32x16_t zwxy0123() const { return int32x16_t(_mm512_shuffle_epi32(vec, (_MM_PERM_ENUM)0x4e)); }
+			TS_INLINE int32x16_t yxwz0123() const { return int32x16_t(_mm512_shuffle_epi32(vec, (_MM_PERM_ENUM)0xb1)); }
+			TS_INLINE int32x16_t xyzw1032() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xb1)); }
+			TS_INLINE int32x16_t xyzw2301() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x4e)); }
+			TS_INLINE int32x16_t xyzw0() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x00)); }
+			TS_INLINE int32x16_t xyzw1() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x55)); }
+			TS_INLINE int32x16_t xyzw2() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xaa)); }
+			TS_INLINE int32x16_t xyzw3() const { return int32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xff)); }
+		#else
+			TS_INLINE int32x16_t zwxy0123() const { return int32x16_t(lo.zwxy01(), hi.zwxy01()); }
+			TS_INLINE int32x16_t yxwz0123() const { return int32x16_t(lo.yxwz01(), hi.yxwz01()); }
+			TS_INLINE int32x16_t xyzw1032() const { return int32x16_t(lo.xyzw10(), hi.xyzw10()); }
+			TS_INLINE int32x16_t xyzw2301() const { return int32x16_t(hi, lo); }
+			TS_INLINE int32x16_t xyzw0() const { int32x8_t v = lo.xyzw0(); return int32x16_t(v, v); }
+			TS_INLINE int32x16_t xyzw1() const { int32x8_t v = lo.xyzw1(); return int32x16_t(v, v); }
+			TS_INLINE int32x16_t xyzw2() const { int32x8_t v = hi.xyzw0(); return int32x16_t(v, v); }
+			TS_INLINE int32x16_t xyzw3() const { int32x8_t v = hi.xyzw1(); return int32x16_t(v, v); }
+		#endif
+		
+		/// sum vector components
+		TS_INLINE int32_t sum() const {
+			#if TS_AVX512
+				return _mm512_reduce_add_epi32(vec);
+			#else
+				return (lo + hi).sum();
+			#endif
+		}
+		
+		#if TS_AVX512
+			union {
+				__m512i vec;
+				int32_t v[16];
+			};
+		#else
+			int32x8_t lo, hi;
+		#endif
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * uint32x16_t
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	struct TS_ALIGNAS64 uint32x16_t {
+		
+		uint32x16_t() { }
+		#if TS_AVX512
+			uint32x16_t(__m512i v) : vec(v) { }
+			explicit uint32x16_t(uint32_t v) : vec(_mm512_set1_epi32((int32_t)v)) { }
+			explicit uint32x16_t(const uint32_t *v) : vec(_mm512_loadu_si512(v)) { }
+			uint32x16_t(const uint32x8_t &lo, const uint32x8_t &hi) : vec(_mm512_inserti64x4(_mm512_castsi256_si512(lo.vec), hi.vec, 1)) { }
+		#else
+			explicit uint32x16_t(uint32_t v) : lo(v), hi(v) { }
+			explicit uint32x16_t(const uint32_t *v) { TS_ALIGNAS32 uint32_t data[16]; memcpy(data, v, sizeof(data)); lo = uint32x8_t(data); hi = uint32x8_t(data + 8); }
+			uint32x16_t(const uint32x8_t &lo, const uint32x8_t &hi) : lo(lo), hi(hi) { }
+		#endif
+		uint32x16_t(uint32_t x0, uint32_t y0, uint32_t z0, uint32_t w0, uint32_t x1, uint32_t y1, uint32_t z1, uint32_t w1,
+			uint32_t x2, uint32_t y2, uint32_t z2, uint32_t w2, uint32_t x3, uint32_t y3, uint32_t z3, uint32_t w3) :
+			uint32x16_t(uint32x8_t(x0, y0, z0, w0, x1, y1, z1, w1), uint32x8_t(x2, y2, z2, w2, x3, y3, z3, w3)) { }
+		explicit uint32x16_t(const int32x16_t &v);
+		explicit uint32x16_t(const float32x16_t &v);
+		
+		/// cast vector data
+		TS_INLINE int32x16_t asi32x16() const;
+		TS_INLINE float32x16_t asf32x16() const;
+		
+		/// vector halves
+		#if TS_AVX512
+			TS_INLINE uint32x8_t getLo() const { return uint32x8_t(_mm512_castsi512_si256(vec)); }
+			TS_INLINE uint32x8_t getHi() const { return uint32x8_t(_mm512_extracti64x4_epi64(vec, 1)); }
+		#else
+			TS_INLINE const uint32x8_t &getLo() const { return lo; }
+			TS_INLINE const uint32x8_t &getHi() const { return hi; }
+		#endif
+		
+		/// update vector data
+		template <uint32_t Index> void set(uint32_t v) {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				vec = _mm512_mask_set1_epi32(vec, (__mmask16)(1u << Index), (int32_t)v);
+			#else
+				if(Index < 8) lo.template set<(Index & 7)>(v);
+				else hi.template set<(Index & 7)>(v);
+			#endif
+		}
+		
+		/// vector data
+		template <uint32_t Index> uint32_t get() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return v[Index];
+			#else
+				if(Index < 8) return lo.template get<(Index & 7)>();
+				return hi.template get<(Index & 7)>();
+			#endif
+		}
+		void get(uint32_t *v) const {
+			#if TS_AVX512
+				_mm512_storeu_si512(v, vec);
+			#else
+				for(uint32_t i = 0; i < 8; i++) v[i] = lo.v[i];
+				for(uint32_t i = 0; i < 8; i++) v[i + 8] = hi.v[i];
+			#endif
+		}
+		
+		/// broadcast vector element
+		template <uint32_t Index> uint32x16_t get16() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return uint32x16_t(_mm512_permutexvar_epi32(_mm512_set1_epi32(Index), vec));
+			#else
+				return uint32x16_t(get<Index>());
+			#endif
+		}
+		
+		/// swizzle vector quads
+		#if TS_AVX512
+			TS_INLINE uint32x16_t zwxy0123() const { return uint32x16_t(_mm512_shuffle_epi32(vec, (_MM_PERM_ENUM)0x4e)); }
+			TS_INLINE uint32x16_t yxwz0123() const { return uint32x16_t(_mm512_shuffle_epi32(vec, (_MM_PERM_ENUM)0xb1)); }
+			TS_INLINE uint32x16_t xyzw1032() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xb1)); }
+			TS_INLINE uint32x16_t xyzw2301() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x4e)); }
+			TS_INLINE uint32x16_t xyzw0() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x00)); }
+			TS_INLINE uint32x16_t xyzw1() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0x55)); }
+			TS_INLINE uint32x16_t xyzw2() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xaa)); }
+			TS_INLINE uint32x16_t xyzw3() const { return uint32x16_t(_mm512_shuffle_i32x4(vec, vec, 0xff)); }
+		#else
+			TS_INLINE uint32x16_t zwxy0123() const { return uint32x16_t(lo.zwxy01(), hi.zwxy01()); }
+			TS_INLINE uint32x16_t yxwz0123() const { return uint32x16_t(lo.yxwz01(), hi.yxwz01()); }
+			TS_INLINE uint32x16_t xyzw1032() const { return uint32x16_t(lo.xyzw10(), hi.xyzw10()); }
+			TS_INLINE uint32x16_t xyzw2301() const { return uint32x16_t(hi, lo); }
+			TS_INLINE uint32x16_t xyzw0() const { uint32x8_t v = lo.xyzw0(); return uint32x16_t(v, v); }
+			TS_INLINE uint32x16_t xyzw1() const { uint32x8_t v = lo.xyzw1(); return uint32x16_t(v, v); }
+			TS_INLINE uint32x16_t xyzw2() const { uint32x8_t v = hi.xyzw0(); return uint32x16_t(v, v); }
+			TS_INLINE uint32x16_t xyzw3() const { uint32x8_t v = hi.xyzw1(); return uint32x16_t(v, v); }
+		#endif
+		
+		/// sum vector components
+		TS_INLINE uint32_t sum() const {
+			#if TS_AVX512
+				return (uint32_t)_mm512_reduce_add_epi32(vec);
+			#else
+				return (lo + hi).sum();
+			#endif
+		}
+		
+		#if TS_AVX512
+			union {
+				__m512i vec;
+				uint32_t v[16];
+			};
+		#else
+			uint32x8_t lo, hi;
+		#endif
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * float32x16_t
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	struct TS_ALIGNAS64 float32x16_t {
+		
+		float32x16_t() { }
+		#if TS_AVX512
+			float32x16_t(__m512 v) : vec(v) { }
+			explicit float32x16_t(float32_t v) : vec(_mm512_set1_ps(v)) { }
+			explicit float32x16_t(const float32_t *v) : vec(_mm512_loadu_ps(v)) { }
+			float32x16_t(const float32x8_t &lo, const float32x8_t &hi) : vec(_mm512_insertf32x8(_mm512_castps256_ps512(lo.vec), hi.vec, 1)) { }
+		#else
+			explicit float32x16_t(float32_t v) : lo(v), hi(v) { }
+			explicit float32x16_t(const float32_t *v) { TS_ALIGNAS32 float32_t data[16]; memcpy(data, v, sizeof(data)); lo = float32x8_t(data); hi = float32x8_t(data + 8); }
+			float32x16_t(const float32x8_t &lo, const float32x8_t &hi) : lo(lo), hi(hi) { }
+		#endif
+		float32x16_t(float32_t x0, float32_t y0, float32_t z0, float32_t w0, float32_t x1, float32_t y1, float32_t z1, float32_t w1,
+			float32_t x2, float32_t y2, float32_t z2, float32_t w2, float32_t x3, float32_t y3, float32_t z3, float32_t w3) :
+			float32x16_t(float32x8_t(x0, y0, z0, w0, x1, y1, z1, w1), float32x8_t(x2, y2, z2, w2, x3, y3, z3, w3)) { }
+		explicit float32x16_t(const int32x16_t &v);
+		explicit float32x16_t(const uint32x16_t &v);
+		
+		/// cast vector data
+		TS_INLINE int32x16_t asi32x16() const;
+		TS_INLINE uint32x16_t asu32x16() const;
+		
+		/// vector halves
+		#if TS_AVX512
+			TS_INLINE float32x8_t getLo() const { return float32x8_t(_mm512_castps512_ps256(vec)); }
+			TS_INLINE float32x8_t getHi() const { return float32x8_t(_mm512_extractf32x8_ps(vec, 1)); }
+		#else
+			TS_INLINE const float32x8_t &getLo() const { return lo; }
+			TS_INLINE const float32x8_t &getHi() const { return hi; }
+		#endif
+		
+		/// update vector data
+		template <uint32_t Index> void set(float32_t v) {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				vec = _mm512_mask_mov_ps(vec, (__mmask16)(1u << Index), _mm512_set1_ps(v));
+			#else
+				if(Index < 8) lo.template set<(Index & 7)>(v);
+				else hi.template set<(Index & 7)>(v);
+			#endif
+		}
+		
+		/// vector data
+		template <uint32_t Index> float32_t get() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return v[Index];
+			#else
+				if(Index < 8) return lo.template get<(Index & 7)>();
+				return hi.template get<(Index & 7)>();
+			#endif
+		}
+		void get(float32_t *v) const {
+			#if TS_AVX512
+				_mm512_storeu_ps(v, vec);
+			#else
+				for(uint32_t i = 0; i < 8; i++) v[i] = lo.v[i];
+				for(uint32_t i = 0; i < 8; i++) v[i + 8] = hi.v[i];
+			#endif
+		}
+		
+		/// broadcast vector element
+		template <uint32_t Index> float32x16_t get16() const {
+			TS_STATIC_ASSERT(Index < 16);
+			#if TS_AVX512
+				return float32x16_t(_mm512_permutexvar_ps(_mm512_set1_epi32(Index), vec));
+			#else
+				return float32x16_t(get<Index>());
+			#endif
+		}
+		
+		/// swizzle vector quads
+		#if TS_AVX512
+			TS_INLINE float32x16_t zwxy0123() const { return float32x16_t(_mm512_permute_ps(vec, 0x4e)); }
+			TS_INLINE float32x16_t yxwz0123() const { return float32x16_t(_mm512_permute_ps(vec, 0xb1)); }
+			TS_INLINE float32x16_t xyzw1032() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0xb1)); }
+			TS_INLINE float32x16_t xyzw2301() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0x4e)); }
+			TS_INLINE float32x16_t xyzw0() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0x00)); }
+			TS_INLINE float32x16_t xyzw1() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0x55)); }
+			TS_INLINE float32x16_t xyzw2() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0xaa)); }
+			TS_INLINE float32x16_t xyzw3() const { return float32x16_t(_mm512_shuffle_f32x4(vec, vec, 0xff)); }
+		#else
+			TS_INLINE float32x16_t zwxy0123() const { return float32x16_t(lo.zwxy01(), hi.zwxy01()); }
+			TS_INLINE float32x16_t yxwz0123() const { return float32x16_t(lo.yxwz01(), hi.yxwz01()); }
+			TS_INLINE float32x16_t xyzw1032() const { return float32x16_t(lo.xyzw10(), hi.xyzw10()); }
+			TS_INLINE float32x16_t xyzw2301() const { return float32x16_t(hi, lo); }
+			TS_INLINE float32x16_t xyzw0() const { float32x8_t v = lo.xyzw0(); return float32x16_t(v, v); }
+			TS_INLINE float32x16_t xyzw1() const { float32x8_t v = lo.xyzw1(); return float32x16_t(v, v); }
+			TS_INLINE float32x16_t xyzw2() const { float32x8_t v = hi.xyzw0(); return float32x16_t(v, v); }
+			TS_INLINE float32x16_t xyzw3() const { float32x8_t v = hi.xyzw1(); return float32x16_t(v, v); }
+		#endif
+		
+		/// sum vector components
+		TS_INLINE float32_t sum() const {
+			#if TS_AVX512
+				return _mm512_reduce_add_ps(vec);
+			#else
+				return (lo + hi).sum();
+			#endif
+		}
+		
+		#if TS_AVX512
+			union {
+				__m512 vec;
+				float32_t v[16];
+			};
+		#else
+			float32x8_t lo, hi;
+		#endif
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * Type conversion
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE int32x16_t::int32x16_t(const uint32x16_t &v) : vec(v.vec) { }
+		TS_INLINE int32x16_t::int32x16_t(const float32x16_t &v) : vec(_mm512_cvttps_epi32(v.vec)) { }
+		TS_INLINE uint32x16_t::uint32x16_t(const int32x16_t &v) : vec(v.vec) { }
+		TS_INLINE uint32x16_t::uint32x16_t(const float32x16_t &v) : vec(_mm512_cvttps_epu32(v.vec)) { }
+		TS_INLINE float32x16_t::float32x16_t(const int32x16_t &v) : vec(_mm512_cvtepi32_ps(v.vec)) { }
+		TS_INLINE float32x16_t::float32x16_t(const uint32x16_t &v) : vec(_mm512_cvtepu32_ps(v.vec)) { }
+		TS_INLINE uint32x16_t int32x16_t::asu32x16() const { return uint32x16_t(vec); }
+		TS_INLINE float32x16_t int32x16_t::asf32x16() const { return float32x16_t(_mm512_castsi512_ps(vec)); }
+		TS_INLINE int32x16_t uint32x16_t::asi32x16() const { return int32x16_t(vec); }
+		TS_INLINE float32x16_t uint32x16_t::asf32x16() const { return float32x16_t(_mm512_castsi512_ps(vec)); }
+		TS_INLINE int32x16_t float32x16_t::asi32x16() const { return int32x16_t(_mm512_castps_si512(vec)); }
+		TS_INLINE uint32x16_t float32x16_t::asu32x16() const { return uint32x16_t(_mm512_castps_si512(vec)); }
+	#else
+		TS_INLINE int32x16_t::int32x16_t(const uint32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE int32x16_t::int32x16_t(const float32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE uint32x16_t::uint32x16_t(const int32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE uint32x16_t::uint32x16_t(const float32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE float32x16_t::float32x16_t(const int32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE float32x16_t::float32x16_t(const uint32x16_t &v) : lo(v.lo), hi(v.hi) { }
+		TS_INLINE uint32x16_t int32x16_t::asu32x16() const { return uint32x16_t(lo.asu32x8(), hi.asu32x8()); }
+		TS_INLINE float32x16_t int32x16_t::asf32x16() const { return float32x16_t(lo.asf32x8(), hi.asf32x8()); }
+		TS_INLINE int32x16_t uint32x16_t::asi32x16() const { return int32x16_t(lo.asi32x8(), hi.asi32x8()); }
+		TS_INLINE float32x16_t uint32x16_t::asf32x16() const { return float32x16_t(lo.asf32x8(), hi.asf32x8()); }
+		TS_INLINE int32x16_t float32x16_t::asi32x16() const { return int32x16_t(lo.asi32x8(), hi.asi32x8()); }
+		TS_INLINE uint32x16_t float32x16_t::asu32x16() const { return uint32x16_t(lo.asu32x8(), hi.asu32x8()); }
+	#endif
+	
+	/*****************************************************************************\
+	 *
+	 * int32x16_t operators
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE int32x16_t operator-(const int32x16_t &v) { return int32x16_t(_mm512_sub_epi32(_mm512_setzero_si512(), v.vec)); }
+		TS_INLINE int32x16_t operator*(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_mullo_epi32(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator+(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_add_epi32(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator-(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_sub_epi32(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator&(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_and_si512(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator|(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_or_si512(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator^(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_xor_si512(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t operator<<(const int32x16_t &v, uint32_t shift) { return int32x16_t(_mm512_sll_epi32(v.vec, _mm_cvtsi32_si128((int32_t)shift))); }
+		TS_INLINE int32x16_t operator>>(const int32x16_t &v, uint32_t shift) { return int32x16_t(_mm512_sra_epi32(v.vec, _mm_cvtsi32_si128((int32_t)shift))); }
+		TS_INLINE uint32_t operator<(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmplt_epi32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator>(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmpgt_epi32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator<=(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmple_epi32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator>=(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmpge_epi32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator==(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmpeq_epi32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator!=(const int32x16_t &v0, const int32x16_t &v1) { return _mm512_cmpneq_epi32_mask(v0.vec, v1.vec); }
+	#else
+		TS_INLINE int32x16_t operator-(const int32x16_t &v) { return int32x16_t(-v.lo, -v.hi); }
+		TS_INLINE int32x16_t operator*(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo * v1.lo, v0.hi * v1.hi); }
+		TS_INLINE int32x16_t operator+(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo + v1.lo, v0.hi + v1.hi); }
+		TS_INLINE int32x16_t operator-(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo - v1.lo, v0.hi - v1.hi); }
+		TS_INLINE int32x16_t operator&(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo & v1.lo, v0.hi & v1.hi); }
+		TS_INLINE int32x16_t operator|(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo | v1.lo, v0.hi | v1.hi); }
+		TS_INLINE int32x16_t operator^(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(v0.lo ^ v1.lo, v0.hi ^ v1.hi); }
+		TS_INLINE int32x16_t operator<<(const int32x16_t &v, uint32_t shift) { return int32x16_t(v.lo << shift, v.hi << shift); }
+		TS_INLINE int32x16_t operator>>(const int32x16_t &v, uint32_t shift) { return int32x16_t(v.lo >> shift, v.hi >> shift); }
+		TS_INLINE uint32_t operator<(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo < v1.lo) | ((v0.hi < v1.hi) << 8); }
+		TS_INLINE uint32_t operator>(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo > v1.lo) | ((v0.hi > v1.hi) << 8); }
+		TS_INLINE uint32_t operator<=(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo <= v1.lo) | ((v0.hi <= v1.hi) << 8); }
+		TS_INLINE uint32_t operator>=(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo >= v1.lo) | ((v0.hi >= v1.hi) << 8); }
+		TS_INLINE uint32_t operator==(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo == v1.lo) | ((v0.hi == v1.hi) << 8); }
+		TS_INLINE uint32_t operator!=(const int32x16_t &v0, const int32x16_t &v1) { return (v0.lo != v1.lo) | ((v0.hi != v1.hi) << 8); }
+	#endif
+	
+	TS_INLINE int32x16_t operator*(const int32x16_t &v0, int32_t v1) { return v0 * int32x16_t(v1); }
+	TS_INLINE int32x16_t operator+(const int32x16_t &v0, int32_t v1) { return v0 + int32x16_t(v1); }
+	TS_INLINE int32x16_t operator-(const int32x16_t &v0, int32_t v1) { return v0 - int32x16_t(v1); }
+	TS_INLINE int32x16_t operator&(const int32x16_t &v0, int32_t v1) { return v0 & int32x16_t(v1); }
+	TS_INLINE int32x16_t operator|(const int32x16_t &v0, int32_t v1) { return v0 | int32x16_t(v1); }
+	TS_INLINE int32x16_t operator^(const int32x16_t &v0, int32_t v1) { return v0 ^ int32x16_t(v1); }
+	
+	TS_INLINE int32x16_t &operator*=(int32x16_t &v0, const int32x16_t &v1) { return v0 = v0 * v1; }
+	TS_INLINE int32x16_t &operator+=(int32x16_t &v0, const int32x16_t &v1) { return v0 = v0 + v1; }
+	TS_INLINE int32x16_t &operator-=(int32x16_t &v0, const int32x16_t &v1) { return v0 = v0 - v1; }
+	
+	/*****************************************************************************\
+	 *
+	 * uint32x16_t operators
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE uint32x16_t operator*(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_mullo_epi32(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator+(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_add_epi32(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator-(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_sub_epi32(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator&(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_and_si512(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator|(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_or_si512(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator^(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_xor_si512(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t operator<<(const uint32x16_t &v, uint32_t shift) { return uint32x16_t(_mm512_sll_epi32(v.vec, _mm_cvtsi32_si128((int32_t)shift))); }
+		TS_INLINE uint32x16_t operator>>(const uint32x16_t &v, uint32_t shift) { return uint32x16_t(_mm512_srl_epi32(v.vec, _mm_cvtsi32_si128((int32_t)shift))); }
+		TS_INLINE uint32_t operator<(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmplt_epu32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator>(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmpgt_epu32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator<=(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmple_epu32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator>=(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmpge_epu32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator==(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmpeq_epu32_mask(v0.vec, v1.vec); }
+		TS_INLINE uint32_t operator!=(const uint32x16_t &v0, const uint32x16_t &v1) { return _mm512_cmpneq_epu32_mask(v0.vec, v1.vec); }
+	#else
+		TS_INLINE uint32x16_t operator*(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo * v1.lo, v0.hi * v1.hi); }
+		TS_INLINE uint32x16_t operator+(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo + v1.lo, v0.hi + v1.hi); }
+		TS_INLINE uint32x16_t operator-(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo - v1.lo, v0.hi - v1.hi); }
+		TS_INLINE uint32x16_t operator&(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo & v1.lo, v0.hi & v1.hi); }
+		TS_INLINE uint32x16_t operator|(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo | v1.lo, v0.hi | v1.hi); }
+		TS_INLINE uint32x16_t operator^(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(v0.lo ^ v1.lo, v0.hi ^ v1.hi); }
+		TS_INLINE uint32x16_t operator<<(const uint32x16_t &v, uint32_t shift) { return uint32x16_t(v.lo << shift, v.hi << shift); }
+		TS_INLINE uint32x16_t operator>>(const uint32x16_t &v, uint32_t shift) { return uint32x16_t(v.lo >> shift, v.hi >> shift); }
+		TS_INLINE uint32_t operator<(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo < v1.lo) | ((v0.hi < v1.hi) << 8); }
+		TS_INLINE uint32_t operator>(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo > v1.lo) | ((v0.hi > v1.hi) << 8); }
+		TS_INLINE uint32_t operator<=(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo <= v1.lo) | ((v0.hi <= v1.hi) << 8); }
+		TS_INLINE uint32_t operator>=(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo >= v1.lo) | ((v0.hi >= v1.hi) << 8); }
+		TS_INLINE uint32_t operator==(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo == v1.lo) | ((v0.hi == v1.hi) << 8); }
+		TS_INLINE uint32_t operator!=(const uint32x16_t &v0, const uint32x16_t &v1) { return (v0.lo != v1.lo) | ((v0.hi != v1.hi) << 8); }
+	#endif
+	
+	TS_INLINE uint32x16_t operator*(const uint32x16_t &v0, uint32_t v1) { return v0 * uint32x16_t(v1); }
+	TS_INLINE uint32x16_t operator+(const uint32x16_t &v0, uint32_t v1) { return v0 + uint32x16_t(v1); }
+	TS_INLINE uint32x16_t operator-(const uint32x16_t &v0, uint32_t v1) { return v0 - uint32x16_t(v1); }
+	TS_INLINE uint32x16_t operator&(const uint32x16_t &v0, uint32_t v1) { return v0 & uint32x16_t(v1); }
+	TS_INLINE uint32x16_t operator|(const uint32x16_t &v0, uint32_t v1) { return v0 | uint32x16_t(v1); }
+	TS_INLINE uint32x16_t operator^(const uint32x16_t &v0, uint32_t v1) { return v0 ^ uint32x16_t(v1); }
+	
+	TS_INLINE uint32x16_t &operator*=(uint32x16_t &v0, const uint32x16_t &v1) { return v0 = v0 * v1; }
+	TS_INLINE uint32x16_t &operator+=(uint32x16_t &v0, const uint32x16_t &v1) { return v0 = v0 + v1; }
+	TS_INLINE uint32x16_t &operator-=(uint32x16_t &v0, const uint32x16_t &v1) { return v0 = v0 - v1; }
+	
+	/*****************************************************************************\
+	 *
+	 * float32x16_t operators
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE float32x16_t operator-(const float32x16_t &v) { return float32x16_t(_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v.vec), _mm512_set1_epi32((int32_t)0x80000000u)))); }
+		TS_INLINE float32x16_t operator*(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_mul_ps(v0.vec, v1.vec)); }
+		TS_INLINE float32x16_t operator/(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_div_ps(v0.vec, v1.vec)); }
+		TS_INLINE float32x16_t operator+(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_add_ps(v0.vec, v1.vec)); }
+		TS_INLINE float32x16_t operator-(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_sub_ps(v0.vec, v1.vec)); }
+		TS_INLINE uint32_t operator<(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_LT_OQ); }
+		TS_INLINE uint32_t operator>(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_GT_OQ); }
+		TS_INLINE uint32_t operator<=(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_LE_OQ); }
+		TS_INLINE uint32_t operator>=(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_GE_OQ); }
+		TS_INLINE uint32_t operator==(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_EQ_OQ); }
+		TS_INLINE uint32_t operator!=(const float32x16_t &v0, const float32x16_t &v1) { return _mm512_cmp_ps_mask(v0.vec, v1.vec, _CMP_NEQ_UQ); }
+	#else
+		TS_INLINE float32x16_t operator-(const float32x16_t &v) { return float32x16_t(-v.lo, -v.hi); }
+		TS_INLINE float32x16_t operator*(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(v0.lo * v1.lo, v0.hi * v1.hi); }
+		TS_INLINE float32x16_t operator/(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(v0.lo / v1.lo, v0.hi / v1.hi); }
+		TS_INLINE float32x16_t operator+(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(v0.lo + v1.lo, v0.hi + v1.hi); }
+		TS_INLINE float32x16_t operator-(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(v0.lo - v1.lo, v0.hi - v1.hi); }
+		TS_INLINE uint32_t operator<(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo < v1.lo) | ((v0.hi < v1.hi) << 8); }
+		TS_INLINE uint32_t operator>(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo > v1.lo) | ((v0.hi > v1.hi) << 8); }
+		TS_INLINE uint32_t operator<=(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo <= v1.lo) | ((v0.hi <= v1.hi) << 8); }
+		TS_INLINE uint32_t operator>=(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo >= v1.lo) | ((v0.hi >= v1.hi) << 8); }
+		TS_INLINE uint32_t operator==(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo == v1.lo) | ((v0.hi == v1.hi) << 8); }
+		TS_INLINE uint32_t operator!=(const float32x16_t &v0, const float32x16_t &v1) { return (v0.lo != v1.lo) | ((v0.hi != v1.hi) << 8); }
+	#endif
+	
+	TS_INLINE float32x16_t operator*(const float32x16_t &v0, float32_t v1) { return v0 * float32x16_t(v1); }
+	TS_INLINE float32x16_t operator/(const float32x16_t &v0, float32_t v1) { return v0 / float32x16_t(v1); }
+	TS_INLINE float32x16_t operator+(const float32x16_t &v0, float32_t v1) { return v0 + float32x16_t(v1); }
+	TS_INLINE float32x16_t operator-(const float32x16_t &v0, float32_t v1) { return v0 - float32x16_t(v1); }
+	
+	TS_INLINE float32x16_t &operator*=(float32x16_t &v0, const float32x16_t &v1) { return v0 = v0 * v1; }
+	TS_INLINE float32x16_t &operator/=(float32x16_t &v0, const float32x16_t &v1) { return v0 = v0 / v1; }
+	TS_INLINE float32x16_t &operator+=(float32x16_t &v0, const float32x16_t &v1) { return v0 = v0 + v1; }
+	TS_INLINE float32x16_t &operator-=(float32x16_t &v0, const float32x16_t &v1) { return v0 = v0 - v1; }
+	
+	/*****************************************************************************\
+	 *
+	 * Functions
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE int32x16_t min(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_min_epi32(v0.vec, v1.vec)); }
+		TS_INLINE int32x16_t max(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(_mm512_max_epi32(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t min(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_min_epu32(v0.vec, v1.vec)); }
+		TS_INLINE uint32x16_t max(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(_mm512_max_epu32(v0.vec, v1.vec)); }
+		TS_INLINE float32x16_t min(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_min_ps(v0.vec, v1.vec)); }
+		TS_INLINE float32x16_t max(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(_mm512_max_ps(v0.vec, v1.vec)); }
+	#else
+		TS_INLINE int32x16_t min(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(min(v0.lo, v1.lo), min(v0.hi, v1.hi)); }
+		TS_INLINE int32x16_t max(const int32x16_t &v0, const int32x16_t &v1) { return int32x16_t(max(v0.lo, v1.lo), max(v0.hi, v1.hi)); }
+		TS_INLINE uint32x16_t min(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(min(v0.lo, v1.lo), min(v0.hi, v1.hi)); }
+		TS_INLINE uint32x16_t max(const uint32x16_t &v0, const uint32x16_t &v1) { return uint32x16_t(max(v0.lo, v1.lo), max(v0.hi, v1.hi)); }
+		TS_INLINE float32x16_t min(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(min(v0.lo, v1.lo), min(v0.hi, v1.hi)); }
+		TS_INLINE float32x16_t max(const float32x16_t &v0, const float32x16_t &v1) { return float32x16_t(max(v0.lo, v1.lo), max(v0.hi, v1.hi)); }
+	#endif
+	
+	/*
+	 */
+	#if TS_AVX512
+		TS_INLINE float32x16_t sqrt(const float32x16_t &v) { return float32x16_t(_mm512_sqrt_ps(v.vec)); }
+		TS_INLINE float32x16_t rcp(const float32x16_t &v) { return float32x16_t(_mm512_div_ps(_mm512_set1_ps(1.0f), v.vec)); }
+		TS_INLINE float32x16_t rsqrt(const float32x16_t &v) { return float32x16_t(_mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_sqrt_ps(v.vec))); }
+		TS_INLINE float32x16_t rsqrtFast(const float32x16_t &v) { return float32x16_t(_mm512_rsqrt14_ps(v.vec)); }
+		TS_INLINE float32x16_t abs(const float32x16_t &v) { return float32x16_t(_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v.vec), _mm512_set1_epi32(0x7fffffff)))); }
+		TS_INLINE float32x16_t ceil(const float32x16_t &v) { return float32x16_t(_mm512_roundscale_ps(v.vec, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC)); }
+		TS_INLINE float32x16_t floor(const float32x16_t &v) { return float32x16_t(_mm512_roundscale_ps(v.vec, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)); }
+	#else
+		TS_INLINE float32x16_t sqrt(const float32x16_t &v) { return float32x16_t(sqrt(v.lo), sqrt(v.hi)); }
+		TS_INLINE float32x16_t rcp(const float32x16_t &v) { return float32x16_t(rcp(v.lo), rcp(v.hi)); }
+		TS_INLINE float32x16_t rsqrt(const float32x16_t &v) { return float32x16_t(rsqrt(v.lo), rsqrt(v.hi)); }
+		TS_INLINE float32x16_t rsqrtFast(const float32x16_t &v) { return float32x16_t(rsqrtFast(v.lo), rsqrtFast(v.hi)); }
+		TS_INLINE float32x16_t abs(const float32x16_t &v) { return float32x16_t(abs(v.lo), abs(v.hi)); }
+		TS_INLINE float32x16_t ceil(const float32x16_t &v) { return float32x16_t(ceil(v.lo), ceil(v.hi)); }
+		TS_INLINE float32x16_t floor(const float32x16_t &v) { return float32x16_t(floor(v.lo), floor(v.hi)); }
+	#endif
+	
+	TS_INLINE float32x16_t powFast(const float32x16_t &v, float32_t p) {
+		return float32x16_t(powFast(v.getLo(), p), powFast(v.getHi(), p));
+	}
+	
+	/// select by the sign of the third argument
+	#if TS_AVX512
+		TS_INLINE int32x16_t select(const int32x16_t &v0, const int32x16_t &v1, const int32x16_t &s) {
+			return int32x16_t(_mm512_mask_blend_epi32(_mm512_movepi32_mask(s.vec), v0.vec, v1.vec));
+		}
+		TS_INLINE float32x16_t select(const float32x16_t &v0, const float32x16_t &v1, const float32x16_t &s) {
+			return float32x16_t(_mm512_mask_blend_ps(_mm512_movepi32_mask(_mm512_castps_si512(s.vec)), v0.vec, v1.vec));
+		}
+	#else
+		TS_INLINE int32x16_t select(const int32x16_t &v0, const int32x16_t &v1, const int32x16_t &s) {
+			return int32x16_t(select(v0.lo, v1.lo, s.lo), select(v0.hi, v1.hi, s.hi));
+		}
+		TS_INLINE float32x16_t select(const float32x16_t &v0, const float32x16_t &v1, const float32x16_t &s) {
+			return float32x16_t(select(v0.lo, v1.lo, s.lo), select(v0.hi, v1.hi, s.hi));
+		}
+	#endif
+	
+	/*****************************************************************************\
+	 *
+	 * SimdCPU
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	class SimdCPU {
+			
+		public:
+			
+			/// instruction set levels
+			enum Level {
+				LevelScalar = 0,
+				LevelSIMD128,		// SSE4.1 or NEON
+				LevelAVX2,			// AVX2 and FMA
+				LevelAVX512,		// AVX-512 F and DQ
+				NumLevels,
+			};
+			
+			/// processor features
+			enum Feature {
+				FeatureSSE41	= (1 << 0),
+				FeatureAVX		= (1 << 1),
+				FeatureAVX2		= (1 << 2),
+				FeatureFMA		= (1 << 3),
+				FeatureF16C		= (1 << 4),
+				FeatureAVX512F	= (1 << 5),
+				FeatureAVX512DQ	= (1 << 6),
+				FeatureAVX512BW	= (1 << 7),
+				FeatureAVX512VL	= (1 << 8),
+				FeatureNEON		= (1 << 9),
+			};
+			
+			/// processor features are detected once
+			static uint32_t getFeatures() {
+				static uint32_t features = detect_features();
+				return features;
+			}
+			static bool hasFeature(Feature feature) {
+				return ((getFeatures() & feature) != 0);
+			}
+			
+			/// the best supported level
+			static Level getLevel() {
+				uint32_t features = getFeatures();
+				if((features & (FeatureAVX512F | FeatureAVX512DQ)) == (FeatureAVX512F | FeatureAVX512DQ)) return LevelAVX512;
+				if((features & (FeatureAVX2 | FeatureFMA)) == (FeatureAVX2 | FeatureFMA)) return LevelAVX2;
+				if(features & (FeatureSSE41 | FeatureNEON)) return LevelSIMD128;
+				return LevelScalar;
+			}
+			
+			/// level name
+			static const char *getLevelName(Level level) {
+				if(level == LevelAVX512) return "AVX-512";
+				if(level == LevelAVX2) return "AVX2";
+				if(level == LevelSIMD128) return (hasFeature(FeatureNEON)) ? "NEON" : "SSE4.1";
+				return "Scalar";
+			}
+			
+		private:
+			
+			#if TS_SSE
+				
+				static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *regs) {
+					#if _WIN32
+						int32_t ret[4];
+						__cpuidex(ret, (int32_t)leaf, (int32_t)subleaf);
+						for(uint32_t i = 0; i < 4; i++) regs[i] = (uint32_t)ret[i];
+					#else
+						__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+					#endif
+				}
+				
+				static uint64_t xgetbv() {
+					#if _WIN32
+						return _xgetbv(0);
+					#else
+						uint32_t eax = 0, edx = 0;
+						__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+						return ((uint64_t)edx << 32) | eax;
+					#endif
+				}
+				
+			#endif
+			
+			static uint32_t detect_features() {
+				
+				uint32_t ret = 0;
+				
+				#if TS_SSE
+					
+					// basic features
+					uint32_t regs[4] = {};
+					cpuid(0, 0, regs);
+					uint32_t max_leaf = regs[0];
+					if(max_leaf < 1) return ret;
+					cpuid(1, 0, regs);
+					if(regs[2] & (1u << 19)) ret |= FeatureSSE41;
+					
+					// operating system must save the AVX state
+					if((regs[2] & (1u << 27)) == 0) return ret;
+					uint64_t xcr0 = xgetbv();
+					if((xcr0 & 0x06) != 0x06) return ret;
+					if(regs[2] & (1u << 28)) ret |= FeatureAVX;
+					if(regs[2] & (1u << 12)) ret |= FeatureFMA;
+					if(regs[2] & (1u << 29)) ret |= FeatureF16C;
+					
+					// extended features
+					if(max_leaf < 7) return ret;
+					cpuid(7, 0, regs);
+					if(regs[1] & (1u << 5)) ret |= FeatureAVX2;
+					
+					// operating system must save the opmask and ZMM state
+					if((xcr0 & 0xe0) != 0xe0) return ret;
+					if(regs[1] & (1u << 16)) ret |= FeatureAVX512F;
+					if(regs[1] & (1u << 17)) ret |= FeatureAVX512DQ;
+					if(regs[1] & (1u << 30)) ret |= FeatureAVX512BW;
+					if(regs[1] & (1u << 31)) ret |= FeatureAVX512VL;
+					
+				#elif TS_NEON
+					ret |= FeatureNEON;
+				#endif
+				
+				return ret;
+			}
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * SimdDispatch
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	TS_INLINE uint32_t simd_popcount(uint32_t mask) {
+		#if _WIN32
+			return __popcnt(mask);
+		#else
+			return (uint32_t)__builtin_popcount(mask);
+		#endif
+	}
+	
+	TS_INLINE uint32_t simd_ctz(uint32_t mask) {
+		#if _WIN32
+			unsigned long index = 0;
+			_BitScanForward(&index, mask);
+			return (uint32_t)index;
+		#else
+			return (uint32_t)__builtin_ctz(mask);
+		#endif
+	}
+	
+	/// unaligned vector load
+	TS_INLINE float32x4_t simd_loadu(const float32_t *src) {
+		#if TS_SSE
+			return float32x4_t(_mm_loadu_ps(src));
+		#else
+			TS_ALIGNAS16 float32_t data[4];
+			memcpy(data, src, sizeof(data));
+			return float32x4_t(data);
+		#endif
+	}
+	
+	/*
+	 */
+	static void simd_mad_scalar(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size) {
+		for(uint32_t i = 0; i < size; i++) {
+			dest[i] = src[i] * scale + bias;
+		}
+	}
+	
+	static uint32_t simd_cull_scalar(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size) {
+		uint32_t ret = 0;
+		for(uint32_t i = 0; i < size; i++) {
+			uint32_t j = 0;
+			for(; j < num_planes; j++) {
+				const float32_t *plane = planes + j * 4;
+				if(plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3] <= -r[i]) break;
+			}
+			if(j == num_planes) indices[ret++] = i;
+		}
+		return ret;
+	}
+	
+	/*
+	 */
+	#if TS_SSE || TS_NEON
+		
+		static void simd_mad_simd128(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size) {
+			uint32_t i = 0;
+			float32x4_t scale_4(scale);
+			float32x4_t bias_4(bias);
+			for(; i + 4 <= size; i += 4) {
+				float32x4_t v = simd_loadu(src + i) * scale_4 + bias_4;
+				#if TS_SSE
+					_mm_storeu_ps(dest + i, v.vec);
+				#else
+					vst1q_f32(dest + i, v.vec);
+				#endif
+			}
+			simd_mad_scalar(dest + i, src + i, scale, bias, size - i);
+		}
+		
+		static uint32_t simd_cull_simd128(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size) {
+			uint32_t i = 0;
+			uint32_t ret = 0;
+			for(; i + 4 <= size; i += 4) {
+				float32x4_t px = simd_loadu(x + i), py = simd_loadu(y + i), pz = simd_loadu(z + i);
+				float32x4_t radius = -simd_loadu(r + i);
+				uint32_t mask = 0x0f;
+				for(uint32_t j = 0; j < num_planes && mask; j++) {
+					const float32_t *plane = planes + j * 4;
+					float32x4_t distance = px * plane[0] + py * plane[1] + pz * plane[2] + plane[3];
+					mask &= (distance > radius);
+				}
+				for(; mask; mask &= mask - 1) {
+					indices[ret++] = i + simd_ctz(mask);
+				}
+			}
+			uint32_t tail = simd_cull_scalar(indices + ret, x + i, y + i, z + i, r + i, planes, num_planes, size - i);
+			for(uint32_t j = 0; j < tail; j++) indices[ret++] += i;
+			return ret;
+		}
+		
+	#endif
+	
+	/*
+	 */
+	#if TS_SSE
+		
+		TS_TARGET_AVX2 static void simd_mad_avx2(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size) {
+			uint32_t i = 0;
+			__m256 scale_8 = _mm256_set1_ps(scale);
+			__m256 bias_8 = _mm256_set1_ps(bias);
+			for(; i + 8 <= size; i += 8) {
+				_mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), scale_8, bias_8));
+			}
+			simd_mad_scalar(dest + i, src + i, scale, bias, size - i);
+		}
+		
+		TS_TARGET_AVX2 static uint32_t simd_cull_avx2(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size) {
+			uint32_t i = 0;
+			uint32_t ret = 0;
+			__m256 sign = _mm256_set1_ps(-0.0f);
+			for(; i + 8 <= size; i += 8) {
+				__m256 px = _mm256_loadu_ps(x + i);
+				__m256 py = _mm256_loadu_ps(y + i);
+				__m256 pz = _mm256_loadu_ps(z + i);
+				__m256 radius = _mm256_xor_ps(_mm256_loadu_ps(r + i), sign);
+				uint32_t mask = 0xff;
+				for(uint32_t j = 0; j < num_planes && mask; j++) {
+					const float32_t *plane = planes + j * 4;
+					__m256 distance = _mm256_fmadd_ps(px, _mm256_set1_ps(plane[0]), _mm256_set1_ps(plane[3]));
+					distance = _mm256_fmadd_ps(py, _mm256_set1_ps(plane[1]), distance);
+					distance = _mm256_fmadd_ps(pz, _mm256_set1_ps(plane[2]), distance);
+					mask &= (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(distance, radius, _CMP_GT_OQ));
+				}
+				for(; mask; mask &= mask - 1) {
+					indices[ret++] = i + simd_ctz(mask);
+				}
+			}
+			uint32_t tail = simd_cull_scalar(indices + ret, x + i, y + i, z + i, r + i, planes, num_planes, size - i);
+			for(uint32_t j = 0; j < tail; j++) indices[ret++] += i;
+			return ret;
+		}
+		
+		TS_TARGET_AVX512 static void simd_mad_avx512(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size) {
+			__m512 scale_16 = _mm512_set1_ps(scale);
+			__m512 bias_16 = _mm512_set1_ps(bias);
+			for(uint32_t i = 0; i < size; i += 16) {
+				__mmask16 mask = (size - i >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << (size - i)) - 1);
+				_mm512_mask_storeu_ps(dest + i, mask, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, src + i), scale_16, bias_16));
+			}
+		}
+		
+		TS_TARGET_AVX512 static uint32_t simd_cull_avx512(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size) {
+			uint32_t ret = 0;
+			__m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+			__m512i step = _mm512_set1_epi32(16);
+			__m512 sign = _mm512_set1_ps(-0.0f);
+			for(uint32_t i = 0; i < size; i += 16) {
+				__mmask16 mask = (size - i >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << (size - i)) - 1);
+				__m512 px = _mm512_maskz_loadu_ps(mask, x + i);
+				__m512 py = _mm512_maskz_loadu_ps(mask, y + i);
+				__m512 pz = _mm512_maskz_loadu_ps(mask, z + i);
+				__m512 radius = _mm512_xor_ps(_mm512_maskz_loadu_ps(mask, r + i), sign);
+				for(uint32_t j = 0; j < num_planes && mask; j++) {
+					const float32_t *plane = planes + j * 4;
+					__m512 distance = _mm512_fmadd_ps(px, _mm512_set1_ps(plane[0]), _mm512_set1_ps(plane[3]));
+					distance = _mm512_fmadd_ps(py, _mm512_set1_ps(plane[1]), distance);
+					distance = _mm512_fmadd_ps(pz, _mm512_set1_ps(plane[2]), distance);
+					mask = _mm512_mask_cmp_ps_mask(mask, distance, radius, _CMP_GT_OQ);
+				}
+				_mm512_mask_compressstoreu_epi32(indices + ret, mask, index);
+				ret += simd_popcount(mask);
+				index = _mm512_add_epi32(index, step);
+			}
+			return ret;
+		}
+		
+	#endif
+	
+	/*
+	 */
+	class SimdDispatch {
+			
+		public:
+			
+			/// dest = src * scale + bias
+			using MadFunction = void(*)(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size);
+			
+			/// visible sphere indices for the (x, y, z, r) SoA streams and xyzw planes
+			using CullFunction = uint32_t(*)(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size);
+			
+			/// dispatched kernels
+			static void mad(float32_t *dest, const float32_t *src, float32_t scale, float32_t bias, uint32_t size) {
+				get_kernels().mad(dest, src, scale, bias, size);
+			}
+			static uint32_t cull(uint32_t *indices, const float32_t *x, const float32_t *y, const float32_t *z, const float32_t *r, const float32_t *planes, uint32_t num_planes, uint32_t size) {
+				return get_kernels().cull(indices, x, y, z, r, planes, num_planes, size);
+			}
+			
+			/// kernels level is selected at startup
+			/// it can be lowered for validation but never raised above the processor level
+			static SimdCPU::Level setLevel(SimdCPU::Level level) {
+				get_kernels() = select_kernels(level);
+				return get_kernels().level;
+			}
+			static SimdCPU::Level getLevel() {
+				return get_kernels().level;
+			}
+			
+		private:
+			
+			struct Kernels {
+				SimdCPU::Level level;
+				MadFunction mad;
+				CullFunction cull;
+			};
+			
+			static Kernels select_kernels(SimdCPU::Level level) {
+				if(level > SimdCPU::getLevel()) level = SimdCPU::getLevel();
+				#if TS_SSE
+					if(level == SimdCPU::LevelAVX512) return { level, simd_mad_avx512, simd_cull_avx512 };
+					if(level == SimdCPU::LevelAVX2) return { level, simd_mad_avx2, simd_cull_avx2 };
+				#endif
+				#if TS_SSE || TS_NEON
+					if(level >= SimdCPU::LevelSIMD128) return { SimdCPU::LevelSIMD128, simd_mad_simd128, simd_cull_simd128 };
+				#endif
+				return { SimdCPU::LevelScalar, simd_mad_scalar, simd_cull_scalar };
+			}
+			
+			static Kernels &get_kernels() {
+				static Kernels kernels = select_kernels(SimdCPU::getLevel());
+				return kernels;
+			}
+	};
+}
+
+#endif /* __TELLUSIM_TESTS_SIMD16_H__ */
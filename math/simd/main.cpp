@@ -21,8 +21,13 @@
 // SOFTWARE.
 
 #include <core/TellusimLog.h>
+#include <math/TellusimMath.h>
 #include <math/TellusimSimd.h>
 
+#include "main_simd16.h"
+#include "main_simd_math.h"
+#include "main_simd_ops.h"
+
 /*
  */
 using namespace Tellusim;
@@ -65,6 +70,193 @@ void print(const char *str, const Tellusim::float32x8_t &v) {
 	TS_LOGF(Message, "%s%f %f %f %f %f %f %f %f\n", str, v.get<0>(), v.get<1>(), v.get<2>(), v.get<3>(), v.get<4>(), v.get<5>(), v.get<6>(), v.get<7>());
 }
 
+/*
+ */
+void print(const char *str, const Tellusim::int32x16_t &v) {
+	TS_ALIGNAS64 int32_t d[16];
+	v.get(d);
+	TS_LOGF(Message, "%s%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d\n", str, d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8], d[9], d[10], d[11], d[12], d[13], d[14], d[15]);
+}
+
+void print(const char *str, const Tellusim::uint32x16_t &v) {
+	TS_ALIGNAS64 uint32_t d[16];
+	v.get(d);
+	TS_LOGF(Message, "%s%u %u %u %u %u %u %u %u %u %u %u %u %u %u %u %u\n", str, d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8], d[9], d[10], d[11], d[12], d[13], d[14], d[15]);
+}
+
+void print(const char *str, const Tellusim::float32x16_t &v) {
+	TS_ALIGNAS64 float32_t d[16];
+	v.get(d);
+	TS_LOGF(Message, "%s%f %f %f %f %f %f %f %f %f %f %f %f %f %f %f %f\n", str, d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8], d[9], d[10], d[11], d[12], d[13], d[14], d[15]);
+}
+
+/*
+ */
+float64_t get_ulp(float32_t value, float64_t reference) {
+	union { float32_t f; uint32_t u; } ref;
+	ref.f = (float32_t)reference;
+	uint32_t exponent = Tellusim::max((ref.u >> 23) & 0xffu, 1u);
+	return Tellusim::abs((float64_t)value - reference) / Tellusim::pow(2.0, (float64_t)exponent - 150.0);
+}
+
+template <class Type, class Function, class Reference> float64_t get_max_ulp(const Function &function, const Reference &reference, float32_t x0, float32_t x1) {
+	constexpr uint32_t size = sizeof(Type) / sizeof(float32_t);
+	constexpr uint32_t num = 1 << 16;
+	TS_ALIGNAS64 float32_t src[size];
+	TS_ALIGNAS64 float32_t dest[size];
+	float64_t ret = 0.0;
+	for(uint32_t i = 0; i < num; i += size) {
+		for(uint32_t j = 0; j < size; j++) src[j] = x0 + (x1 - x0) * (float32_t)(i + j) / (float32_t)num;
+		function(Type(src)).get(dest);
+		for(uint32_t j = 0; j < size; j++) ret = Tellusim::max(ret, get_ulp(dest[j], reference((float64_t)src[j])));
+	}
+	return ret;
+}
+
+/// zero, infinite, nan and denormal arguments
+/// the nan or infinite result mismatch is reported as the maximal error
+template <class Type, class Function, class Reference> float64_t get_special_ulp(const Function &function, const Reference &reference) {
+	constexpr uint32_t size = sizeof(Type) / sizeof(float32_t);
+	const uint32_t values[] = { 0x00000000u, 0x80000000u, 0x7f800000u, 0xff800000u, 0x7fc00000u, 0xbf800000u, 0x00000001u, 0x00000100u, 0x3f800000u };
+	TS_ALIGNAS64 float32_t src[size];
+	TS_ALIGNAS64 float32_t dest[size];
+	float64_t ret = 0.0;
+	for(uint32_t i = 0; i < TS_COUNTOF(values); i += size) {
+		for(uint32_t j = 0; j < size; j++) memcpy(&src[j], &values[(i + j) % TS_COUNTOF(values)], sizeof(float32_t));
+		function(Type(src)).get(dest);
+		for(uint32_t j = 0; j < size; j++) {
+			float64_t value = dest[j];
+			float64_t expected = reference((float64_t)src[j]);
+			if(value != value || expected != expected) {
+				if((value != value) != (expected != expected)) return Maxf64;
+			} else if(Tellusim::abs(value) > Maxf32 || Tellusim::abs(expected) > Maxf32) {
+				if(value != expected) return Maxf64;
+			} else {
+				ret = Tellusim::max(ret, get_ulp(dest[j], expected));
+			}
+		}
+	}
+	return ret;
+}
+
+/*
+ */
+template <class Type> bool check_math(const char *type) {
+	
+	struct Result {
+		const char *name;
+		float64_t ulp;
+		float64_t max_ulp;
+	};
+	
+	auto sin64 = [](float64_t x) { return Tellusim::sin(x); };
+	auto cos64 = [](float64_t x) { return Tellusim::cos(x); };
+	auto exp64 = [](float64_t x) { return Tellusim::exp(x); };
+	auto exp264 = [](float64_t x) { return Tellusim::pow(2.0, x); };
+	auto log64 = [](float64_t x) { return Tellusim::log(x); };
+	auto log264 = [](float64_t x) { return Tellusim::log(x) / Tellusim::log(2.0); };
+	auto tanh64 = [](float64_t x) { float64_t e = Tellusim::exp(x * 2.0); return (e - 1.0) / (e + 1.0); };
+	
+	const Result results[] = {
+		{ "sin",    get_max_ulp<Type>([](const Type &x) { return sin(x); }, sin64, -16.0f, 16.0f), 2.0 },
+		{ "cos",    get_max_ulp<Type>([](const Type &x) { return cos(x); }, cos64, -16.0f, 16.0f), 2.0 },
+		{ "sincos", get_max_ulp<Type>([](const Type &x) { Type s, c; sincos(x, s, c); return s; }, sin64, -4.0f, 4.0f), 2.0 },
+		{ "exp",    get_max_ulp<Type>([](const Type &x) { return exp(x); }, exp64, -87.0f, 88.0f), 2.0 },
+		{ "exp2",   get_max_ulp<Type>([](const Type &x) { return exp2(x); }, exp264, -126.0f, 127.0f), 2.0 },
+		{ "log",    get_max_ulp<Type>([](const Type &x) { return log(x); }, log64, 0.25f, 4.0f), 1.0 },
+		{ "log",    get_max_ulp<Type>([](const Type &x) { return log(x); }, log64, 1.0f, 1.0e6f), 1.0 },
+		{ "log2",   get_max_ulp<Type>([](const Type &x) { return log2(x); }, log264, 0.25f, 4.0f), 2.0 },
+		{ "log2",   get_max_ulp<Type>([](const Type &x) { return log2(x); }, log264, 1.0f, 1.0e6f), 2.0 },
+		{ "atan2",  get_max_ulp<Type>([](const Type &y) { return atan2(y, Type(0.75f)); }, [](float64_t y) { return Tellusim::atan2(y, 0.75); }, -8.0f, 8.0f), 3.0 },
+		{ "atan2",  get_max_ulp<Type>([](const Type &x) { return atan2(Type(-2.0f), x); }, [](float64_t x) { return Tellusim::atan2(-2.0, x); }, -8.0f, 8.0f), 3.0 },
+		{ "tanh",   get_max_ulp<Type>([](const Type &x) { return tanh(x); }, tanh64, -8.0f, 8.0f), 2.0 },
+		{ "exp special",  get_special_ulp<Type>([](const Type &x) { return exp(x); }, exp64), 2.0 },
+		{ "exp2 special", get_special_ulp<Type>([](const Type &x) { return exp2(x); }, exp264), 2.0 },
+		{ "log special",  get_special_ulp<Type>([](const Type &x) { return log(x); }, log64), 1.0 },
+		{ "log2 special", get_special_ulp<Type>([](const Type &x) { return log2(x); }, log264), 2.0 },
+	};
+	
+	bool ret = true;
+	for(const Result &result : results) {
+		TS_LOGF(Message, "%s %s: %.2f ULP\n", type, result.name, result.ulp);
+		if(result.ulp > result.max_ulp) ret = false;
+	}
+	
+	return ret;
+}
+
+/*
+ */
+template <class Type> bool check_ops(const char *type) {
+	
+	using Scalar = typename SimdOps<Type>::Scalar;
+	using Index = typename SimdOps<Type>::Index;
+	constexpr uint32_t size = SimdOps<Type>::Size;
+	
+	TS_ALIGNAS32 const Scalar src[16] = { 5, 3, 8, 1, 9, 2, 7, 4, 6, 12, 10, 15, 11, 14, 13, 16 };
+	TS_ALIGNAS32 int32_t index[size];
+	TS_ALIGNAS32 Scalar data[size];
+	
+	// masked tail load
+	for(uint32_t num = 0; num <= size; num++) {
+		Type value = loadMasked<Type>(src, getTailMask<Type>(num));
+		value.get(data);
+		for(uint32_t i = 0; i < size; i++) {
+			if(data[i] != ((i < num) ? src[i] : Scalar(0))) return false;
+		}
+	}
+	TS_LOGF(Message, "%s", type);
+	print(" loadMasked: ", loadMasked<Type>(src, 0x05));
+	
+	// masked store
+	Scalar dest[size + 1];
+	for(uint32_t i = 0; i <= size; i++) dest[i] = 100;
+	storeMasked(dest, Type(src), 0x0a);
+	for(uint32_t i = 0; i <= size; i++) {
+		if(dest[i] != ((i == 1 || i == 3) ? src[i] : Scalar(100))) return false;
+	}
+	
+	// reversed gather and scatter
+	for(uint32_t i = 0; i < size; i++) index[i] = (int32_t)(size - i - 1) * 2;
+	Type value = gather<Type>(src, Index(index));
+	value.get(data);
+	for(uint32_t i = 0; i < size; i++) {
+		if(data[i] != src[index[i]]) return false;
+	}
+	TS_LOGF(Message, "%s", type);
+	print(" gather: ", value);
+	Scalar buffer[size * 2] = {};
+	scatter(buffer, value, Index(index));
+	for(uint32_t i = 0; i < size; i++) {
+		if(buffer[index[i]] != data[i]) return false;
+	}
+	
+	// horizontal min and max
+	value = loadUnaligned<Type>(src + 1);
+	Scalar min_value = src[1], max_value = src[1];
+	uint32_t min_index = 0, max_index = 0;
+	for(uint32_t i = 1; i < size; i++) {
+		if(min_value > src[i + 1]) { min_value = src[i + 1]; min_index = i; }
+		if(max_value < src[i + 1]) { max_value = src[i + 1]; max_index = i; }
+	}
+	if(hmin(value) != min_value || argmin(value) != min_index) return false;
+	if(hmax(value) != max_value || argmax(value) != max_index) return false;
+	TS_LOGF(Message, "%s hmin: %u %u hmax: %u %u\n", type, (uint32_t)hmin(value), argmin(value), (uint32_t)hmax(value), argmax(value));
+	
+	// inclusive prefix sum
+	value = prefixSum(Type(src));
+	value.get(data);
+	Scalar sum = 0;
+	for(uint32_t i = 0; i < size; i++) {
+		sum += src[i];
+		if(data[i] != sum) return false;
+	}
+	TS_LOGF(Message, "%s", type);
+	print(" prefixSum: ", value);
+	
+	return true;
+}
+
 /*
  */
 int32_t main(int32_t argc, char **argv) {
@@ -78,6 +270,9 @@ int32_t main(int32_t argc, char **argv) {
 	using Tellusim::float32x4_t;
 	using Tellusim::float64x2_t;
 	using Tellusim::float64x4_t;
+	using Tellusim::int32x16_t;
+	using Tellusim::uint32x16_t;
+	using Tellusim::float32x16_t;
 	
 	TS_ALIGNAS16 int16_t int16_array[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
 	TS_ALIGNAS16 int32_t int32_array[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
@@ -94,6 +289,10 @@ int32_t main(int32_t argc, char **argv) {
 	TS_UNUSED(float32_array);
 	TS_UNUSED(float64_array);
 	
+	TS_ALIGNAS64 int32_t int32x16_array[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+	TS_ALIGNAS64 uint32_t uint32x16_array[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+	TS_ALIGNAS64 float32_t float32x16_array[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f };
+	
 	// four elements type conversion
 	if(1) {
 		
@@ -154,6 +353,35 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8 from f32x8: ", float32x8_t(-float32x8_t(float32_array)));
 	}
 	
+	// sixteen elements type conversion
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		print("int32x16 from u32x16: ", int32x16_t(uint32x16_t(uint32x16_array)));
+		print("int32x16 from f32x16: ", int32x16_t(float32x16_t(float32x16_array)));
+		print("int32x16 from i32x16: ", int32x16_t(-int32x16_t(int32x16_array)));
+		print("int32x16 from f32x16: ", int32x16_t(-float32x16_t(float32x16_array)));
+		
+		TS_LOG(Message, "\n");
+		
+		print("uint32x16 from i32x16: ", uint32x16_t(int32x16_t(int32x16_array)));
+		print("uint32x16 from f32x16: ", uint32x16_t(float32x16_t(float32x16_array)));
+		
+		TS_LOG(Message, "\n");
+		
+		print("float32x16 from i32x16: ", float32x16_t(int32x16_t(int32x16_array)));
+		print("float32x16 from u32x16: ", float32x16_t(uint32x16_t(uint32x16_array)));
+		print("float32x16 from i32x16: ", float32x16_t(-int32x16_t(int32x16_array)));
+		print("float32x16 from f32x16: ", float32x16_t(-float32x16_t(float32x16_array)));
+		
+		TS_LOG(Message, "\n");
+		
+		print("float32x16 from f32x8: ", float32x16_t(float32x8_t(float32_array), -float32x8_t(float32_array)));
+		print("float32x8 from f32x16: ", float32x16_t(float32x16_array).getLo());
+		print("float32x8 from f32x16: ", float32x16_t(float32x16_array).getHi());
+	}
+	
 	// reinterpret cast
 	if(1) {
 		
@@ -182,6 +410,19 @@ int32_t main(int32_t argc, char **argv) {
 		
 		print(" int32x8 as f32x8: ", int32x8_t((int32_t)Onef32).asf32x8());
 		print("uint32x8 as f32x8: ", uint32x8_t(Onef32).asf32x8());
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16 as u32x16: ", int32x16_t(int32x16_array).asu32x16().asi32x16());
+		print(" int32x16 as f32x16: ", int32x16_t(int32x16_array).asf32x16().asi32x16());
+		
+		print("uint32x16 as i32x16: ", uint32x16_t(uint32x16_array).asi32x16().asu32x16());
+		print("uint32x16 as f32x16: ", uint32x16_t(uint32x16_array).asf32x16().asu32x16());
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16 as f32x16: ", int32x16_t((int32_t)Onef32).asf32x16());
+		print("uint32x16 as f32x16: ", uint32x16_t(Onef32).asf32x16());
 	}
 	
 	// set elements
@@ -227,6 +468,29 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8: ", float32x8);
 		
 		TS_LOG(Message, "\n");
+		
+		int32x16_t int32x16;
+		int32x16.set<0>(1); int32x16.set<1>(2); int32x16.set<2>(3); int32x16.set<3>(4);
+		int32x16.set<4>(5); int32x16.set<5>(6); int32x16.set<6>(7); int32x16.set<7>(8);
+		int32x16.set<8>(9); int32x16.set<9>(10); int32x16.set<10>(11); int32x16.set<11>(12);
+		int32x16.set<12>(13); int32x16.set<13>(14); int32x16.set<14>(15); int32x16.set<15>(16);
+		print(" int32x16: ", int32x16);
+		
+		uint32x16_t uint32x16;
+		uint32x16.set<0>(1); uint32x16.set<1>(2); uint32x16.set<2>(3); uint32x16.set<3>(4);
+		uint32x16.set<4>(5); uint32x16.set<5>(6); uint32x16.set<6>(7); uint32x16.set<7>(8);
+		uint32x16.set<8>(9); uint32x16.set<9>(10); uint32x16.set<10>(11); uint32x16.set<11>(12);
+		uint32x16.set<12>(13); uint32x16.set<13>(14); uint32x16.set<14>(15); uint32x16.set<15>(16);
+		print("uint32x16: ", uint32x16);
+		
+		float32x16_t float32x16;
+		float32x16.set<0>(1.0f); float32x16.set<1>(2.0f); float32x16.set<2>(3.0f); float32x16.set<3>(4.0f);
+		float32x16.set<4>(5.0f); float32x16.set<5>(6.0f); float32x16.set<6>(7.0f); float32x16.set<7>(8.0f);
+		float32x16.set<8>(9.0f); float32x16.set<9>(10.0f); float32x16.set<10>(11.0f); float32x16.set<11>(12.0f);
+		float32x16.set<12>(13.0f); float32x16.set<13>(14.0f); float32x16.set<14>(15.0f); float32x16.set<15>(16.0f);
+		print("float32x16: ", float32x16);
+		
+		TS_LOG(Message, "\n");
 	}
 	
 	// get elements
@@ -291,6 +555,21 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8: ", float32x8_t(float32_array).get8<5>());
 		print("float32x8: ", float32x8_t(float32_array).get8<6>());
 		print("float32x8: ", float32x8_t(float32_array).get8<7>());
+		
+		TS_LOG(Message, "\n");
+		
+		TS_LOGF(Message, " int32x16: %d %d %d %d\n", int32x16_t(int32x16_array).get<0>(), int32x16_t(int32x16_array).get<5>(), int32x16_t(int32x16_array).get<10>(), int32x16_t(int32x16_array).get<15>());
+		TS_LOGF(Message, "uint32x16: %u %u %u %u\n", uint32x16_t(uint32x16_array).get<0>(), uint32x16_t(uint32x16_array).get<5>(), uint32x16_t(uint32x16_array).get<10>(), uint32x16_t(uint32x16_array).get<15>());
+		TS_LOGF(Message, "float32x16: %f %f %f %f\n", float32x16_t(float32x16_array).get<0>(), float32x16_t(float32x16_array).get<5>(), float32x16_t(float32x16_array).get<10>(), float32x16_t(float32x16_array).get<15>());
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16: ", int32x16_t(int32x16_array).get16<0>());
+		print(" int32x16: ", int32x16_t(int32x16_array).get16<9>());
+		print("uint32x16: ", uint32x16_t(uint32x16_array).get16<3>());
+		print("uint32x16: ", uint32x16_t(uint32x16_array).get16<12>());
+		print("float32x16: ", float32x16_t(float32x16_array).get16<7>());
+		print("float32x16: ", float32x16_t(float32x16_array).get16<15>());
 	}
 	
 	// math operators
@@ -402,6 +681,55 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8 sub: ", float32x8_t(float32_array) - float32x8_t(16.0f));
 	}
 	
+	// math operators
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		print("int32x16 mul: ", int32x16_t(int32x16_array) * 16);
+		print("int32x16 mul: ", int32x16_t(int32x16_array) * int32x16_t(16));
+		print("int32x16 add: ", int32x16_t(int32x16_array) + 16);
+		print("int32x16 add: ", int32x16_t(int32x16_array) + int32x16_t(16));
+		print("int32x16 sub: ", int32x16_t(int32x16_array) - 16);
+		print("int32x16 sub: ", int32x16_t(int32x16_array) - int32x16_t(16));
+		print("int32x16 and: ", int32x16_t(int32x16_array) & 1);
+		print("int32x16 and: ", int32x16_t(int32x16_array) & int32x16_t(1));
+		print("int32x16  or: ", int32x16_t(int32x16_array) | 2);
+		print("int32x16  or: ", int32x16_t(int32x16_array) | int32x16_t(2));
+		print("int32x16 xor: ", int32x16_t(int32x16_array) ^ 1);
+		print("int32x16 xor: ", int32x16_t(int32x16_array) ^ int32x16_t(1));
+		print("int32x16 shl: ", int32x16_t(int32x16_array) << 4);
+		print("int32x16 shr: ", int32x16_t(int32x16_array) >> 1);
+		
+		TS_LOG(Message, "\n");
+		
+		print("uint32x16 mul: ", uint32x16_t(uint32x16_array) * 16u);
+		print("uint32x16 mul: ", uint32x16_t(uint32x16_array) * uint32x16_t(16u));
+		print("uint32x16 add: ", uint32x16_t(uint32x16_array) + 16u);
+		print("uint32x16 add: ", uint32x16_t(uint32x16_array) + uint32x16_t(16u));
+		print("uint32x16 sub: ", uint32x16_t(uint32x16_array) - 1u);
+		print("uint32x16 sub: ", uint32x16_t(uint32x16_array) - uint32x16_t(1u));
+		print("uint32x16 and: ", uint32x16_t(uint32x16_array) & 1u);
+		print("uint32x16 and: ", uint32x16_t(uint32x16_array) & uint32x16_t(1u));
+		print("uint32x16  or: ", uint32x16_t(uint32x16_array) | 2u);
+		print("uint32x16  or: ", uint32x16_t(uint32x16_array) | uint32x16_t(2u));
+		print("uint32x16 xor: ", uint32x16_t(uint32x16_array) ^ 1u);
+		print("uint32x16 xor: ", uint32x16_t(uint32x16_array) ^ uint32x16_t(1u));
+		print("uint32x16 shl: ", uint32x16_t(uint32x16_array) << 4u);
+		print("uint32x16 shr: ", uint32x16_t(uint32x16_array) >> 1u);
+		
+		TS_LOG(Message, "\n");
+		
+		print("float32x16 mul: ", float32x16_t(float32x16_array) * 16.0f);
+		print("float32x16 mul: ", float32x16_t(float32x16_array) * float32x16_t(16.0f));
+		print("float32x16 div: ", float32x16_t(float32x16_array) / 16.0f);
+		print("float32x16 div: ", float32x16_t(float32x16_array) / float32x16_t(16.0f));
+		print("float32x16 add: ", float32x16_t(float32x16_array) + 16.0f);
+		print("float32x16 add: ", float32x16_t(float32x16_array) + float32x16_t(16.0f));
+		print("float32x16 sub: ", float32x16_t(float32x16_array) - 16.0f);
+		print("float32x16 sub: ", float32x16_t(float32x16_array) - float32x16_t(16.0f));
+	}
+	
 	// math functions
 	if(1) {
 		
@@ -443,6 +771,19 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8 rsqrtFast: ", rsqrtFast(float32x8_t(2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f)));
 		print("float32x8 rsqrtFast: ", rsqrtFast(float32x8_t(10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f, 17.0f)));
 		print("float32x8 powFast: ", powFast(float32x8_t(0.5f, 1.0f, 2.0f, 4.0f, 8.0f, 16.0f, 32.0f, 64.0f), 2.0f));
+		
+		TS_LOG(Message, "\n");
+		
+		print("float32x16 rcp: ", rcp(float32x16_t(float32x16_array) + 1.0f));
+		print("float32x16 sqrt: ", sqrt(float32x16_t(float32x16_array) + 1.0f));
+		print("float32x16 rsqrt: ", rsqrt(float32x16_t(float32x16_array) + 1.0f));
+		print("float32x16 abs: ", abs(float32x16_t(float32x16_array) - 8.0f));
+		print("float32x16 ceil: ", ceil(float32x16_t(float32x16_array) * 0.3f - 2.0f));
+		print("float32x16 floor: ", floor(float32x16_t(float32x16_array) * 0.3f - 2.0f));
+		print("float32x16 min: ", min(float32x16_t(float32x16_array), float32x16_t(8.0f)));
+		print("float32x16 max: ", max(float32x16_t(float32x16_array), float32x16_t(8.0f)));
+		print("float32x16 rsqrtFast: ", rsqrtFast(float32x16_t(float32x16_array) + 1.0f));
+		print("float32x16 powFast: ", powFast(float32x16_t(float32x16_array) * 0.5f, 2.0f));
 	}
 	
 	// swizzles
@@ -508,6 +849,31 @@ int32_t main(int32_t argc, char **argv) {
 		print("float64x4 zw: ", float64x4_t(float64_array).zw());
 		
 		print("float64x2 yx: ", float64x2_t(float64_array).yx());
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16 zwxy0123: ", int32x16_t(int32x16_array).zwxy0123());
+		print("uint32x16 zwxy0123: ", uint32x16_t(uint32x16_array).zwxy0123());
+		print("float32x16 zwxy0123: ", float32x16_t(float32x16_array).zwxy0123());
+		
+		print(" int32x16 yxwz0123: ", int32x16_t(int32x16_array).yxwz0123());
+		print("uint32x16 yxwz0123: ", uint32x16_t(uint32x16_array).yxwz0123());
+		print("float32x16 yxwz0123: ", float32x16_t(float32x16_array).yxwz0123());
+		
+		print(" int32x16 xyzw1032: ", int32x16_t(int32x16_array).xyzw1032());
+		print("uint32x16 xyzw1032: ", uint32x16_t(uint32x16_array).xyzw1032());
+		print("float32x16 xyzw1032: ", float32x16_t(float32x16_array).xyzw1032());
+		
+		print(" int32x16 xyzw2301: ", int32x16_t(int32x16_array).xyzw2301());
+		print("uint32x16 xyzw2301: ", uint32x16_t(uint32x16_array).xyzw2301());
+		print("float32x16 xyzw2301: ", float32x16_t(float32x16_array).xyzw2301());
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16 xyzw0: ", int32x16_t(int32x16_array).xyzw0());
+		print("uint32x16 xyzw1: ", uint32x16_t(uint32x16_array).xyzw1());
+		print("float32x16 xyzw2: ", float32x16_t(float32x16_array).xyzw2());
+		print("float32x16 xyzw3: ", float32x16_t(float32x16_array).xyzw3());
 	}
 	
 	// sum components
@@ -531,6 +897,12 @@ int32_t main(int32_t argc, char **argv) {
 		TS_LOGF(Message, "float64x4: %f\n", float64x4_t(float64_array).sum());
 		
 		TS_LOGF(Message, "float32x8: %f\n", float32x8_t(float32_array).sum());
+		
+		TS_LOG(Message, "\n");
+		
+		TS_LOGF(Message, " int32x16: %d\n", int32x16_t(int32x16_array).sum());
+		TS_LOGF(Message, "uint32x16: %u\n", uint32x16_t(uint32x16_array).sum());
+		TS_LOGF(Message, "float32x16: %f\n", float32x16_t(float32x16_array).sum());
 	}
 	
 	// comparison operators
@@ -568,6 +940,26 @@ int32_t main(int32_t argc, char **argv) {
 		TS_LOGF(Message, "float32x8 op>=: 0x%02x\n", float32x8_t(float32_array) >= float32x8_t(2.0f));
 		TS_LOGF(Message, "float32x8 op==: 0x%02x\n", float32x8_t(float32_array) == float32x8_t(2.0f));
 		TS_LOGF(Message, "float32x8 op!=: 0x%02x\n", float32x8_t(float32_array) != float32x8_t(2.0f));
+		
+		TS_LOG(Message, "\n");
+		
+		TS_LOGF(Message, "float32x16 op<:  0x%04x\n", float32x16_t(float32x16_array) <  float32x16_t(10.0f));
+		TS_LOGF(Message, "float32x16 op>:  0x%04x\n", float32x16_t(float32x16_array) >  float32x16_t(10.0f));
+		TS_LOGF(Message, "float32x16 op<=: 0x%04x\n", float32x16_t(float32x16_array) <= float32x16_t(10.0f));
+		TS_LOGF(Message, "float32x16 op>=: 0x%04x\n", float32x16_t(float32x16_array) >= float32x16_t(10.0f));
+		TS_LOGF(Message, "float32x16 op==: 0x%04x\n", float32x16_t(float32x16_array) == float32x16_t(10.0f));
+		TS_LOGF(Message, "float32x16 op!=: 0x%04x\n", float32x16_t(float32x16_array) != float32x16_t(10.0f));
+		
+		TS_LOG(Message, "\n");
+		
+		TS_LOGF(Message, " int32x16 op<:  0x%04x\n", int32x16_t(int32x16_array) <  int32x16_t(10));
+		TS_LOGF(Message, " int32x16 op>=: 0x%04x\n", int32x16_t(int32x16_array) >= int32x16_t(10));
+		TS_LOGF(Message, "uint32x16 op>:  0x%04x\n", uint32x16_t(uint32x16_array) >  uint32x16_t(10u));
+		TS_LOGF(Message, "uint32x16 op==: 0x%04x\n", uint32x16_t(uint32x16_array) == uint32x16_t(10u));
+		
+		if((float32x16_t(float32x16_array) < float32x16_t(10.0f)) != 0x01ff) return 1;
+		if((int32x16_t(int32x16_array) >= int32x16_t(10)) != 0xfe00) return 1;
+		if((uint32x16_t(0x80000000u) > uint32x16_t(uint32x16_array)) != 0xffff) return 1;
 	}
 	
 	// select functions
@@ -611,6 +1003,133 @@ int32_t main(int32_t argc, char **argv) {
 		print("float32x8 select: ", select(float32x8_t(float32_array), -float32x8_t(float32_array), float32x8_t(1.0f)));
 		print("float32x8 select: ", select(float32x8_t(float32_array), -float32x8_t(float32_array), float32x8_t(1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f)));
 		print("float32x8 select: ", select(float32x8_t(float32_array), -float32x8_t(float32_array), float32x8_t(-1.0f)));
+		
+		TS_LOG(Message, "\n");
+		
+		print(" int32x16 select: ", select(int32x16_t(int32x16_array), -int32x16_t(int32x16_array), int32x16_t((int32_t)0)));
+		print(" int32x16 select: ", select(int32x16_t(int32x16_array), -int32x16_t(int32x16_array), int32x16_t(int32x16_array) - 9));
+		print(" int32x16 select: ", select(int32x16_t(int32x16_array), -int32x16_t(int32x16_array), int32x16_t(-1)));
+		
+		TS_LOG(Message, "\n");
+		
+		print("float32x16 select: ", select(float32x16_t(float32x16_array), -float32x16_t(float32x16_array), float32x16_t(0.0f)));
+		print("float32x16 select: ", select(float32x16_t(float32x16_array), -float32x16_t(float32x16_array), float32x16_t(float32x16_array) - 8.5f));
+		print("float32x16 select: ", select(float32x16_t(float32x16_array), -float32x16_t(float32x16_array), float32x16_t(-1.0f)));
+	}
+	
+	// runtime dispatch
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		using Tellusim::SimdCPU;
+		using Tellusim::SimdDispatch;
+		
+		SimdCPU::Level level = SimdCPU::getLevel();
+		TS_LOGF(Message, "CPU level: %s (features 0x%03x)\n", SimdCPU::getLevelName(level), SimdCPU::getFeatures());
+		
+		// frustum planes
+		const float32_t planes[] = {
+			 1.0f,  0.0f,  0.0f, 10.0f,
+			-1.0f,  0.0f,  0.0f, 10.0f,
+			 0.0f,  1.0f,  0.0f, 10.0f,
+			 0.0f, -1.0f,  0.0f, 10.0f,
+			 0.0f,  0.0f,  1.0f, 10.0f,
+			 0.0f,  0.0f, -1.0f, 10.0f,
+		};
+		
+		// sphere streams
+		constexpr uint32_t size = 1003;
+		float32_t x[size], y[size], z[size], r[size], dest[size];
+		for(uint32_t i = 0; i < size; i++) {
+			x[i] = (float32_t)((i * 37) % 41) - 20.0f;
+			y[i] = (float32_t)((i * 53) % 43) - 21.0f;
+			z[i] = (float32_t)((i * 71) % 47) - 23.0f;
+			r[i] = (float32_t)(i % 5);
+		}
+		
+		// reference result
+		uint32_t scalar_indices[size];
+		SimdDispatch::setLevel(SimdCPU::LevelScalar);
+		uint32_t num_scalar_indices = SimdDispatch::cull(scalar_indices, x, y, z, r, planes, 6, size);
+		
+		// all supported levels
+		for(uint32_t i = SimdCPU::LevelScalar; i <= (uint32_t)level; i++) {
+			
+			SimdCPU::Level kernel_level = SimdDispatch::setLevel((SimdCPU::Level)i);
+			
+			SimdDispatch::mad(dest, x, 2.0f, 1.0f, size);
+			for(uint32_t j = 0; j < size; j++) {
+				if(dest[j] != x[j] * 2.0f + 1.0f) return 1;
+			}
+			
+			// misaligned streams
+			SimdDispatch::mad(dest + 1, x + 1, 3.0f, 2.0f, size - 1);
+			for(uint32_t j = 1; j < size; j++) {
+				if(dest[j] != x[j] * 3.0f + 2.0f) return 1;
+			}
+			
+			uint32_t indices[size];
+			uint32_t num_indices = SimdDispatch::cull(indices, x, y, z, r, planes, 6, size);
+			TS_LOGF(Message, "%8s cull: %u/%u\n", SimdCPU::getLevelName(kernel_level), num_indices, size);
+			if(num_indices != num_scalar_indices) return 1;
+			for(uint32_t j = 0; j < num_indices; j++) {
+				if(indices[j] != scalar_indices[j]) return 1;
+			}
+		}
+		
+		SimdDispatch::setLevel(level);
+	}
+	
+	// masked and indexed operations
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		if(!check_ops<int32x4_t>(" int32x4")) return 1;
+		if(!check_ops<uint32x4_t>("uint32x4")) return 1;
+		if(!check_ops<float32x4_t>("float32x4")) return 1;
+		
+		TS_LOG(Message, "\n");
+		
+		if(!check_ops<int32x8_t>(" int32x8")) return 1;
+		if(!check_ops<uint32x8_t>("uint32x8")) return 1;
+		if(!check_ops<float32x8_t>("float32x8")) return 1;
+		
+		// nan lanes
+		float32x4_t nan_4 = float32x4_t(1.0f, 2.0f, 0.0f, 3.0f) / float32x4_t(1.0f, 1.0f, 0.0f, 1.0f);
+		if(argmin(nan_4) != 2 || argmax(nan_4) != 2) return 1;
+		float32x8_t nan_8 = float32x8_t(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 0.0f, 6.0f, 0.0f) / float32x8_t(1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f);
+		if(argmin(nan_8) != 5 || argmax(nan_8) != 5) return 1;
+		
+		// masked tail loop
+		float32_t x[19], y[19];
+		for(uint32_t i = 0; i < TS_COUNTOF(x); i++) x[i] = (float32_t)i;
+		for(uint32_t i = 0; i < TS_COUNTOF(x); i += 8) {
+			uint32_t mask = getTailMask<float32x8_t>(TS_COUNTOF(x) - i);
+			storeMasked(y + i, loadMasked<float32x8_t>(x + i, mask) * 2.0f + 1.0f, mask);
+		}
+		for(uint32_t i = 0; i < TS_COUNTOF(x); i++) {
+			if(y[i] != x[i] * 2.0f + 1.0f) return 1;
+		}
+	}
+	
+	// transcendental functions
+	if(1) {
+		
+		TS_LOG(Message, "\n");
+		
+		if(!check_math<float32x4_t>("float32x4")) return 1;
+		if(!check_math<float32x8_t>("float32x8")) return 1;
+		if(!check_math<float32x16_t>("float32x16")) return 1;
+		
+		float32x4_t s, c;
+		sincos(float32x4_t(0.0f, 1.0f, Pi, -2.0f), s, c);
+		print("float32x4 sin: ", s);
+		print("float32x4 cos: ", c);
+		print("float32x4 exp: ", exp(float32x4_t(-200.0f, 0.0f, 1.0f, 100.0f)));
+		print("float32x4 log: ", log(float32x4_t(0.0f, 1.0f, 2.0f, -1.0f)));
+		print("float32x4 atan2: ", atan2(float32x4_t(0.0f, 1.0f, -1.0f, 0.0f), float32x4_t(1.0f, 0.0f, 0.0f, -1.0f)));
 	}
 	
 	return 0;
@@ -0,0 +1,351 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_SIMD_MATH_H__
+#define __TELLUSIM_TESTS_SIMD_MATH_H__
+
+#include <math/TellusimSimd.h>
+
+#include "main_simd16.h"
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <class Type> struct SimdMath;
+	
+	template <> struct SimdMath<float32x4_t> {
+		using Int = int32x4_t;
+		static TS_INLINE int32x4_t asi(const float32x4_t &v) { return v.asi32x4(); }
+		static TS_INLINE float32x4_t asf(const int32x4_t &v) { return v.asf32x4(); }
+	};
+	
+	template <> struct SimdMath<float32x8_t> {
+		using Int = int32x8_t;
+		static TS_INLINE int32x8_t asi(const float32x8_t &v) { return v.asi32x8(); }
+		static TS_INLINE float32x8_t asf(const int32x8_t &v) { return v.asf32x8(); }
+	};
+	
+	template <> struct SimdMath<float32x16_t> {
+		using Int = int32x16_t;
+		static TS_INLINE int32x16_t asi(const float32x16_t &v) { return v.asi32x16(); }
+		static TS_INLINE float32x16_t asf(const int32x16_t &v) { return v.asf32x16(); }
+	};
+	
+	/*****************************************************************************\
+	 *
+	 * Helpers
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_sign(const Type &v) {
+		using Math = SimdMath<Type>;
+		return Math::asf(Math::asi(v) & (int32_t)0x80000000u);
+	}
+	
+	template <class Type> TS_INLINE Type simd_abs(const Type &v) {
+		using Math = SimdMath<Type>;
+		return Math::asf(Math::asi(v) & 0x7fffffff);
+	}
+	
+	template <class Type> TS_INLINE Type simd_xor(const Type &v0, const Type &v1) {
+		using Math = SimdMath<Type>;
+		return Math::asf(Math::asi(v0) ^ Math::asi(v1));
+	}
+	
+	/// v for the nan arguments, y otherwise
+	template <class Type> TS_INLINE Type simd_nan(const Type &y, const Type &v) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		return select(y, v, Math::asf(Int(0x7f800000) - (Math::asi(v) & 0x7fffffff)));
+	}
+	
+	/// v * 2^n for the integer valued n in the [-252, 254] range
+	template <class Type> TS_INLINE Type simd_ldexp(const Type &v, const Type &n) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		Int n0 = Int(n);
+		Int n1 = n0 >> 1;
+		Type ret = v * Math::asf((n1 + 127) << 23);
+		return ret * Math::asf((n0 - n1 + 127) << 23);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Trigonometric functions
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> TS_INLINE void simd_sincos(const Type &v, Type &s, Type &c) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		
+		// octant of the absolute value
+		Type x = simd_abs(v);
+		Type j = floor(x * 1.27323954473516f);
+		j = j + (j - floor(j * 0.5f) * 2.0f);
+		Int q = Int(j);
+		
+		// extended precision argument reduction
+		x = ((x - j * 0.78515625f) - j * 2.4187564849853515625e-4f) - j * 3.77489497744594108e-8f;
+		Type z = x * x;
+		
+		// polynomial approximations on the [-Pi/4, Pi/4] range
+		Type ps = ((z * -1.9515295891e-4f + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+		Type pc = ((z * 2.443315711809948e-5f - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - z * 0.5f + 1.0f;
+		
+		// swap polynomials in the odd quadrants
+		Type swap = Type(q & 2) - 1.0f;
+		Type rs = select(ps, pc, -swap);
+		Type rc = select(pc, ps, -swap);
+		
+		// sine sign depends on the argument sign
+		s = simd_xor(rs, simd_xor(Math::asf((q & 4) << 29), simd_sign(v)));
+		c = simd_xor(rc, Math::asf(((q + 2) & 4) << 29));
+	}
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_sin(const Type &v) {
+		Type s, c;
+		simd_sincos(v, s, c);
+		return s;
+	}
+	
+	template <class Type> TS_INLINE Type simd_cos(const Type &v) {
+		Type s, c;
+		simd_sincos(v, s, c);
+		return c;
+	}
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_atan2(const Type &y, const Type &x) {
+		
+		// ratio of the smaller and the larger component
+		Type ax = simd_abs(x);
+		Type ay = simd_abs(y);
+		Type swap = ax - ay;
+		Type n = min(ax, ay);
+		Type d = max(ax, ay);
+		
+		// Pi/8 range reduction
+		Type r = d * 0.414213562373095f - n;
+		Type a = select(Type(0.0f), Type(0.785398185253143f), r);
+		Type b = select(Type(0.0f), Type(-2.18556950e-8f), r);
+		Type t = select(n, n - d, r) / select(d, n + d, r);
+		t = select(Type(0.0f), t, Type(0.0f) - d);
+		
+		// polynomial approximation
+		Type z = t * t;
+		a = a + ((((z * 8.05374449538e-2f - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + b + t);
+		
+		// restore the quadrant
+		a = select(a, Type(1.57079632679490f) - a, swap);
+		a = select(a, Type(3.14159265358979f) - a, x);
+		return simd_xor(a, simd_sign(y));
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Exponential functions
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_exp(const Type &v) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		
+		// saturated argument
+		Type x = min(max(v, Type(-103.972084f)), Type(88.7228394f));
+		
+		// x = n * ln(2) + r
+		Type n = floor(x * 1.44269504088896341f + 0.5f);
+		x = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+		
+		// polynomial approximation
+		Type z = x * x;
+		Type y = (((((x * 1.9875691500e-4f + 1.3981999507e-3f) * x + 8.3334519073e-3f) * x + 4.1665795894e-2f) * x + 1.6666665459e-1f) * x + 5.0000001201e-1f) * z + x + 1.0f;
+		y = simd_ldexp(y, n);
+		
+		// overflow and nan arguments
+		y = select(y, Math::asf(Int(0x7f800000)), Type(88.7228394f) - v);
+		return simd_nan(y, v);
+	}
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_exp2(const Type &v) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		
+		// saturated argument
+		Type x = min(max(v, Type(-150.0f)), Type(128.0f));
+		
+		// x = n + r
+		Type n = floor(x + 0.5f);
+		x = x - n;
+		
+		// polynomial approximation
+		Type y = (((((x * 1.535336188319500e-4f + 1.339887440266574e-3f) * x + 9.618437357674640e-3f) * x + 5.550332471162809e-2f) * x + 2.402264791363012e-1f) * x + 6.931472028550421e-1f) * x + 1.0f;
+		y = simd_ldexp(y, n);
+		
+		// overflow and nan arguments
+		y = select(y, Math::asf(Int(0x7f800000)), Type(128.0f) - v);
+		return simd_nan(y, v);
+	}
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_tanh(const Type &v) {
+		
+		// polynomial approximation for the small arguments
+		Type x = simd_abs(v);
+		Type z = x * x;
+		Type p = ((((z * -5.70498872745e-3f + 2.06390887954e-2f) * z - 5.37397155531e-2f) * z + 1.33314422036e-1f) * z - 3.33332819422e-1f) * z * x + x;
+		
+		// exponential form for the large arguments
+		Type e = Type(1.0f) - Type(2.0f) / (simd_exp(x * 2.0f) + 1.0f);
+		
+		return simd_xor(select(e, p, x - 0.625f), simd_sign(v));
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Logarithmic functions
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> TS_INLINE void simd_log_reduce(const Type &v, Type &e, Type &x) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		
+		// denormal arguments are scaled by 2^23
+		Type scale = Math::asf((Math::asi(v) & 0x7fffffff) - 0x00800000);
+		Int i = Math::asi(select(v, v * 8388608.0f, scale));
+		
+		// v = 2^e * m, m in the [sqrt(0.5), sqrt(2)) range
+		Type m = Math::asf((i & 0x007fffff) | 0x3f000000);
+		e = Type(((i >> 23) & 0xff) - 126) - select(Type(0.0f), Type(23.0f), scale);
+		Type r = m - 0.707106781186547524f;
+		e = select(e, e - 1.0f, r);
+		x = select(m - 1.0f, m + m - 1.0f, r);
+	}
+	
+	/// log(1 + x) - x for the reduced argument
+	template <class Type> TS_INLINE Type simd_log_poly(const Type &x) {
+		Type z = x * x;
+		Type y = ((((((((x * 7.0376836292e-2f - 1.1514610310e-1f) * x + 1.1676998740e-1f) * x - 1.2420140846e-1f) * x + 1.4249322787e-1f) * x - 1.6668057665e-1f) * x + 2.0000714765e-1f) * x - 2.4999993993e-1f) * x + 3.3333331174e-1f) * x * z;
+		return y - z * 0.5f;
+	}
+	
+	/// special values: log(+inf) = +inf, log(nan) = nan, log(+-0) = -inf, log(x < 0) = nan
+	template <class Type> TS_INLINE Type simd_log_special(const Type &y, const Type &v) {
+		using Math = SimdMath<Type>;
+		using Int = typename Math::Int;
+		Int i = Math::asi(v) & 0x7fffffff;
+		Type ret = select(y, v, Math::asf(Int(0x7f7fffff) - i));
+		ret = select(ret, Math::asf(Int(0x7fc00000)), v);
+		return select(ret, Math::asf(Int((int32_t)0xff800000u)), Math::asf(i - 1));
+	}
+	
+	/*
+	 */
+	template <class Type> TS_INLINE Type simd_log(const Type &v) {
+		Type e, x;
+		simd_log_reduce(v, e, x);
+		Type y = simd_log_poly(x) + e * -2.12194440e-4f;
+		y = (x + y) + e * 0.693359375f;
+		return simd_log_special(y, v);
+	}
+	
+	template <class Type> TS_INLINE Type simd_log2(const Type &v) {
+		Type e, x;
+		simd_log_reduce(v, e, x);
+		Type y = simd_log_poly(x);
+		y = (y * 1.44269504088896341f + x * 0.44269504088896341f) + x + e;
+		return simd_log_special(y, v);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Vector functions
+	 *
+	 * The maximum error is measured against the float64_t functions:
+	 *   sin, cos, sincos:  2 ULP for |x| <= 16, 1e-7 absolute error for |x| <= 8192
+	 *   exp, exp2:         2 ULP for the finite results
+	 *   log:               1 ULP for the positive arguments
+	 *   log2:              2 ULP for the positive arguments
+	 *   zero, infinite and nan arguments follow the scalar functions
+	 *   atan2:             3 ULP
+	 *   tanh:              2 ULP
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	TS_INLINE float32x4_t sin(const float32x4_t &v) { return simd_sin(v); }
+	TS_INLINE float32x4_t cos(const float32x4_t &v) { return simd_cos(v); }
+	TS_INLINE void sincos(const float32x4_t &v, float32x4_t &s, float32x4_t &c) { simd_sincos(v, s, c); }
+	TS_INLINE float32x4_t atan2(const float32x4_t &y, const float32x4_t &x) { return simd_atan2(y, x); }
+	TS_INLINE float32x4_t exp(const float32x4_t &v) { return simd_exp(v); }
+	TS_INLINE float32x4_t exp2(const float32x4_t &v) { return simd_exp2(v); }
+	TS_INLINE float32x4_t log(const float32x4_t &v) { return simd_log(v); }
+	TS_INLINE float32x4_t log2(const float32x4_t &v) { return simd_log2(v); }
+	TS_INLINE float32x4_t tanh(const float32x4_t &v) { return simd_tanh(v); }
+	
+	/*
+	 */
+	TS_INLINE float32x8_t sin(const float32x8_t &v) { return simd_sin(v); }
+	TS_INLINE float32x8_t cos(const float32x8_t &v) { return simd_cos(v); }
+	TS_INLINE void sincos(const float32x8_t &v, float32x8_t &s, float32x8_t &c) { simd_sincos(v, s, c); }
+	TS_INLINE float32x8_t atan2(const float32x8_t &y, const float32x8_t &x) { return simd_atan2(y, x); }
+	TS_INLINE float32x8_t exp(const float32x8_t &v) { return simd_exp(v); }
+	TS_INLINE float32x8_t exp2(const float32x8_t &v) { return simd_exp2(v); }
+	TS_INLINE float32x8_t log(const float32x8_t &v) { return simd_log(v); }
+	TS_INLINE float32x8_t log2(const float32x8_t &v) { return simd_log2(v); }
+	TS_INLINE float32x8_t tanh(const float32x8_t &v) { return simd_tanh(v); }
+	
+	/*
+	 */
+	TS_INLINE float32x16_t sin(const float32x16_t &v) { return simd_sin(v); }
+	TS_INLINE float32x16_t cos(const float32x16_t &v) { return simd_cos(v); }
+	TS_INLINE void sincos(const float32x16_t &v, float32x16_t &s, float32x16_t &c) { simd_sincos(v, s, c); }
+	TS_INLINE float32x16_t atan2(const float32x16_t &y, const float32x16_t &x) { return simd_atan2(y, x); }
+	TS_INLINE float32x16_t exp(const float32x16_t &v) { return simd_exp(v); }
+	TS_INLINE float32x16_t exp2(const float32x16_t &v) { return simd_exp2(v); }
+	TS_INLINE float32x16_t log(const float32x16_t &v) { return simd_log(v); }
+	TS_INLINE float32x16_t log2(const float32x16_t &v) { return simd_log2(v); }
+	TS_INLINE float32x16_t tanh(const float32x16_t &v) { return simd_tanh(v); }
+}
+
+#endif /* __TELLUSIM_TESTS_SIMD_MATH_H__ */
@@ -0,0 +1,424 @@
+// MIT License
+// 
+// Copyright (C) 2018-2024, Tellusim Technologies Inc. https://tellusim.com/
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TELLUSIM_TESTS_SIMD_OPS_H__
+#define __TELLUSIM_TESTS_SIMD_OPS_H__
+
+#include <math/TellusimSimd.h>
+
+#include "main_simd16.h"
+
+/*
+ */
+#if TS_AVX && defined(__AVX2__)
+	#define TS_SIMD_OPS_AVX2	1
+#else
+	#define TS_SIMD_OPS_AVX2	0
+#endif
+
+#if TS_SSE && (defined(__SSE4_1__) || defined(__AVX__))
+	#define TS_SIMD_OPS_SSE41	1
+#else
+	#define TS_SIMD_OPS_SSE41	0
+#endif
+
+/*
+ */
+namespace Tellusim {
+	
+	/*
+	 */
+	template <class Type> struct SimdOps;
+	
+	template <> struct SimdOps<int32x4_t> { using Scalar = int32_t; using Index = int32x4_t; enum { Size = 4 }; };
+	template <> struct SimdOps<uint32x4_t> { using Scalar = uint32_t; using Index = int32x4_t; enum { Size = 4 }; };
+	template <> struct SimdOps<float32x4_t> { using Scalar = float32_t; using Index = int32x4_t; enum { Size = 4 }; };
+	
+	template <> struct SimdOps<int32x8_t> { using Scalar = int32_t; using Index = int32x8_t; enum { Size = 8 }; };
+	template <> struct SimdOps<uint32x8_t> { using Scalar = uint32_t; using Index = int32x8_t; enum { Size = 8 }; };
+	template <> struct SimdOps<float32x8_t> { using Scalar = float32_t; using Index = int32x8_t; enum { Size = 8 }; };
+	
+	/// lane mask of the first num elements
+	template <class Type> TS_INLINE uint32_t getTailMask(uint32_t num) {
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		return (num >= size) ? ((1u << size) - 1) : ((1u << num) - 1);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Masked load and store
+	 *
+	\*****************************************************************************/
+	
+	/// loads the lanes selected by the mask, the other lanes are zero
+	/// memory of the disabled lanes is not accessed
+	template <class Type> TS_INLINE Type loadMasked(const typename SimdOps<Type>::Scalar *src, uint32_t mask) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		for(uint32_t i = 0; i < size; i++) {
+			data[i] = (mask & (1u << i)) ? src[i] : Scalar(0);
+		}
+		return Type(data);
+	}
+	
+	/// stores the lanes selected by the mask
+	/// memory of the disabled lanes is not accessed
+	template <class Type> TS_INLINE void storeMasked(typename SimdOps<Type>::Scalar *dest, const Type &src, uint32_t mask) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		src.get(data);
+		for(uint32_t i = 0; i < size; i++) {
+			if(mask & (1u << i)) dest[i] = data[i];
+		}
+	}
+	
+	/// loads the vector from the memory without the alignment requirement
+	template <class Type> TS_INLINE Type loadUnaligned(const typename SimdOps<Type>::Scalar *src) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		memcpy(data, src, sizeof(data));
+		return Type(data);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Gather and scatter
+	 *
+	\*****************************************************************************/
+	
+	/// dest[i] = src[indices[i]]
+	template <class Type> TS_INLINE Type gather(const typename SimdOps<Type>::Scalar *src, const typename SimdOps<Type>::Index &indices) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 int32_t index[size];
+		TS_ALIGNAS32 Scalar data[size];
+		indices.get(index);
+		for(uint32_t i = 0; i < size; i++) {
+			data[i] = src[index[i]];
+		}
+		return Type(data);
+	}
+	
+	/// dest[indices[i]] = src[i], the highest lane wins on the duplicate indices
+	template <class Type> TS_INLINE void scatter(typename SimdOps<Type>::Scalar *dest, const Type &src, const typename SimdOps<Type>::Index &indices) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 int32_t index[size];
+		TS_ALIGNAS32 Scalar data[size];
+		indices.get(index);
+		src.get(data);
+		for(uint32_t i = 0; i < size; i++) {
+			dest[index[i]] = data[i];
+		}
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * Horizontal operations
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <class Type> TS_INLINE typename SimdOps<Type>::Scalar hmin(const Type &v) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		v.get(data);
+		Scalar ret = data[0];
+		for(uint32_t i = 1; i < size; i++) {
+			if(ret > data[i]) ret = data[i];
+		}
+		return ret;
+	}
+	
+	template <class Type> TS_INLINE typename SimdOps<Type>::Scalar hmax(const Type &v) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		v.get(data);
+		Scalar ret = data[0];
+		for(uint32_t i = 1; i < size; i++) {
+			if(ret < data[i]) ret = data[i];
+		}
+		return ret;
+	}
+	
+	/// index of the first minimal lane, the first nan lane wins
+	template <class Type> TS_INLINE uint32_t argmin(const Type &v) {
+		uint32_t mask = ~(v == v) & getTailMask<Type>(SimdOps<Type>::Size);
+		if(mask == 0) mask = (v == Type(hmin(v)));
+		return (mask) ? simd_ctz(mask) : 0;
+	}
+	
+	/// index of the first maximal lane, the first nan lane wins
+	template <class Type> TS_INLINE uint32_t argmax(const Type &v) {
+		uint32_t mask = ~(v == v) & getTailMask<Type>(SimdOps<Type>::Size);
+		if(mask == 0) mask = (v == Type(hmax(v)));
+		return (mask) ? simd_ctz(mask) : 0;
+	}
+	
+	/// inclusive prefix sum: ret[i] = v[0] + ... + v[i]
+	/// the generic path sums the lanes sequentially, the SSE and AVX2 paths sum them in log2(Size) steps
+	/// so the float32 rounding may differ between the targets
+	template <class Type> TS_INLINE Type prefixSum(const Type &v) {
+		using Scalar = typename SimdOps<Type>::Scalar;
+		constexpr uint32_t size = SimdOps<Type>::Size;
+		TS_ALIGNAS32 Scalar data[size];
+		v.get(data);
+		for(uint32_t i = 1; i < size; i++) {
+			data[i] += data[i - 1];
+		}
+		return Type(data);
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * float32 horizontal operations
+	 *
+	\*****************************************************************************/
+	
+	/*
+	 */
+	template <> TS_INLINE float32_t hmin(const float32x4_t &v) {
+		float32x4_t ret = min(v, v.zwxy());
+		return min(ret, ret.yxwz()).get<0>();
+	}
+	
+	template <> TS_INLINE float32_t hmax(const float32x4_t &v) {
+		float32x4_t ret = max(v, v.zwxy());
+		return max(ret, ret.yxwz()).get<0>();
+	}
+	
+	template <> TS_INLINE float32_t hmin(const float32x8_t &v) {
+		float32x8_t ret = min(v, v.xyzw10());
+		ret = min(ret, ret.zwxy01());
+		return min(ret, ret.yxwz01()).get<0>();
+	}
+	
+	template <> TS_INLINE float32_t hmax(const float32x8_t &v) {
+		float32x8_t ret = max(v, v.xyzw10());
+		ret = max(ret, ret.zwxy01());
+		return max(ret, ret.yxwz01()).get<0>();
+	}
+	
+	/*****************************************************************************\
+	 *
+	 * SSE specializations
+	 *
+	\*****************************************************************************/
+	
+	#if TS_SSE
+		
+		/*
+		 */
+		TS_INLINE __m128i simd_mask_sse(uint32_t mask) {
+			__m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+			return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32((int32_t)mask), bits), bits);
+		}
+		
+		#if TS_AVX
+			
+			/*
+			 */
+			template <> TS_INLINE float32x4_t loadMasked<float32x4_t>(const float32_t *src, uint32_t mask) {
+				return float32x4_t(_mm_maskload_ps(src, simd_mask_sse(mask)));
+			}
+			template <> TS_INLINE int32x4_t loadMasked<int32x4_t>(const int32_t *src, uint32_t mask) {
+				return int32x4_t(_mm_castps_si128(_mm_maskload_ps((const float32_t*)src, simd_mask_sse(mask))));
+			}
+			template <> TS_INLINE uint32x4_t loadMasked<uint32x4_t>(const uint32_t *src, uint32_t mask) {
+				return uint32x4_t(_mm_castps_si128(_mm_maskload_ps((const float32_t*)src, simd_mask_sse(mask))));
+			}
+			
+			/*
+			 */
+			template <> TS_INLINE void storeMasked(float32_t *dest, const float32x4_t &src, uint32_t mask) {
+				_mm_maskstore_ps(dest, simd_mask_sse(mask), src.vec);
+			}
+			template <> TS_INLINE void storeMasked(int32_t *dest, const int32x4_t &src, uint32_t mask) {
+				_mm_maskstore_ps((float32_t*)dest, simd_mask_sse(mask), _mm_castsi128_ps(src.vec));
+			}
+			template <> TS_INLINE void storeMasked(uint32_t *dest, const uint32x4_t &src, uint32_t mask) {
+				_mm_maskstore_ps((float32_t*)dest, simd_mask_sse(mask), _mm_castsi128_ps(src.vec));
+			}
+			
+		#endif
+		
+		#if TS_SIMD_OPS_AVX2
+			
+			/*
+			 */
+			template <> TS_INLINE float32x4_t gather<float32x4_t>(const float32_t *src, const int32x4_t &indices) {
+				return float32x4_t(_mm_i32gather_ps(src, indices.vec, 4));
+			}
+			template <> TS_INLINE int32x4_t gather<int32x4_t>(const int32_t *src, const int32x4_t &indices) {
+				return int32x4_t(_mm_i32gather_epi32(src, indices.vec, 4));
+			}
+			template <> TS_INLINE uint32x4_t gather<uint32x4_t>(const uint32_t *src, const int32x4_t &indices) {
+				return uint32x4_t(_mm_i32gather_epi32((const int32_t*)src, indices.vec, 4));
+			}
+			
+		#endif
+		
+		#if TS_SIMD_OPS_SSE41
+			
+			/*
+			 */
+			template <> TS_INLINE int32_t hmin(const int32x4_t &v) {
+				__m128i ret = _mm_min_epi32(v.vec, _mm_shuffle_epi32(v.vec, 0x4e));
+				return _mm_cvtsi128_si32(_mm_min_epi32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+			}
+			template <> TS_INLINE int32_t hmax(const int32x4_t &v) {
+				__m128i ret = _mm_max_epi32(v.vec, _mm_shuffle_epi32(v.vec, 0x4e));
+				return _mm_cvtsi128_si32(_mm_max_epi32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+			}
+			template <> TS_INLINE uint32_t hmin(const uint32x4_t &v) {
+				__m128i ret = _mm_min_epu32(v.vec, _mm_shuffle_epi32(v.vec, 0x4e));
+				return (uint32_t)_mm_cvtsi128_si32(_mm_min_epu32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+			}
+			template <> TS_INLINE uint32_t hmax(const uint32x4_t &v) {
+				__m128i ret = _mm_max_epu32(v.vec, _mm_shuffle_epi32(v.vec, 0x4e));
+				return (uint32_t)_mm_cvtsi128_si32(_mm_max_epu32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+			}
+			
+		#endif
+		
+		/*
+		 */
+		template <> TS_INLINE int32x4_t prefixSum(const int32x4_t &v) {
+			__m128i ret = _mm_add_epi32(v.vec, _mm_slli_si128(v.vec, 4));
+			return int32x4_t(_mm_add_epi32(ret, _mm_slli_si128(ret, 8)));
+		}
+		template <> TS_INLINE uint32x4_t prefixSum(const uint32x4_t &v) {
+			__m128i ret = _mm_add_epi32(v.vec, _mm_slli_si128(v.vec, 4));
+			return uint32x4_t(_mm_add_epi32(ret, _mm_slli_si128(ret, 8)));
+		}
+		template <> TS_INLINE float32x4_t prefixSum(const float32x4_t &v) {
+			__m128 ret = _mm_add_ps(v.vec, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v.vec), 4)));
+			return float32x4_t(_mm_add_ps(ret, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(ret), 8))));
+		}
+		
+	#endif
+	
+	/*****************************************************************************\
+	 *
+	 * AVX2 specializations
+	 *
+	\*****************************************************************************/
+	
+	#if TS_SIMD_OPS_AVX2
+		
+		/*
+		 */
+		TS_INLINE __m256i simd_mask_avx2(uint32_t mask) {
+			__m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+			return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int32_t)mask), bits), bits);
+		}
+		
+		/*
+		 */
+		template <> TS_INLINE float32x8_t loadMasked<float32x8_t>(const float32_t *src, uint32_t mask) {
+			return float32x8_t(_mm256_maskload_ps(src, simd_mask_avx2(mask)));
+		}
+		template <> TS_INLINE int32x8_t loadMasked<int32x8_t>(const int32_t *src, uint32_t mask) {
+			return int32x8_t(_mm256_maskload_epi32(src, simd_mask_avx2(mask)));
+		}
+		template <> TS_INLINE uint32x8_t loadMasked<uint32x8_t>(const uint32_t *src, uint32_t mask) {
+			return uint32x8_t(_mm256_maskload_epi32((const int32_t*)src, simd_mask_avx2(mask)));
+		}
+		
+		/*
+		 */
+		template <> TS_INLINE void storeMasked(float32_t *dest, const float32x8_t &src, uint32_t mask) {
+			_mm256_maskstore_ps(dest, simd_mask_avx2(mask), src.vec);
+		}
+		template <> TS_INLINE void storeMasked(int32_t *dest, const int32x8_t &src, uint32_t mask) {
+			_mm256_maskstore_epi32(dest, simd_mask_avx2(mask), src.vec);
+		}
+		template <> TS_INLINE void storeMasked(uint32_t *dest, const uint32x8_t &src, uint32_t mask) {
+			_mm256_maskstore_epi32((int32_t*)dest, simd_mask_avx2(mask), src.vec);
+		}
+		
+		/*
+		 */
+		template <> TS_INLINE float32x8_t gather<float32x8_t>(const float32_t *src, const int32x8_t &indices) {
+			return float32x8_t(_mm256_i32gather_ps(src, indices.vec, 4));
+		}
+		template <> TS_INLINE int32x8_t gather<int32x8_t>(const int32_t *src, const int32x8_t &indices) {
+			return int32x8_t(_mm256_i32gather_epi32(src, indices.vec, 4));
+		}
+		template <> TS_INLINE uint32x8_t gather<uint32x8_t>(const uint32_t *src, const int32x8_t &indices) {
+			return uint32x8_t(_mm256_i32gather_epi32((const int32_t*)src, indices.vec, 4));
+		}
+		
+		/*
+		 */
+		template <> TS_INLINE int32_t hmin(const int32x8_t &v) {
+			__m128i ret = _mm_min_epi32(_mm256_castsi256_si128(v.vec), _mm256_extracti128_si256(v.vec, 1));
+			ret = _mm_min_epi32(ret, _mm_shuffle_epi32(ret, 0x4e));
+			return _mm_cvtsi128_si32(_mm_min_epi32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+		}
+		template <> TS_INLINE int32_t hmax(const int32x8_t &v) {
+			__m128i ret = _mm_max_epi32(_mm256_castsi256_si128(v.vec), _mm256_extracti128_si256(v.vec, 1));
+			ret = _mm_max_epi32(ret, _mm_shuffle_epi32(ret, 0x4e));
+			return _mm_cvtsi128_si32(_mm_max_epi32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+		}
+		template <> TS_INLINE uint32_t hmin(const uint32x8_t &v) {
+			__m128i ret = _mm_min_epu32(_mm256_castsi256_si128(v.vec), _mm256_extracti128_si256(v.vec, 1));
+			ret = _mm_min_epu32(ret, _mm_shuffle_epi32(ret, 0x4e));
+			return (uint32_t)_mm_cvtsi128_si32(_mm_min_epu32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+		}
+		template <> TS_INLINE uint32_t hmax(const uint32x8_t &v) {
+			__m128i ret = _mm_max_epu32(_mm256_castsi256_si128(v.vec), _mm256_extracti128_si256(v.vec, 1));
+			ret = _mm_max_epu32(ret, _mm_shuffle_epi32(ret, 0x4e));
+			return (uint32_t)_mm_cvtsi128_si32(_mm_max_epu32(ret, _mm_shuffle_epi32(ret, 0xb1)));
+		}
+		
+		/// prefix sum inside the 128-bit lanes and the low lane carry
+		TS_INLINE __m256i simd_prefix_sum_avx2(__m256i v) {
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+			__m256i carry = _mm256_shuffle_epi32(v, 0xff);
+			return _mm256_add_epi32(v, _mm256_permute2x128_si256(carry, carry, 0x08));
+		}
+		
+		template <> TS_INLINE int32x8_t prefixSum(const int32x8_t &v) {
+			return int32x8_t(simd_prefix_sum_avx2(v.vec));
+		}
+		template <> TS_INLINE uint32x8_t prefixSum(const uint32x8_t &v) {
+			return uint32x8_t(simd_prefix_sum_avx2(v.vec));
+		}
+		template <> TS_INLINE float32x8_t prefixSum(const float32x8_t &v) {
+			__m256 ret = _mm256_add_ps(v.vec, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(v.vec), 4)));
+			ret = _mm256_add_ps(ret, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(ret), 8)));
+			__m256 carry = _mm256_permute_ps(ret, 0xff);
+			return float32x8_t(_mm256_add_ps(ret, _mm256_permute2f128_ps(carry, carry, 0x08)));
+		}
+		
+	#endif
+}
+
+#endif /* __TELLUSIM_TESTS_SIMD_OPS_H__ */